@@ -0,0 +1,373 @@
+// Nightly jobs without the GUI, for cron / Task Scheduler.
+// Usage: sis-batch [--jobs list] [--threads N] [--chunk-size N] [--date yyyy-MM-dd]
+//                  [--grace-days N] [--from yyyy-MM-dd] [--to yyyy-MM-dd]
+//                  [--out-dir path] [--config file.ini] [--sqlite path]
+//                  [--trace file.json] [--quiet]
+//
+// Jobs run one after another; --threads sets the parallelism inside a job.
+// Every job walks its table in id windows or streams rows, so memory stays
+// flat however large the database is.
+//
+// Exit codes: 0 all jobs succeeded, 1 a job failed, 2 bad arguments,
+// 3 the database could not be opened.
+
+#include "../database/databasemanager.h"
+#include "../database/idrange.h"
+#include "../database/scopedconnection.h"
+#include "../modules/attendance/attendanceanalytics.h"
+#include "../modules/finance/paymentrepository.h"
+#include "../modules/grades/graderepository.h"
+#include "../modules/library/libraryrepository.h"
+#include "../modules/reports/reportengine.h"
+#include "../utils/memoryusage.h"
+#include "../utils/tracer.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace {
+enum ExitCode {
+    ExitOk = 0,
+    ExitJobFailed = 1,
+    ExitUsage = 2,
+    ExitDatabase = 3
+};
+
+const QStringList AllJobs = {"overdue-loans", "payment-aging", "attendance-alerts", "gpa", "reports"};
+
+struct Options {
+    QStringList jobs;
+    int threads = 0;
+    int chunkSize = 5000;
+    int graceDays = 30;
+    QDate date;
+    QDate from;
+    QDate to;
+    QString outDir;
+    bool quiet = false;
+};
+
+struct JobResult {
+    bool ok = true;
+    qint64 processed = 0;  // Rows (or ids) looked at
+    qint64 changed = 0;    // Rows written
+    QString detail;
+};
+
+// Throttled "sis-batch: job 42% (done/total)" lines on stderr; safe to call from workers
+class ProgressPrinter {
+public:
+    ProgressPrinter(const QString& job, bool quiet) : m_job(job), m_quiet(quiet) { m_clock.start(); }
+
+    void update(qint64 done, qint64 total)
+    {
+        if (m_quiet || total <= 0) {
+            return;
+        }
+        QMutexLocker lock(&m_mutex);
+        if (done < total && m_clock.elapsed() - m_lastMs < 500) {
+            return;
+        }
+        m_lastMs = m_clock.elapsed();
+        QTextStream(stderr) << "sis-batch: " << m_job << ' ' << (done * 100 / total) << "% ("
+                            << done << '/' << total << ")\n";
+    }
+
+    ProgressCallback callback()
+    {
+        return [this](qint64 done, qint64 total) { update(done, total); };
+    }
+
+private:
+    QString m_job;
+    bool m_quiet;
+    QMutex m_mutex;
+    QElapsedTimer m_clock;
+    qint64 m_lastMs = -1000;
+};
+
+int threadCount(const Options& options)
+{
+    return options.threads > 0 ? options.threads : QThread::idealThreadCount();
+}
+
+JobResult overdueLoans(const Options& options, ProgressPrinter& progress)
+{
+    JobResult result;
+    const qint64 changed = LibraryRepository::markOverdueLoans(DatabaseManager::instance().getDatabase(), options.date,
+                                                               options.chunkSize, progress.callback());
+    result.ok = changed >= 0;
+    result.changed = qMax<qint64>(changed, 0);
+    return result;
+}
+
+JobResult paymentAging(const Options& options, ProgressPrinter& progress)
+{
+    JobResult result;
+    const qint64 changed = PaymentRepository::markOverduePayments(DatabaseManager::instance().getDatabase(),
+                                                                  options.date, options.graceDays,
+                                                                  options.chunkSize, progress.callback());
+    result.ok = changed >= 0;
+    result.changed = qMax<qint64>(changed, 0);
+    return result;
+}
+
+JobResult attendanceAlerts(const Options& options, ProgressPrinter&)
+{
+    AttendanceAnalytics::Config config;
+    config.threadCount = options.threads;
+    config.from = options.from;
+    config.to = options.to;
+    const AttendanceAnalytics::RunSummary run = AttendanceAnalytics(config).run(options.date);
+
+    JobResult result;
+    result.ok = run.saved;
+    result.processed = run.studentSectionsEvaluated;
+    result.changed = run.alertsRaised;
+    result.detail = QString("load %1 ms, evaluate %2 ms, save %3 ms")
+                        .arg(run.loadMs).arg(run.evaluateMs).arg(run.saveMs);
+    return result;
+}
+
+// Each worker owns a slice of student ids and its own connection
+JobResult recomputeGpa(const Options& options, ProgressPrinter& progress)
+{
+    JobResult result;
+    const std::optional<IdRange> range = IdRange::of(DatabaseManager::instance().getDatabase(), "grades", "student_id");
+    if (!range) {
+        result.ok = false;
+        return result;
+    }
+    if (range->isEmpty()) {
+        return result;
+    }
+
+    const std::vector<IdRange> parts = range->split(threadCount(options));
+    std::vector<GradeRecomputeSummary> summaries(parts.size());
+    std::vector<std::atomic<qint64>> done(parts.size());
+    for (auto& d : done) {
+        d = 0;
+    }
+    auto report = [&progress, &done, &range](size_t part, qint64 partDone) {
+        done[part] = partDone;
+        qint64 total = 0;
+        for (const auto& d : done) {
+            total += d;
+        }
+        progress.update(total, range->size());
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(int(parts.size()));
+    for (size_t i = 0; i < parts.size(); ++i) {
+        pool.start([&, i]() {
+            ScopedConnection connection;
+            if (!connection.isOpen()) {
+                summaries[i].ok = false;
+                return;
+            }
+            summaries[i] = GradeRepository::recomputeTotals(connection.database(), parts[i], options.chunkSize,
+                                                            [&report, i](qint64 partDone, qint64) { report(i, partDone); });
+        });
+    }
+    pool.waitForDone();
+
+    GradeRecomputeSummary total;
+    for (const GradeRecomputeSummary& summary : summaries) {
+        total.merge(summary);
+    }
+    result.ok = total.ok;
+    result.processed = total.rows;
+    result.changed = total.updated;
+    result.detail = QString("%1 students, mean GPA %2, %3 below 2.0")
+                        .arg(total.students)
+                        .arg(QString::number(total.meanGpa(), 'f', 2))
+                        .arg(total.belowTwo);
+    return result;
+}
+
+// One CSV per report type, exported in parallel with the GUI's file layout
+JobResult exportReports(const Options& options, ProgressPrinter& progress)
+{
+    const std::vector<ReportType> types = {ReportType::StudentEnrollment, ReportType::CourseStatistics,
+                                           ReportType::AttendanceSummary, ReportType::FinancialSummary};
+    std::vector<qint64> rows(types.size(), 0);
+    std::vector<char> ok(types.size(), 0);
+    std::atomic<qint64> finished(0);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMin(threadCount(options), int(types.size())));
+    for (size_t i = 0; i < types.size(); ++i) {
+        pool.start([&, i]() {
+            ScopedConnection connection(DbAccess::ReadOnly);
+            if (connection.isOpen()) {
+                const QString name = ReportEngine::typeName(types[i]).toLower().replace(' ', '_');
+                const QString path = QDir(options.outDir).filePath(
+                    QString("%1_%2.csv").arg(name, options.date.toString("yyyy-MM-dd")));
+                ok[i] = ReportEngine(connection.database()).exportCsv(types[i], options.from, options.to, path, &rows[i]);
+            }
+            progress.update(++finished, qint64(types.size()));
+        });
+    }
+    pool.waitForDone();
+
+    JobResult result;
+    QStringList failed;
+    for (size_t i = 0; i < types.size(); ++i) {
+        result.ok = result.ok && ok[i];
+        result.processed += rows[i];
+        result.changed += ok[i] ? 1 : 0;
+        if (!ok[i]) {
+            failed << ReportEngine::typeName(types[i]);
+        }
+    }
+    result.detail = QString("%1 files in %2").arg(result.changed).arg(QDir(options.outDir).absolutePath());
+    if (!failed.isEmpty()) {
+        result.detail += QString("; failed: %1").arg(failed.join(", "));
+    }
+    return result;
+}
+
+using Job = std::function<JobResult(const Options&, ProgressPrinter&)>;
+
+Job jobFor(const QString& name)
+{
+    if (name == "overdue-loans") return overdueLoans;
+    if (name == "payment-aging") return paymentAging;
+    if (name == "attendance-alerts") return attendanceAlerts;
+    if (name == "gpa") return recomputeGpa;
+    return exportReports;
+}
+
+QDate dateOption(const QCommandLineParser& parser, const QString& name, const QDate& fallback, bool* valid)
+{
+    if (!parser.isSet(name)) {
+        return fallback;
+    }
+    const QDate date = QDate::fromString(parser.value(name), "yyyy-MM-dd");
+    if (!date.isValid()) {
+        QTextStream(stderr) << "sis-batch: --" << name << " expects yyyy-MM-dd, got " << parser.value(name) << "\n";
+        *valid = false;
+    }
+    return date;
+}
+
+int intOption(const QCommandLineParser& parser, const QString& name, int fallback, int minimum, bool* valid)
+{
+    if (!parser.isSet(name)) {
+        return fallback;
+    }
+    bool parsed = false;
+    const int value = parser.value(name).toInt(&parsed);
+    if (!parsed || value < minimum) {
+        QTextStream(stderr) << "sis-batch: --" << name << " expects an integer >= " << minimum << "\n";
+        *valid = false;
+    }
+    return value;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("sis-batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs the University SIS nightly jobs.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"jobs", "Comma-separated jobs to run: " + AllJobs.join(", ") + " or all.", "list", "all"},
+        {"threads", "Worker threads inside a job (0 = one per core).", "n", "0"},
+        {"chunk-size", "Ids per window / transaction.", "n", "5000"},
+        {"date", "Run date, default today.", "yyyy-MM-dd"},
+        {"grace-days", "Days a pending payment may stay unpaid before it is overdue.", "n", "30"},
+        {"from", "Start of the report/attendance window, default one month before --to.", "yyyy-MM-dd"},
+        {"to", "End of the report/attendance window, default --date.", "yyyy-MM-dd"},
+        {"out-dir", "Directory for report CSV files.", "path", "."},
+        {"config", "Read database settings from this INI file instead of SIS_CONFIG.", "path"},
+        {"sqlite", "Use this SQLite database instead of the configured server.", "path"},
+        {"trace", "Write a Chrome trace of the run to this file.", "file.json"},
+        {"quiet", "No progress output."},
+    });
+    parser.process(app);
+
+    Options options;
+    bool valid = true;
+    const QString jobList = parser.value("jobs");
+    options.jobs = jobList == "all" ? AllJobs : jobList.split(',', Qt::SkipEmptyParts);
+    for (const QString& job : options.jobs) {
+        if (!AllJobs.contains(job)) {
+            QTextStream(stderr) << "sis-batch: unknown job " << job << "\n";
+            valid = false;
+        }
+    }
+    options.threads = intOption(parser, "threads", 0, 0, &valid);
+    options.chunkSize = intOption(parser, "chunk-size", 5000, 1, &valid);
+    options.graceDays = intOption(parser, "grace-days", 30, 0, &valid);
+    options.date = dateOption(parser, "date", QDate::currentDate(), &valid);
+    options.to = dateOption(parser, "to", options.date, &valid);
+    options.from = dateOption(parser, "from", options.to.addMonths(-1), &valid);
+    options.outDir = parser.value("out-dir");
+    options.quiet = parser.isSet("quiet");
+    if (valid && options.from > options.to) {
+        QTextStream(stderr) << "sis-batch: --from is after --to\n";
+        valid = false;
+    }
+    if (valid && options.jobs.contains("reports") && !QDir().mkpath(options.outDir)) {
+        QTextStream(stderr) << "sis-batch: cannot create " << options.outDir << "\n";
+        valid = false;
+    }
+    if (!valid || options.jobs.isEmpty()) {
+        QTextStream(stderr) << "Try 'sis-batch --help'.\n";
+        return ExitUsage;
+    }
+
+    if (parser.isSet("trace")) {
+        Tracer::instance().start(parser.value("trace"));
+    }
+    if (parser.isSet("config")) {
+        DatabaseManager::instance().setConfig(DatabaseConfig::load(parser.value("config")));
+    }
+    if (parser.isSet("sqlite")) {
+        DatabaseManager::instance().setSqlitePath(parser.value("sqlite"));
+    }
+    if (!DatabaseManager::instance().connect()) {
+        QTextStream(stderr) << "sis-batch: database unavailable\n";
+        Tracer::instance().finish();
+        return ExitDatabase;
+    }
+
+    QTextStream out(stdout);
+    int exitCode = ExitOk;
+    for (const QString& name : options.jobs) {
+        ProgressPrinter progress(name, options.quiet);
+        QElapsedTimer clock;
+        clock.start();
+        const JobResult result = jobFor(name)(options, progress);
+        const qint64 rssMb = currentRssBytes() / (1024 * 1024);
+
+        out << name << ": " << (result.ok ? "ok" : "FAILED")
+            << ", processed " << result.processed << ", changed " << result.changed
+            << ", " << clock.elapsed() << " ms, rss " << rssMb << " MB";
+        if (!result.detail.isEmpty()) {
+            out << " (" << result.detail << ")";
+        }
+        out << "\n";
+        out.flush();
+        if (!result.ok) {
+            exitCode = ExitJobFailed;
+        }
+    }
+
+    DatabaseManager::instance().runMaintenance();  // No event loop here, so no aboutToQuit
+    Tracer::instance().finish();
+    return exitCode;
+}
@@ -0,0 +1,110 @@
+// Login cost and timing uniformity of the credential subsystem.
+// Usage: sis-bench-auth [--iterations N] [--cost N] [--tolerance PCT] [--json path]
+//
+// verify_correct, verify_wrong, verify_unknown and verify_legacy should report
+// near-identical means; cache_hit shows what a repeat kiosk login costs.
+// Exits 1 when a wrong password or unknown user is accepted, a correct or
+// legacy password is rejected, or the wrong/unknown/legacy mean falls outside
+// [1 / (1 + PCT/100), 1 + PCT/100] of verify_correct (default 25: 0.8 - 1.25).
+
+#include "benchmarkharness.h"
+#include "../modules/auth/credentialverifier.h"
+#include "../modules/auth/passwordhasher.h"
+#include <QCoreApplication>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int iterations = BenchmarkReport::intOption(args, "--iterations", 20);
+    PasswordHasher::setIterations(BenchmarkReport::intOption(args, "--cost", PasswordHasher::DefaultIterations));
+
+    BenchmarkReport report("auth");
+    report.setParameter("pbkdf2_iterations", PasswordHasher::iterations());
+
+    const QString password = "pass123";
+    const QString stored = PasswordHasher::hash(password);
+
+    report.run("hash", iterations, [&](int) {
+        PasswordHasher::hash(password);
+    });
+
+    // accepted counts the timed runs only, not the warm-up (i == -1)
+    int accepted = 0;
+    auto& correct = report.run("verify_correct", iterations, [&](int i) {
+        const bool ok = PasswordHasher::verify(password, stored).ok;
+        accepted += (i >= 0 && ok) ? 1 : 0;
+    });
+    correct.counters["accepted"] = accepted;
+
+    accepted = 0;
+    auto& wrong = report.run("verify_wrong", iterations, [&](int i) {
+        const bool ok = PasswordHasher::verify("pass124", stored).ok;
+        accepted += (i >= 0 && ok) ? 1 : 0;
+    });
+    wrong.counters["accepted"] = accepted;
+
+    auto& unknown = report.run("verify_unknown", iterations, [&](int) {
+        CredentialVerifier::instance().rejectUnknown(password);
+    });
+    // rejectUnknown cannot accept; check that a missing stored hash is never a match either
+    unknown.counters["accepted"] = PasswordHasher::verify(password, QString()).ok ? 1 : 0;
+
+    accepted = 0;
+    auto& legacy = report.run("verify_legacy", iterations, [&](int i) {
+        const bool ok = PasswordHasher::verify(password, password).ok;
+        accepted += (i >= 0 && ok) ? 1 : 0;
+    });
+    legacy.counters["accepted"] = accepted;
+
+    // Repeat logins of one account after the first verification populated the cache
+    CredentialVerifier& verifier = CredentialVerifier::instance();
+    verifier.clear();
+    verifier.verify("students", "kiosk.user", password, stored);
+    accepted = 0;
+    auto& hit = report.run("cache_hit", iterations, [&](int i) {
+        const bool ok = verifier.verify("students", "kiosk.user", password, stored);
+        accepted += (i >= 0 && ok) ? 1 : 0;
+    });
+    hit.counters["accepted"] = accepted;
+    hit.counters["hits"] = qint64(verifier.stats().hits);
+
+    QStringList failures;
+    auto expectAccepted = [&](const BenchmarkResult& result, int expected) {
+        const int got = result.counters.value("accepted").toInt();
+        if (got != expected) {
+            failures << QString("%1: accepted %2, expected %3").arg(result.name).arg(got).arg(expected);
+        }
+    };
+    expectAccepted(correct, iterations);
+    expectAccepted(wrong, 0);
+    expectAccepted(unknown, 0);
+    expectAccepted(legacy, iterations);
+
+    const double tolerance = BenchmarkReport::intOption(args, "--tolerance", 25) / 100.0;
+    const double low = 1.0 / (1.0 + tolerance);
+    const double high = 1.0 + tolerance;
+    report.setParameter("ratio_band", QString("%1-%2").arg(low, 0, 'f', 2).arg(high, 0, 'f', 2));
+    const double baseline = correct.meanMs();
+    if (baseline > 0.0) {
+        for (BenchmarkResult* result : {&wrong, &unknown, &legacy}) {
+            const double ratio = result->meanMs() / baseline;
+            result->counters["ratio_to_correct"] = ratio;
+            if (ratio < low || ratio > high) {
+                failures << QString("%1: %2x the time of verify_correct, outside %3-%4")
+                                .arg(result->name).arg(ratio, 0, 'f', 2).arg(low, 0, 'f', 2).arg(high, 0, 'f', 2);
+            }
+        }
+    }
+
+    const int code = report.finish(args);
+    if (!failures.isEmpty()) {
+        QTextStream err(stderr);
+        for (const QString& failure : failures) {
+            err << "FAIL " << failure << "\n";
+        }
+        return 1;
+    }
+    return code;
+}
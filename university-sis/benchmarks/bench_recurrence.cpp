@@ -0,0 +1,108 @@
+// Expands a full term's weekly timetable for every section.
+// Usage: sis-bench-recurrence [--sections N] [--iterations N] [--json path]
+
+#include "benchmarkharness.h"
+#include "../modules/calendar/recurringevent.h"
+#include <QCoreApplication>
+#include <QRandomGenerator>
+#include <bitset>
+
+namespace {
+
+std::vector<RecurringEvent> makeTimetable(int sections, const QDate& termStart, const QDate& termEnd,
+                                          const RecurrenceRule& holidays)
+{
+    QRandomGenerator rng(42);
+    std::vector<RecurringEvent> timetable;
+    timetable.reserve(sections);
+    for (int i = 0; i < sections; ++i) {
+        RecurringEvent s;
+        s.id = i + 1;
+        s.sectionId = i + 1;
+        s.startDate = termStart;
+        s.time = QTime(8 + rng.bounded(10), rng.bounded(2) * 30);
+        s.title = QString("Section %1 lecture").arg(i + 1);
+        s.type = "Class";
+        // Two or three meetings a week, Sunday to Thursday
+        static const quint8 days[] = {RecurrenceRule::Sunday, RecurrenceRule::Monday, RecurrenceRule::Tuesday,
+                                      RecurrenceRule::Wednesday, RecurrenceRule::Thursday};
+        const int meetings = 2 + rng.bounded(2);
+        while (int(std::bitset<7>(s.rule.weekdays).count()) < meetings) {
+            s.rule.weekdays |= days[rng.bounded(5)];
+        }
+        if (rng.bounded(10) == 0) {
+            s.rule.intervalWeeks = 2; // Some labs run every other week
+        }
+        s.rule.until = termEnd;
+        s.rule.exceptions = holidays.exceptions;
+        timetable.push_back(s);
+    }
+    return timetable;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int sections = BenchmarkReport::intOption(args, "--sections", 2000);
+    const int iterations = BenchmarkReport::intOption(args, "--iterations", 20);
+
+    const QDate termStart(2024, 9, 15);
+    const QDate termEnd(2024, 12, 31);
+    RecurrenceRule holidays;
+    holidays.setExceptionsFromString("2024-10-06,2024-10-07,2024-11-20,2024-12-25");
+    const std::vector<RecurringEvent> timetable = makeTimetable(sections, termStart, termEnd, holidays);
+
+    BenchmarkReport report("recurrence");
+    report.setParameter("sections", sections);
+    report.setParameter("term_start", termStart.toString(Qt::ISODate));
+    report.setParameter("term_end", termEnd.toString(Qt::ISODate));
+
+    std::vector<CalendarEvent> events;
+    auto& fullTerm = report.run("expand_full_term", iterations, [&](int) {
+        events.clear();
+        for (const auto& s : timetable) {
+            s.appendOccurrences(termStart, termEnd, events);
+        }
+    });
+    fullTerm.counters["occurrences"] = qint64(events.size());
+
+    // What CalendarSystem does when paging through the term one month at a time
+    qint64 monthOccurrences = 0;
+    auto& months = report.run("expand_month_windows", iterations, [&](int) {
+        monthOccurrences = 0;
+        for (QDate month(termStart.year(), termStart.month(), 1); month <= termEnd; month = month.addMonths(1)) {
+            events.clear();
+            for (const auto& s : timetable) {
+                s.appendOccurrences(month, month.addMonths(1).addDays(-1), events);
+            }
+            monthOccurrences += qint64(events.size());
+        }
+    });
+    months.counters["occurrences"] = monthOccurrences;
+
+    // A single week in the middle of the term, as shown by the news feed
+    const QDate weekStart(2024, 11, 3);
+    auto& week = report.run("expand_single_week", iterations, [&](int) {
+        events.clear();
+        for (const auto& s : timetable) {
+            s.appendOccurrences(weekStart, weekStart.addDays(6), events);
+        }
+    });
+    week.counters["occurrences"] = qint64(events.size());
+
+    int parsed = 0;
+    auto& roundtrip = report.run("rrule_roundtrip", iterations, [&](int) {
+        parsed = 0;
+        for (const auto& s : timetable) {
+            if (RecurrenceRule::fromRRule(s.rule.toRRule())) {
+                ++parsed;
+            }
+        }
+    });
+    roundtrip.counters["rules"] = parsed;
+
+    return report.finish(args);
+}
@@ -0,0 +1,455 @@
+// Every repository and service method against a generated campus.
+// Usage: sis-bench-repositories [--students N] [--iterations N] [--seed N] [--cost N]
+//                               [--db path] [--json path]
+//
+// Without --db the campus is generated into a temporary SQLite file that is
+// removed on exit. Read cases on cached repositories are reported twice:
+// "cold" invalidates the cache before every call, "cached" does not.
+// Write cases add and remove their own rows so the dataset stays stable.
+
+#include "benchmarkharness.h"
+#include "campusgenerator.h"
+#include "../database/databasemanager.h"
+#include "../database/queryprofiler.h"
+#include "../modules/academic/courserepository.h"
+#include "../modules/academic/sectionrepository.h"
+#include "../modules/attendance/attendanceanalytics.h"
+#include "../modules/attendance/attendancerepository.h"
+#include "../modules/auth/authservice.h"
+#include "../modules/auth/passwordhasher.h"
+#include "../modules/auth/userrepository.h"
+#include "../modules/calendar/calendarrepository.h"
+#include "../modules/enrollment/enrollmentrepository.h"
+#include "../modules/enrollment/enrollmentvalidator.h"
+#include "../modules/enrollment/waitlistmanager.h"
+#include "../modules/facility/facilityrepository.h"
+#include "../modules/faculty/facultyrepository.h"
+#include "../modules/finance/paymentrepository.h"
+#include "../modules/grades/graderepository.h"
+#include "../modules/library/libraryrepository.h"
+#include "../modules/reports/reportengine.h"
+#include "../modules/scheduling/timetablerepository.h"
+#include "../modules/scheduling/timetablesolver.h"
+#include "../modules/session/sessiondataservice.h"
+#include "../modules/student/studentrepository.h"
+#include <QCoreApplication>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <functional>
+#include <vector>
+
+namespace {
+std::vector<int> columnValues(const QString& sql)
+{
+    std::vector<int> values;
+    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    query.setForwardOnly(true);
+    query.exec(sql);
+    while (query.next()) {
+        values.push_back(query.value(0).toInt());
+    }
+    return values;
+}
+
+int lastId(const QString& table, const QString& column)
+{
+    const std::vector<int> ids = columnValues(QString("SELECT MAX(%1) FROM %2").arg(column, table));
+    return ids.empty() ? 0 : ids.front();
+}
+
+// Deterministic walk over ids so repeated runs hit the same rows
+int pick(const std::vector<int>& ids, int iteration)
+{
+    return ids.empty() ? 0 : ids[size_t(qAbs(iteration * 7919 + 13)) % ids.size()];
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int students = BenchmarkReport::intOption(args, "--students", 2000);
+    const int iterations = BenchmarkReport::intOption(args, "--iterations", 10);
+    const quint32 seed = quint32(BenchmarkReport::intOption(args, "--seed", 2024));
+    // Account hashing cost only matters for the login cases; keep generation quick
+    PasswordHasher::setIterations(BenchmarkReport::intOption(args, "--cost", 10000));
+
+    QTemporaryDir tempDir;
+    const QString dbPath = BenchmarkReport::option(args, "--db", tempDir.filePath("bench_campus.db"));
+    DatabaseManager::instance().setSqlitePath(dbPath);
+    QueryProfiler::instance().setEnabled(false);  // Measure the repositories, not the profiler
+    if (!DatabaseManager::instance().connect()) {
+        QTextStream(stderr) << "Cannot open " << dbPath << "\n";
+        return 1;
+    }
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+
+    BenchmarkReport report("repositories");
+    const CampusGenerator::Scale scale = CampusGenerator::Scale::forStudents(students);
+    report.setParameter("scale", scale.toJson());
+    report.setParameter("seed", qint64(seed));
+    report.setParameter("pbkdf2_iterations", PasswordHasher::iterations());
+
+    CampusGenerator generator(scale, seed);
+    bool generated = false;
+    auto& gen = report.run("generate_campus", 1, [&](int iteration) {
+        if (iteration >= 0) { // One shot: the warm-up would generate a second campus
+            generated = generator.generate(db);
+        }
+    });
+    gen.counters = generator.counts().toJson();
+    if (!generated) {
+        QTextStream(stderr) << "Campus generation failed\n";
+        report.finish(args);
+        return 1;
+    }
+
+    const std::vector<int> studentIds = columnValues("SELECT student_id FROM students");
+    const std::vector<int> facultyIds = columnValues("SELECT faculty_id FROM faculty");
+    const std::vector<int> courseIds = columnValues("SELECT course_id FROM courses");
+    const std::vector<int> sectionIds = columnValues("SELECT section_id FROM sections");
+    const std::vector<int> paymentIds = columnValues("SELECT payment_id FROM payments");
+    const std::vector<int> buildingIds = columnValues("SELECT building_id FROM buildings");
+    const std::vector<int> bookIds = columnValues("SELECT book_id FROM books");
+    const QDate termStart = scale.termStart;
+    const QDate termEnd = termStart.addDays(120);
+
+    // Read case whose row count is recorded as a counter
+    auto countRows = [&](const QString& name, int count, const std::function<int()>& fn) {
+        int rows = 0;
+        auto& result = report.run(name, count, [&](int) { rows = fn(); });
+        result.counters["rows"] = rows;
+    };
+
+    // Students
+    StudentRepository studentRepo;
+    countRows("StudentRepository::getAllStudents", iterations, [&] { return int(studentRepo.getAllStudents().size()); });
+    countRows("StudentRepository::getAllStudentsCompact", iterations, [&] { return int(studentRepo.getAllStudentsCompact().size()); });
+    report.run("StudentRepository::getStudentById", iterations * 10, [&](int i) {
+        studentRepo.getStudentById(pick(studentIds, i));
+    });
+    report.run("StudentRepository::emailExists", iterations * 10, [&](int i) {
+        studentRepo.emailExists(QString("nobody%1@nctu.eg.edu").arg(i));
+    });
+    int serial = 0;
+    report.run("StudentRepository::add+update+delete", iterations, [&](int) {
+        Student s;
+        s.name = QString::fromUtf8("طالب اختبار");
+        s.department = QString::fromUtf8("علوم الحاسب");
+        s.username = QString("bench.student.%1").arg(++serial);
+        s.password = CampusGenerator::samplePassword();
+        studentRepo.addStudent(s);
+        s.id = lastId("students", "student_id");
+        s.year = 2;
+        s.password.clear();
+        studentRepo.updateStudent(s);
+        studentRepo.deleteStudent(s.id);
+    });
+
+    // Faculty
+    FacultyRepository facultyRepo;
+    countRows("FacultyRepository::getAllFaculty", iterations, [&] { return int(facultyRepo.getAllFaculty().size()); });
+    countRows("FacultyRepository::getAllFacultyCompact", iterations, [&] { return int(facultyRepo.getAllFacultyCompact().size()); });
+    report.run("FacultyRepository::getFacultyById", iterations * 10, [&](int i) {
+        facultyRepo.getFacultyById(pick(facultyIds, i));
+    });
+    report.run("FacultyRepository::add+update+delete", iterations, [&](int) {
+        Faculty f;
+        f.name = QString::fromUtf8("د. عضو اختبار");
+        f.email = QString("bench.faculty.%1@nctu.eg.edu").arg(++serial);
+        f.department = QString::fromUtf8("الرياضيات");
+        f.username = QString("bench.faculty.%1").arg(serial);
+        f.password = CampusGenerator::samplePassword();
+        facultyRepo.addFaculty(f);
+        f.id = lastId("faculty", "faculty_id");
+        f.password.clear();
+        facultyRepo.updateFaculty(f);
+        facultyRepo.deleteFaculty(f.id);
+    });
+
+    // Courses and sections (cached repositories)
+    CourseRepository courseRepo;
+    countRows("CourseRepository::getAllCourses (cold)", iterations, [&] {
+        CourseRepository::invalidateCache();
+        return int(courseRepo.getAllCourses().size());
+    });
+    report.run("CourseRepository::getAllCourses (cached)", iterations * 10, [&](int) {
+        courseRepo.getAllCourses();
+    });
+    report.run("CourseRepository::getCourseById (cold)", iterations * 10, [&](int i) {
+        CourseRepository::invalidateCache();
+        courseRepo.getCourseById(pick(courseIds, i));
+    });
+    report.run("CourseRepository::add+update+delete", iterations, [&](int) {
+        Course c;
+        c.name = QString("Bench Course %1").arg(++serial);
+        courseRepo.addCourse(c);
+        c.id = lastId("courses", "course_id");
+        c.hours = 4;
+        courseRepo.updateCourse(c);
+        courseRepo.deleteCourse(c.id);
+    });
+    SectionRepository sectionRepo;
+    countRows("SectionRepository::getAllSections (cold)", iterations, [&] {
+        SectionRepository::invalidateCache();
+        return int(sectionRepo.getAllSections().size());
+    });
+    report.run("SectionRepository::getAllSections (cached)", iterations * 10, [&](int) {
+        sectionRepo.getAllSections();
+    });
+    report.run("SectionRepository::add+delete", iterations, [&](int i) {
+        Section s;
+        s.courseId = pick(courseIds, i);
+        sectionRepo.addSection(s);
+        sectionRepo.deleteSection(lastId("sections", "section_id"));
+    });
+
+    // Enrollment
+    EnrollmentRepository enrollmentRepo;
+    countRows("EnrollmentRepository::getAllEnrollments", iterations, [&] { return int(enrollmentRepo.getAllEnrollments().size()); });
+    countRows("EnrollmentRepository::getAllEnrollmentsWithNames", iterations, [&] { return int(enrollmentRepo.getAllEnrollmentsWithNames().size()); });
+    report.run("EnrollmentRepository::getStudentIdsBySection", iterations * 10, [&](int i) {
+        enrollmentRepo.getStudentIdsBySection(pick(sectionIds, i));
+    });
+    EnrollmentValidator& validator = EnrollmentValidator::instance();
+    report.run("EnrollmentValidator::load", iterations, [&](int) {
+        validator.load(db);
+    });
+    report.run("EnrollmentValidator::check", iterations * 100, [&](int i) {
+        validator.check(pick(studentIds, i), pick(sectionIds, i + 1));
+    });
+    int enrolled = 0;
+    auto& enrollCase = report.run("EnrollmentRepository::enroll+unenroll", iterations, [&](int i) {
+        Enrollment e;
+        e.studentId = pick(studentIds, i);
+        e.sectionId = pick(sectionIds, i + 3);
+        if (enrollmentRepo.enroll(e).ok()) {
+            ++enrolled;
+            enrollmentRepo.unenrollStudent(e.studentId, e.sectionId);
+        }
+    });
+    enrollCase.counters["enrolled"] = enrolled;
+    WaitlistManager& waitlist = WaitlistManager::instance();
+    report.run("WaitlistManager::join+position+leave", iterations, [&](int i) {
+        const int studentId = pick(studentIds, i);
+        const int sectionId = pick(sectionIds, i + 5);
+        waitlist.join(studentId, sectionId);
+        waitlist.position(studentId, sectionId);
+        waitlist.head(sectionId);
+        waitlist.length(sectionId);
+        waitlist.leave(studentId, sectionId);
+    });
+    report.run("WaitlistManager::getEntriesWithNames", iterations, [&](int) {
+        waitlist.getEntriesWithNames();
+    });
+
+    // Attendance
+    AttendanceRepository attendanceRepo;
+    countRows("AttendanceRepository::getAllAttendance", iterations, [&] { return int(attendanceRepo.getAllAttendance().size()); });
+    countRows("AttendanceRepository::getAttendanceWithNames", iterations, [&] { return int(attendanceRepo.getAttendanceWithNames().size()); });
+    report.run("AttendanceRepository::getAttendanceAggregates", iterations, [&](int) {
+        attendanceRepo.getAttendanceAggregates(termStart, termEnd);
+    });
+    report.run("AttendanceRepository::add+delete", iterations, [&](int i) {
+        Attendance a;
+        a.studentId = pick(studentIds, i);
+        a.sectionId = pick(sectionIds, i);
+        a.date = termEnd;
+        attendanceRepo.addAttendance(a);
+        attendanceRepo.deleteAttendance(lastId("attendance", "attendance_id"));
+    });
+    report.run("AttendanceRepository::addMultipleAttendance", iterations, [&](int i) {
+        // Re-marks one section meeting; the repository replaces existing rows
+        const int sectionId = pick(sectionIds, i);
+        std::vector<Attendance> sheet;
+        for (int studentId : enrollmentRepo.getStudentIdsBySection(sectionId)) {
+            Attendance a;
+            a.studentId = studentId;
+            a.sectionId = sectionId;
+            a.date = termStart;
+            sheet.push_back(a);
+        }
+        attendanceRepo.addMultipleAttendance(sheet);
+    });
+    AttendanceAnalytics::RunSummary analytics;
+    auto& analyticsCase = report.run("AttendanceAnalytics::run (replaceAlerts)", iterations, [&](int) {
+        analytics = AttendanceAnalytics().run(termEnd);
+    });
+    analyticsCase.counters["alerts"] = analytics.alertsRaised;
+    countRows("AttendanceRepository::getAlerts", iterations, [&] { return int(attendanceRepo.getAlerts(termEnd).size()); });
+
+    // Finance
+    PaymentRepository paymentRepo;
+    countRows("PaymentRepository::getAllPayments", iterations, [&] { return int(paymentRepo.getAllPayments().size()); });
+    countRows("PaymentRepository::getAllPaymentsWithNames", iterations, [&] { return int(paymentRepo.getAllPaymentsWithNames().size()); });
+    report.run("PaymentRepository::getPaymentById", iterations * 10, [&](int i) {
+        paymentRepo.getPaymentById(pick(paymentIds, i));
+    });
+    report.run("PaymentRepository::add+update+delete", iterations, [&](int i) {
+        Payment p;
+        p.studentId = pick(studentIds, i);
+        p.amount = 250.0;
+        p.description = "Bench";
+        paymentRepo.addPayment(p);
+        p.id = lastId("payments", "payment_id");
+        p.status = PaymentStatus::Paid;
+        paymentRepo.updatePayment(p);
+        paymentRepo.deletePayment(p.id);
+    });
+
+    // Facilities
+    FacilityRepository facilityRepo;
+    countRows("FacilityRepository::getAllBuildings (cold)", iterations, [&] {
+        FacilityRepository::invalidateCache();
+        return int(facilityRepo.getAllBuildings().size());
+    });
+    report.run("FacilityRepository::getBuildingById (cold)", iterations * 10, [&](int i) {
+        FacilityRepository::invalidateCache();
+        facilityRepo.getBuildingById(pick(buildingIds, i));
+    });
+    countRows("FacilityRepository::getAllRooms (cold)", iterations, [&] {
+        FacilityRepository::invalidateCache();
+        return int(facilityRepo.getAllRooms().size());
+    });
+    report.run("FacilityRepository::getAllRoomsCompact", iterations, [&](int) {
+        facilityRepo.getAllRoomsCompact();
+    });
+    report.run("FacilityRepository::getRoomsByBuildingId", iterations * 10, [&](int i) {
+        facilityRepo.getRoomsByBuildingId(pick(buildingIds, i));
+    });
+    report.run("FacilityRepository::getRoomsWithBuildings", iterations, [&](int) {
+        RoomFilter filter;
+        filter.minCapacity = 30;
+        facilityRepo.getRoomsWithBuildings(filter);
+    });
+    report.run("FacilityRepository::building+room add/update/delete", iterations, [&](int) {
+        Building b;
+        b.name = "Bench Hall";
+        b.code = QString("BENCH%1").arg(++serial);
+        facilityRepo.addBuilding(b);
+        b.id = lastId("buildings", "building_id");
+        facilityRepo.updateBuilding(b);
+        Room r;
+        r.buildingId = b.id;
+        r.roomNumber = "001";
+        r.capacity = 40;
+        facilityRepo.addRoom(r);
+        r.id = lastId("rooms", "room_id");
+        facilityRepo.updateRoom(r);
+        facilityRepo.deleteRoom(r.id);
+        facilityRepo.deleteBuilding(b.id);
+    });
+
+    // Calendar
+    CalendarRepository calendarRepo;
+    countRows("CalendarRepository::getEventsInRange", iterations, [&] { return int(calendarRepo.getEventsInRange(termStart, termEnd).size()); });
+    countRows("CalendarRepository::getSeriesInRange", iterations, [&] { return int(calendarRepo.getSeriesInRange(termStart, termEnd).size()); });
+    report.run("CalendarRepository::event add+delete", iterations, [&](int) {
+        CalendarEvent e;
+        e.date = termStart;
+        e.title = "Bench";
+        e.type = "Other";
+        calendarRepo.deleteEvent(calendarRepo.addEvent(e));
+    });
+    report.run("CalendarRepository::series add+exception+delete", iterations, [&](int) {
+        RecurringEvent s;
+        s.startDate = termStart;
+        s.title = "Bench";
+        s.type = "Class";
+        s.rule = *RecurrenceRule::fromRRule("FREQ=WEEKLY;BYDAY=MO,WE;UNTIL=20241220");
+        const int id = calendarRepo.addSeries(s);
+        calendarRepo.addSeriesException(id, termStart.addDays(7));
+        calendarRepo.deleteSeries(id);
+    });
+
+    // Timetable: solve once outside the timed region, then time the repository calls
+    TimetableRepository timetableRepo;
+    TimetableProblem problem;
+    auto& loadCase = report.run("TimetableRepository::loadProblem", iterations, [&](int) {
+        problem = timetableRepo.loadProblem();
+    });
+    loadCase.counters["sections"] = qint64(problem.sections.size());
+    TimetableSolver::Config solverConfig;
+    solverConfig.timeBudgetMs = 2000;
+    const TimetableResult solved = TimetableSolver(solverConfig).solve(problem);
+    report.run("TimetableRepository::saveSchedule", iterations, [&](int) {
+        timetableRepo.saveSchedule(problem, solved);
+    });
+    countRows("TimetableRepository::getScheduleLabels", iterations, [&] { return int(timetableRepo.getScheduleLabels().size()); });
+
+    // Grades
+    GradeRepository gradeRepo;
+    countRows("GradeRepository::getGrades", iterations, [&] { return int(gradeRepo.getGrades().size()); });
+    report.run("GradeRepository::getGrades (course)", iterations * 10, [&](int i) {
+        gradeRepo.getGrades(pick(courseIds, i));
+    });
+    report.run("GradeRepository::saveComponent", iterations * 10, [&](int i) {
+        const std::vector<GradeRecord> existing = gradeRepo.getGrades(-1, pick(studentIds, i));
+        if (!existing.empty()) {
+            gradeRepo.saveComponent(existing.front().studentId, existing.front().courseId,
+                                    GradeComponent::Assignment2, "B+");
+        }
+    });
+    report.run("GradeRepository::computeGpa", iterations * 10, [&](int i) {
+        gradeRepo.computeGpa(pick(studentIds, i));
+    });
+
+    // Library
+    LibraryRepository libraryRepo;
+    countRows("LibraryRepository::getBooks", iterations, [&] { return int(libraryRepo.getBooks().size()); });
+    countRows("LibraryRepository::getBooks (search)", iterations, [&] { return int(libraryRepo.getBooks(QString::fromUtf8("البيانات")).size()); });
+    countRows("LibraryRepository::getBooks (overdue)", iterations, [&] {
+        return int(libraryRepo.getBooks(QString(), BookFilter::Overdue).size());
+    });
+    report.run("LibraryRepository::checkOut+return", iterations, [&](int i) {
+        BookLoan loan;
+        loan.bookId = pick(bookIds, i);
+        loan.studentId = pick(studentIds, i);
+        if (libraryRepo.checkOut(loan)) {
+            libraryRepo.returnLoan(loan, loan.checkoutDate);
+        }
+    });
+
+    // Reports
+    ReportEngine reportEngine;
+    for (ReportType type : {ReportType::StudentEnrollment, ReportType::CourseStatistics,
+                            ReportType::AttendanceSummary, ReportType::FinancialSummary}) {
+        countRows("ReportEngine::generate (" + ReportEngine::typeName(type) + ")", iterations, [&] {
+            return int(reportEngine.generate(type, termStart, termEnd).rows.size());
+        });
+    }
+    QTemporaryDir exportDir;
+    report.run("ReportEngine::exportCsv (Attendance Summary)", iterations, [&](int) {
+        const Report attendance = reportEngine.generate(ReportType::AttendanceSummary, termStart, termEnd);
+        ReportEngine::exportCsv(attendance, exportDir.filePath("attendance.csv"));
+    });
+
+    // Accounts and per-session loading
+    UserRepository userRepo;
+    QSqlQuery sample(db);
+    sample.exec("SELECT u.user_id, u.username FROM users u WHERE u.student_id IS NOT NULL ORDER BY u.user_id DESC LIMIT 1");
+    const bool haveAccount = sample.next();
+    const int accountId = haveAccount ? sample.value(0).toInt() : 0;
+    const QString accountName = haveAccount ? sample.value(1).toString() : QString();
+    sample.finish();
+    report.run("UserRepository::findForLogin", iterations * 10, [&](int) {
+        userRepo.findForLogin(accountName);
+    });
+    const QString storedHash = PasswordHasher::hash(CampusGenerator::samplePassword());
+    report.run("UserRepository::updatePasswordHash", iterations, [&](int) {
+        userRepo.updatePasswordHash(accountId, storedHash);
+    });
+    report.run("UserRepository::setStudentPassword", iterations, [&](int i) {
+        userRepo.setStudentPassword(pick(studentIds, i), CampusGenerator::samplePassword());
+    });
+    int loggedIn = 0;
+    auto& loginCase = report.run("AuthService::login", iterations, [&](int) {
+        loggedIn += AuthService().login(accountName, CampusGenerator::samplePassword()) ? 1 : 0;
+    });
+    loginCase.counters["accepted"] = loggedIn;
+    report.run("SessionDataService::load", iterations * 10, [&](int i) {
+        SessionDataService::load(pick(studentIds, i), db);
+    });
+
+    return report.finish(args);
+}
@@ -0,0 +1,182 @@
+// SQLite connection profile: the tuned pragmas against SQLite's own defaults.
+// Usage: sis-bench-sqlite [--rows N] [--autocommit-rows N] [--readers N]
+//                         [--reads N] [--iterations N] [--json path]
+//
+// Each profile gets a fresh database file with an attendance-shaped table,
+// so the pragmas are the only difference between the two sets of cases.
+// concurrent_reads runs --readers threads, each on its own connection,
+// while one more connection keeps committing single-row inserts.
+
+#include "benchmarkharness.h"
+#include "../database/sqliteprofile.h"
+#include <QCoreApplication>
+#include <QDate>
+#include <QRandomGenerator>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+
+namespace {
+constexpr int Students = 5000;
+constexpr int Sections = 400;
+
+// Opens a named connection, runs fn, then closes and removes it again
+void withConnection(const QString& path, const QString& name, const SqliteProfile& profile,
+                    const std::function<void(QSqlDatabase&)>& fn)
+{
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+        db.setDatabaseName(path);
+        if (db.open() && profile.apply(db)) {
+            fn(db);
+        } else {
+            QTextStream(stderr) << "Cannot open " << path << ": " << db.lastError().text() << "\n";
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(name);
+}
+
+bool createSchema(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+    return query.exec("CREATE TABLE IF NOT EXISTS marks ("
+                      "mark_id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                      "student_id INT, section_id INT, date DATE, status_id INT)")
+        && query.exec("CREATE INDEX IF NOT EXISTS idx_marks_student ON marks(student_id)");
+}
+
+// Each statement commits on its own unless the caller opened a transaction
+int insertRows(QSqlDatabase& db, int count, QRandomGenerator& rng)
+{
+    QSqlQuery query(db);
+    query.prepare("INSERT INTO marks (student_id, section_id, date, status_id) VALUES (?, ?, ?, ?)");
+    const QDate termStart(2024, 9, 1);
+    int inserted = 0;
+    for (int i = 0; i < count; ++i) {
+        query.bindValue(0, int(rng.bounded(Students)) + 1);
+        query.bindValue(1, int(rng.bounded(Sections)) + 1);
+        query.bindValue(2, termStart.addDays(rng.bounded(120)).toString("yyyy-MM-dd"));
+        query.bindValue(3, int(rng.bounded(3)) + 1);
+        if (!query.exec()) {
+            return inserted;
+        }
+        ++inserted;
+    }
+    return inserted;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int rows = BenchmarkReport::intOption(args, "--rows", 200000);
+    const int autocommitRows = BenchmarkReport::intOption(args, "--autocommit-rows", 500);
+    const int readers = BenchmarkReport::intOption(args, "--readers", 4);
+    const int readsPerReader = BenchmarkReport::intOption(args, "--reads", 500);
+    const int iterations = BenchmarkReport::intOption(args, "--iterations", 5);
+
+    BenchmarkReport report("sqlite");
+    report.setParameter("rows", rows);
+    report.setParameter("autocommit_rows", autocommitRows);
+    report.setParameter("readers", readers);
+    report.setParameter("reads_per_reader", readsPerReader);
+
+    QTemporaryDir tempDir;
+    for (const SqliteProfile& profile : {SqliteProfile::sqliteDefaults(), SqliteProfile::tuned()}) {
+        const QString path = tempDir.filePath(QString("bench_%1.db").arg(profile.name));
+        const QString prefix = profile.name + "/";
+        QRandomGenerator rng(2024);
+
+        withConnection(path, "bench_main", profile, [&](QSqlDatabase& db) {
+            if (!createSchema(db)) {
+                QTextStream(stderr) << "Schema Error: " << db.lastError().text() << "\n";
+                return;
+            }
+
+            // Bulk load: one transaction for the whole batch
+            int loaded = 0;
+            auto& bulk = report.run(prefix + "insert_batched", 1, [&](int iteration) {
+                if (iteration >= 0) { // One shot: the table is the dataset for the read cases
+                    db.transaction();
+                    loaded = insertRows(db, rows, rng);
+                    db.commit();
+                }
+            });
+            bulk.counters["rows"] = loaded;
+
+            // Single-row commits, the pattern of the GUI dialogs
+            auto& autocommit = report.run(prefix + "insert_autocommit", iterations, [&](int) {
+                insertRows(db, autocommitRows, rng);
+            });
+            autocommit.counters["rows_per_iteration"] = autocommitRows;
+
+            std::atomic<qint64> reads(0);
+            std::atomic<qint64> writes(0);
+            std::atomic<qint64> errors(0);
+            auto& concurrent = report.run(prefix + "concurrent_reads", iterations, [&](int iteration) {
+                if (iteration == 0) { // Counters cover the timed iterations only
+                    reads = 0;
+                    writes = 0;
+                    errors = 0;
+                }
+                std::atomic<int> readersLeft(readers);
+                QThreadPool pool;
+                pool.setMaxThreadCount(readers + 1);
+                pool.start([&, iteration]() {
+                    withConnection(path, QString("bench_writer_%1").arg(iteration), profile, [&](QSqlDatabase& writer) {
+                        QRandomGenerator writerRng(quint32(iteration) + 7u);
+                        while (readersLeft.load() > 0) {
+                            if (insertRows(writer, 1, writerRng) == 1) {
+                                ++writes;
+                            } else {
+                                ++errors;
+                            }
+                        }
+                    });
+                });
+                for (int r = 0; r < readers; ++r) {
+                    pool.start([&, r, iteration]() {
+                        withConnection(path, QString("bench_reader_%1_%2").arg(iteration).arg(r), profile, [&](QSqlDatabase& reader) {
+                            QRandomGenerator readerRng(quint32(r * 31 + iteration));
+                            QSqlQuery query(reader);
+                            query.setForwardOnly(true);
+                            query.prepare("SELECT status_id, COUNT(*) FROM marks "
+                                          "WHERE student_id BETWEEN ? AND ? GROUP BY status_id");
+                            for (int i = 0; i < readsPerReader; ++i) {
+                                const int from = int(readerRng.bounded(Students - 50)) + 1;
+                                query.bindValue(0, from);
+                                query.bindValue(1, from + 50);
+                                if (query.exec()) {
+                                    while (query.next()) {
+                                    }
+                                    ++reads;
+                                } else {
+                                    ++errors;
+                                }
+                            }
+                        });
+                        --readersLeft;
+                    });
+                }
+                pool.waitForDone();
+            });
+            concurrent.counters["reads"] = reads.load();
+            concurrent.counters["writes"] = writes.load();
+            concurrent.counters["errors"] = errors.load();
+            concurrent.counters["reads_per_s"] = concurrent.totalMs > 0 ? reads.load() * 1000.0 / concurrent.totalMs : 0.0;
+
+            report.run(prefix + "optimize_checkpoint", 1, [&](int iteration) {
+                if (iteration >= 0) {
+                    SqliteProfile::runMaintenance(db);
+                }
+            });
+        });
+    }
+    return report.finish(args);
+}
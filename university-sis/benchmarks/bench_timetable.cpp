@@ -0,0 +1,57 @@
+// Solves generated timetable problems of increasing size.
+// Usage: sis-bench-timetable [--sections N] [--budget-ms N] [--threads N] [--seed N] [--json path]
+
+#include "benchmarkharness.h"
+#include "../modules/scheduling/timetablegenerator.h"
+#include "../modules/scheduling/timetablesolver.h"
+#include <QCoreApplication>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int maxSections = BenchmarkReport::intOption(args, "--sections", 2000);
+
+    TimetableSolver::Config config;
+    config.timeBudgetMs = BenchmarkReport::intOption(args, "--budget-ms", 30000);
+    config.threadCount = BenchmarkReport::intOption(args, "--threads", 0);
+    config.seed = quint32(BenchmarkReport::intOption(args, "--seed", 1));
+
+    BenchmarkReport report("timetable");
+    report.setParameter("budget_ms", config.timeBudgetMs);
+    report.setParameter("threads", config.threadCount);
+
+    for (int sections : {maxSections / 8, maxSections / 2, maxSections}) {
+        if (sections <= 0) {
+            continue;
+        }
+        TimetableGenerator::Params params;
+        params.sections = sections;
+        const TimetableProblem problem = TimetableGenerator::generate(params);
+
+        qint64 edges = 0;
+        for (const auto& list : problem.conflicts) {
+            edges += qint64(list.size());
+        }
+
+        TimetableResult result;
+        auto& r = report.run(QString("solve_%1_sections").arg(sections), 1, [&](int iteration) {
+            if (iteration >= 0) { // Skip the harness warm-up run; every solve uses the full budget
+                result = TimetableSolver(config).solve(problem);
+            }
+        });
+        r.counters["sections"] = sections;
+        r.counters["rooms"] = qint64(problem.rooms.size());
+        r.counters["slots"] = qint64(problem.slots.size());
+        r.counters["conflict_edges"] = edges / 2;
+        r.counters["greedy_ms"] = result.greedyMs;
+        r.counters["unassigned"] = result.unassigned;
+        r.counters["student_conflicts"] = result.studentConflicts;
+        r.counters["room_conflicts"] = result.roomConflicts;
+        r.counters["capacity_violations"] = result.capacityViolations;
+        r.counters["moves"] = qint64(result.moves);
+        r.counters["solver_threads"] = result.threads;
+    }
+
+    return report.finish(args);
+}
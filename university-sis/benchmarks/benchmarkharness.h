@@ -0,0 +1,130 @@
+#ifndef BENCHMARKHARNESS_H
+#define BENCHMARKHARNESS_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QThread>
+#include <algorithm>
+#include <limits>
+#include <deque>
+
+struct BenchmarkResult {
+    QString name;
+    int iterations = 0;
+    double totalMs = 0.0;
+    double minMs = std::numeric_limits<double>::max();
+    double maxMs = 0.0;
+    QJsonObject counters; // Benchmark specific numbers (rows, occurrences, ...)
+
+    double meanMs() const { return iterations > 0 ? totalMs / iterations : 0.0; }
+};
+
+/**
+ * @brief Minimal harness shared by the benchmark executables.
+ *
+ * Each case is timed per iteration; the report is printed as a table on
+ * stderr and as JSON on stdout, or to the file given with --json <path>.
+ */
+class BenchmarkReport {
+public:
+    explicit BenchmarkReport(const QString& suite) : m_suite(suite) {}
+
+    void setParameter(const QString& key, const QJsonValue& value) { m_parameters.insert(key, value); }
+
+    // fn(iteration) runs once as warm-up, then `iterations` timed times
+    template <typename Fn>
+    BenchmarkResult& run(const QString& name, int iterations, Fn fn) {
+        fn(-1);
+        BenchmarkResult result;
+        result.name = name;
+        QElapsedTimer timer;
+        for (int i = 0; i < iterations; ++i) {
+            timer.start();
+            fn(i);
+            const double ms = timer.nsecsElapsed() / 1e6;
+            result.totalMs += ms;
+            result.minMs = std::min(result.minMs, ms);
+            result.maxMs = std::max(result.maxMs, ms);
+            ++result.iterations;
+        }
+        m_results.push_back(result);
+        return m_results.back();
+    }
+
+    QJsonObject toJson() const {
+        QJsonArray cases;
+        for (const auto& r : m_results) {
+            QJsonObject o;
+            o["name"] = r.name;
+            o["iterations"] = r.iterations;
+            o["total_ms"] = r.totalMs;
+            o["mean_ms"] = r.meanMs();
+            o["min_ms"] = r.iterations > 0 ? r.minMs : 0.0;
+            o["max_ms"] = r.maxMs;
+            o["counters"] = r.counters;
+            cases.append(o);
+        }
+        QJsonObject root;
+        root["suite"] = m_suite;
+        root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        root["cpu"] = QSysInfo::currentCpuArchitecture();
+        root["threads"] = QThread::idealThreadCount();
+        root["parameters"] = m_parameters;
+        root["results"] = cases;
+        return root;
+    }
+
+    // Writes the report; returns the process exit code
+    int finish(const QStringList& args) const {
+        QTextStream err(stderr);
+        for (const auto& r : m_results) {
+            err << QString("%1  %2 iters  mean %3 ms  min %4 ms  max %5 ms\n")
+                       .arg(r.name, -32)
+                       .arg(r.iterations)
+                       .arg(r.meanMs(), 0, 'f', 3)
+                       .arg(r.iterations > 0 ? r.minMs : 0.0, 0, 'f', 3)
+                       .arg(r.maxMs, 0, 'f', 3);
+        }
+        err.flush();
+
+        const QByteArray json = QJsonDocument(toJson()).toJson(QJsonDocument::Indented);
+        const QString path = option(args, "--json");
+        if (path.isEmpty()) {
+            QTextStream(stdout) << json;
+            return 0;
+        }
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "Cannot write " << path << "\n";
+            return 1;
+        }
+        file.write(json);
+        return 0;
+    }
+
+    static QString option(const QStringList& args, const QString& name, const QString& fallback = QString()) {
+        const int i = args.indexOf(name);
+        return (i >= 0 && i + 1 < args.size()) ? args.at(i + 1) : fallback;
+    }
+
+    static int intOption(const QStringList& args, const QString& name, int fallback) {
+        bool ok = false;
+        const int value = option(args, name).toInt(&ok);
+        return ok ? value : fallback;
+    }
+
+private:
+    QString m_suite;
+    QJsonObject m_parameters;
+    std::deque<BenchmarkResult> m_results; // deque keeps returned references valid
+};
+
+#endif // BENCHMARKHARNESS_H
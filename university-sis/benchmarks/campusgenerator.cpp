@@ -0,0 +1,580 @@
+#include "campusgenerator.h"
+#include "../modules/auth/passwordhasher.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+struct NamePart {
+    const char* arabic;
+    const char* latin;
+};
+
+const NamePart kMaleNames[] = {
+    {"أحمد", "ahmed"}, {"محمد", "mohamed"}, {"محمود", "mahmoud"}, {"مصطفى", "mostafa"},
+    {"عمر", "omar"}, {"علي", "ali"}, {"يوسف", "youssef"}, {"خالد", "khaled"},
+    {"حسن", "hassan"}, {"حسين", "hussein"}, {"إبراهيم", "ibrahim"}, {"عبدالله", "abdullah"},
+    {"عبدالرحمن", "abdelrahman"}, {"كريم", "karim"}, {"طارق", "tarek"}, {"هشام", "hesham"},
+    {"أمير", "amir"}, {"مازن", "mazen"}, {"سيف", "seif"}, {"زياد", "ziad"},
+    {"ياسين", "yassin"}, {"إسلام", "islam"}, {"عمرو", "amr"}, {"شريف", "sherif"}, {"وليد", "walid"}
+};
+
+const NamePart kFemaleNames[] = {
+    {"فاطمة", "fatma"}, {"مريم", "mariam"}, {"سارة", "sara"}, {"نور", "nour"},
+    {"ليلى", "layla"}, {"هدى", "huda"}, {"منى", "mona"}, {"آية", "aya"},
+    {"ياسمين", "yasmin"}, {"رنا", "rana"}, {"سلمى", "salma"}, {"هبة", "heba"},
+    {"دينا", "dina"}, {"نادية", "nadia"}, {"إيمان", "eman"}, {"شيماء", "shaimaa"},
+    {"ريم", "reem"}, {"جنى", "jana"}, {"ملك", "malak"}, {"حبيبة", "habiba"}
+};
+
+const NamePart kFamilyNames[] = {
+    {"المصري", "elmasry"}, {"الشريف", "elsherif"}, {"السيد", "elsayed"}, {"عبدالعزيز", "abdelaziz"},
+    {"النجار", "elnaggar"}, {"الخطيب", "elkhatib"}, {"سليمان", "soliman"}, {"منصور", "mansour"},
+    {"فؤاد", "fouad"}, {"رمضان", "ramadan"}, {"عثمان", "osman"}, {"الجمال", "elgammal"},
+    {"زكي", "zaki"}, {"صبري", "sabry"}, {"حجازي", "hegazy"}, {"البنا", "elbanna"},
+    {"شاهين", "shahin"}, {"سالم", "salem"}, {"فهمي", "fahmy"}, {"نصار", "nassar"}
+};
+
+// Same departments as the sample data; weights are the share of students
+const char* const kDepartments[] = {"علوم الحاسب", "الهندسة", "الرياضيات", "الفيزياء", "الكيمياء", "الأحياء"};
+const std::vector<int> kDepartmentWeights = {30, 25, 12, 10, 10, 13};
+
+const char* const kPositions[] = {"أستاذ", "أستاذ مساعد", "مدرس", "مدرس مساعد"};
+const std::vector<int> kPositionWeights = {25, 35, 25, 15};
+
+// Level 1 students outnumber level 4 (dropouts, transfers)
+const std::vector<int> kYearWeights = {30, 27, 23, 20};
+
+const char* const kSubjects[] = {
+    "مقدمة في البرمجة", "هياكل البيانات", "أنظمة قواعد البيانات", "هندسة البرمجيات",
+    "حساب التفاضل والتكامل", "الجبر الخطي", "الفيزياء العامة", "أساسيات الكيمياء",
+    "الأحياء العامة", "الخوارزميات", "تعلم الآلة", "شبكات الحاسب", "نظم التشغيل",
+    "تطوير الويب", "الأمن السيبراني", "الذكاء الاصطناعي", "النظم الموزعة",
+    "رسوميات الحاسب", "معالجة الإشارات", "النظم المدمجة", "الإحصاء والاحتمالات",
+    "المعادلات التفاضلية", "الكيمياء العضوية", "الميكانيكا", "الكهرومغناطيسية",
+    "علم الوراثة", "الأحياء الدقيقة", "الدوائر الكهربية", "التحليل العددي", "الرياضيات المتقطعة"
+};
+
+const char* const kLetterGrades[] = {"A", "A-", "B+", "B", "B-", "C+", "C", "D", "F"};
+const std::vector<int> kLetterWeights = {15, 15, 20, 18, 10, 10, 7, 3, 2};
+
+const char* const kBookCategories[] = {"علوم الحاسب", "الرياضيات", "الفيزياء", "الكيمياء", "الأحياء", "الهندسة", "الأدب", "التاريخ"};
+const char* const kPublishers[] = {"دار الشروق", "دار المعارف", "مكتبة الأنجلو المصرية", "دار النهضة العربية", "الهيئة المصرية العامة للكتاب"};
+
+template <typename T, size_t N>
+constexpr int countOf(const T (&)[N]) { return int(N); }
+
+// Ids of the rows inserted after `before` (single writer, ascending AUTOINCREMENT)
+std::vector<int> idsAfter(QSqlDatabase& db, const QString& table, const QString& column, int before)
+{
+    std::vector<int> ids;
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare(QString("SELECT %1 FROM %2 WHERE %1 > :before ORDER BY %1").arg(column, table));
+    query.bindValue(":before", before);
+    if (!query.exec()) {
+        qDebug() << "Generator Error:" << query.lastError().text();
+        return ids;
+    }
+    while (query.next()) {
+        ids.push_back(query.value(0).toInt());
+    }
+    return ids;
+}
+
+int maxId(QSqlDatabase& db, const QString& table, const QString& column)
+{
+    QSqlQuery query(db);
+    if (query.exec(QString("SELECT COALESCE(MAX(%1), 0) FROM %2").arg(column, table)) && query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
+
+// Column-wise batch insert inside its own transaction
+bool insertBatch(QSqlDatabase& db, const QString& sql, const std::vector<QVariantList>& columns)
+{
+    if (columns.empty() || columns.front().isEmpty()) {
+        return true;
+    }
+    db.transaction();
+    QSqlQuery query(db);
+    query.prepare(sql);
+    for (const QVariantList& column : columns) {
+        query.addBindValue(column);
+    }
+    if (!query.execBatch()) {
+        qDebug() << "Generator Error:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+    return db.commit();
+}
+}
+
+CampusGenerator::Scale CampusGenerator::Scale::forStudents(int n)
+{
+    Scale scale;
+    scale.students = std::max(1, n);
+    scale.faculty = std::max(8, n / 25);
+    scale.courses = std::clamp(n / 25, 24, 400);
+    scale.enrollmentsPerStudent = 5;
+    // Enough 40-seat sections for every enrollment plus some slack
+    const int seatsNeeded = scale.students * scale.enrollmentsPerStudent;
+    scale.sectionsPerCourse = std::max(1, int(std::ceil(seatsNeeded * 1.25 / (40.0 * scale.courses))));
+    scale.attendanceDays = 24;
+    scale.paymentsPerStudent = 3;
+    scale.books = std::max(200, n / 2);
+    scale.loans = std::max(100, n / 3);
+    return scale;
+}
+
+QJsonObject CampusGenerator::Scale::toJson() const
+{
+    QJsonObject o;
+    o["students"] = students;
+    o["faculty"] = faculty;
+    o["courses"] = courses;
+    o["sections_per_course"] = sectionsPerCourse;
+    o["enrollments_per_student"] = enrollmentsPerStudent;
+    o["attendance_days"] = attendanceDays;
+    o["payments_per_student"] = paymentsPerStudent;
+    o["books"] = books;
+    o["loans"] = loans;
+    o["term_start"] = termStart.toString(Qt::ISODate);
+    return o;
+}
+
+QJsonObject CampusGenerator::Counts::toJson() const
+{
+    QJsonObject o;
+    o["students"] = students;
+    o["faculty"] = faculty;
+    o["courses"] = courses;
+    o["sections"] = sections;
+    o["enrollments"] = enrollments;
+    o["attendance"] = attendance;
+    o["grades"] = grades;
+    o["payments"] = payments;
+    o["books"] = books;
+    o["loans"] = loans;
+    return o;
+}
+
+const QString& CampusGenerator::samplePassword()
+{
+    static const QString password = "pass123";
+    return password;
+}
+
+CampusGenerator::CampusGenerator(const Scale& scale, quint32 seed)
+    : m_scale(scale), m_rng(seed)
+{
+}
+
+bool CampusGenerator::generate(const QSqlDatabase& database)
+{
+    QSqlDatabase db = database;
+    m_counts = Counts();
+    // One hash for every account: hashing each at full cost would dominate generation
+    m_passwordHash = PasswordHasher::hash(samplePassword());
+
+    return generateFaculty(db)
+        && generateCourses(db)
+        && generateStudents(db)
+        && generateEnrollments(db)
+        && generateAttendance(db)
+        && generateGrades(db)
+        && generatePayments(db)
+        && generateLibrary(db);
+}
+
+int CampusGenerator::weighted(const std::vector<int>& weights)
+{
+    std::discrete_distribution<int> dist(weights.begin(), weights.end());
+    return dist(m_rng);
+}
+
+CampusGenerator::PersonName CampusGenerator::randomName(bool female)
+{
+    std::uniform_int_distribution<int> male(0, countOf(kMaleNames) - 1);
+    std::uniform_int_distribution<int> fem(0, countOf(kFemaleNames) - 1);
+    std::uniform_int_distribution<int> family(0, countOf(kFamilyNames) - 1);
+
+    const NamePart& first = female ? kFemaleNames[fem(m_rng)] : kMaleNames[male(m_rng)];
+    const NamePart& father = kMaleNames[male(m_rng)];
+    const NamePart& last = kFamilyNames[family(m_rng)];
+
+    PersonName name;
+    name.arabic = QString("%1 %2 %3").arg(QString::fromUtf8(first.arabic),
+                                          QString::fromUtf8(father.arabic),
+                                          QString::fromUtf8(last.arabic));
+    name.latin = QString("%1.%2").arg(QLatin1String(first.latin), QLatin1String(last.latin));
+    return name;
+}
+
+QString CampusGenerator::uniqueUsername(const QString& base)
+{
+    // The "g" marker keeps generated names apart from the sample accounts
+    const int n = m_usernames.value(base, 0) + 1;
+    m_usernames.insert(base, n);
+    return QString("%1.g%2").arg(base).arg(n);
+}
+
+bool CampusGenerator::generateFaculty(QSqlDatabase& db)
+{
+    const int before = maxId(db, "faculty", "faculty_id");
+    QVariantList names, emails, departments, positions, usernames;
+    std::bernoulli_distribution female(0.4);
+    for (int i = 0; i < m_scale.faculty; ++i) {
+        const PersonName person = randomName(female(m_rng));
+        const QString username = uniqueUsername(person.latin);
+        names << QString::fromUtf8("د. ") + person.arabic;
+        emails << username + "@nctu.eg.edu";
+        departments << QString::fromUtf8(kDepartments[weighted(kDepartmentWeights)]);
+        positions << QString::fromUtf8(kPositions[weighted(kPositionWeights)]);
+        usernames << username;
+    }
+    if (!insertBatch(db, "INSERT INTO faculty (name, email, department, position, username) VALUES (?, ?, ?, ?, ?)",
+                     {names, emails, departments, positions, usernames})) {
+        return false;
+    }
+    m_facultyIds = idsAfter(db, "faculty", "faculty_id", before);
+    m_counts.faculty = int(m_facultyIds.size());
+
+    QVariantList hashes, roles, ids;
+    for (int id : m_facultyIds) {
+        hashes << m_passwordHash;
+        roles << "FACULTY";
+        ids << id;
+    }
+    if (ids.size() != usernames.size()) {
+        qDebug() << "Generator Error: expected" << usernames.size() << "faculty, found" << ids.size();
+        return false;
+    }
+    return insertBatch(db, "INSERT INTO users (username, password_hash, role, display_name, faculty_id) VALUES (?, ?, ?, ?, ?)",
+                       {usernames, hashes, roles, names, ids});
+}
+
+bool CampusGenerator::generateCourses(QSqlDatabase& db)
+{
+    const int before = maxId(db, "courses", "course_id");
+    QVariantList names, years, hours;
+    std::bernoulli_distribution fourHours(0.3);
+    for (int i = 0; i < m_scale.courses; ++i) {
+        const int subject = i % countOf(kSubjects);
+        const int level = i / countOf(kSubjects);
+        QString name = QString::fromUtf8(kSubjects[subject]);
+        if (level > 0) {
+            name += QString(" %1").arg(level + 1);
+        }
+        names << name;
+        years << 1 + (i + level) % 4;
+        hours << (fourHours(m_rng) ? 4 : 3);
+    }
+    if (!insertBatch(db, "INSERT INTO courses (name, year, hours) VALUES (?, ?, ?)", {names, years, hours})) {
+        return false;
+    }
+    m_courseIds = idsAfter(db, "courses", "course_id", before);
+    m_counts.courses = int(m_courseIds.size());
+
+    const int sectionsBefore = maxId(db, "sections", "section_id");
+    QVariantList courseIds, capacities;
+    std::uniform_int_distribution<int> capacity(35, 50);
+    for (int courseId : m_courseIds) {
+        for (int s = 0; s < m_scale.sectionsPerCourse; ++s) {
+            courseIds << courseId;
+            capacities << capacity(m_rng);
+        }
+    }
+    if (!insertBatch(db, "INSERT INTO sections (course_id, max_students) VALUES (?, ?)", {courseIds, capacities})) {
+        return false;
+    }
+    m_sectionIds = idsAfter(db, "sections", "section_id", sectionsBefore);
+    if (int(m_sectionIds.size()) != courseIds.size()) {
+        qDebug() << "Generator Error: expected" << courseIds.size() << "sections, found" << m_sectionIds.size();
+        return false;
+    }
+    m_sectionCourse.clear();
+    m_sectionCapacity.clear();
+    for (int i = 0; i < courseIds.size(); ++i) {
+        m_sectionCourse.push_back(courseIds.at(i).toInt());
+        m_sectionCapacity.push_back(capacities.at(i).toInt());
+    }
+    m_counts.sections = int(m_sectionIds.size());
+    return true;
+}
+
+bool CampusGenerator::generateStudents(QSqlDatabase& db)
+{
+    const int before = maxId(db, "students", "student_id");
+    QVariantList names, years, departments, usernames;
+    std::bernoulli_distribution female(0.5);
+    for (int i = 0; i < m_scale.students; ++i) {
+        const PersonName person = randomName(female(m_rng));
+        names << person.arabic;
+        years << 1 + weighted(kYearWeights);
+        departments << QString::fromUtf8(kDepartments[weighted(kDepartmentWeights)]);
+        usernames << uniqueUsername(person.latin);
+    }
+    if (!insertBatch(db, "INSERT INTO students (name, year, department, username) VALUES (?, ?, ?, ?)",
+                     {names, years, departments, usernames})) {
+        return false;
+    }
+    m_studentIds = idsAfter(db, "students", "student_id", before);
+    m_counts.students = int(m_studentIds.size());
+
+    // Roughly one student in ten misses classes often; the rest rarely do
+    std::bernoulli_distribution atRisk(0.1);
+    std::uniform_real_distribution<double> lowRate(0.0, 0.08);
+    std::uniform_real_distribution<double> highRate(0.2, 0.45);
+    m_absenceRate.clear();
+    QVariantList hashes, roles, ids;
+    for (int id : m_studentIds) {
+        m_absenceRate.push_back(atRisk(m_rng) ? highRate(m_rng) : lowRate(m_rng));
+        hashes << m_passwordHash;
+        roles << "STUDENT";
+        ids << id;
+    }
+    if (ids.size() != usernames.size()) {
+        qDebug() << "Generator Error: expected" << usernames.size() << "students, found" << ids.size();
+        return false;
+    }
+    return insertBatch(db, "INSERT INTO users (username, password_hash, role, display_name, student_id) VALUES (?, ?, ?, ?, ?)",
+                       {usernames, hashes, roles, names, ids});
+}
+
+bool CampusGenerator::generateEnrollments(QSqlDatabase& db)
+{
+    if (m_sectionIds.empty()) {
+        return true;
+    }
+    // Sections grouped by course, with seats left
+    QHash<int, std::vector<int>> sectionsByCourse;  // course id -> indexes into m_sectionIds
+    for (int i = 0; i < int(m_sectionIds.size()); ++i) {
+        sectionsByCourse[m_sectionCourse[i]].push_back(i);
+    }
+    std::vector<int> seatsLeft = m_sectionCapacity;
+
+    QVariantList studentIds, sectionIds;
+    std::uniform_int_distribution<int> anyCourse(0, int(m_courseIds.size()) - 1);
+    m_studentSections.assign(m_studentIds.size(), {});
+    for (int s = 0; s < int(m_studentIds.size()); ++s) {
+        std::vector<int> taken;
+        for (int attempt = 0; attempt < m_scale.enrollmentsPerStudent * 4
+                              && int(taken.size()) < m_scale.enrollmentsPerStudent; ++attempt) {
+            const int courseId = m_courseIds[anyCourse(m_rng)];
+            if (std::find(taken.begin(), taken.end(), courseId) != taken.end()) {
+                continue;
+            }
+            for (int index : sectionsByCourse.value(courseId)) {
+                if (seatsLeft[index] > 0) {
+                    --seatsLeft[index];
+                    taken.push_back(courseId);
+                    m_studentSections[s].push_back(index);
+                    studentIds << m_studentIds[s];
+                    sectionIds << m_sectionIds[index];
+                    break;
+                }
+            }
+        }
+    }
+    if (!insertBatch(db, "INSERT INTO student_section (student_id, section_id) VALUES (?, ?)", {studentIds, sectionIds})) {
+        return false;
+    }
+    m_counts.enrollments = int(studentIds.size());
+    return true;
+}
+
+bool CampusGenerator::generateAttendance(QSqlDatabase& db)
+{
+    // Each section meets twice a week; record the first attendanceDays meetings
+    std::uniform_real_distribution<double> roll(0.0, 1.0);
+    QVariantList studentIds, sectionIds, courseIds, dates, statuses;
+    for (int s = 0; s < int(m_studentIds.size()); ++s) {
+        for (int index : m_studentSections[s]) {
+            const int firstDay = index % 5;  // Spread sections over the week
+            for (int k = 0; k < m_scale.attendanceDays; ++k) {
+                const QDate date = m_scale.termStart.addDays((k / 2) * 7 + firstDay + (k % 2) * 2);
+                const double r = roll(m_rng);
+                int status = 1;                                 // Present
+                if (r < m_absenceRate[s]) status = 2;           // Absent
+                else if (r < m_absenceRate[s] + 0.05) status = 3;  // Late
+                else if (r < m_absenceRate[s] + 0.07) status = 4;  // Excused
+                studentIds << m_studentIds[s];
+                sectionIds << m_sectionIds[index];
+                courseIds << m_sectionCourse[index];
+                dates << date;
+                statuses << status;
+            }
+        }
+        // Flush periodically so very large campuses do not build one giant batch
+        if (studentIds.size() >= 200000 || s + 1 == int(m_studentIds.size())) {
+            if (!insertBatch(db, "INSERT INTO attendance (student_id, section_id, course_id, date, status_id) VALUES (?, ?, ?, ?, ?)",
+                             {studentIds, sectionIds, courseIds, dates, statuses})) {
+                return false;
+            }
+            m_counts.attendance += int(studentIds.size());
+            studentIds.clear(); sectionIds.clear(); courseIds.clear(); dates.clear(); statuses.clear();
+        }
+    }
+    return true;
+}
+
+bool CampusGenerator::generateGrades(QSqlDatabase& db)
+{
+    // A per-student ability shifts every component grade; components vary around it
+    std::normal_distribution<double> jitter(0.0, 1.0);
+    const int letters = countOf(kLetterGrades);
+    QVariantList studentIds, courseIds, a1s, a2s, finals, totals;
+    for (int s = 0; s < int(m_studentIds.size()); ++s) {
+        const int ability = weighted(kLetterWeights);
+        for (int index : m_studentSections[s]) {
+            int sum = 0;
+            QString parts[3];
+            for (QString& part : parts) {
+                const int g = std::clamp(ability + int(std::lround(jitter(m_rng))), 0, letters - 1);
+                sum += g;
+                part = QString::fromLatin1(kLetterGrades[g]);
+            }
+            studentIds << m_studentIds[s];
+            courseIds << m_sectionCourse[index];
+            a1s << parts[0];
+            a2s << parts[1];
+            finals << parts[2];
+            totals << QString::fromLatin1(kLetterGrades[std::clamp(int(std::lround(sum / 3.0)), 0, letters - 1)]);
+        }
+    }
+    if (!insertBatch(db, "INSERT INTO grades (student_id, course_id, a1, a2, final_exam, total) VALUES (?, ?, ?, ?, ?, ?)",
+                     {studentIds, courseIds, a1s, a2s, finals, totals})) {
+        return false;
+    }
+    m_counts.grades = int(studentIds.size());
+    return true;
+}
+
+bool CampusGenerator::generatePayments(QSqlDatabase& db)
+{
+    // Tuition first, then lab and library fees; most are paid, some overdue
+    const std::vector<int> statusWeights = {20, 70, 10};  // Pending, Paid, Overdue
+    std::uniform_int_distribution<int> tuition(10, 18);   // x 500 EGP
+    std::uniform_int_distribution<int> dayOffset(-14, 30);
+    QVariantList studentIds, amounts, descriptions, statuses, dates;
+    const QString tuitionText = QString::fromUtf8("رسوم دراسية - الفصل الدراسي الأول %1").arg(m_scale.termStart.year());
+    const QString labText = QString::fromUtf8("رسوم المختبر");
+    const QString libraryText = QString::fromUtf8("رسوم المكتبة");
+    for (int id : m_studentIds) {
+        for (int p = 0; p < m_scale.paymentsPerStudent; ++p) {
+            const int kind = p % 3;
+            studentIds << id;
+            amounts << (kind == 0 ? tuition(m_rng) * 500.0 : kind == 1 ? 500.0 : 300.0);
+            descriptions << (kind == 0 ? tuitionText : kind == 1 ? labText : libraryText);
+            statuses << 1 + weighted(statusWeights);
+            dates << m_scale.termStart.addDays(dayOffset(m_rng) + kind * 10);
+        }
+    }
+    if (!insertBatch(db, "INSERT INTO payments (student_id, amount, description, status_id, date) VALUES (?, ?, ?, ?, ?)",
+                     {studentIds, amounts, descriptions, statuses, dates})) {
+        return false;
+    }
+    m_counts.payments = int(studentIds.size());
+    return true;
+}
+
+bool CampusGenerator::generateLibrary(QSqlDatabase& db)
+{
+    if (m_scale.books <= 0) {
+        return true;
+    }
+    const int before = maxId(db, "books", "book_id");
+    std::uniform_int_distribution<int> copies(1, 5);
+    std::uniform_int_distribution<int> year(1990, m_scale.termStart.year());
+    std::uniform_int_distribution<int> shelf(1, 40);
+    std::bernoulli_distribution female(0.4);
+
+    std::vector<int> total(m_scale.books), available(m_scale.books);
+    for (int i = 0; i < m_scale.books; ++i) {
+        total[i] = available[i] = copies(m_rng);
+    }
+
+    // Plan the loans first so available_copies matches the open loans
+    struct PlannedLoan { int book; int studentId; int facultyId; QDate checkout; QDate due; QVariant returned; int status; };
+    std::vector<PlannedLoan> loans;
+    const QDate today = m_scale.termStart.addDays(60);
+    std::uniform_int_distribution<int> anyBook(0, m_scale.books - 1);
+    std::uniform_int_distribution<int> checkoutOffset(0, 59);
+    std::uniform_int_distribution<int> keptDays(1, 20);
+    std::bernoulli_distribution byFaculty(0.15);
+    std::bernoulli_distribution returned(0.6);
+    for (int i = 0; i < m_scale.loans; ++i) {
+        const int book = anyBook(m_rng);
+        if (available[book] == 0) {
+            continue;
+        }
+        PlannedLoan loan;
+        loan.book = book;
+        const bool faculty = !m_facultyIds.empty() && (m_studentIds.empty() || byFaculty(m_rng));
+        loan.studentId = faculty ? 0 : m_studentIds[std::uniform_int_distribution<int>(0, int(m_studentIds.size()) - 1)(m_rng)];
+        loan.facultyId = faculty ? m_facultyIds[std::uniform_int_distribution<int>(0, int(m_facultyIds.size()) - 1)(m_rng)] : 0;
+        if (loan.studentId == 0 && loan.facultyId == 0) {
+            continue;
+        }
+        loan.checkout = m_scale.termStart.addDays(checkoutOffset(m_rng));
+        loan.due = loan.checkout.addDays(14);
+        const QDate back = loan.checkout.addDays(keptDays(m_rng));
+        if (returned(m_rng) && back <= today) {
+            loan.returned = back;
+            loan.status = 2;                               // Returned
+        } else {
+            loan.status = loan.due < today ? 3 : 1;        // Overdue / Checked Out
+            --available[book];
+        }
+        loans.push_back(loan);
+    }
+
+    QVariantList isbns, titles, authors, publishers, years, categories, totals, availables, locations;
+    for (int i = 0; i < m_scale.books; ++i) {
+        const int category = i % countOf(kBookCategories);
+        isbns << QString("978-977-%1").arg(before + i + 1, 8, 10, QChar('0'));
+        titles << QString("%1 - %2").arg(QString::fromUtf8(kSubjects[i % countOf(kSubjects)])).arg(i / countOf(kSubjects) + 1);
+        authors << QString::fromUtf8("د. ") + randomName(female(m_rng)).arabic;
+        publishers << QString::fromUtf8(kPublishers[i % countOf(kPublishers)]);
+        years << year(m_rng);
+        categories << QString::fromUtf8(kBookCategories[category]);
+        totals << total[i];
+        availables << available[i];
+        locations << QString("%1-%2").arg(QChar('A' + category)).arg(shelf(m_rng));
+    }
+    if (!insertBatch(db, "INSERT INTO books (isbn, title, author, publisher, publication_year, category, "
+                         "total_copies, available_copies, location) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
+                     {isbns, titles, authors, publishers, years, categories, totals, availables, locations})) {
+        return false;
+    }
+    const std::vector<int> bookIds = idsAfter(db, "books", "book_id", before);
+    m_counts.books = int(bookIds.size());
+    if (int(bookIds.size()) != m_scale.books) {
+        qDebug() << "Generator Error: expected" << m_scale.books << "books, found" << bookIds.size();
+        return false;
+    }
+
+    QVariantList loanBooks, loanStudents, loanFaculty, checkouts, dues, returns, loanStatuses;
+    for (const PlannedLoan& loan : loans) {
+        loanBooks << bookIds[loan.book];
+        loanStudents << (loan.studentId ? QVariant(loan.studentId) : QVariant());
+        loanFaculty << (loan.facultyId ? QVariant(loan.facultyId) : QVariant());
+        checkouts << loan.checkout;
+        dues << loan.due;
+        returns << loan.returned;
+        loanStatuses << loan.status;
+    }
+    if (!insertBatch(db, "INSERT INTO book_loans (book_id, student_id, faculty_id, checkout_date, due_date, "
+                         "return_date, status_id) VALUES (?, ?, ?, ?, ?, ?, ?)",
+                     {loanBooks, loanStudents, loanFaculty, checkouts, dues, returns, loanStatuses})) {
+        return false;
+    }
+    m_counts.loans = int(loans.size());
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef CAMPUSGENERATOR_H
+#define CAMPUSGENERATOR_H
+
+#include <QDate>
+#include <QHash>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QString>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Fills a database with a synthetic campus of any size.
+ *
+ * Names are drawn from common Egyptian/Arabic first, father and family names
+ * (usernames use the Latin transliteration). Years, attendance, payment status
+ * and grades follow skewed distributions rather than uniform ones: more first
+ * years than fourth years, a small group of frequently absent students, most
+ * payments paid. Output is deterministic for a given seed.
+ *
+ * Meant for a freshly created database: rows are appended through batched
+ * prepared inserts, one transaction per table. Student and faculty accounts
+ * all share one precomputed password hash.
+ */
+class CampusGenerator {
+public:
+    struct Scale {
+        int students = 1000;
+        int faculty = 40;
+        int courses = 40;
+        int sectionsPerCourse = 2;
+        int enrollmentsPerStudent = 5;
+        int attendanceDays = 30;          // Class meetings recorded per enrollment
+        int paymentsPerStudent = 3;
+        int books = 500;
+        int loans = 300;
+        QDate termStart = QDate(2024, 9, 15);
+
+        // Proportional campus for n students (about 25 students per faculty member)
+        static Scale forStudents(int n);
+        QJsonObject toJson() const;
+    };
+
+    struct Counts {
+        int students = 0;
+        int faculty = 0;
+        int courses = 0;
+        int sections = 0;
+        int enrollments = 0;
+        int attendance = 0;
+        int grades = 0;
+        int payments = 0;
+        int books = 0;
+        int loans = 0;
+
+        QJsonObject toJson() const;
+    };
+
+    explicit CampusGenerator(const Scale& scale, quint32 seed = 2024);
+
+    bool generate(const QSqlDatabase& db);
+    Counts counts() const { return m_counts; }
+
+    static const QString& samplePassword();  // Password of every generated account
+
+private:
+    bool generateFaculty(QSqlDatabase& db);
+    bool generateCourses(QSqlDatabase& db);
+    bool generateStudents(QSqlDatabase& db);
+    bool generateEnrollments(QSqlDatabase& db);
+    bool generateAttendance(QSqlDatabase& db);
+    bool generateGrades(QSqlDatabase& db);
+    bool generatePayments(QSqlDatabase& db);
+    bool generateLibrary(QSqlDatabase& db);
+
+    struct PersonName {
+        QString arabic;
+        QString latin;   // first.family
+    };
+    PersonName randomName(bool female);
+    int weighted(const std::vector<int>& weights);
+    QString uniqueUsername(const QString& base);
+
+    Scale m_scale;
+    std::mt19937 m_rng;
+    Counts m_counts;
+    QString m_passwordHash;
+    QHash<QString, int> m_usernames;     // base -> times used
+    std::vector<int> m_studentIds;
+    std::vector<int> m_facultyIds;
+    std::vector<int> m_courseIds;
+    std::vector<int> m_sectionIds;
+    std::vector<int> m_sectionCourse;    // Parallel to m_sectionIds
+    std::vector<int> m_sectionCapacity;  // Parallel to m_sectionIds
+    std::vector<std::vector<int>> m_studentSections;  // Parallel to m_studentIds
+    std::vector<double> m_absenceRate;   // Parallel to m_studentIds
+};
+
+#endif // CAMPUSGENERATOR_H
@@ -0,0 +1,218 @@
+#include "connectionguard.h"
+#include "databasemanager.h"
+#include "../utils/tracer.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+
+ConnectionGuard& ConnectionGuard::instance()
+{
+    static ConnectionGuard instance;
+    return instance;
+}
+
+void ConnectionGuard::setPolicy(const RetryPolicy& policy)
+{
+    QMutexLocker lock(&m_mutex);
+    m_policy = policy;
+}
+
+RetryPolicy ConnectionGuard::policy() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_policy;
+}
+
+ConnectionGuard::Failure ConnectionGuard::classify(const QSqlError& error)
+{
+    if (error.type() == QSqlError::NoError) {
+        return Failure::None;
+    }
+    // MySQL client/server codes: can't connect, gone away, lost connection,
+    // server shutting down, disconnected for inactivity
+    static const QStringList lost = {"2002", "2003", "2006", "2013", "2055", "1053", "4031"};
+    // SQLITE_BUSY / SQLITE_LOCKED, MySQL lock wait timeout / deadlock victim
+    static const QStringList transient = {"5", "6", "1205", "1213"};
+
+    const QString code = error.nativeErrorCode();
+    if (error.type() == QSqlError::ConnectionError || lost.contains(code)) {
+        return Failure::ConnectionLost;
+    }
+    if (transient.contains(code)) {
+        return Failure::Transient;
+    }
+    return Failure::None;
+}
+
+bool ConnectionGuard::isReadOnlyStatement(const QString& sql)
+{
+    static const QStringList readVerbs = {"SELECT", "WITH", "SHOW", "EXPLAIN", "DESCRIBE"};
+    const QString verb = sql.trimmed().section(QRegularExpression("\\s+"), 0, 0).toUpper();
+    return readVerbs.contains(verb);
+}
+
+QString ConnectionGuard::serverKey(const QSqlDatabase& db)
+{
+    return QString("%1://%2:%3/%4").arg(db.driverName(), db.hostName()).arg(db.port()).arg(db.databaseName());
+}
+
+bool ConnectionGuard::allow(const QSqlDatabase& db)
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_circuits.constFind(serverKey(db));
+    if (it == m_circuits.constEnd() || it->openUntilMs == 0
+        || QDateTime::currentMSecsSinceEpoch() >= it->openUntilMs) {
+        return true;  // Closed, or half-open: the next attempt is the probe
+    }
+    ++m_rejected;
+    return false;
+}
+
+void ConnectionGuard::recordSuccess(const QSqlDatabase& db)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_circuits.remove(serverKey(db)) > 0) {
+        m_watching = int(m_circuits.size() + m_brokenTransactions.size());
+    }
+}
+
+void ConnectionGuard::recordFailure(const QString& key)
+{
+    QMutexLocker lock(&m_mutex);
+    Circuit& circuit = m_circuits[key];
+    ++circuit.failures;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (circuit.failures >= m_policy.breakerFailures && circuit.openUntilMs <= now) {
+        circuit.openUntilMs = now + m_policy.breakerCooldownMs;
+        ++m_circuitOpens;
+        qDebug() << "Circuit open for" << key << "after" << circuit.failures << "failures; failing fast for"
+                 << m_policy.breakerCooldownMs << "ms";
+        publish("circuit_opens", m_circuitOpens);
+    }
+    m_watching = int(m_circuits.size() + m_brokenTransactions.size());
+}
+
+bool ConnectionGuard::reconnect(QSqlDatabase& db)
+{
+    SIS_TRACE_SCOPE("db", "ConnectionGuard::reconnect");
+    if (!allow(db)) {
+        return false;
+    }
+    db.close();
+    if (db.open()) {
+        if (db.driverName() == "QSQLITE") {
+            // PRAGMAs are per connection and went with the old one
+            DatabaseManager::instance().sqliteProfile().apply(db);
+        }
+        ++m_reconnects;
+        publish("reconnects", m_reconnects);
+        qDebug() << "Database: reconnected" << db.connectionName();
+        recordSuccess(db);
+        return true;
+    }
+    ++m_reconnectFailures;
+    qDebug() << "Reconnect Error:" << db.connectionName() << db.lastError().text();
+    recordFailure(serverKey(db));
+    return false;
+}
+
+bool ConnectionGuard::ping(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+    return query.exec("SELECT 1");
+}
+
+void ConnectionGuard::backoff(int attempt) const
+{
+    const RetryPolicy current = policy();
+    const qint64 exponential = qint64(current.baseDelayMs) << std::min(attempt - 1, 16);
+    const int delay = int(std::min<qint64>(current.maxDelayMs, exponential));
+    // Half fixed, half random so clients that lost the server together do not return together
+    QThread::msleep(ulong(delay / 2 + QRandomGenerator::global()->bounded(delay / 2 + 1)));
+}
+
+bool ConnectionGuard::canBackOff()
+{
+    const QCoreApplication* app = QCoreApplication::instance();
+    return !app || QThread::currentThread() != app->thread() || !app->inherits("QGuiApplication");
+}
+
+void ConnectionGuard::countRetry(bool succeeded)
+{
+    ++m_retries;
+    if (succeeded) {
+        ++m_retriesSucceeded;
+    }
+    publish("retries", m_retries);
+}
+
+void ConnectionGuard::countHealthCheck()
+{
+    ++m_healthChecks;
+}
+
+void ConnectionGuard::beginTransaction(const QString& connectionName)
+{
+    QMutexLocker lock(&m_mutex);
+    m_transactions.insert(connectionName);
+}
+
+void ConnectionGuard::endTransaction(const QString& connectionName)
+{
+    QMutexLocker lock(&m_mutex);
+    m_transactions.remove(connectionName);
+    if (m_brokenTransactions.remove(connectionName)) {
+        m_watching = int(m_circuits.size() + m_brokenTransactions.size());
+    }
+}
+
+bool ConnectionGuard::inTransaction(const QString& connectionName) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_transactions.contains(connectionName);
+}
+
+bool ConnectionGuard::isTransactionBroken(const QString& connectionName) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_brokenTransactions.contains(connectionName);
+}
+
+void ConnectionGuard::markTransactionBroken(const QString& connectionName)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_transactions.contains(connectionName) || m_brokenTransactions.contains(connectionName)) {
+        return;
+    }
+    m_brokenTransactions.insert(connectionName);
+    m_watching = int(m_circuits.size() + m_brokenTransactions.size());
+    ++m_transactionsAborted;
+    qDebug() << "Transaction on" << connectionName << "lost its connection; it will be rolled back";
+}
+
+ConnectionGuard::Metrics ConnectionGuard::metrics() const
+{
+    Metrics m;
+    m.retries = m_retries;
+    m.retriesSucceeded = m_retriesSucceeded;
+    m.reconnects = m_reconnects;
+    m.reconnectFailures = m_reconnectFailures;
+    m.healthChecks = m_healthChecks;
+    m.circuitOpens = m_circuitOpens;
+    m.rejected = m_rejected;
+    m.transactionsAborted = m_transactionsAborted;
+    return m;
+}
+
+void ConnectionGuard::publish(const char* name, quint64 value) const
+{
+    if (Q_UNLIKELY(Tracer::enabled())) {
+        Tracer::instance().counter("db", name, double(value));
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef CONNECTIONGUARD_H
+#define CONNECTIONGUARD_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QString>
+#include <atomic>
+
+// Retry and circuit-breaker settings ([database] keys in DatabaseConfig)
+struct RetryPolicy {
+    int attempts = 3;                 // Retries after the first failure; 0 = off
+    int baseDelayMs = 100;            // Backoff doubles per attempt, with jitter
+    int maxDelayMs = 2000;
+    int breakerFailures = 5;          // Consecutive reconnect failures that open the circuit
+    int breakerCooldownMs = 15000;    // Statements fail fast while the circuit is open
+    int healthCheckIntervalSeconds = 30;  // Idle main connection is pinged before reuse; 0 = off
+};
+
+/**
+ * @brief Reconnects dropped connections, retries safe statements with
+ * exponential backoff and stops hammering a server that is down.
+ *
+ * ProfiledQuery reports failures here. Only statements that cannot have
+ * taken effect are retried: reads outside a transaction after a lost
+ * connection, and any statement outside a transaction that hit a lock.
+ * A transaction that loses its connection is marked broken so commit()
+ * fails instead of committing half of it on the new session. Each server
+ * (driver, host, port, database) has its own circuit. Thread-safe.
+ *
+ * Workers and sis-batch back off between attempts; the GUI thread retries
+ * once without sleeping (see canBackOff()).
+ */
+class ConnectionGuard {
+public:
+    enum class Failure {
+        None,            // Not a connection problem (SQL error, constraint, ...)
+        Transient,       // Lock contention; nothing ran
+        ConnectionLost   // Server gone away / unreachable
+    };
+
+    struct Metrics {
+        quint64 retries = 0;
+        quint64 retriesSucceeded = 0;
+        quint64 reconnects = 0;
+        quint64 reconnectFailures = 0;
+        quint64 healthChecks = 0;
+        quint64 circuitOpens = 0;
+        quint64 rejected = 0;             // Statements failed fast by an open circuit
+        quint64 transactionsAborted = 0;
+    };
+
+    static ConnectionGuard& instance();
+
+    void setPolicy(const RetryPolicy& policy);
+    RetryPolicy policy() const;
+
+    static Failure classify(const QSqlError& error);
+    static bool isReadOnlyStatement(const QString& sql);
+
+    // Cheap check for the hot path: false while every server is healthy
+    bool watching() const { return m_watching.load(std::memory_order_relaxed) > 0; }
+    bool allow(const QSqlDatabase& db);   // False while the server's circuit is open
+    void recordSuccess(const QSqlDatabase& db);
+
+    bool reconnect(QSqlDatabase& db);     // Close + open (+ SQLite profile); counts towards the circuit
+    bool ping(QSqlDatabase& db);          // SELECT 1
+    void backoff(int attempt) const;      // Sleeps the calling thread
+    // False on a GUI application's main thread: sleeping there freezes the window,
+    // so it gets one immediate retry instead of the backoff loop
+    static bool canBackOff();
+    void countRetry(bool succeeded);
+    void countHealthCheck();
+
+    // Transactions are tracked per connection name (see DatabaseManager::beginTransaction)
+    void beginTransaction(const QString& connectionName);
+    void endTransaction(const QString& connectionName);
+    bool inTransaction(const QString& connectionName) const;
+    bool isTransactionBroken(const QString& connectionName) const;
+    void markTransactionBroken(const QString& connectionName);
+
+    Metrics metrics() const;
+
+private:
+    ConnectionGuard() = default;
+    ConnectionGuard(const ConnectionGuard&) = delete;
+    ConnectionGuard& operator=(const ConnectionGuard&) = delete;
+
+    struct Circuit {
+        int failures = 0;
+        qint64 openUntilMs = 0;  // Epoch ms; 0 = closed
+    };
+
+    static QString serverKey(const QSqlDatabase& db);
+    void recordFailure(const QString& key);
+    void publish(const char* name, quint64 value) const;
+
+    mutable QMutex m_mutex;
+    RetryPolicy m_policy;
+    QHash<QString, Circuit> m_circuits;   // Only servers with failures
+    QSet<QString> m_transactions;         // Connection names with an open transaction
+    QSet<QString> m_brokenTransactions;
+    std::atomic<int> m_watching{0};       // Circuits + broken transactions, readable without the lock
+
+    std::atomic<quint64> m_retries{0};
+    std::atomic<quint64> m_retriesSucceeded{0};
+    std::atomic<quint64> m_reconnects{0};
+    std::atomic<quint64> m_reconnectFailures{0};
+    std::atomic<quint64> m_healthChecks{0};
+    std::atomic<quint64> m_circuitOpens{0};
+    std::atomic<quint64> m_rejected{0};
+    std::atomic<quint64> m_transactionsAborted{0};
+};
+
+#endif // CONNECTIONGUARD_H
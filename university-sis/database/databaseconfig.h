@@ -0,0 +1,59 @@
+#ifndef DATABASECONFIG_H
+#define DATABASECONFIG_H
+
+#include "connectionguard.h"
+#include "sqliteprofile.h"
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+// One database server; for SQLite only the driver matters (see DatabaseConfig::sqlitePath)
+struct DatabaseEndpoint {
+    QString driver = "auto";  // QMYSQL, QSQLITE, or auto: MySQL when its driver is available
+    QString host = "localhost";
+    int port = -1;            // Driver default
+    QString name = "university_sis";
+    QString user = "university_sis";
+    QString password = "university_sis@123";
+};
+
+/**
+ * @brief Where and how DatabaseManager connects, read once at startup.
+ *
+ * Values come from an INI file (SIS_CONFIG, else university-sis.ini next to
+ * the executable) and are overridden by environment variables named
+ * SIS_<GROUP>_<KEY>, e.g. SIS_DATABASE_HOST or SIS_SQLITE_PROFILE. A missing
+ * file leaves the defaults. See README.md for the keys.
+ */
+struct DatabaseConfig {
+    DatabaseEndpoint primary;
+    std::optional<DatabaseEndpoint> replica;  // [replica]: read-only endpoint for heavy queries
+
+    QString sqlitePath;             // Empty: university_sis.db next to the executable; see absoluteSqlitePath()
+    SqliteProfile sqlite;
+
+    int connectTimeoutSeconds = 5;
+    int queryTimeoutSeconds = 30;   // MySQL read/write timeout
+    int busyTimeoutMs = 5000;       // SQLite lock wait
+    int workerConnections = 0;      // Max concurrent ScopedConnections; 0 = unlimited
+    bool routeReads = true;         // Send DbAccess::ReadOnly queries to the replica / a read-only SQLite connection
+    RetryPolicy retry;              // Reconnect, retry and circuit-breaker settings
+
+    QString source;                 // File the values came from, empty if none
+    QStringList warnings;           // Unreadable values; the defaults were kept
+
+    static DatabaseConfig load();
+    static DatabaseConfig load(const QString& path);
+
+    // Resolves "auto" against the drivers available at runtime
+    QString resolvedDriver(const DatabaseEndpoint& endpoint) const;
+    QString resolvedSqlitePath() const;
+    // Anchors a relative path at baseDir (empty: the working directory);
+    // empty and ":memory:" are returned untouched
+    static QString absoluteSqlitePath(const QString& path, const QString& baseDir = QString());
+    // Adds (does not open) a connection configured for endpoint
+    QSqlDatabase addDatabase(const DatabaseEndpoint& endpoint, const QString& connectionName) const;
+};
+
+#endif // DATABASECONFIG_H
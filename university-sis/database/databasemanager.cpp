@@ -1,14 +1,25 @@
 #include "databasemanager.h"
+#include "connectionguard.h"
+#include "../utils/tracer.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QCoreApplication>
+#include <QSqlRecord>
+#include <QStringList>
+#include <QPair>
+#include <QThread>
+#include <QTimer>
 
 DatabaseManager::DatabaseManager()
+    : m_config(DatabaseConfig::load())
 {
 }
 
 DatabaseManager::~DatabaseManager()
 {
+    if (m_readDb.isOpen()) {
+        m_readDb.close();
+    }
     if (m_db.isOpen()) {
         m_db.close();
     }
@@ -22,44 +33,124 @@ DatabaseManager& DatabaseManager::instance()
 
 bool DatabaseManager::connect()
 {
+    SIS_TRACE_SCOPE("db", "DatabaseManager::connect");
     if (m_db.isOpen()) {
         return true;
     }
 
-    // Check available drivers
-    if (QSqlDatabase::isDriverAvailable("QMYSQL")) {
-        m_db = QSqlDatabase::addDatabase("QMYSQL");
-        m_db.setHostName("localhost");
-        m_db.setDatabaseName("university_sis");
-        m_db.setUserName("university_sis");
-        m_db.setPassword("university_sis@123");
-        qDebug() << "Using MySQL Database";
-    } else {
+    for (const QString& warning : m_config.warnings) {
+        qDebug() << "Database Config Warning:" << warning;
+    }
+    if (!m_config.source.isEmpty()) {
+        qDebug() << "Database config:" << m_config.source;
+    }
+
+    const QString driver = m_config.resolvedDriver(m_config.primary);
+    if (!QSqlDatabase::isDriverAvailable(driver)) {
+        qDebug() << "Error: database driver" << driver << "is not available";
+        return false;
+    }
+    if (driver == "QSQLITE" && m_config.primary.driver.compare("auto", Qt::CaseInsensitive) == 0) {
         // Fallback to SQLite if MySQL driver is missing (Common on Windows/Qt)
         qDebug() << "MySQL Driver (QMYSQL) not found. Falling back to SQLite.";
-        m_db = QSqlDatabase::addDatabase("QSQLITE");
-        
-        // Save database in the application directory or standard location
-        QString dbPath = QDir(QCoreApplication::applicationDirPath()).filePath("university_sis.db");
-        m_db.setDatabaseName(dbPath);
-        qDebug() << "SQLite Database Path:" << dbPath;
+    }
+    m_db = m_config.addDatabase(m_config.primary, QString(QSqlDatabase::defaultConnection));
+    if (driver == "QSQLITE") {
+        qDebug() << "SQLite Database Path:" << m_db.databaseName();
+    } else {
+        qDebug() << "Using" << driver << "Database on" << m_db.hostName();
     }
 
+    ConnectionGuard::instance().setPolicy(m_config.retry);
     if (!m_db.open()) {
         qDebug() << "Error: Connection with database failed";
         qDebug() << m_db.lastError().text();
         return false;
     } else {
         qDebug() << "Database: connection ok";
-        // Enable foreign keys for SQLite
+        m_ownerThread = QThread::currentThread();
+        m_dbChecked.start();
         if (m_db.driverName() == "QSQLITE") {
-            QSqlQuery query;
-            query.exec("PRAGMA foreign_keys = ON");
+            const SqliteProfile& profile = m_config.sqlite;
+            profile.apply(m_db);
+            qDebug() << "SQLite profile:" << profile.name;
+
+            // The timer lives on the main thread with m_db and dies with the application
+            if (QCoreApplication* app = QCoreApplication::instance()) {
+                if (profile.maintenanceIntervalMinutes > 0) {
+                    QTimer* timer = new QTimer(app);
+                    QObject::connect(timer, &QTimer::timeout, [this]() { runMaintenance(); });
+                    timer->start(profile.maintenanceIntervalMinutes * 60 * 1000);
+                }
+                QObject::connect(app, &QCoreApplication::aboutToQuit, [this]() { runMaintenance(); });
+            }
         }
         
         initSchema();
+        openReadConnection();
+        return true;
+    }
+}
+
+void DatabaseManager::openReadConnection()
+{
+    SIS_TRACE_SCOPE("db", "DatabaseManager::openReadConnection");
+    if (!m_config.routeReads) {
+        return;
+    }
+
+    const bool sqlite = m_db.driverName() == "QSQLITE";
+    if (sqlite) {
+        // Without WAL a reader would still lock out the writer, so a second connection buys nothing
+        QSqlQuery mode(m_db);
+        if (!mode.exec("PRAGMA journal_mode") || !mode.next()
+            || mode.value(0).toString().compare("wal", Qt::CaseInsensitive) != 0) {
+            qDebug() << "Read routing: SQLite is not in WAL mode, reads stay on the main connection";
+            return;
+        }
+        m_readDb = m_config.addDatabase(m_config.primary, "sis_read");
+        m_readDb.setConnectOptions(m_readDb.connectOptions() + ";QSQLITE_OPEN_READONLY");
+    } else if (m_config.replica) {
+        m_readDb = m_config.addDatabase(*m_config.replica, "sis_read");
+    } else {
+        return;
+    }
+
+    if (!m_readDb.open()) {
+        qDebug() << "Read routing Error:" << m_readDb.lastError().text() << "- reads stay on the main connection";
+        m_readDb = QSqlDatabase();
+        QSqlDatabase::removeDatabase("sis_read");
+        return;
+    }
+    if (sqlite) {
+        m_config.sqlite.apply(m_readDb);
+    }
+    m_readDbChecked.start();
+    qDebug() << "Read routing: read-only queries use" << (sqlite ? "a second SQLite connection" : m_readDb.hostName());
+}
+
+void DatabaseManager::setConfig(const DatabaseConfig& config)
+{
+    m_config = config;
+}
+
+void DatabaseManager::setSqlitePath(const QString& path)
+{
+    m_config.primary.driver = "QSQLITE";
+    m_config.sqlitePath = DatabaseConfig::absoluteSqlitePath(path);  // Command line: relative to the working directory
+}
+
+void DatabaseManager::setSqliteProfile(const SqliteProfile& profile)
+{
+    m_config.sqlite = profile;
+}
+
+bool DatabaseManager::runMaintenance()
+{
+    if (!m_db.isOpen() || m_db.driverName() != "QSQLITE") {
         return true;
     }
+    return SqliteProfile::runMaintenance(m_db);
 }
 
 bool DatabaseManager::isOpen() const
@@ -67,24 +158,104 @@ bool DatabaseManager::isOpen() const
     return m_db.isOpen();
 }
 
-QSqlDatabase DatabaseManager::getDatabase() const
+QSqlDatabase DatabaseManager::getDatabase(DbAccess access) const
 {
+    if (access == DbAccess::ReadOnly && m_readDb.isOpen()) {
+        checkHealth(m_readDb, m_readDbChecked);
+        return m_readDb;
+    }
+    checkHealth(m_db, m_dbChecked);
     return m_db;
 }
 
+void DatabaseManager::checkHealth(QSqlDatabase db, QElapsedTimer& lastChecked) const
+{
+    // A server connection left idle (lunch break, laptop asleep) is often closed by the
+    // server; find out here rather than on the user's next save. SQLite files don't drop.
+    const int interval = m_config.retry.healthCheckIntervalSeconds;
+    if (interval <= 0 || !lastChecked.isValid()
+        || QThread::currentThread() != m_ownerThread || db.driverName() == "QSQLITE") {
+        return;
+    }
+    // lastChecked is the last use, so only a connection idle for the interval is pinged
+    const bool idle = lastChecked.elapsed() >= interval * 1000LL;
+    lastChecked.restart();
+    ConnectionGuard& guard = ConnectionGuard::instance();
+    if (!idle || guard.inTransaction(db.connectionName())) {
+        return;
+    }
+    guard.countHealthCheck();
+    if (!guard.ping(db)) {
+        qDebug() << "Health check failed for" << db.connectionName() << "- reconnecting";
+        guard.reconnect(db);
+    }
+}
+
+bool DatabaseManager::routesReads() const
+{
+    return m_readDb.isOpen();
+}
+
+bool DatabaseManager::beginTransaction(QSqlDatabase& db)
+{
+    ConnectionGuard& guard = ConnectionGuard::instance();
+    guard.beginTransaction(db.connectionName());
+    if (db.transaction()) {
+        return true;
+    }
+    qDebug() << "Begin Transaction Error:" << db.lastError().text();
+    if (ConnectionGuard::classify(db.lastError()) == ConnectionGuard::Failure::ConnectionLost) {
+        // Nothing ran yet, but the caller's statements must not run on a reconnected session as autocommit
+        guard.markTransactionBroken(db.connectionName());
+        guard.reconnect(db);
+    }
+    return false;
+}
+
+bool DatabaseManager::commitTransaction(QSqlDatabase& db)
+{
+    ConnectionGuard& guard = ConnectionGuard::instance();
+    const QString name = db.connectionName();
+    if (guard.isTransactionBroken(name)) {
+        qDebug() << "Commit Error: connection" << name << "was lost during the transaction";
+        guard.endTransaction(name);
+        return false;
+    }
+    const bool ok = db.commit();
+    guard.endTransaction(name);
+    return ok;
+}
+
+bool DatabaseManager::rollbackTransaction(QSqlDatabase& db)
+{
+    const bool ok = db.rollback();
+    ConnectionGuard::instance().endTransaction(db.connectionName());
+    return ok;
+}
+
 void DatabaseManager::initSchema()
 {
+    SIS_TRACE_SCOPE("db", "DatabaseManager::initSchema");
     QSqlQuery query;
     bool isSqlite = (m_db.driverName() == "QSQLITE");
     
     QString autoInc = isSqlite ? "INTEGER PRIMARY KEY AUTOINCREMENT" : "INT AUTO_INCREMENT PRIMARY KEY";
     
-    // Users Table
+    // Users Table - one login account per person; student/faculty accounts link to their profile
     query.exec(QString("CREATE TABLE IF NOT EXISTS users ("
                "user_id %1, "
-               "password_hash VARCHAR(100) NOT NULL, "
-               "role VARCHAR(20) NOT NULL, "
-               "display_name VARCHAR(100))").arg(autoInc));
+               "username VARCHAR(50) UNIQUE, "
+               "password_hash VARCHAR(128) NOT NULL, "
+               "role VARCHAR(20) NOT NULL, " // ADMIN, STUDENT, FACULTY, FINANCE, REGISTRAR
+               "display_name VARCHAR(100), "
+               "student_id INT REFERENCES students(student_id) ON DELETE CASCADE, "
+               "faculty_id INT REFERENCES faculty(faculty_id) ON DELETE CASCADE)").arg(autoInc));
+    query.exec("ALTER TABLE users ADD COLUMN username VARCHAR(50)");
+    query.exec("ALTER TABLE users ADD COLUMN student_id INT REFERENCES students(student_id) ON DELETE CASCADE");
+    query.exec("ALTER TABLE users ADD COLUMN faculty_id INT REFERENCES faculty(faculty_id) ON DELETE CASCADE");
+    query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_users_username ON users(username)");
+    query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_users_student ON users(student_id)");
+    query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_users_faculty ON users(faculty_id)");
 
     // Students Table - UPDATED with username/password
     // Note: If table exists, these columns might be missing. Using simple check.
@@ -95,7 +266,7 @@ void DatabaseManager::initSchema()
                "department VARCHAR(50), "
                "section_id INT, "
                "username VARCHAR(50) UNIQUE, "
-               "password VARCHAR(50))").arg(autoInc));
+               "password VARCHAR(128))").arg(autoInc));
     
     // Attempt to alter table if columns missing (Migration logic)
     query.exec("ALTER TABLE students ADD COLUMN username VARCHAR(50)");
@@ -110,13 +281,20 @@ void DatabaseManager::initSchema()
                "department VARCHAR(50), "
                "position VARCHAR(50), "
                "username VARCHAR(50) UNIQUE, "
-               "password VARCHAR(50))").arg(autoInc));
+               "password VARCHAR(128))").arg(autoInc));
 
     // Migration for Faculty
     query.exec("ALTER TABLE faculty ADD COLUMN username VARCHAR(50)");
     query.exec("ALTER TABLE faculty ADD COLUMN password VARCHAR(50)");
     query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_faculty_username ON faculty(username)");
 
+    // Password columns hold PBKDF2 hashes (~90 chars); SQLite ignores declared lengths
+    if (!isSqlite) {
+        query.exec("ALTER TABLE users MODIFY password_hash VARCHAR(128) NOT NULL");
+        query.exec("ALTER TABLE students MODIFY password VARCHAR(128)");
+        query.exec("ALTER TABLE faculty MODIFY password VARCHAR(128)");
+    }
+
     // Courses Table
     query.exec(QString("CREATE TABLE IF NOT EXISTS courses ("
                "course_id %1, "
@@ -139,6 +317,17 @@ void DatabaseManager::initSchema()
                "FOREIGN KEY (student_id) REFERENCES students(student_id), "
                "FOREIGN KEY (section_id) REFERENCES sections(section_id))");
 
+    // Waitlist for full sections; position is a per-section sequence (lower = earlier)
+    query.exec("CREATE TABLE IF NOT EXISTS section_waitlist ("
+               "section_id INT NOT NULL, "
+               "student_id INT NOT NULL, "
+               "position INT NOT NULL, "
+               "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, "
+               "PRIMARY KEY (section_id, student_id), "
+               "FOREIGN KEY (section_id) REFERENCES sections(section_id) ON DELETE CASCADE, "
+               "FOREIGN KEY (student_id) REFERENCES students(student_id) ON DELETE CASCADE)");
+    query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_section_waitlist_order ON section_waitlist(section_id, position)");
+
     // Grades Table
     query.exec("CREATE TABLE IF NOT EXISTS grades ("
                "student_id INT, "
@@ -153,15 +342,37 @@ void DatabaseManager::initSchema()
                
     // SCALED ARCHITECTURE TABLES
     
+    // Status lookup tables: ids match AttendanceStatus / PaymentStatus / LoanStatus
+    const QList<QPair<QString, QStringList>> statusLookups = {
+        {"attendance_statuses", {"Present", "Absent", "Late", "Excused"}},
+        {"payment_statuses", {"Pending", "Paid", "Overdue"}},
+        {"loan_statuses", {"Checked Out", "Returned", "Overdue"}}
+    };
+    for (const auto& lookup : statusLookups) {
+        query.exec(QString("CREATE TABLE IF NOT EXISTS %1 ("
+                   "status_id TINYINT PRIMARY KEY, "
+                   "name VARCHAR(20) NOT NULL UNIQUE)").arg(lookup.first));
+        for (int i = 0; i < lookup.second.size(); ++i) {
+            QSqlQuery insert(m_db);
+            insert.prepare(QString("INSERT INTO %1 (status_id, name) VALUES (:id, :name)").arg(lookup.first));
+            insert.bindValue(":id", i + 1);
+            insert.bindValue(":name", lookup.second.at(i));
+            insert.exec(); // Ignore error if already exists
+        }
+    }
+
     // 5. Payment & Finance
     query.exec(QString("CREATE TABLE IF NOT EXISTS payments ("
                "payment_id %1, "
                "student_id INT, "
                "amount DECIMAL(10,2), "
                "description VARCHAR(255), "
-               "status VARCHAR(20), " // Paid, Pending, Overdue
+               "status_id TINYINT NOT NULL DEFAULT 1, " // payment_statuses: Pending, Paid, Overdue
                "date DATE, "
-               "FOREIGN KEY (student_id) REFERENCES students(student_id))").arg(autoInc));
+               "FOREIGN KEY (student_id) REFERENCES students(student_id), "
+               "FOREIGN KEY (status_id) REFERENCES payment_statuses(status_id))").arg(autoInc));
+    migrateStatusColumn("payments", "payment_statuses");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_payments_student ON payments(student_id)");
 
     // 6. Attendance
     query.exec(QString("CREATE TABLE IF NOT EXISTS attendance ("
@@ -170,15 +381,36 @@ void DatabaseManager::initSchema()
                "section_id INT, "
                "course_id INT, "
                "date DATE, "
-               "status VARCHAR(20), " // Present, Absent, Late
+               "status_id TINYINT NOT NULL DEFAULT 1, " // attendance_statuses: Present, Absent, Late, Excused
                "FOREIGN KEY (student_id) REFERENCES students(student_id), "
                "FOREIGN KEY (section_id) REFERENCES sections(section_id), "
-               "FOREIGN KEY (course_id) REFERENCES courses(course_id))").arg(autoInc));
+               "FOREIGN KEY (course_id) REFERENCES courses(course_id), "
+               "FOREIGN KEY (status_id) REFERENCES attendance_statuses(status_id))").arg(autoInc));
     
     // Migration for Attendance: Add section_id column if missing (SQLite ignores if column exists)
     // Note: Foreign key constraint can only be added in CREATE TABLE, not ALTER TABLE in SQLite
     query.exec("ALTER TABLE attendance ADD COLUMN section_id INT");
-               
+    migrateStatusColumn("attendance", "attendance_statuses");
+
+    // Indexes used by attendance analytics (grouped per student/section and per section/date)
+    query.exec("CREATE INDEX IF NOT EXISTS idx_attendance_student_section ON attendance(student_id, section_id, date)");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_attendance_section_date ON attendance(section_id, date)");
+
+    // 6b. Attendance alerts produced by the analytics engine (one batch per generation date)
+    query.exec(QString("CREATE TABLE IF NOT EXISTS attendance_alerts ("
+               "alert_id %1, "
+               "student_id INT, "
+               "section_id INT, "
+               "course_id INT, "
+               "rule VARCHAR(30), " // AbsenceRate, ConsecutiveAbsences
+               "absence_rate DOUBLE, "
+               "consecutive_absences INT, "
+               "total_sessions INT, "
+               "generated_on DATE, "
+               "FOREIGN KEY (student_id) REFERENCES students(student_id), "
+               "FOREIGN KEY (section_id) REFERENCES sections(section_id))").arg(autoInc));
+    query.exec("CREATE INDEX IF NOT EXISTS idx_attendance_alerts_date ON attendance_alerts(generated_on)");
+
     // 9. Notifications / News
     query.exec(QString("CREATE TABLE IF NOT EXISTS announcements ("
                "id %1, "
@@ -201,6 +433,18 @@ void DatabaseManager::initSchema()
                "type VARCHAR(50), " // Lab, Lecture Hall, etc.
                "capacity INT, "
                "FOREIGN KEY (building_id) REFERENCES buildings(building_id) ON DELETE CASCADE)").arg(autoInc));
+    query.exec("CREATE INDEX IF NOT EXISTS idx_rooms_building ON rooms(building_id)");
+
+    // Generated timetable: one weekly meeting pattern and room per section
+    query.exec("CREATE TABLE IF NOT EXISTS section_schedule ("
+               "section_id INT PRIMARY KEY, "
+               "room_id INT NOT NULL, "
+               "days TINYINT NOT NULL, " // Weekday bit mask, Monday = 1
+               "start_time TIME NOT NULL, "
+               "end_time TIME NOT NULL, "
+               "FOREIGN KEY (section_id) REFERENCES sections(section_id) ON DELETE CASCADE, "
+               "FOREIGN KEY (room_id) REFERENCES rooms(room_id) ON DELETE CASCADE)");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_section_schedule_room ON section_schedule(room_id)");
 
     // Calendar Events Table
     query.exec(QString("CREATE TABLE IF NOT EXISTS calendar_events ("
@@ -211,6 +455,23 @@ void DatabaseManager::initSchema()
                "type VARCHAR(50), " // e.g., Class, Exam, Assignment Due, Meeting, Holiday, Other
                "description TEXT, "
                "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP)").arg(autoInc));
+    query.exec("CREATE INDEX IF NOT EXISTS idx_calendar_events_date ON calendar_events(date)");
+
+    // Recurring events: stored once as an RRULE subset, expanded per requested window
+    query.exec(QString("CREATE TABLE IF NOT EXISTS calendar_series ("
+               "id %1, "
+               "start_date DATE NOT NULL, "
+               "until_date DATE, " // Copy of the rule's UNTIL, NULL = open ended
+               "time TIME, "
+               "title VARCHAR(200) NOT NULL, "
+               "type VARCHAR(50), "
+               "description TEXT, "
+               "rrule VARCHAR(255) NOT NULL, " // e.g. FREQ=WEEKLY;BYDAY=MO,WE;UNTIL=20241220
+               "exdates TEXT, " // Comma separated ISO dates that are skipped
+               "section_id INT, "
+               "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, "
+               "FOREIGN KEY (section_id) REFERENCES sections(section_id) ON DELETE CASCADE)").arg(autoInc));
+    query.exec("CREATE INDEX IF NOT EXISTS idx_calendar_series_range ON calendar_series(start_date, until_date)");
 
     // Library Books Table
     query.exec(QString("CREATE TABLE IF NOT EXISTS books ("
@@ -234,26 +495,100 @@ void DatabaseManager::initSchema()
                "checkout_date DATE NOT NULL, "
                "due_date DATE NOT NULL, "
                "return_date DATE, "
-               "status VARCHAR(20) DEFAULT 'Checked Out', " // Checked Out, Returned, Overdue
+               "status_id TINYINT NOT NULL DEFAULT 1, " // loan_statuses: Checked Out, Returned, Overdue
                "FOREIGN KEY (book_id) REFERENCES books(book_id) ON DELETE CASCADE, "
                "FOREIGN KEY (student_id) REFERENCES students(student_id) ON DELETE SET NULL, "
-               "FOREIGN KEY (faculty_id) REFERENCES faculty(faculty_id) ON DELETE SET NULL)").arg(autoInc));
+               "FOREIGN KEY (faculty_id) REFERENCES faculty(faculty_id) ON DELETE SET NULL, "
+               "FOREIGN KEY (status_id) REFERENCES loan_statuses(status_id))").arg(autoInc));
+    migrateStatusColumn("book_loans", "loan_statuses");
 
      // Seed admin user if not exists
      QSqlQuery seed;
      // SQLite uses INSERT OR IGNORE, MySQL uses INSERT IGNORE.
      // Standard SQL: check existence first or catch error. Simplest cross-db approach:
-     seed.prepare("INSERT INTO users (user_id, password_hash, role, display_name) VALUES (1, '1234', 'ADMIN', 'المدير')");
+     // The plaintext seed password is replaced by a salted hash on the first login.
+     seed.prepare("INSERT INTO users (user_id, username, password_hash, role, display_name) VALUES (1, 'admin', '1234', 'ADMIN', 'المدير')");
      if(!seed.exec()) {
          // Ignore error if already exists (constraint violation)
      }
+     seed.exec("UPDATE users SET username = 'admin' WHERE user_id = 1 AND username IS NULL");
      
      // Seed sample data
      seedSampleData();
+
+     migrateUserAccounts();
+}
+
+void DatabaseManager::migrateUserAccounts()
+{
+    SIS_TRACE_SCOPE("db", "DatabaseManager::migrateUserAccounts");
+    // Older databases kept credentials on students/faculty. Give every profile with a
+    // username an account in users (keeping its password value, which is rehashed on the
+    // next login) and clear the copied password from the profile row.
+    beginTransaction(m_db);
+    QSqlQuery query(m_db);
+    const bool ok =
+        query.exec("INSERT INTO users (username, password_hash, role, display_name, student_id) "
+                   "SELECT s.username, s.password, 'STUDENT', s.name, s.student_id FROM students s "
+                   "WHERE s.username IS NOT NULL AND s.username <> '' AND s.password IS NOT NULL "
+                   "AND NOT EXISTS (SELECT 1 FROM users u WHERE u.student_id = s.student_id OR u.username = s.username)")
+        && query.exec("INSERT INTO users (username, password_hash, role, display_name, faculty_id) "
+                      "SELECT f.username, f.password, 'FACULTY', f.name, f.faculty_id FROM faculty f "
+                      "WHERE f.username IS NOT NULL AND f.username <> '' AND f.password IS NOT NULL "
+                      "AND NOT EXISTS (SELECT 1 FROM users u WHERE u.faculty_id = f.faculty_id OR u.username = f.username)")
+        && query.exec("UPDATE students SET password = NULL WHERE password IS NOT NULL "
+                      "AND student_id IN (SELECT student_id FROM users WHERE student_id IS NOT NULL)")
+        && query.exec("UPDATE faculty SET password = NULL WHERE password IS NOT NULL "
+                      "AND faculty_id IN (SELECT faculty_id FROM users WHERE faculty_id IS NOT NULL)");
+    if (!ok) {
+        qDebug() << "User account migration failed:" << query.lastError().text();
+        rollbackTransaction(m_db);
+        return;
+    }
+    commitTransaction(m_db);
+}
+
+void DatabaseManager::migrateStatusColumn(const QString& table, const QString& lookupTable)
+{
+    // Older databases stored the status as VARCHAR text; convert it once to status_id.
+    // status can outlive the migration (DROP COLUMN needs SQLite 3.35+), so status_id
+    // marks it done: re-running would reset rows written since then.
+    const QSqlRecord columns = m_db.record(table);
+    if (!columns.contains("status") || columns.contains("status_id")) {
+        return;
+    }
+
+    qDebug() << "Migrating" << table << "status text to" << lookupTable << "ids";
+    // SQLite runs DDL inside the transaction; MySQL commits implicitly on ALTER TABLE
+    const bool transactionalDdl = m_db.driverName() == "QSQLITE";
+    const QString addColumn = QString("ALTER TABLE %1 ADD COLUMN status_id TINYINT NOT NULL DEFAULT 1").arg(table);
+    QSqlQuery query(m_db);
+    if (!transactionalDdl && !query.exec(addColumn)) {
+        qDebug() << "Status migration failed for" << table << ":" << query.lastError().text();
+        return;
+    }
+    beginTransaction(m_db);
+    if ((transactionalDdl && !query.exec(addColumn))
+        || !query.exec(QString("UPDATE %1 SET status_id = COALESCE("
+                               "(SELECT l.status_id FROM %2 l WHERE l.name = %1.status), 1)").arg(table, lookupTable))) {
+        qDebug() << "Status migration failed for" << table << ":" << query.lastError().text();
+        rollbackTransaction(m_db);
+        if (!transactionalDdl) {
+            query.exec(QString("ALTER TABLE %1 DROP COLUMN status_id").arg(table)); // Retry on the next launch
+        }
+        return;
+    }
+    commitTransaction(m_db);
+
+    // Needs SQLite 3.35+ (bundled with Qt 6); on failure the unused column is simply left behind
+    if (!query.exec(QString("ALTER TABLE %1 DROP COLUMN status").arg(table))) {
+        qDebug() << "Could not drop legacy status column from" << table << ":" << query.lastError().text();
+    }
 }
 
 void DatabaseManager::seedSampleData()
 {
+    SIS_TRACE_SCOPE("db", "DatabaseManager::seedSampleData");
     QSqlQuery query(m_db);
     
     // Check if data already exists
@@ -267,6 +602,11 @@ void DatabaseManager::seedSampleData()
         return; // Don't seed if data already exists
     }
     
+    // Demo staff accounts come with the sample data only, never on an existing install
+    query.exec("INSERT INTO users (username, password_hash, role, display_name) VALUES "
+               "('finance', '1234', 'FINANCE', 'مسؤول المالية'), "
+               "('registrar', '1234', 'REGISTRAR', 'مسؤول التسجيل')");
+    
     // Seed Students (Arabic names)
     query.exec("INSERT INTO students (name, year, department, username, password) VALUES "
                "('أحمد محمد علي', 2, 'علوم الحاسب', 'ahmed.mohamed', 'pass123'), "
@@ -334,17 +674,17 @@ void DatabaseManager::seedSampleData()
                "(7, 8), (8, 5), (8, 9), (9, 1), (9, 3), (9, 14), "
                "(10, 1), (10, 8), (10, 14)");
     
-    // Seed Attendance
-    query.exec("INSERT INTO attendance (student_id, section_id, course_id, date, status) VALUES "
-               "(1, 1, 1, '2024-09-15', 'Present'), (1, 1, 1, '2024-09-17', 'Present'), "
-               "(1, 1, 1, '2024-09-19', 'Late'), (1, 1, 1, '2024-09-22', 'Present'), "
-               "(2, 5, 3, '2024-09-16', 'Present'), (2, 5, 3, '2024-09-18', 'Absent'), "
-               "(2, 5, 3, '2024-09-20', 'Present'), (3, 7, 7, '2024-09-15', 'Present'), "
-               "(3, 7, 7, '2024-09-17', 'Present'), (4, 1, 1, '2024-09-15', 'Present'), "
-               "(4, 1, 1, '2024-09-17', 'Present'), (5, 1, 1, '2024-09-15', 'Present'), "
-               "(5, 1, 1, '2024-09-17', 'Late'), (6, 11, 9, '2024-09-16', 'Present'), "
-               "(7, 7, 7, '2024-09-15', 'Absent'), (8, 5, 3, '2024-09-16', 'Present'), "
-               "(9, 1, 1, '2024-09-15', 'Present'), (10, 1, 1, '2024-09-15', 'Present')");
+    // Seed Attendance (status_id: 1 Present, 2 Absent, 3 Late)
+    query.exec("INSERT INTO attendance (student_id, section_id, course_id, date, status_id) VALUES "
+               "(1, 1, 1, '2024-09-15', 1), (1, 1, 1, '2024-09-17', 1), "
+               "(1, 1, 1, '2024-09-19', 3), (1, 1, 1, '2024-09-22', 1), "
+               "(2, 5, 3, '2024-09-16', 1), (2, 5, 3, '2024-09-18', 2), "
+               "(2, 5, 3, '2024-09-20', 1), (3, 7, 7, '2024-09-15', 1), "
+               "(3, 7, 7, '2024-09-17', 1), (4, 1, 1, '2024-09-15', 1), "
+               "(4, 1, 1, '2024-09-17', 1), (5, 1, 1, '2024-09-15', 1), "
+               "(5, 1, 1, '2024-09-17', 3), (6, 11, 9, '2024-09-16', 1), "
+               "(7, 7, 7, '2024-09-15', 2), (8, 5, 3, '2024-09-16', 1), "
+               "(9, 1, 1, '2024-09-15', 1), (10, 1, 1, '2024-09-15', 1)");
     
     // Seed Grades (comprehensive mock data for all students and courses)
     query.exec("INSERT INTO grades (student_id, course_id, a1, a2, final_exam, total) VALUES "
@@ -410,28 +750,28 @@ void DatabaseManager::seedSampleData()
                "(11, '101', 'ورشة عمل', 35), (11, '201', 'مختبر', 30), "
                "(12, '101', 'قاعة اجتماعات', 20), (12, '201', 'مختبر أبحاث', 15)");
     
-    // Seed Payments (Arabic descriptions)
-    query.exec("INSERT INTO payments (student_id, amount, description, status, date) VALUES "
-               "(1, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-01'), "
-               "(2, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-01'), "
-               "(3, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-02'), "
-               "(4, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-02'), "
-               "(5, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-03'), "
-               "(6, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-03'), "
-               "(7, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-04'), "
-               "(8, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-04'), "
-               "(9, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-05'), "
-               "(10, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 'Paid', '2024-09-05'), "
-               "(1, 500.00, 'رسوم المختبر', 'Paid', '2024-09-15'), "
-               "(2, 500.00, 'رسوم المختبر', 'Paid', '2024-09-15'), "
-               "(3, 500.00, 'رسوم المختبر', 'Paid', '2024-09-16'), "
-               "(4, 500.00, 'رسوم المختبر', 'Paid', '2024-09-16'), "
-               "(5, 500.00, 'رسوم المختبر', 'Paid', '2024-09-17'), "
-               "(6, 500.00, 'رسوم المختبر', 'Paid', '2024-09-17'), "
-               "(1, 300.00, 'رسوم المكتبة', 'Paid', '2024-09-20'), "
-               "(2, 300.00, 'رسوم المكتبة', 'Paid', '2024-09-20'), "
-               "(3, 300.00, 'رسوم المكتبة', 'Pending', '2024-09-25'), "
-               "(4, 300.00, 'رسوم المكتبة', 'Pending', '2024-09-25')");
+    // Seed Payments (Arabic descriptions; status_id: 1 Pending, 2 Paid)
+    query.exec("INSERT INTO payments (student_id, amount, description, status_id, date) VALUES "
+               "(1, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-01'), "
+               "(2, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-01'), "
+               "(3, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-02'), "
+               "(4, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-02'), "
+               "(5, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-03'), "
+               "(6, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-03'), "
+               "(7, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-04'), "
+               "(8, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-04'), "
+               "(9, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-05'), "
+               "(10, 5000.00, 'رسوم دراسية - الفصل الدراسي الأول 2024', 2, '2024-09-05'), "
+               "(1, 500.00, 'رسوم المختبر', 2, '2024-09-15'), "
+               "(2, 500.00, 'رسوم المختبر', 2, '2024-09-15'), "
+               "(3, 500.00, 'رسوم المختبر', 2, '2024-09-16'), "
+               "(4, 500.00, 'رسوم المختبر', 2, '2024-09-16'), "
+               "(5, 500.00, 'رسوم المختبر', 2, '2024-09-17'), "
+               "(6, 500.00, 'رسوم المختبر', 2, '2024-09-17'), "
+               "(1, 300.00, 'رسوم المكتبة', 2, '2024-09-20'), "
+               "(2, 300.00, 'رسوم المكتبة', 2, '2024-09-20'), "
+               "(3, 300.00, 'رسوم المكتبة', 1, '2024-09-25'), "
+               "(4, 300.00, 'رسوم المكتبة', 1, '2024-09-25')");
     
     // Seed Announcements (Arabic)
     query.exec("INSERT INTO announcements (title, content, date, target_role) VALUES "
@@ -457,6 +797,15 @@ void DatabaseManager::seedSampleData()
                "('2024-12-01', '08:00:00', 'بدء فترة الامتحانات النهائية', 'Exam', 'بدء فترة الامتحانات النهائية للفصل الدراسي الأول'), "
                "('2024-12-20', '17:00:00', 'نهاية الفصل الدراسي الأول', 'Other', 'نهاية الفصل الدراسي الأول وبدء الإجازة'), "
                "('2024-12-25', '00:00:00', 'رأس السنة الميلادية', 'Holiday', 'عطلة رسمية بمناسبة رأس السنة الميلادية')");
+
+    // Seed weekly lectures as recurring series (holidays skipped via exdates)
+    query.exec("INSERT INTO calendar_series (start_date, until_date, time, title, type, description, rrule, exdates, section_id) VALUES "
+               "('2024-09-15', '2024-11-30', '08:00:00', 'محاضرة - مقدمة في البرمجة', 'Class', 'محاضرة أسبوعية', "
+               "'FREQ=WEEKLY;BYDAY=TU,SU;UNTIL=20241130', '2024-10-06', 1), "
+               "('2024-09-16', '2024-11-30', '10:00:00', 'محاضرة - هياكل البيانات', 'Class', 'محاضرة أسبوعية', "
+               "'FREQ=WEEKLY;BYDAY=MO,WE;UNTIL=20241130', '2024-10-07', 2), "
+               "('2024-09-19', '2024-12-20', '12:00:00', 'الساعات المكتبية', 'Meeting', 'ساعات مكتبية كل أسبوعين', "
+               "'FREQ=WEEKLY;INTERVAL=2;BYDAY=TH;UNTIL=20241220', '', NULL)");
     
     // Seed Library Books (Arabic titles and authors)
     query.exec("INSERT INTO books (isbn, title, author, publisher, publication_year, category, total_copies, available_copies, location) VALUES "
@@ -1,26 +1,63 @@
 #ifndef DATABASEMANAGER_H
 #define DATABASEMANAGER_H
 
+#include "databaseconfig.h"
+#include <QElapsedTimer>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QString>
 #include <QDebug>
 
+class QThread;
+
+// ReadOnly work may be served by a replica (or a second SQLite connection in
+// WAL mode) that can lag the primary; anything that reads its own writes,
+// and every data-entry screen, stays on ReadWrite
+enum class DbAccess {
+    ReadWrite,
+    ReadOnly
+};
+
 class DatabaseManager
 {
 public:
     static DatabaseManager& instance();
     bool connect();
+    // The setters below override the loaded configuration; call them before connect()
+    void setConfig(const DatabaseConfig& config); // Defaults to DatabaseConfig::load()
+    const DatabaseConfig& config() const { return m_config; }
+    void setSqlitePath(const QString& path); // Always use this SQLite file
+    void setSqliteProfile(const SqliteProfile& profile);
+    const SqliteProfile& sqliteProfile() const { return m_config.sqlite; }
+    bool runMaintenance(); // SQLite only: optimize + checkpoint; also runs on a timer and at quit
     bool isOpen() const;
-    QSqlDatabase getDatabase() const;
+    // Pings a main-thread connection idle for RetryPolicy::healthCheckIntervalSeconds and reconnects it if dead
+    QSqlDatabase getDatabase(DbAccess access = DbAccess::ReadWrite) const;
+    bool routesReads() const; // Whether ReadOnly gets a connection of its own
     void initSchema(); // Helper to create tables if they don't exist
     void seedSampleData(); // Seed database with sample data
 
+    // Use these instead of QSqlDatabase::transaction()/commit()/rollback() so
+    // ConnectionGuard knows not to retry inside the transaction; commit fails
+    // if the connection was lost (and reconnected) partway through
+    static bool beginTransaction(QSqlDatabase& db);
+    static bool commitTransaction(QSqlDatabase& db);
+    static bool rollbackTransaction(QSqlDatabase& db);
+
 private:
     DatabaseManager();
     ~DatabaseManager();
+    void migrateStatusColumn(const QString& table, const QString& lookupTable); // VARCHAR status -> status_id
+    void migrateUserAccounts(); // students/faculty credentials -> users
+    void openReadConnection();  // Replica / read-only SQLite; on failure reads use m_db
+    void checkHealth(QSqlDatabase db, QElapsedTimer& lastChecked) const;
     QSqlDatabase m_db;
+    QSqlDatabase m_readDb;
+    DatabaseConfig m_config;
+    QThread* m_ownerThread = nullptr;      // Thread that opened m_db / m_readDb
+    mutable QElapsedTimer m_dbChecked;     // Restarted on every use; see checkHealth()
+    mutable QElapsedTimer m_readDbChecked;
 };
 
 #endif // DATABASEMANAGER_H
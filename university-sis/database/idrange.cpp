@@ -0,0 +1,35 @@
+#include "idrange.h"
+#include "queryprofiler.h"
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+#include <algorithm>
+
+std::optional<IdRange> IdRange::of(const QSqlDatabase& db, const QString& table, const QString& column)
+{
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    if (!query.exec(QString("SELECT MIN(%1), MAX(%1) FROM %2").arg(column, table))) {
+        qDebug() << "Id Range Error:" << query.lastError().text();
+        return std::nullopt;
+    }
+    IdRange range;
+    if (query.next() && !query.value(0).isNull()) {
+        range.first = query.value(0).toLongLong();
+        range.last = query.value(1).toLongLong();
+    }
+    return range;
+}
+
+std::vector<IdRange> IdRange::split(int n) const
+{
+    std::vector<IdRange> parts;
+    if (isEmpty()) {
+        return parts;
+    }
+    const qint64 count = std::clamp<qint64>(n, 1, size());
+    const qint64 width = (size() + count - 1) / count;
+    for (qint64 lo = first; lo <= last; lo += width) {
+        parts.push_back({lo, std::min(last, lo + width - 1)});
+    }
+    return parts;
+}
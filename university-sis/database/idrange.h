@@ -0,0 +1,33 @@
+#ifndef IDRANGE_H
+#define IDRANGE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <functional>
+#include <optional>
+#include <vector>
+
+// Reports work done so far out of total (same unit, e.g. ids covered)
+using ProgressCallback = std::function<void(qint64 done, qint64 total)>;
+
+/**
+ * @brief Inclusive [first, last] span of an integer key.
+ *
+ * Bulk jobs walk a table in fixed-width windows of the key instead of
+ * loading it, so memory stays flat and each statement holds locks briefly.
+ * Windows are half-open: [lo, lo + width).
+ */
+struct IdRange {
+    qint64 first = 0;
+    qint64 last = -1;
+
+    bool isEmpty() const { return last < first; }
+    qint64 size() const { return isEmpty() ? 0 : last - first + 1; }
+
+    // MIN/MAX of column; std::nullopt on a query error
+    static std::optional<IdRange> of(const QSqlDatabase& db, const QString& table, const QString& column);
+    // n contiguous parts of near-equal width (fewer if the range is small)
+    std::vector<IdRange> split(int n) const;
+};
+
+#endif // IDRANGE_H
@@ -0,0 +1,472 @@
+#include "queryprofiler.h"
+#include "connectionguard.h"
+#include "databasemanager.h"
+#include "../utils/tracer.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QDebug>
+#include <algorithm>
+
+QueryProfiler& QueryProfiler::instance()
+{
+    static QueryProfiler profiler;
+    return profiler;
+}
+
+QueryProfiler::QueryProfiler()
+{
+    m_slow.reserve(DefaultSlowCapacity);
+}
+
+void QueryProfiler::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+quint64 QueryProfiler::hashSql(const QString& sql)
+{
+    // First 8 bytes of SHA-1: stable across runs, unlike qHash
+    const QByteArray digest = QCryptographicHash::hash(sql.toUtf8(), QCryptographicHash::Sha1);
+    quint64 h = 0;
+    for (int i = 0; i < 8; ++i) {
+        h = (h << 8) | quint8(digest[i]);
+    }
+    return h;
+}
+
+void QueryProfiler::record(const QueryRecord& record)
+{
+    const qint64 total = record.totalUs();
+    const bool slow = total >= slowThresholdUs();
+
+    // The slow entry is built before taking the lock; fast statements skip it entirely
+    SlowQuery entry;
+    if (slow) {
+        entry.sqlHash = hashSql(record.sql);
+        entry.sql = record.sql;
+        entry.boundValues = record.boundValues;
+        entry.site = QString::fromUtf8(record.site ? record.site : "");
+        entry.connectionName = record.connectionName;
+        entry.rows = record.rows;
+        entry.prepareUs = record.prepareUs;
+        entry.execUs = record.execUs;
+        entry.fetchUs = record.fetchUs;
+        entry.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        QueryStats& s = m_stats[record.sql];
+        if (s.calls == 0) {
+            s.sql = record.sql;
+        }
+        s.site = record.site;
+        ++s.calls;
+        if (!record.ok) {
+            ++s.errors;
+        }
+        if (record.rows > 0) {
+            s.rows += quint64(record.rows);
+        }
+        s.prepareUs += record.prepareUs;
+        s.execUs += record.execUs;
+        s.fetchUs += record.fetchUs;
+        s.maxUs = std::max(s.maxUs, total);
+
+        if (!slow || m_slowCapacity <= 0) {
+            return;
+        }
+        if (int(m_slow.size()) < m_slowCapacity) {
+            m_slow.push_back(std::move(entry));
+        } else {
+            m_slow[m_slowNext] = std::move(entry);
+        }
+        m_slowNext = (m_slowNext + 1) % m_slowCapacity;
+    }
+
+    qDebug() << "Slow query:" << total / 1000.0 << "ms," << record.rows << "rows at" << record.site;
+}
+
+std::vector<QueryStats> QueryProfiler::stats() const
+{
+    std::vector<QueryStats> result;
+    {
+        QMutexLocker locker(&m_mutex);
+        result.reserve(m_stats.size());
+        for (const QueryStats& s : m_stats) {
+            result.push_back(s);
+        }
+    }
+    for (QueryStats& s : result) {
+        s.sqlHash = hashSql(s.sql);
+    }
+    std::sort(result.begin(), result.end(), [](const QueryStats& a, const QueryStats& b) {
+        return a.totalUs() > b.totalUs();
+    });
+    return result;
+}
+
+std::vector<SlowQuery> QueryProfiler::slowQueries() const
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<SlowQuery> result;
+    const int n = int(m_slow.size());
+    result.reserve(n);
+    // m_slowNext is the oldest entry once the buffer has wrapped
+    for (int i = 1; i <= n; ++i) {
+        result.push_back(m_slow[(m_slowNext - i + n) % n]);
+    }
+    return result;
+}
+
+void QueryProfiler::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.clear();
+    m_slow.clear();
+    m_slowNext = 0;
+}
+
+void QueryProfiler::setSlowThresholdMs(int ms)
+{
+    m_slowThresholdUs.store(qint64(std::max(0, ms)) * 1000, std::memory_order_relaxed);
+}
+
+int QueryProfiler::slowCapacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_slowCapacity;
+}
+
+void QueryProfiler::setSlowCapacity(int capacity)
+{
+    QMutexLocker locker(&m_mutex);
+    m_slowCapacity = std::max(0, capacity);
+    m_slow.clear();
+    m_slowNext = 0;
+}
+
+QStringList QueryProfiler::explain(const SlowQuery& slow) const
+{
+    QStringList lines;
+    const QString sql = slow.sql.trimmed();
+    const QString verb = sql.section(' ', 0, 0).toUpper();
+    if (verb != "SELECT" && verb != "WITH") {
+        lines << QString("Only SELECT statements can be explained (got %1).").arg(verb);
+        return lines;
+    }
+
+    // Always explain on the main connection; worker connections are short-lived
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    const bool isSqlite = db.driverName() == "QSQLITE";
+    QSqlQuery query(db);
+    if (!query.prepare((isSqlite ? "EXPLAIN QUERY PLAN " : "EXPLAIN ") + sql)) {
+        lines << "Explain Error: " + query.lastError().text();
+        return lines;
+    }
+    for (int i = 0; i < slow.boundValues.size(); ++i) {
+        query.bindValue(i, slow.boundValues[i]);
+    }
+    if (!query.exec()) {
+        lines << "Explain Error: " + query.lastError().text();
+        return lines;
+    }
+
+    const QSqlRecord rec = query.record();
+    if (!isSqlite) {
+        QStringList header;
+        for (int c = 0; c < rec.count(); ++c) {
+            header << rec.fieldName(c);
+        }
+        lines << header.join(" | ");
+    }
+    while (query.next()) {
+        if (isSqlite) {
+            // Columns: id, parent, notused, detail
+            lines << QString("%1 %2").arg(QString(query.value(1).toInt() == 0 ? "" : "  "),
+                                          query.value(3).toString());
+        } else {
+            QStringList cells;
+            for (int c = 0; c < rec.count(); ++c) {
+                cells << query.value(c).toString();
+            }
+            lines << cells.join(" | ");
+        }
+    }
+    return lines;
+}
+
+ProfiledQuery::ProfiledQuery(const char* site)
+    : QSqlQuery(), m_site(site), m_connectionName(QSqlDatabase::defaultConnection)
+{
+}
+
+ProfiledQuery::ProfiledQuery(const QSqlDatabase& db, const char* site)
+    : QSqlQuery(db), m_site(site), m_connectionName(db.connectionName())
+{
+}
+
+ProfiledQuery::ProfiledQuery(const QString& sql, const char* site)
+    : ProfiledQuery(site)
+{
+    exec(sql);
+}
+
+ProfiledQuery::ProfiledQuery(const QString& sql, const QSqlDatabase& db, const char* site)
+    : ProfiledQuery(db, site)
+{
+    exec(sql);
+}
+
+ProfiledQuery::~ProfiledQuery()
+{
+    report();
+}
+
+void ProfiledQuery::begin(const QString& sql)
+{
+    report();
+    m_sql = sql;
+    m_prepareNs = 0;
+    m_execNs = 0;
+    m_fetchNs = 0;
+    m_rows = 0;
+    m_ok = true;
+    m_executed = false;
+}
+
+void ProfiledQuery::afterExec(bool ok, qint64 elapsedNs)
+{
+    m_execNs += elapsedNs;
+    m_ok = m_ok && ok;
+    m_pending = true;
+    m_executed = true;
+    if (ok && !isSelect()) {
+        m_rows = numRowsAffected();
+    }
+}
+
+QVariantList ProfiledQuery::positionalBoundValues() const
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return boundValues();
+#else
+    // Qt 5 returns a QMap keyed by placeholder name, which is not bind order
+    QVariantList values;
+    const int count = boundValues().size();
+    for (int i = 0; i < count; ++i) {
+        values << boundValue(i);
+    }
+    return values;
+#endif
+}
+
+void ProfiledQuery::report()
+{
+    if (!m_pending) {
+        return;
+    }
+    m_pending = false;
+    if (!m_executed && m_ok) {
+        return;  // Prepared but never run
+    }
+    QueryRecord entry;
+    entry.sql = m_sql;
+    entry.site = m_site;
+    entry.connectionName = m_connectionName;
+    entry.rows = m_rows;
+    entry.prepareUs = m_prepareNs / 1000;
+    entry.execUs = m_execNs / 1000;
+    entry.fetchUs = m_fetchNs / 1000;
+    entry.ok = m_ok;
+    if (entry.totalUs() >= QueryProfiler::instance().slowThresholdUs()) {
+        entry.boundValues = positionalBoundValues();  // Still bound until the next prepare
+        // The slow log is shown on the Diagnostics page: a statement that touches a
+        // password column keeps only the types of its values
+        static const QRegularExpression credentials("\\bpassword(_hash)?\\b",
+                                                    QRegularExpression::CaseInsensitiveOption);
+        if (m_sql.contains(credentials)) {
+            for (QVariant& value : entry.boundValues) {
+                value = QString("<redacted %1>").arg(QString::fromLatin1(value.isValid() ? value.typeName() : "null"));
+            }
+        }
+    }
+    QueryProfiler::instance().record(entry);
+}
+
+bool ProfiledQuery::prepare(const QString& sql)
+{
+    if (!QueryProfiler::enabled()) {
+        return QSqlQuery::prepare(sql);
+    }
+    begin(sql);
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = QSqlQuery::prepare(sql);
+    m_prepareNs = timer.nsecsElapsed();
+    m_ok = ok;
+    m_pending = true;
+    return ok;
+}
+
+bool ProfiledQuery::exec()
+{
+    if (!QueryProfiler::enabled()) {
+        return execGuarded(nullptr);
+    }
+    if (m_executed) {
+        // Re-executing a prepared statement: report the previous run first
+        const QString sql = m_sql;
+        begin(sql);
+    }
+    const qint64 startNs = Tracer::enabled() ? Tracer::instance().nowNs() : 0;
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = execGuarded(nullptr);
+    afterExec(ok, timer.nsecsElapsed());
+    if (Q_UNLIKELY(Tracer::enabled()) && m_site) {
+        Tracer::instance().complete("sql", m_site, startNs, Tracer::instance().nowNs());
+    }
+    return ok;
+}
+
+bool ProfiledQuery::exec(const QString& sql)
+{
+    if (!QueryProfiler::enabled()) {
+        return execGuarded(&sql);
+    }
+    begin(sql);
+    const qint64 startNs = Tracer::enabled() ? Tracer::instance().nowNs() : 0;
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = execGuarded(&sql);
+    afterExec(ok, timer.nsecsElapsed());
+    if (Q_UNLIKELY(Tracer::enabled()) && m_site) {
+        Tracer::instance().complete("sql", m_site, startNs, Tracer::instance().nowNs());
+    }
+    return ok;
+}
+
+bool ProfiledQuery::execGuarded(const QString* sql)
+{
+    ConnectionGuard& guard = ConnectionGuard::instance();
+    if (Q_UNLIKELY(guard.watching())) {
+        // A server with failures or a transaction that lost its connection
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+        if (guard.isTransactionBroken(m_connectionName) || !guard.allow(db)) {
+            return false;
+        }
+    }
+    const bool ok = sql ? QSqlQuery::exec(*sql) : QSqlQuery::exec();
+    if (Q_LIKELY(ok)) {
+        if (Q_UNLIKELY(guard.watching())) {
+            guard.recordSuccess(QSqlDatabase::database(m_connectionName, false));
+        }
+        return true;
+    }
+    const ConnectionGuard::Failure failure = ConnectionGuard::classify(lastError());
+    return failure != ConnectionGuard::Failure::None && retryAfter(failure, sql);
+}
+
+bool ProfiledQuery::retryAfter(ConnectionGuard::Failure failure, const QString* sql)
+{
+    ConnectionGuard& guard = ConnectionGuard::instance();
+    QSqlDatabase db = QSqlDatabase::database(m_connectionName, false);
+    const QString statement = sql ? *sql : lastQuery();
+    const bool inTransaction = guard.inTransaction(m_connectionName);
+    bool lost = failure == ConnectionGuard::Failure::ConnectionLost;
+
+    // Retry only what cannot have taken effect: a lost write may have run on
+    // the server, and a transaction cannot continue on a new session
+    const bool retryable = !inTransaction && (!lost || ConnectionGuard::isReadOnlyStatement(statement));
+    if (!retryable) {
+        if (lost) {
+            guard.markTransactionBroken(m_connectionName);
+            guard.reconnect(db);  // So the next operation starts on a live connection
+        }
+        return false;
+    }
+
+    const QVariantList values = positionalBoundValues();
+    const bool forwardOnly = isForwardOnly();
+    const bool mayBackOff = ConnectionGuard::canBackOff();
+    const int attempts = mayBackOff ? guard.policy().attempts : std::min(1, guard.policy().attempts);
+    bool ok = false;
+    for (int attempt = 1; attempt <= attempts && !ok; ++attempt) {
+        if (!guard.allow(db)) {
+            break;
+        }
+        if (mayBackOff) {
+            guard.backoff(attempt);
+        }
+        if (lost) {
+            if (!guard.reconnect(db)) {
+                continue;
+            }
+            // Statement handles died with the old session
+            if (!sql) {
+                setForwardOnly(forwardOnly);
+                if (!QSqlQuery::prepare(statement)) {
+                    continue;
+                }
+                for (int i = 0; i < values.size(); ++i) {
+                    bindValue(i, values.at(i));
+                }
+            }
+        }
+        ok = sql ? QSqlQuery::exec(*sql) : QSqlQuery::exec();
+        guard.countRetry(ok);
+        if (!ok) {
+            failure = ConnectionGuard::classify(lastError());
+            if (failure == ConnectionGuard::Failure::None) {
+                break;
+            }
+            lost = failure == ConnectionGuard::Failure::ConnectionLost;
+        }
+    }
+    if (!ok) {
+        qDebug() << "Retry Error:" << m_connectionName << "gave up after" << attempts << "attempts";
+    }
+    return ok;
+}
+
+bool ProfiledQuery::execBatch(QSqlQuery::BatchExecutionMode mode)
+{
+    if (!QueryProfiler::enabled()) {
+        return QSqlQuery::execBatch(mode);
+    }
+    if (m_executed) {
+        const QString sql = m_sql;
+        begin(sql);
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const bool ok = QSqlQuery::execBatch(mode);
+    afterExec(ok, timer.nsecsElapsed());
+    return ok;
+}
+
+bool ProfiledQuery::next()
+{
+    if (!m_executed) {
+        return QSqlQuery::next();
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const bool more = QSqlQuery::next();
+    m_fetchNs += timer.nsecsElapsed();
+    if (more) {
+        ++m_rows;
+    }
+    return more;
+}
+
+void ProfiledQuery::finish()
+{
+    report();
+    QSqlQuery::finish();
+}
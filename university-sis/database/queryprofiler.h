@@ -0,0 +1,165 @@
+#ifndef QUERYPROFILER_H
+#define QUERYPROFILER_H
+
+#include "connectionguard.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <atomic>
+#include <vector>
+
+// One executed statement, as reported by ProfiledQuery
+struct QueryRecord {
+    QString sql;
+    QVariantList boundValues;
+    const char* site = nullptr;   // Q_FUNC_INFO of the caller
+    QString connectionName;
+    int rows = -1;                // Rows fetched (SELECT) or affected (DML)
+    qint64 prepareUs = 0;
+    qint64 execUs = 0;
+    qint64 fetchUs = 0;
+    bool ok = true;
+
+    qint64 totalUs() const { return prepareUs + execUs + fetchUs; }
+};
+
+// Per-statement totals, keyed by the SQL text
+struct QueryStats {
+    quint64 sqlHash = 0;          // hashSql(sql), filled in by QueryProfiler::stats()
+    QString sql;
+    const char* site = nullptr;   // Last caller seen
+    quint64 calls = 0;
+    quint64 errors = 0;
+    quint64 rows = 0;
+    qint64 prepareUs = 0;
+    qint64 execUs = 0;
+    qint64 fetchUs = 0;
+    qint64 maxUs = 0;
+
+    qint64 totalUs() const { return prepareUs + execUs + fetchUs; }
+    double meanUs() const { return calls > 0 ? double(totalUs()) / double(calls) : 0.0; }
+};
+
+// A statement slower than the threshold, kept with its bind values for EXPLAIN.
+// Statements that mention a password column keep only "<redacted type>" placeholders.
+struct SlowQuery {
+    quint64 sqlHash = 0;
+    QString sql;
+    QVariantList boundValues;
+    QString site;
+    QString connectionName;
+    int rows = -1;
+    qint64 prepareUs = 0;
+    qint64 execUs = 0;
+    qint64 fetchUs = 0;
+    qint64 timestampMs = 0;       // Epoch ms
+
+    qint64 totalUs() const { return prepareUs + execUs + fetchUs; }
+};
+
+/**
+ * @brief Collects timings for every statement run through ProfiledQuery.
+ *
+ * Aggregates per SQL text and keeps the most recent statements above the
+ * slow threshold in a fixed-size ring buffer. Thread-safe; worker threads
+ * report through the same instance. Every statement only bumps its counters
+ * under the lock; hashing and bind value capture are left to slow statements.
+ */
+class QueryProfiler {
+public:
+    static QueryProfiler& instance();
+
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled);
+
+    void record(const QueryRecord& record);
+
+    std::vector<QueryStats> stats() const;        // Sorted by total time, descending
+    std::vector<SlowQuery> slowQueries() const;   // Newest first
+    void reset();
+
+    qint64 slowThresholdUs() const { return m_slowThresholdUs.load(std::memory_order_relaxed); }
+    void setSlowThresholdMs(int ms);
+    int slowCapacity() const;
+    void setSlowCapacity(int capacity);
+
+    // EXPLAIN QUERY PLAN (SQLite) / EXPLAIN (MySQL) for a captured statement.
+    // Only SELECT/WITH statements are explained; others return an explanation line.
+    QStringList explain(const SlowQuery& query) const;
+
+    static quint64 hashSql(const QString& sql);
+
+    static constexpr int DefaultSlowThresholdMs = 50;
+    static constexpr int DefaultSlowCapacity = 200;
+
+private:
+    QueryProfiler();
+    QueryProfiler(const QueryProfiler&) = delete;
+    QueryProfiler& operator=(const QueryProfiler&) = delete;
+
+    static inline std::atomic<bool> s_enabled{true};
+
+    std::atomic<qint64> m_slowThresholdUs{qint64(DefaultSlowThresholdMs) * 1000};
+    mutable QMutex m_mutex;
+    QHash<QString, QueryStats> m_stats;
+    std::vector<SlowQuery> m_slow;  // Ring buffer
+    int m_slowCapacity = DefaultSlowCapacity;
+    int m_slowNext = 0;
+};
+
+/**
+ * @brief QSqlQuery that reports prepare/exec/fetch times, row counts and the
+ * calling site to QueryProfiler.
+ *
+ * Drop-in for the repositories: declare it instead of QSqlQuery and pass
+ * SIS_QUERY_SITE last. A statement is reported when the query is re-executed,
+ * re-prepared, finished or destroyed. Calls made through a QSqlQuery& are not
+ * timed. exec() failures caused by a lost connection or a lock go to
+ * ConnectionGuard, which may reconnect and run the statement again.
+ */
+class ProfiledQuery : public QSqlQuery {
+public:
+    explicit ProfiledQuery(const char* site);
+    ProfiledQuery(const QSqlDatabase& db, const char* site);
+    ProfiledQuery(const QString& sql, const char* site);                        // Executes sql
+    ProfiledQuery(const QString& sql, const QSqlDatabase& db, const char* site); // Executes sql
+    ~ProfiledQuery();
+
+    ProfiledQuery(const ProfiledQuery&) = delete;
+    ProfiledQuery& operator=(const ProfiledQuery&) = delete;
+
+    bool prepare(const QString& sql);
+    bool exec();
+    bool exec(const QString& sql);
+    bool execBatch(QSqlQuery::BatchExecutionMode mode = QSqlQuery::ValuesAsRows);
+    bool next();
+    void finish();
+
+private:
+    bool execGuarded(const QString* sql);  // Runs the statement through ConnectionGuard
+    bool retryAfter(ConnectionGuard::Failure failure, const QString* sql);
+    QVariantList positionalBoundValues() const;
+    void report();
+    void begin(const QString& sql);
+    void afterExec(bool ok, qint64 elapsedNs);
+
+    const char* m_site = nullptr;
+    QString m_sql;
+    QString m_connectionName;
+    qint64 m_prepareNs = 0;
+    qint64 m_execNs = 0;
+    qint64 m_fetchNs = 0;
+    int m_rows = 0;
+    bool m_ok = true;
+    bool m_pending = false;   // Something to report
+    bool m_executed = false;  // exec ran since the last prepare
+};
+
+#define SIS_QUERY_SITE Q_FUNC_INFO
+
+#endif // QUERYPROFILER_H
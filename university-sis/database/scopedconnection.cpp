@@ -0,0 +1,56 @@
+#include "scopedconnection.h"
+#include "databasemanager.h"
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QSqlError>
+#include <QDebug>
+
+namespace {
+QAtomicInt s_connectionCounter;
+
+// Caps concurrent worker connections at [database] worker_connections; nullptr = unlimited
+QSemaphore* workerSlots()
+{
+    static QSemaphore* available = []() -> QSemaphore* {
+        const int limit = DatabaseManager::instance().config().workerConnections;
+        return limit > 0 ? new QSemaphore(limit) : nullptr;
+    }();
+    return available;
+}
+}
+
+ScopedConnection::ScopedConnection(DbAccess access)
+{
+    if (QSemaphore* available = workerSlots()) {
+        const int waitMs = DatabaseManager::instance().config().connectTimeoutSeconds * 1000;
+        if (!available->tryAcquire(1, waitMs)) {
+            qDebug() << "ScopedConnection: no free worker connection after" << waitMs << "ms";
+            return;
+        }
+        m_holdsSlot = true;
+    }
+    const QString source = DatabaseManager::instance().getDatabase(access).connectionName();
+    const QString name = QString("sis_worker_%1").arg(s_connectionCounter.fetchAndAddRelaxed(1));
+    m_db = QSqlDatabase::cloneDatabase(source, name);
+    if (!m_db.open()) {
+        qDebug() << "ScopedConnection: failed to open" << name << ":" << m_db.lastError().text();
+        return;
+    }
+    if (m_db.driverName() == "QSQLITE") {
+        DatabaseManager::instance().sqliteProfile().apply(m_db);
+    }
+}
+
+ScopedConnection::~ScopedConnection()
+{
+    if (m_db.isValid()) {
+        const QString name = m_db.connectionName();
+        m_db.close();
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+    // Last, so a waiting worker cannot open its connection while this one is still alive
+    if (m_holdsSlot) {
+        workerSlots()->release();
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef SCOPEDCONNECTION_H
+#define SCOPEDCONNECTION_H
+
+#include "databasemanager.h"
+#include <QSqlDatabase>
+#include <QString>
+
+/**
+ * @brief Private database connection for worker threads.
+ *
+ * QSqlDatabase connections may only be used from the thread that opened them,
+ * so background jobs clone the main connection's settings, open the clone on
+ * their own thread and remove it again when the scope ends. Declare it before
+ * any QSqlQuery that uses it so the queries are destroyed first. At most
+ * DatabaseConfig::workerConnections clones are open at once; the rest wait.
+ */
+class ScopedConnection {
+public:
+    // ReadOnly clones the read connection when DatabaseManager routes reads
+    explicit ScopedConnection(DbAccess access = DbAccess::ReadWrite);
+    ~ScopedConnection();
+
+    ScopedConnection(const ScopedConnection&) = delete;
+    ScopedConnection& operator=(const ScopedConnection&) = delete;
+
+    bool isOpen() const { return m_db.isOpen(); }
+    QSqlDatabase database() const { return m_db; }
+
+private:
+    QSqlDatabase m_db;
+    bool m_holdsSlot = false;
+};
+
+#endif // SCOPEDCONNECTION_H
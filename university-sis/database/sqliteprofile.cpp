@@ -0,0 +1,74 @@
+#include "sqliteprofile.h"
+#include "../utils/tracer.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QStringList>
+#include <QDebug>
+
+SqliteProfile SqliteProfile::tuned()
+{
+    return SqliteProfile();
+}
+
+SqliteProfile SqliteProfile::sqliteDefaults()
+{
+    SqliteProfile profile;
+    profile.name = "default";
+    profile.journalMode = "DELETE";
+    profile.synchronous = "FULL";
+    profile.mmapSizeBytes = 0;
+    profile.cacheSizeKib = 2000;
+    profile.tempStore = "DEFAULT";
+    profile.maintenanceIntervalMinutes = 0;
+    return profile;
+}
+
+std::optional<SqliteProfile> SqliteProfile::fromName(const QString& name)
+{
+    if (name == "tuned") {
+        return tuned();
+    }
+    if (name == "default") {
+        return sqliteDefaults();
+    }
+    return std::nullopt;
+}
+
+bool SqliteProfile::apply(const QSqlDatabase& db) const
+{
+    SIS_TRACE_SCOPE("db", "SqliteProfile::apply");
+    const QStringList pragmas = {
+        QString("PRAGMA journal_mode = %1").arg(journalMode),
+        QString("PRAGMA synchronous = %1").arg(synchronous),
+        QString("PRAGMA mmap_size = %1").arg(mmapSizeBytes),
+        QString("PRAGMA cache_size = -%1").arg(cacheSizeKib),  // Negative: KiB rather than pages
+        QString("PRAGMA temp_store = %1").arg(tempStore),
+        QString("PRAGMA foreign_keys = %1").arg(foreignKeys ? "ON" : "OFF"),
+    };
+
+    QSqlQuery query(db);
+    bool ok = true;
+    for (const QString& pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            qDebug() << "SQLite Profile Error:" << pragma << query.lastError().text();
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool SqliteProfile::runMaintenance(const QSqlDatabase& db)
+{
+    SIS_TRACE_SCOPE("db", "SqliteProfile::runMaintenance");
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA optimize")) {
+        qDebug() << "SQLite Maintenance Error:" << query.lastError().text();
+        return false;
+    }
+    // Returns (busy, wal pages, checkpointed pages); a no-op outside WAL mode
+    if (!query.exec("PRAGMA wal_checkpoint(PASSIVE)")) {
+        qDebug() << "SQLite Maintenance Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef SQLITEPROFILE_H
+#define SQLITEPROFILE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <optional>
+
+/**
+ * @brief Connection pragmas for the SQLite fallback.
+ *
+ * journal_mode is stored in the database file; the other settings are per
+ * connection, so the profile is applied to the main connection and to every
+ * ScopedConnection clone. WAL lets worker threads read while another
+ * connection writes.
+ */
+struct SqliteProfile {
+    QString name = "tuned";
+    QString journalMode = "WAL";
+    QString synchronous = "NORMAL";       // Durable across application crashes; a power loss may drop the last commits
+    qint64 mmapSizeBytes = 256ll * 1024 * 1024;
+    int cacheSizeKib = 32 * 1024;         // Per connection
+    QString tempStore = "MEMORY";
+    bool foreignKeys = true;
+    int maintenanceIntervalMinutes = 60;  // PRAGMA optimize + WAL checkpoint; 0 = only at shutdown
+
+    static SqliteProfile tuned();
+    // SQLite's own defaults (rollback journal, synchronous=FULL), foreign keys still on
+    static SqliteProfile sqliteDefaults();
+    // "tuned" or "default"; std::nullopt for anything else
+    static std::optional<SqliteProfile> fromName(const QString& name);
+
+    bool apply(const QSqlDatabase& db) const;
+
+    // PRAGMA optimize, then a passive checkpoint so the -wal file does not keep growing
+    static bool runMaintenance(const QSqlDatabase& db);
+};
+
+#endif // SQLITEPROFILE_H
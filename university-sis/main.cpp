@@ -1,21 +1,35 @@
 #include "mainwindow.h"
 #include "database/databasemanager.h"
 #include "modules/student/studentrepository.h"
+#include "modules/faculty/facultyrepository.h"
+#include "modules/facility/facilityrepository.h"
+#include "utils/memoryusage.h"
+#include "utils/stringpool.h"
+#include "utils/startuptimer.h"
+#include "utils/tracer.h"
 #include <QApplication>
 #include <QLocale>
 #include <QTranslator>
 #include <QDebug>
 #include <QMessageBox>
+#include <QElapsedTimer>
+#include <QTimer>
 
-void runDatabaseSelfTest() {
+// Opt-in diagnostics (--selftest): exercises the database round trip and reports
+// per-step latency. Writes a throwaway student, so it never runs on a normal launch.
+bool runDatabaseSelfTest() {
     qDebug() << "=== Running Database Self-Test ===";
+    bool ok = true;
+    QElapsedTimer step;
+    auto ms = [&step]() { return QString("(%1 ms)").arg(step.nsecsElapsed() / 1e6, 0, 'f', 2); };
     
     // 1. Connection Test
+    step.start();
     if (!DatabaseManager::instance().connect()) {
-        qCritical() << "FAIL: Could not connect to database.";
-        return;
+        qCritical() << "FAIL: Could not connect to database." << ms();
+        return false;
     }
-    qDebug() << "PASS: Database connected.";
+    qDebug() << "PASS: Database connected." << ms();
     qDebug() << "Driver:" << DatabaseManager::instance().getDatabase().driverName();
 
     // 2. Write Test (Add Student)
@@ -26,13 +40,16 @@ void runDatabaseSelfTest() {
     testStudent.department = "CS_TEST";
     testStudent.sectionId = 101;
     
+    step.start();
     if (repo.addStudent(testStudent)) {
-        qDebug() << "PASS: Successfully added test student.";
+        qDebug() << "PASS: Successfully added test student." << ms();
     } else {
-        qCritical() << "FAIL: Failed to add test student.";
+        qCritical() << "FAIL: Failed to add test student." << ms();
+        ok = false;
     }
 
     // 3. Read Test
+    step.start();
     auto students = repo.getAllStudents();
     bool found = false;
     int testId = -1;
@@ -45,24 +62,90 @@ void runDatabaseSelfTest() {
     }
 
     if (found) {
-        qDebug() << "PASS: Successfully retrieved test student. ID:" << testId;
+        qDebug() << "PASS: Successfully retrieved test student. ID:" << testId << ms();
         
         // 4. Delete Test (Cleanup)
+        step.start();
         if (repo.deleteStudent(testId)) {
-            qDebug() << "PASS: Cleanup (delete) successful.";
+            qDebug() << "PASS: Cleanup (delete) successful." << ms();
         } else {
-            qWarning() << "WARN: Cleanup failed.";
+            qWarning() << "WARN: Cleanup failed." << ms();
         }
     } else {
-        qCritical() << "FAIL: Could not find the added test student.";
+        qCritical() << "FAIL: Could not find the added test student." << ms();
+        ok = false;
+    }
+
+    // 5. Memory footprint: full entities vs compact (interned) variants
+    {
+        FacultyRepository facultyRepo;
+        FacilityRepository facilityRepo;
+
+        step.start();
+        const qint64 before = currentRssBytes();
+        auto fullStudents = repo.getAllStudents();
+        auto fullFaculty = facultyRepo.getAllFaculty();
+        auto fullRooms = facilityRepo.getAllRooms();
+        // The loaders already pool these fields; give each row its own copy, as
+        // it had before interning, so the baseline is the unpooled layout
+        auto unpooled = [](QString& value) { value = QString(value.constData(), value.size()); };
+        for (auto& s : fullStudents) {
+            unpooled(s.department);
+        }
+        for (auto& f : fullFaculty) {
+            unpooled(f.department);
+            unpooled(f.position);
+        }
+        for (auto& r : fullRooms) {
+            unpooled(r.type);
+        }
+        const qint64 afterFull = currentRssBytes();
+        auto compactStudents = repo.getAllStudentsCompact();
+        auto compactFaculty = facultyRepo.getAllFacultyCompact();
+        auto compactRooms = facilityRepo.getAllRoomsCompact();
+        const qint64 afterCompact = currentRssBytes();
+
+        if (before >= 0 && compactStudents.size() == fullStudents.size()) {
+            qDebug() << "INFO: Loaded" << fullStudents.size() << "students," << fullFaculty.size() << "faculty,"
+                     << fullRooms.size() << "rooms. RSS delta full (unpooled):" << (afterFull - before) / 1024 << "KiB,"
+                     << "compact:" << (afterCompact - afterFull) / 1024 << "KiB,"
+                     << "pooled strings:" << StringPool::instance().size() << ms();
+        }
     }
     
-    qDebug() << "=== Self-Test Complete ===";
+    qDebug() << "=== Self-Test Complete ===" << (ok ? "PASS" : "FAIL");
+    return ok;
 }
 
 int main(int argc, char *argv[])
 {
+    StartupTimer& startup = StartupTimer::instance();
+    startup.start();
+
     QApplication a(argc, argv);
+    startup.mark("QApplication");
+
+    // Tracing: --trace <file.json> or SIS_TRACE=<file.json>
+    QString tracePath = qEnvironmentVariable("SIS_TRACE");
+    const int traceArg = a.arguments().indexOf("--trace");
+    if (traceArg > 0 && traceArg + 1 < a.arguments().size()) {
+        tracePath = a.arguments().at(traceArg + 1);
+    }
+    if (!tracePath.isEmpty()) {
+        Tracer::instance().start(tracePath);
+    }
+
+    // Database settings: --config <file.ini>, else SIS_CONFIG or university-sis.ini beside the executable
+    const int configArg = a.arguments().indexOf("--config");
+    if (configArg > 0 && configArg + 1 < a.arguments().size()) {
+        DatabaseManager::instance().setConfig(DatabaseConfig::load(a.arguments().at(configArg + 1)));
+    }
+
+    if (a.arguments().contains("--selftest")) {
+        const bool ok = runDatabaseSelfTest();
+        Tracer::instance().finish();
+        return ok ? 0 : 1;
+    }
 
     QTranslator translator;
     const QStringList uiLanguages = QLocale::system().uiLanguages();
@@ -73,11 +156,23 @@ int main(int argc, char *argv[])
             break;
         }
     }
+    startup.mark("translations");
 
-    // Run the DB check
-    runDatabaseSelfTest();
+    // The login dialog needs the schema, so connect before MainWindow
+    if (!DatabaseManager::instance().connect()) {
+        qCritical() << "Could not connect to database.";
+    }
+    startup.mark("database connect + schema");
 
     MainWindow w;
     w.show();
-    return a.exec();
+    startup.mark("show");
+
+    // Runs once the event loop has processed the initial expose/paint
+    QTimer::singleShot(0, &w, []() {
+        StartupTimer::instance().finish("first frame");
+    });
+    const int rc = a.exec();
+    Tracer::instance().finish();
+    return rc;
 }
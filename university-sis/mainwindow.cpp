@@ -1,5 +1,6 @@
 #include "mainwindow.h"
 #include "database/databasemanager.h"
+#include "database/queryprofiler.h"
 #include "ui/studentportal.h"
 #include "ui/academic/academicsystem.h"
 #include "ui/finance/financesystem.h"
@@ -14,7 +15,12 @@
 #include "ui/calendar/calendarsystem.h"
 #include "ui/grades/gradessystem.h"
 #include "ui/reports/reportssystem.h"
+#include "ui/diagnostics/diagnosticssystem.h"
+#include "ui/pageregistry.h"
+#include "modules/finance/payment.h"
+#include "modules/session/sessiondataservice.h"
 #include "utils/thememanager.h"
+#include "utils/startuptimer.h"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QGridLayout>
@@ -27,6 +33,8 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QDebug>
 
 #include <QGraphicsDropShadowEffect>
 
@@ -35,6 +43,10 @@ class DashboardWidget : public QWidget {
 public:
     explicit DashboardWidget(const QString& role, QWidget* parent = nullptr) : QWidget(parent), m_role(role) {
         setupDashboard();
+        // Student cards come from the session prefetch, which usually lands after construction
+        connect(&SessionDataService::instance(), &SessionDataService::loaded, this, [this](bool) {
+            refreshDashboard();
+        });
     }
     
     void refreshDashboard() {
@@ -106,7 +118,10 @@ private:
             refreshBtn->setText("⏳ Loading...");
             QApplication::processEvents(); // Update UI immediately
             
-            // Refresh dashboard
+            // Refresh dashboard (students: re-run the session prefetch, which redraws when done)
+            if (SessionDataService::instance().isStudentSession()) {
+                SessionDataService::instance().refresh();
+            }
             refreshDashboard();
             
             // Re-enable button after refresh
@@ -154,8 +169,28 @@ private:
             return card;
         };
         
-        // Query real data from database
-        QSqlQuery query(DatabaseManager::instance().getDatabase());
+        // Students see their own numbers from the session prefetch
+        SessionDataService& session = SessionDataService::instance();
+        if (session.isStudentSession()) {
+            auto data = session.snapshot();
+            const QString waiting = session.isPending() ? "..." : "N/A";
+            statsLayout->addWidget(createStatCard("Enrolled Sections",
+                data ? QString::number(data->enrollments.size()) : waiting), 0, 0);
+            statsLayout->addWidget(createStatCard("Graded Courses",
+                data ? QString::number(data->grades.size()) : waiting), 0, 1);
+            statsLayout->addWidget(createStatCard("Attendance",
+                data && data->attendance.total() > 0 ? QString::number(data->attendance.rate(), 'f', 0) + "%" : (data ? "N/A" : waiting)), 0, 2);
+            statsLayout->addWidget(createStatCard("Balance Due",
+                data ? "$" + QString::number(data->balanceDue, 'f', 2) : waiting), 1, 0);
+            statsLayout->addWidget(createStatCard("Total Paid",
+                data ? "$" + QString::number(data->totalPaid, 'f', 2) : waiting), 1, 1);
+            mainLayout->addLayout(statsLayout);
+            mainLayout->addStretch();
+            return;
+        }
+        
+        // Query real data from database; counts may come from the read replica
+        ProfiledQuery query(DatabaseManager::instance().getDatabase(DbAccess::ReadOnly), SIS_QUERY_SITE);
         
         // Total Courses
         int totalCourses = 0;
@@ -191,7 +226,8 @@ private:
         
         // Total Revenue (sum of payments)
         double totalRevenue = 0.0;
-        if (query.exec("SELECT COALESCE(SUM(amount), 0) FROM payments WHERE status = 'Paid'")) {
+        if (query.exec(QString("SELECT COALESCE(SUM(amount), 0) FROM payments WHERE status_id = %1")
+                           .arg(int(PaymentStatus::Paid)))) {
             if (query.next()) {
                 totalRevenue = query.value(0).toDouble();
             }
@@ -234,13 +270,16 @@ MainWindow::MainWindow(QWidget *parent)
 
     // Show Login Screen First
     LoginDialog login;
+    StartupTimer::instance().mark("theme + login dialog setup");
     if (login.exec() != QDialog::Accepted) {
         QTimer::singleShot(0, this, &MainWindow::close);
         return;
     }
+    StartupTimer::instance().mark("login", true);
     
     // Capture Session
     auto session = login.getSession();
+    SessionDataService::instance().start(session.role, session.userId);
     
     // Connect to database
     if (!DatabaseManager::instance().connect()) {
@@ -254,6 +293,7 @@ MainWindow::MainWindow(QWidget *parent)
     // Set window properties
     setWindowTitle("University SIS - " + session.role + " Dashboard");
     resize(1280, 850);
+    StartupTimer::instance().mark("main window setup");
 }
 
 MainWindow::~MainWindow()
@@ -262,6 +302,9 @@ MainWindow::~MainWindow()
 
 void MainWindow::setupUi(const QString& username, const QString& role, int userId)
 {
+    QElapsedTimer uiTimer;
+    uiTimer.start();
+    
     // Cleanup if re-initializing (Logout/Login cycle)
     if (centralWidget()) {
         delete centralWidget();
@@ -345,7 +388,12 @@ void MainWindow::setupUi(const QString& username, const QString& role, int userI
     // 12. News (All)
     new QListWidgetItem("News & Info", m_sidebar);
     
-    // 13. Profile (Bottom)
+    // 13. Query diagnostics (Admin)
+    if (isAdmin) {
+        new QListWidgetItem("Diagnostics", m_sidebar);
+    }
+    
+    // 14. Profile (Bottom)
     auto profileItem = new QListWidgetItem("My Profile", m_sidebar);
     
     sidebarLayout->addWidget(m_sidebar);
@@ -382,102 +430,118 @@ void MainWindow::setupUi(const QString& username, const QString& role, int userI
 
 
     
-    // Initialize Modules
-    // BETTER APPROACH: Add ALL pages to stack, and sidebar click maps to specific index or finding by name.
-    // For simplicity in this demo, we will add ALL potential widgets to the stack, 
-    // and the sidebar `currentRowChanged` might need mapping if indices don't align perfectly.
-    // However, simplest is to just add them in a fixed known order and map menu items to them.
-    
-    // To ensure correct navigation, we'll store widgets in a map or just add them all 
-    // and rely on the fact that sidebar items match the order we add them IF we add them dynamically.
-    // But here we're mixing dynamic sidebar with static stack. 
-    // FIX: We will just add the widgets blindly to the stack, and use `userData` in list items to store the index.
-    
-    // Helper to add module
-    auto addModule = [&](QWidget* w, QString name) {
-        m_contentArea->addWidget(w);
-        // Find the item with this text and set UserData to the index
+    // Modules are registered with a factory and built on first navigation (or by the
+    // idle warm-up below), so reaching the dashboard costs the same however many exist.
+    // Sidebar items carry their page id in Qt::UserRole; the dashboard has none.
+    m_pages = new PageRegistry(m_contentArea);
+    auto addModule = [&](const QString& name, PageRegistry::Factory factory) -> int {
         auto items = m_sidebar->findItems(name, Qt::MatchContains);
-        if (!items.isEmpty()) {
-            items.first()->setData(Qt::UserRole, m_contentArea->count() - 1);
+        if (items.isEmpty()) {
+            return -1; // Not in this role's menu
         }
+        const int id = m_pages->add(name, std::move(factory));
+        items.first()->setData(Qt::UserRole, id);
+        return id;
     };
     
-    auto studentPortal = new StudentPortal(this);
-    studentPortal->setUserContext(role, userId);
-    // Connect student changes to dashboard refresh
-    connect(studentPortal, &StudentPortal::dataChanged, this, [this]() {
-        if (m_dashboardWidget) {
-            m_dashboardWidget->refreshDashboard();
-        }
+    const int studentPortalPage = addModule("Student Portal", [this, role, userId]() {
+        auto studentPortal = new StudentPortal(this);
+        studentPortal->setUserContext(role, userId);
+        // Connect student changes to dashboard refresh
+        connect(studentPortal, &StudentPortal::dataChanged, this, [this]() {
+            if (m_dashboardWidget) {
+                m_dashboardWidget->refreshDashboard();
+            }
+        });
+        return studentPortal;
     });
-    addModule(studentPortal, "Student Portal");
-    addModule(new AcademicSystem(this), "Academic System");
-    auto enrollmentSys = new EnrollmentSystem(this);
-    enrollmentSys->setUserContext(role, userId);
-    addModule(enrollmentSys, "Enrollment");
-
-    addModule(new AttendanceSystem(this), "Attendance");
+    const int academicPage = addModule("Academic System", [this]() { return new AcademicSystem(this); });
+    const int enrollmentPage = addModule("Enrollment", [this, role, userId]() {
+        auto enrollmentSys = new EnrollmentSystem(this);
+        enrollmentSys->setUserContext(role, userId);
+        return enrollmentSys;
+    });
+    const int attendancePage = addModule("Attendance", [this]() { return new AttendanceSystem(this); });
     
     // Calendar System
-    addModule(new CalendarSystem(this), "Calendar");
+    addModule("Calendar", [this]() { return new CalendarSystem(this); });
     
     // Grades System
-    auto gradesSys = new GradesSystem(this);
-    gradesSys->setUserContext(role, userId);
-    addModule(gradesSys, "Grades");
+    const int gradesPage = addModule("Grades", [this, role, userId]() {
+        auto gradesSys = new GradesSystem(this);
+        gradesSys->setUserContext(role, userId);
+        return gradesSys;
+    });
     
-    addModule(new FinanceSystem(this), "Payment");
-    addModule(new FacultySystem(this), "Faculty");
-    addModule(new FacilitySystem(this), "Facilities");
+    const int financePage = addModule("Payment", [this]() { return new FinanceSystem(this); });
+    addModule("Faculty", [this]() { return new FacultySystem(this); });
+    addModule("Facilities", [this]() { return new FacilitySystem(this); });
     
     // Library System
-    auto librarySystem = new LibrarySystem(this);
-    librarySystem->setUserContext(role, userId);
-    addModule(librarySystem, "Library System");
+    addModule("Library System", [this, role, userId]() {
+        auto librarySystem = new LibrarySystem(this);
+        librarySystem->setUserContext(role, userId);
+        return librarySystem;
+    });
     
     // Reports System
-    if (isAdmin || isFaculty) {
-        addModule(new ReportsSystem(this), "Reports");
-    }
+    addModule("Reports", [this]() { return new ReportsSystem(this); });
     
     // News & Info
-    auto newsSystem = new NewsSystem(this);
-    addModule(newsSystem, "News & Info");
+    const int newsPage = addModule("News & Info", [this]() { return new NewsSystem(this); });
+
+    // Diagnostics
+    addModule("Diagnostics", [this]() { return new DiagnosticsSystem(this); });
 
     // Profile
-    auto profileWidget = new ProfileWidget(username, role, this);
-    addModule(profileWidget, "Profile");
-    
-    connect(profileWidget, &ProfileWidget::logoutRequested, this, &MainWindow::logout);
+    addModule("Profile", [this, username, role]() {
+        auto profileWidget = new ProfileWidget(username, role, this);
+        connect(profileWidget, &ProfileWidget::logoutRequested, this, &MainWindow::logout);
+        return profileWidget;
+    });
 
     mainLayout->addWidget(sidebarWidget);
     mainLayout->addWidget(m_contentArea);
 
-    connect(m_sidebar, &QListWidget::itemClicked, this, [this, newsSystem](QListWidgetItem* item){
-        int index = item->data(Qt::UserRole).toInt();
-        // If index is 0 but it's not the dashboard (dashboard has no user data set, so it defaults to 0), 
-        // we need to be careful. Dashboard item wasn't processed by addModule.
-        // Let's fix Dashboard logic:
-        if (item->text().contains("Dashboard")) {
-             // Refresh dashboard when switching to it
+    connect(m_sidebar, &QListWidget::itemClicked, this, [this, newsPage](QListWidgetItem* item){
+        const QVariant pageId = item->data(Qt::UserRole);
+        if (!pageId.isValid()) {
+             // Dashboard: refresh when switching to it
              if (m_dashboardWidget) {
                  m_dashboardWidget->refreshDashboard();
              }
              m_contentArea->setCurrentIndex(0);
-        } else if (item->text() == "News & Info") {
-             // Refresh news when switching to it to show latest calendar events
-             newsSystem->refreshNews();
-             m_contentArea->setCurrentIndex(index);
-        } else if (index > 0) {
-             m_contentArea->setCurrentIndex(index);
+             return;
+        }
+        const int id = pageId.toInt();
+        if (id == newsPage) {
+             // Refresh news when switching back to it to show latest calendar events
+             if (auto news = qobject_cast<NewsSystem*>(m_pages->createdPage(id))) {
+                 news->refreshNews();
+             }
         }
+        m_pages->show(id);
     });
 
+    // Pre-build the pages this role most likely opens next while the UI is idle
+    QList<int> likelyPages;
+    if (isStudent) {
+        likelyPages = {enrollmentPage, gradesPage};
+    } else if (isFaculty) {
+        likelyPages = {attendancePage, gradesPage};
+    } else if (isFinance) {
+        likelyPages = {financePage};
+    } else if (isAdmin) {
+        likelyPages = {studentPortalPage, academicPage};
+    }
+    likelyPages.removeAll(-1);
+    m_pages->warmUp(likelyPages);
+
     connect(m_themeBtn, &QPushButton::clicked, this, &MainWindow::onToggleTheme);
     
     // Set default
     m_sidebar->setCurrentRow(0);
+    qDebug() << "Main window ready in" << uiTimer.elapsed() << "ms with" << m_pages->count() << "lazy modules";
 }
 
 void MainWindow::onMenuChanged(int index)
@@ -503,8 +567,10 @@ void MainWindow::logout()
     // DatabaseManager::instance().close(); // Optional
     
     LoginDialog login;
+    SessionDataService::instance().clear();
     if (login.exec() == QDialog::Accepted) {
         auto session = login.getSession();
+        SessionDataService::instance().start(session.role, session.userId);
         
         // Re-connect / Verify DB
         if (!DatabaseManager::instance().isOpen()) {
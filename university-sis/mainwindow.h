@@ -26,5 +26,6 @@ private:
     QStackedWidget *m_contentArea;
     class QPushButton* m_themeBtn; // Forward declaration
     class DashboardWidget* m_dashboardWidget; // Forward declaration for dashboard
+    class PageRegistry* m_pages = nullptr; // Lazily built module pages; owned by m_contentArea
 };
 #endif // MAINWINDOW_H
@@ -1,15 +1,26 @@
 #include "courserepository.h"
+#include "../../utils/tracer.h"
 #include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
 #include <QDebug>
 
+namespace {
+EntityCache<Course>& courseCache()
+{
+    static EntityCache<Course> cache("courses");
+    return cache;
+}
+}
+
 CourseRepository::CourseRepository() {}
 
 bool CourseRepository::addCourse(const Course& course) {
+    SIS_TRACE_SCOPE("db", "CourseRepository::addCourse");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("INSERT INTO courses (name, year, hours) VALUES (:name, :year, :hours)");
     query.bindValue(":name", course.name);
     query.bindValue(":year", course.year);
@@ -19,12 +30,14 @@ bool CourseRepository::addCourse(const Course& course) {
         qDebug() << "Add Course Error:" << query.lastError().text();
         return false;
     }
+    courseCache().invalidate();
     return true;
 }
 
 bool CourseRepository::updateCourse(const Course& course) {
+    SIS_TRACE_SCOPE("db", "CourseRepository::updateCourse");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("UPDATE courses SET name=:name, year=:year, hours=:hours WHERE course_id=:id");
     query.bindValue(":name", course.name);
     query.bindValue(":year", course.year);
@@ -35,12 +48,14 @@ bool CourseRepository::updateCourse(const Course& course) {
         qDebug() << "Update Course Error:" << query.lastError().text();
         return false;
     }
+    courseCache().invalidate();
     return true;
 }
 
 bool CourseRepository::deleteCourse(int id) {
+    SIS_TRACE_SCOPE("db", "CourseRepository::deleteCourse");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("DELETE FROM courses WHERE course_id = :id");
     query.bindValue(":id", id);
     
@@ -48,13 +63,37 @@ bool CourseRepository::deleteCourse(int id) {
         qDebug() << "Delete Course Error:" << query.lastError().text();
         return false;
     }
+    courseCache().invalidate();
     return true;
 }
 
 std::vector<Course> CourseRepository::getAllCourses() {
+    SIS_TRACE_SCOPE("db", "CourseRepository::getAllCourses");
+    return courseCache().getAll(&CourseRepository::loadAllCourses);
+}
+
+std::optional<Course> CourseRepository::getCourseById(int id) {
+    SIS_TRACE_SCOPE("db", "CourseRepository::getCourseById");
+    return courseCache().get(id, [id]() { return loadCourseById(id); });
+}
+
+EntityCacheStats CourseRepository::cacheStats() {
+    return courseCache().stats();
+}
+
+void CourseRepository::invalidateCache() {
+    courseCache().invalidate();
+}
+
+std::optional<std::vector<Course>> CourseRepository::loadAllCourses() {
+    SIS_TRACE_SCOPE("db", "CourseRepository::loadAllCourses");
     std::vector<Course> courses;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query("SELECT course_id, name, year, hours FROM courses", db);
+    ProfiledQuery query("SELECT course_id, name, year, hours FROM courses", db, SIS_QUERY_SITE);
+    if (!query.isActive()) {
+        qDebug() << "Load Courses Error:" << query.lastError().text();
+        return std::nullopt;
+    }
     
     while (query.next()) {
         Course c;
@@ -67,9 +106,10 @@ std::vector<Course> CourseRepository::getAllCourses() {
     return courses;
 }
 
-std::optional<Course> CourseRepository::getCourseById(int id) {
+std::optional<Course> CourseRepository::loadCourseById(int id) {
+    SIS_TRACE_SCOPE("db", "CourseRepository::loadCourseById");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("SELECT course_id, name, year, hours FROM courses WHERE course_id = :id");
     query.bindValue(":id", id);
     
@@ -2,6 +2,7 @@
 #define COURSEREPOSITORY_H
 
 #include "course.h"
+#include "../../utils/entitycache.h"
 #include <vector>
 #include <optional>
 
@@ -15,6 +16,14 @@ public:
     
     std::vector<Course> getAllCourses();
     std::optional<Course> getCourseById(int id);
+
+    // Shared read-through cache, invalidated by every write above
+    static EntityCacheStats cacheStats();
+    static void invalidateCache();
+
+private:
+    static std::optional<std::vector<Course>> loadAllCourses();
+    static std::optional<Course> loadCourseById(int id);
 };
 
 #endif // COURSEREPOSITORY_H
@@ -1,14 +1,27 @@
 #include "sectionrepository.h"
+#include "../../utils/tracer.h"
 #include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "../enrollment/enrollmentvalidator.h"
+#include "../enrollment/waitlistmanager.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 
+namespace {
+EntityCache<Section>& sectionCache()
+{
+    static EntityCache<Section> cache("sections");
+    return cache;
+}
+}
+
 SectionRepository::SectionRepository() {}
 
 bool SectionRepository::addSection(const Section& section) {
+    SIS_TRACE_SCOPE("db", "SectionRepository::addSection");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("INSERT INTO sections (course_id, max_students) VALUES (:cid, :max)");
     query.bindValue(":cid", section.courseId);
     query.bindValue(":max", section.maxStudents);
@@ -17,12 +30,15 @@ bool SectionRepository::addSection(const Section& section) {
         qDebug() << "Add Section Error:" << query.lastError().text();
         return false;
     }
+    sectionCache().invalidate();
+    EnrollmentValidator::instance().invalidate(); // Capacities changed
     return true;
 }
 
 bool SectionRepository::deleteSection(int id) {
+    SIS_TRACE_SCOPE("db", "SectionRepository::deleteSection");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("DELETE FROM sections WHERE section_id = :id");
     query.bindValue(":id", id);
     
@@ -30,13 +46,34 @@ bool SectionRepository::deleteSection(int id) {
         qDebug() << "Delete Section Error:" << query.lastError().text();
         return false;
     }
+    sectionCache().invalidate();
+    EnrollmentValidator::instance().invalidate(); // Capacities changed
+    WaitlistManager::instance().invalidate();     // Waitlist rows went with the section
     return true;
 }
 
 std::vector<Section> SectionRepository::getAllSections() {
+    SIS_TRACE_SCOPE("db", "SectionRepository::getAllSections");
+    return sectionCache().getAll(&SectionRepository::loadAllSections);
+}
+
+EntityCacheStats SectionRepository::cacheStats() {
+    return sectionCache().stats();
+}
+
+void SectionRepository::invalidateCache() {
+    sectionCache().invalidate();
+}
+
+std::optional<std::vector<Section>> SectionRepository::loadAllSections() {
+    SIS_TRACE_SCOPE("db", "SectionRepository::loadAllSections");
     std::vector<Section> list;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query("SELECT section_id, course_id, max_students FROM sections", db);
+    ProfiledQuery query("SELECT section_id, course_id, max_students FROM sections", db, SIS_QUERY_SITE);
+    if (!query.isActive()) {
+        qDebug() << "Load Sections Error:" << query.lastError().text();
+        return std::nullopt;
+    }
     
     while (query.next()) {
         Section s;
@@ -2,6 +2,7 @@
 #define SECTIONREPOSITORY_H
 
 #include "section.h"
+#include "../../utils/entitycache.h"
 #include <vector>
 
 class SectionRepository {
@@ -11,6 +12,13 @@ public:
     bool addSection(const Section& section);
     bool deleteSection(int id);
     std::vector<Section> getAllSections();
+
+    // Shared read-through cache, invalidated by every write above
+    static EntityCacheStats cacheStats();
+    static void invalidateCache();
+
+private:
+    static std::optional<std::vector<Section>> loadAllSections();
 };
 
 #endif // SECTIONREPOSITORY_H
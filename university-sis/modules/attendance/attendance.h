@@ -3,6 +3,15 @@
 
 #include <QString>
 #include <QDate>
+#include <QtGlobal>
+
+// Values match attendance_statuses.status_id (stored as TINYINT)
+enum class AttendanceStatus : quint8 {
+    Present = 1,
+    Absent = 2,
+    Late = 3,
+    Excused = 4
+};
 
 struct Attendance {
     int id = 0;
@@ -12,7 +21,26 @@ struct Attendance {
     int courseId = 0;   // Course ID (derived from section, kept for convenience)
     QString courseName;  // Course name for display
     QDate date = QDate::currentDate();
-    QString status = "Present"; // Present, Absent, Late
+    AttendanceStatus status = AttendanceStatus::Present;
+
+    static QString statusToString(AttendanceStatus status) {
+        switch (status) {
+        case AttendanceStatus::Absent: return "Absent";
+        case AttendanceStatus::Late: return "Late";
+        case AttendanceStatus::Excused: return "Excused";
+        case AttendanceStatus::Present: break;
+        }
+        return "Present";
+    }
+    static AttendanceStatus statusFromString(const QString& text) {
+        if (text == "Absent") return AttendanceStatus::Absent;
+        if (text == "Late") return AttendanceStatus::Late;
+        if (text == "Excused") return AttendanceStatus::Excused;
+        return AttendanceStatus::Present;
+    }
+    static AttendanceStatus statusFromId(int id) {
+        return (id >= 1 && id <= 4) ? static_cast<AttendanceStatus>(id) : AttendanceStatus::Present;
+    }
 };
 
 #endif // ATTENDANCE_H
@@ -0,0 +1,33 @@
+#ifndef ATTENDANCEALERT_H
+#define ATTENDANCEALERT_H
+
+#include <QString>
+#include <QDate>
+
+enum class AttendanceAlertRule {
+    AbsenceRate,         // Absences / sessions crossed the configured threshold
+    ConsecutiveAbsences  // K or more sessions in a row were missed
+};
+
+struct AttendanceAlert {
+    int id = 0;
+    int studentId = 0;
+    QString studentName;  // Student name for display
+    int sectionId = 0;
+    int courseId = 0;
+    AttendanceAlertRule rule = AttendanceAlertRule::AbsenceRate;
+    double absenceRate = 0.0;     // 0..1
+    int consecutiveAbsences = 0;  // Longest run of missed sessions
+    int totalSessions = 0;
+    QDate generatedOn = QDate::currentDate();
+
+    static QString ruleToString(AttendanceAlertRule rule) {
+        return rule == AttendanceAlertRule::AbsenceRate ? "AbsenceRate" : "ConsecutiveAbsences";
+    }
+    static AttendanceAlertRule ruleFromString(const QString& text) {
+        return text == "ConsecutiveAbsences" ? AttendanceAlertRule::ConsecutiveAbsences
+                                             : AttendanceAlertRule::AbsenceRate;
+    }
+};
+
+#endif // ATTENDANCEALERT_H
@@ -0,0 +1,176 @@
+#include "attendanceanalytics.h"
+#include "attendancerepository.h"
+#include "../../database/databasemanager.h"
+#include <QThreadPool>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// Longest run of absences on consecutive session days of the section
+int longestAbsenceRun(const StudentSectionAttendance& row, const AttendanceAggregates& data)
+{
+    if (row.absenceEnd <= row.absenceBegin) {
+        return 0;
+    }
+    auto it = data.sectionSessions.constFind(row.sectionId);
+    if (it == data.sectionSessions.constEnd()) {
+        return 0;
+    }
+
+    const std::vector<qint64>& sessions = it.value();
+    auto from = sessions.begin();
+    qint64 previous = -2;
+    int run = 0;
+    int longest = 0;
+    for (int i = row.absenceBegin; i < row.absenceEnd; ++i) {
+        // Absence days are ascending, so each search can start where the last one ended
+        from = std::lower_bound(from, sessions.end(), data.absenceDays[i]);
+        const qint64 index = from - sessions.begin();
+        run = (index == previous + 1) ? run + 1 : 1;
+        previous = index;
+        longest = std::max(longest, run);
+    }
+    return longest;
+}
+
+void evaluateRow(const StudentSectionAttendance& row,
+                 const AttendanceAggregates& data,
+                 const AttendanceAnalytics::Config& config,
+                 const QDate& generatedOn,
+                 std::vector<AttendanceAlert>& out)
+{
+    if (row.totalSessions <= 0) {
+        return;
+    }
+
+    const double rate = double(row.absences) / row.totalSessions;
+    const int run = longestAbsenceRun(row, data);
+
+    auto makeAlert = [&](AttendanceAlertRule rule) {
+        AttendanceAlert alert;
+        alert.studentId = row.studentId;
+        alert.sectionId = row.sectionId;
+        alert.courseId = row.courseId;
+        alert.rule = rule;
+        alert.absenceRate = rate;
+        alert.consecutiveAbsences = run;
+        alert.totalSessions = row.totalSessions;
+        alert.generatedOn = generatedOn;
+        return alert;
+    };
+
+    if (row.totalSessions >= config.minSessions && rate >= config.absenceRateThreshold) {
+        out.push_back(makeAlert(AttendanceAlertRule::AbsenceRate));
+    }
+    if (config.consecutiveAbsenceThreshold > 0 && run >= config.consecutiveAbsenceThreshold) {
+        out.push_back(makeAlert(AttendanceAlertRule::ConsecutiveAbsences));
+    }
+}
+
+} // namespace
+
+AttendanceAnalytics::AttendanceAnalytics() {}
+
+AttendanceAnalytics::AttendanceAnalytics(const Config& config) : m_config(config) {}
+
+std::vector<AttendanceAlert> AttendanceAnalytics::evaluate(const QDate& generatedOn)
+{
+    AttendanceRepository repo;
+    return evaluate(repo.getAttendanceAggregates(m_config.from, m_config.to), m_config, generatedOn);
+}
+
+AttendanceAnalytics::RunSummary AttendanceAnalytics::run(const QDate& generatedOn)
+{
+    DatabaseManager& manager = DatabaseManager::instance();
+    return run(generatedOn, manager.getDatabase(DbAccess::ReadOnly), manager.getDatabase());
+}
+
+AttendanceAnalytics::RunSummary AttendanceAnalytics::run(const QDate& generatedOn, const QSqlDatabase& db)
+{
+    return run(generatedOn, db, db);
+}
+
+AttendanceAnalytics::RunSummary AttendanceAnalytics::run(const QDate& generatedOn, const QSqlDatabase& readDb,
+                                                         const QSqlDatabase& writeDb)
+{
+    RunSummary summary;
+    QElapsedTimer timer;
+    timer.start();
+
+    AttendanceRepository repo;
+    AttendanceAggregates data = repo.getAttendanceAggregates(m_config.from, m_config.to, readDb);
+    summary.loadMs = timer.restart();
+
+    std::vector<AttendanceAlert> alerts = evaluate(data, m_config, generatedOn);
+    summary.evaluateMs = timer.restart();
+    summary.studentSectionsEvaluated = int(data.rows.size());
+    summary.alertsRaised = int(alerts.size());
+
+    summary.saved = repo.replaceAlerts(alerts, generatedOn, writeDb);
+    summary.saveMs = timer.elapsed();
+
+    qDebug() << "AttendanceAnalytics: evaluated" << summary.studentSectionsEvaluated
+             << "student/section pairs, raised" << summary.alertsRaised << "alerts"
+             << "(load" << summary.loadMs << "ms, evaluate" << summary.evaluateMs
+             << "ms, save" << summary.saveMs << "ms)";
+    return summary;
+}
+
+std::vector<AttendanceAlert> AttendanceAnalytics::evaluate(const AttendanceAggregates& data,
+                                                           const Config& config,
+                                                           const QDate& generatedOn)
+{
+    const std::vector<StudentSectionAttendance>& rows = data.rows;
+    if (rows.empty()) {
+        return {};
+    }
+
+    const int threads = std::max(1, config.threadCount > 0 ? config.threadCount : QThread::idealThreadCount());
+
+    // Contiguous chunks that never split one student's sections across workers
+    std::vector<size_t> bounds{0};
+    const size_t target = std::max<size_t>(1, (rows.size() + threads - 1) / threads);
+    size_t next = target;
+    while (next < rows.size()) {
+        while (next < rows.size() && rows[next].studentId == rows[next - 1].studentId) {
+            ++next;
+        }
+        if (next < rows.size()) {
+            bounds.push_back(next);
+        }
+        next += target;
+    }
+    bounds.push_back(rows.size());
+
+    std::vector<std::vector<AttendanceAlert>> partial(bounds.size() - 1);
+    auto evaluateChunk = [&](size_t chunk) {
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            evaluateRow(rows[i], data, config, generatedOn, partial[chunk]);
+        }
+    };
+
+    if (partial.size() == 1) {
+        evaluateChunk(0);
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for (size_t chunk = 0; chunk < partial.size(); ++chunk) {
+            pool.start([&evaluateChunk, chunk]() { evaluateChunk(chunk); });
+        }
+        pool.waitForDone();
+    }
+
+    size_t total = 0;
+    for (const auto& chunk : partial) {
+        total += chunk.size();
+    }
+    std::vector<AttendanceAlert> alerts;
+    alerts.reserve(total);
+    for (auto& chunk : partial) {
+        alerts.insert(alerts.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+    }
+    return alerts;
+}
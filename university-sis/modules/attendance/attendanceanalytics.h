@@ -0,0 +1,58 @@
+#ifndef ATTENDANCEANALYTICS_H
+#define ATTENDANCEANALYTICS_H
+
+#include "attendancealert.h"
+#include "attendancestats.h"
+#include <QDate>
+#include <QSqlDatabase>
+#include <vector>
+
+/**
+ * @brief Flags at-risk students from pre-aggregated attendance.
+ *
+ * Loading is done once on the calling thread (grouped queries, no raw rows);
+ * rule evaluation is pure C++ and is partitioned by student across a thread pool.
+ */
+class AttendanceAnalytics {
+public:
+    struct Config {
+        double absenceRateThreshold = 0.25;  // Flag when absences / sessions >= threshold
+        int consecutiveAbsenceThreshold = 3; // Flag when K sessions in a row were missed (0 = off)
+        int minSessions = 4;                 // Rate rule ignores sections met fewer times than this
+        int threadCount = 0;                 // 0 = QThread::idealThreadCount()
+        QDate from;                          // Optional evaluation window
+        QDate to;
+    };
+
+    struct RunSummary {
+        int studentSectionsEvaluated = 0;
+        int alertsRaised = 0;
+        qint64 loadMs = 0;
+        qint64 evaluateMs = 0;
+        qint64 saveMs = 0;
+        bool saved = false;
+    };
+
+    AttendanceAnalytics();
+    explicit AttendanceAnalytics(const Config& config);
+
+    // Loads aggregates and evaluates the rules without writing anything
+    std::vector<AttendanceAlert> evaluate(const QDate& generatedOn = QDate::currentDate());
+
+    // Evaluates and replaces the attendance_alerts rows for generatedOn
+    RunSummary run(const QDate& generatedOn = QDate::currentDate());
+    // Same, reading and writing through db (e.g. a ScopedConnection in a worker thread)
+    RunSummary run(const QDate& generatedOn, const QSqlDatabase& db);
+
+    // Pure rule evaluation, safe to call without a database
+    static std::vector<AttendanceAlert> evaluate(const AttendanceAggregates& data,
+                                                 const Config& config,
+                                                 const QDate& generatedOn);
+
+private:
+    RunSummary run(const QDate& generatedOn, const QSqlDatabase& readDb, const QSqlDatabase& writeDb);
+
+    Config m_config;
+};
+
+#endif // ATTENDANCEANALYTICS_H
@@ -1,5 +1,7 @@
 #include "attendancerepository.h"
+#include "../../utils/tracer.h"
 #include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
@@ -7,14 +9,15 @@
 AttendanceRepository::AttendanceRepository() {}
 
 bool AttendanceRepository::addAttendance(const Attendance& att) {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::addAttendance");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
-    query.prepare("INSERT INTO attendance (student_id, section_id, course_id, date, status) VALUES (:sid, :secid, :cid, :date, :stat)");
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO attendance (student_id, section_id, course_id, date, status_id) VALUES (:sid, :secid, :cid, :date, :stat)");
     query.bindValue(":sid", att.studentId);
     query.bindValue(":secid", att.sectionId);
     query.bindValue(":cid", att.courseId);
     query.bindValue(":date", att.date);
-    query.bindValue(":stat", att.status);
+    query.bindValue(":stat", int(att.status));
     
     if (!query.exec()) {
         qDebug() << "Add Attendance Error:" << query.lastError().text();
@@ -24,19 +27,20 @@ bool AttendanceRepository::addAttendance(const Attendance& att) {
 }
 
 bool AttendanceRepository::addMultipleAttendance(const std::vector<Attendance>& attendanceList) {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::addMultipleAttendance");
     if (attendanceList.empty()) {
         return true; // Nothing to do
     }
     
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
     bool isSqlite = (db.driverName() == "QSQLITE");
-    db.transaction(); // Start transaction for atomicity
+    DatabaseManager::beginTransaction(db); // Start transaction for atomicity
     
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     
     // Use INSERT OR REPLACE for SQLite, regular INSERT for others
     // First delete existing records for the same student/section/date to avoid duplicates
-    QSqlQuery deleteQuery(db);
+    ProfiledQuery deleteQuery(db, SIS_QUERY_SITE);
     deleteQuery.prepare("DELETE FROM attendance WHERE student_id = :sid AND section_id = :secid AND date = :date");
     
     for (const auto& att : attendanceList) {
@@ -47,27 +51,28 @@ bool AttendanceRepository::addMultipleAttendance(const std::vector<Attendance>&
         deleteQuery.exec(); // Ignore errors if no record exists
         
         // Insert new record
-        query.prepare("INSERT INTO attendance (student_id, section_id, course_id, date, status) VALUES (:sid, :secid, :cid, :date, :stat)");
+        query.prepare("INSERT INTO attendance (student_id, section_id, course_id, date, status_id) VALUES (:sid, :secid, :cid, :date, :stat)");
         query.bindValue(":sid", att.studentId);
         query.bindValue(":secid", att.sectionId);
         query.bindValue(":cid", att.courseId);
         query.bindValue(":date", att.date);
-        query.bindValue(":stat", att.status);
+        query.bindValue(":stat", int(att.status));
         
         if (!query.exec()) {
             qDebug() << "Add Multiple Attendance Error:" << query.lastError().text();
-            db.rollback();
+            DatabaseManager::rollbackTransaction(db);
             return false;
         }
     }
     
-    db.commit(); // Commit transaction if all inserts succeeded
+    DatabaseManager::commitTransaction(db); // Commit transaction if all inserts succeeded
     return true;
 }
 
 bool AttendanceRepository::deleteAttendance(int id) {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::deleteAttendance");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("DELETE FROM attendance WHERE attendance_id = :id");
     query.bindValue(":id", id);
     
@@ -79,9 +84,10 @@ bool AttendanceRepository::deleteAttendance(int id) {
 }
 
 std::vector<Attendance> AttendanceRepository::getAllAttendance() {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::getAllAttendance");
     std::vector<Attendance> list;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query("SELECT attendance_id, student_id, section_id, course_id, date, status FROM attendance", db);
+    ProfiledQuery query("SELECT attendance_id, student_id, section_id, course_id, date, status_id FROM attendance", db, SIS_QUERY_SITE);
     
     while (query.next()) {
         Attendance a;
@@ -90,20 +96,21 @@ std::vector<Attendance> AttendanceRepository::getAllAttendance() {
         a.sectionId = query.value(2).toInt();
         a.courseId = query.value(3).toInt();
         a.date = query.value(4).toDate();
-        a.status = query.value(5).toString();
+        a.status = Attendance::statusFromId(query.value(5).toInt());
         list.push_back(a);
     }
     return list;
 }
 
 std::vector<Attendance> AttendanceRepository::getAttendanceWithNames() {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::getAttendanceWithNames");
     std::vector<Attendance> list;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     
     query.prepare("SELECT a.attendance_id, a.student_id, s.name as student_name, "
                   "a.section_id, a.course_id, c.name as course_name, "
-                  "a.date, a.status "
+                  "a.date, a.status_id "
                   "FROM attendance a "
                   "LEFT JOIN students s ON a.student_id = s.student_id "
                   "LEFT JOIN courses c ON a.course_id = c.course_id "
@@ -123,7 +130,7 @@ std::vector<Attendance> AttendanceRepository::getAttendanceWithNames() {
         a.courseId = query.value(4).toInt();
         a.courseName = query.value(5).toString();
         a.date = query.value(6).toDate();
-        a.status = query.value(7).toString();
+        a.status = Attendance::statusFromId(query.value(7).toInt());
         list.push_back(a);
     }
     return list;
@@ -132,17 +139,18 @@ std::vector<Attendance> AttendanceRepository::getAttendanceWithNames() {
 std::vector<Attendance> AttendanceRepository::getFilteredAttendance(
     const QString& studentNameFilter,
     int courseIdFilter,
-    const QString& statusFilter,
+    int statusFilter,
     const QDate& dateFrom,
     const QDate& dateTo) {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::getFilteredAttendance");
     
     std::vector<Attendance> list;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     
     QString sql = "SELECT a.attendance_id, a.student_id, s.name as student_name, "
                   "a.section_id, a.course_id, c.name as course_name, "
-                  "a.date, a.status "
+                  "a.date, a.status_id "
                   "FROM attendance a "
                   "LEFT JOIN students s ON a.student_id = s.student_id "
                   "LEFT JOIN courses c ON a.course_id = c.course_id "
@@ -154,8 +162,8 @@ std::vector<Attendance> AttendanceRepository::getFilteredAttendance(
     if (courseIdFilter > 0) {
         sql += " AND a.course_id = :courseId";
     }
-    if (!statusFilter.isEmpty()) {
-        sql += " AND a.status = :status";
+    if (statusFilter > 0) {
+        sql += " AND a.status_id = :status";
     }
     if (dateFrom.isValid()) {
         sql += " AND a.date >= :dateFrom";
@@ -174,7 +182,7 @@ std::vector<Attendance> AttendanceRepository::getFilteredAttendance(
     if (courseIdFilter > 0) {
         query.bindValue(":courseId", courseIdFilter);
     }
-    if (!statusFilter.isEmpty()) {
+    if (statusFilter > 0) {
         query.bindValue(":status", statusFilter);
     }
     if (dateFrom.isValid()) {
@@ -198,8 +206,194 @@ std::vector<Attendance> AttendanceRepository::getFilteredAttendance(
         a.courseId = query.value(4).toInt();
         a.courseName = query.value(5).toString();
         a.date = query.value(6).toDate();
-        a.status = query.value(7).toString();
+        a.status = Attendance::statusFromId(query.value(7).toInt());
         list.push_back(a);
     }
     return list;
-}
\ No newline at end of file
+}
+AttendanceAggregates AttendanceRepository::getAttendanceAggregates(const QDate& dateFrom, const QDate& dateTo) {
+    // Whole-table aggregation
+    return getAttendanceAggregates(dateFrom, dateTo, DatabaseManager::instance().getDatabase(DbAccess::ReadOnly));
+}
+
+AttendanceAggregates AttendanceRepository::getAttendanceAggregates(const QDate& dateFrom, const QDate& dateTo, const QSqlDatabase& db) {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::getAttendanceAggregates");
+    AttendanceAggregates agg;
+
+    QString range;
+    if (dateFrom.isValid()) {
+        range += " AND date >= :dateFrom";
+    }
+    if (dateTo.isValid()) {
+        range += " AND date <= :dateTo";
+    }
+    auto bindRange = [&](QSqlQuery& q) {
+        if (dateFrom.isValid()) {
+            q.bindValue(":dateFrom", dateFrom);
+        }
+        if (dateTo.isValid()) {
+            q.bindValue(":dateTo", dateTo);
+        }
+    };
+
+    // 1. Distinct session days per section (needed for "consecutive" runs)
+    ProfiledQuery sessions(db, SIS_QUERY_SITE);
+    sessions.setForwardOnly(true);
+    sessions.prepare("SELECT section_id, date FROM attendance WHERE 1=1" + range +
+                     " GROUP BY section_id, date ORDER BY section_id, date");
+    bindRange(sessions);
+    if (!sessions.exec()) {
+        qDebug() << "Get Attendance Sessions Error:" << sessions.lastError().text();
+        return agg;
+    }
+    while (sessions.next()) {
+        agg.sectionSessions[sessions.value(0).toInt()].push_back(sessions.value(1).toDate().toJulianDay());
+    }
+
+    // 2. Totals per student and section
+    ProfiledQuery counts(db, SIS_QUERY_SITE);
+    counts.setForwardOnly(true);
+    counts.prepare(QString("SELECT student_id, section_id, MAX(course_id), COUNT(*), "
+                           "SUM(CASE WHEN status_id = %1 THEN 1 ELSE 0 END) "
+                           "FROM attendance WHERE 1=1").arg(int(AttendanceStatus::Absent)) + range +
+                   " GROUP BY student_id, section_id ORDER BY student_id, section_id");
+    bindRange(counts);
+    if (!counts.exec()) {
+        qDebug() << "Get Attendance Counts Error:" << counts.lastError().text();
+        return agg;
+    }
+    while (counts.next()) {
+        StudentSectionAttendance row;
+        row.studentId = counts.value(0).toInt();
+        row.sectionId = counts.value(1).toInt();
+        row.courseId = counts.value(2).toInt();
+        row.totalSessions = counts.value(3).toInt();
+        row.absences = counts.value(4).toInt();
+        agg.rows.push_back(row);
+    }
+
+    // 3. Absence days only, in the same order so they can be merged with the totals
+    ProfiledQuery absences(db, SIS_QUERY_SITE);
+    absences.setForwardOnly(true);
+    absences.prepare(QString("SELECT student_id, section_id, date FROM attendance WHERE status_id = %1")
+                         .arg(int(AttendanceStatus::Absent)) + range +
+                     " ORDER BY student_id, section_id, date");
+    bindRange(absences);
+    if (!absences.exec()) {
+        qDebug() << "Get Attendance Absences Error:" << absences.lastError().text();
+        return agg;
+    }
+    size_t cursor = 0;
+    size_t current = agg.rows.size();
+    while (absences.next()) {
+        const int studentId = absences.value(0).toInt();
+        const int sectionId = absences.value(1).toInt();
+        while (cursor < agg.rows.size() &&
+               (agg.rows[cursor].studentId < studentId ||
+                (agg.rows[cursor].studentId == studentId && agg.rows[cursor].sectionId < sectionId))) {
+            ++cursor;
+        }
+        if (cursor == agg.rows.size() ||
+            agg.rows[cursor].studentId != studentId || agg.rows[cursor].sectionId != sectionId) {
+            continue;
+        }
+        StudentSectionAttendance& row = agg.rows[cursor];
+        if (cursor != current) {
+            row.absenceBegin = int(agg.absenceDays.size());
+            current = cursor;
+        }
+        agg.absenceDays.push_back(absences.value(2).toDate().toJulianDay());
+        row.absenceEnd = int(agg.absenceDays.size());
+    }
+    return agg;
+}
+
+bool AttendanceRepository::replaceAlerts(const std::vector<AttendanceAlert>& alerts, const QDate& generatedOn) {
+    return replaceAlerts(alerts, generatedOn, DatabaseManager::instance().getDatabase());
+}
+
+bool AttendanceRepository::replaceAlerts(const std::vector<AttendanceAlert>& alerts, const QDate& generatedOn, const QSqlDatabase& conn) {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::replaceAlerts");
+    QSqlDatabase db = conn;
+    DatabaseManager::beginTransaction(db);
+
+    ProfiledQuery clear(db, SIS_QUERY_SITE);
+    clear.prepare("DELETE FROM attendance_alerts WHERE generated_on = :date");
+    clear.bindValue(":date", generatedOn);
+    if (!clear.exec()) {
+        qDebug() << "Clear Attendance Alerts Error:" << clear.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+
+    if (!alerts.empty()) {
+        QVariantList studentIds, sectionIds, courseIds, rules, rates, runs, totals, dates;
+        for (const auto& alert : alerts) {
+            studentIds << alert.studentId;
+            sectionIds << alert.sectionId;
+            courseIds << alert.courseId;
+            rules << AttendanceAlert::ruleToString(alert.rule);
+            rates << alert.absenceRate;
+            runs << alert.consecutiveAbsences;
+            totals << alert.totalSessions;
+            dates << generatedOn;
+        }
+
+        ProfiledQuery insert(db, SIS_QUERY_SITE);
+        insert.prepare("INSERT INTO attendance_alerts (student_id, section_id, course_id, rule, absence_rate, "
+                       "consecutive_absences, total_sessions, generated_on) VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+        insert.addBindValue(studentIds);
+        insert.addBindValue(sectionIds);
+        insert.addBindValue(courseIds);
+        insert.addBindValue(rules);
+        insert.addBindValue(rates);
+        insert.addBindValue(runs);
+        insert.addBindValue(totals);
+        insert.addBindValue(dates);
+        if (!insert.execBatch()) {
+            qDebug() << "Save Attendance Alerts Error:" << insert.lastError().text();
+            DatabaseManager::rollbackTransaction(db);
+            return false;
+        }
+    }
+
+    return DatabaseManager::commitTransaction(db);
+}
+
+std::vector<AttendanceAlert> AttendanceRepository::getAlerts(const QDate& generatedOn) {
+    return getAlerts(generatedOn, DatabaseManager::instance().getDatabase());
+}
+
+std::vector<AttendanceAlert> AttendanceRepository::getAlerts(const QDate& generatedOn, const QSqlDatabase& db) {
+    SIS_TRACE_SCOPE("db", "AttendanceRepository::getAlerts");
+    std::vector<AttendanceAlert> list;
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT al.alert_id, al.student_id, s.name, al.section_id, al.course_id, al.rule, "
+                  "al.absence_rate, al.consecutive_absences, al.total_sessions, al.generated_on "
+                  "FROM attendance_alerts al "
+                  "LEFT JOIN students s ON al.student_id = s.student_id "
+                  "WHERE al.generated_on = :date "
+                  "ORDER BY al.absence_rate DESC, al.consecutive_absences DESC, s.name");
+    query.bindValue(":date", generatedOn);
+
+    if (!query.exec()) {
+        qDebug() << "Get Attendance Alerts Error:" << query.lastError().text();
+        return list;
+    }
+
+    while (query.next()) {
+        AttendanceAlert a;
+        a.id = query.value(0).toInt();
+        a.studentId = query.value(1).toInt();
+        a.studentName = query.value(2).toString();
+        a.sectionId = query.value(3).toInt();
+        a.courseId = query.value(4).toInt();
+        a.rule = AttendanceAlert::ruleFromString(query.value(5).toString());
+        a.absenceRate = query.value(6).toDouble();
+        a.consecutiveAbsences = query.value(7).toInt();
+        a.totalSessions = query.value(8).toInt();
+        a.generatedOn = query.value(9).toDate();
+        list.push_back(a);
+    }
+    return list;
+}
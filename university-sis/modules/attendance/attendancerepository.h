@@ -2,10 +2,13 @@
 #define ATTENDANCEREPOSITORY_H
 
 #include "attendance.h"
+#include "attendancealert.h"
+#include "attendancestats.h"
 #include <vector>
 #include <optional>
 #include <QString>
 #include <QDate>
+#include <QSqlDatabase>
 
 class AttendanceRepository {
 public:
@@ -20,10 +23,19 @@ public:
     std::vector<Attendance> getFilteredAttendance(
         const QString& studentNameFilter = QString(),
         int courseIdFilter = -1,
-        const QString& statusFilter = QString(),
+        int statusFilter = -1,  // AttendanceStatus id, -1 = any
         const QDate& dateFrom = QDate(),
         const QDate& dateTo = QDate()
     );  // Gets filtered attendance with names
+
+    // Analytics: grouped per (student, section) instead of raw rows
+    AttendanceAggregates getAttendanceAggregates(const QDate& dateFrom = QDate(), const QDate& dateTo = QDate());
+    bool replaceAlerts(const std::vector<AttendanceAlert>& alerts, const QDate& generatedOn);
+    std::vector<AttendanceAlert> getAlerts(const QDate& generatedOn);
+    // Same queries on an explicit connection (e.g. a ScopedConnection in a worker thread)
+    AttendanceAggregates getAttendanceAggregates(const QDate& dateFrom, const QDate& dateTo, const QSqlDatabase& db);
+    bool replaceAlerts(const std::vector<AttendanceAlert>& alerts, const QDate& generatedOn, const QSqlDatabase& db);
+    std::vector<AttendanceAlert> getAlerts(const QDate& generatedOn, const QSqlDatabase& db);
 };
 
 #endif // ATTENDANCEREPOSITORY_H
@@ -0,0 +1,26 @@
+#ifndef ATTENDANCESTATS_H
+#define ATTENDANCESTATS_H
+
+#include <QHash>
+#include <QtGlobal>
+#include <vector>
+
+// Pre-aggregated attendance for one (student, section) pair.
+// Absence days live in AttendanceAggregates::absenceDays[absenceBegin, absenceEnd).
+struct StudentSectionAttendance {
+    int studentId = 0;
+    int sectionId = 0;
+    int courseId = 0;
+    int totalSessions = 0;
+    int absences = 0;
+    int absenceBegin = 0;
+    int absenceEnd = 0;
+};
+
+struct AttendanceAggregates {
+    std::vector<StudentSectionAttendance> rows;       // Sorted by student, then section
+    std::vector<qint64> absenceDays;                  // Julian days, grouped per row, ascending
+    QHash<int, std::vector<qint64>> sectionSessions;  // Sorted distinct session days per section
+};
+
+#endif // ATTENDANCESTATS_H
@@ -0,0 +1,61 @@
+#include "authservice.h"
+#include "credentialverifier.h"
+#include <QDebug>
+
+namespace {
+struct RoleMapping {
+    const char* code;
+    const char* name;
+};
+
+const RoleMapping Roles[] = {
+    {"ADMIN", "Administrator"},
+    {"STUDENT", "Student"},
+    {"FACULTY", "Faculty Member"},
+    {"FINANCE", "Finance Officer"},
+    {"REGISTRAR", "Registrar Officer"},
+};
+}
+
+AuthService::AuthService() {}
+
+QString AuthService::roleName(const QString& roleCode)
+{
+    for (const auto& r : Roles) {
+        if (roleCode == QLatin1String(r.code)) {
+            return QString::fromLatin1(r.name);
+        }
+    }
+    return QString();
+}
+
+std::optional<AuthSession> AuthService::login(const QString& username, const QString& password)
+{
+    CredentialVerifier& verifier = CredentialVerifier::instance();
+    auto login = m_users.findForLogin(username);
+    if (!login) {
+        verifier.rejectUnknown(password);
+        return std::nullopt;
+    }
+
+    QString upgraded;
+    if (!verifier.verify("users", username, password, login->passwordHash, &upgraded)) {
+        return std::nullopt;
+    }
+    if (!upgraded.isEmpty()) {
+        // Legacy plaintext or low-cost hash; the login still succeeds if the write fails
+        m_users.updatePasswordHash(login->user.id, upgraded);
+    }
+
+    AuthSession session;
+    session.roleName = roleName(login->user.role);
+    if (session.roleName.isEmpty()) {
+        qDebug() << "Login rejected, unknown role" << login->user.role << "for" << username;
+        return std::nullopt;
+    }
+    session.user = login->user;
+    session.department = login->department;
+    session.year = login->year;
+    session.sectionId = login->sectionId;
+    return session;
+}
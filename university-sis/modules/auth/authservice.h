@@ -0,0 +1,43 @@
+#ifndef AUTHSERVICE_H
+#define AUTHSERVICE_H
+
+#include "user.h"
+#include "userrepository.h"
+#include <optional>
+
+// Everything the UI needs about the signed-in account, loaded with the login query
+struct AuthSession {
+    User user;
+    QString roleName;     // Display role used across the UI ("Student", "Administrator", ...)
+    QString department;
+    int year = 0;
+    int sectionId = 0;
+
+    // Id the modules filter by: the student/faculty id for linked accounts, else the account id
+    int profileId() const {
+        if (user.studentId > 0) return user.studentId;
+        if (user.facultyId > 0) return user.facultyId;
+        return user.id;
+    }
+};
+
+/**
+ * @brief Single login path for every role, backed by the users table.
+ *
+ * The role comes from the account row rather than from the login form, and
+ * the password check goes through CredentialVerifier (hashing, rehash of
+ * legacy values, recent-login cache).
+ */
+class AuthService {
+public:
+    AuthService();
+
+    std::optional<AuthSession> login(const QString& username, const QString& password);
+
+    static QString roleName(const QString& roleCode);
+
+private:
+    UserRepository m_users;
+};
+
+#endif // AUTHSERVICE_H
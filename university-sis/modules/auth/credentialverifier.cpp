@@ -0,0 +1,143 @@
+#include "credentialverifier.h"
+#include "passwordhasher.h"
+#include <QMessageAuthenticationCode>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+
+namespace {
+QString cacheKey(const QString& realm, const QString& username)
+{
+    return realm + QChar(0x1f) + username;
+}
+}
+
+CredentialVerifier& CredentialVerifier::instance()
+{
+    static CredentialVerifier verifier;
+    return verifier;
+}
+
+CredentialVerifier::CredentialVerifier()
+    : m_secret(32, Qt::Uninitialized)
+{
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(m_secret.data()), m_secret.size() / int(sizeof(quint32)));
+}
+
+bool CredentialVerifier::verify(const QString& realm, const QString& username, const QString& password,
+                                const QString& stored, QString* upgradedHash)
+{
+    const QString key = cacheKey(realm, username);
+    if (PasswordHasher::isHashed(stored)) {
+        const QByteArray cached = token(key, password, stored);
+        if (lookup(key, cached)) {
+            return true;
+        }
+    }
+
+    const PasswordHasher::Verification result = PasswordHasher::verify(password, stored);
+    if (!result.ok) {
+        return false;
+    }
+
+    QString current = stored;
+    if (result.needsRehash) {
+        current = PasswordHasher::hash(password);
+        if (upgradedHash) {
+            *upgradedHash = current;
+        }
+    }
+    remember(key, token(key, password, current));
+    return true;
+}
+
+void CredentialVerifier::rejectUnknown(const QString& password)
+{
+    PasswordHasher::burn(password);
+}
+
+QByteArray CredentialVerifier::token(const QString& key, const QString& password, const QString& stored) const
+{
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, m_secret);
+    mac.addData(key.toUtf8());
+    mac.addData(QByteArray(1, '\0'));
+    mac.addData(password.toUtf8());
+    mac.addData(QByteArray(1, '\0'));
+    mac.addData(stored.toUtf8());
+    return mac.result();
+}
+
+bool CredentialVerifier::lookup(const QString& key, const QByteArray& token)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end() || it->age.hasExpired(EntryTtlMs)
+        || !PasswordHasher::constantTimeEquals(it->token, token)) {
+        ++m_stats.misses;
+        return false;
+    }
+    m_order.splice(m_order.begin(), m_order, it->order);
+    ++m_stats.hits;
+    return true;
+}
+
+void CredentialVerifier::remember(const QString& key, const QByteArray& token)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_order.splice(m_order.begin(), m_order, it->order);
+        it->token = token;
+        it->age.start();
+        return;
+    }
+
+    m_order.push_front(key);
+    Entry entry;
+    entry.token = token;
+    entry.age.start();
+    entry.order = m_order.begin();
+    m_entries.insert(key, entry);
+    trim();
+}
+
+// Caller holds m_mutex
+void CredentialVerifier::trim()
+{
+    while (int(m_entries.size()) > m_capacity && !m_order.empty()) {
+        m_entries.remove(m_order.back());
+        m_order.pop_back();
+    }
+}
+
+void CredentialVerifier::forget(const QString& realm, const QString& username)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(cacheKey(realm, username));
+    if (it != m_entries.end()) {
+        m_order.erase(it->order);
+        m_entries.erase(it);
+    }
+}
+
+void CredentialVerifier::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_order.clear();
+}
+
+void CredentialVerifier::setCapacity(int capacity)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = qMax(0, capacity);
+    trim();
+}
+
+CredentialCacheStats CredentialVerifier::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    CredentialCacheStats s = m_stats;
+    s.size = int(m_entries.size());
+    s.capacity = m_capacity;
+    return s;
+}
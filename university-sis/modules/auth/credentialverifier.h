@@ -0,0 +1,73 @@
+#ifndef CREDENTIALVERIFIER_H
+#define CREDENTIALVERIFIER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <list>
+
+struct CredentialCacheStats {
+    quint64 hits = 0;
+    quint64 misses = 0;
+    int size = 0;
+    int capacity = 0;
+};
+
+/**
+ * @brief Login check shared by every account table, fronted by a small LRU
+ * of recent successful verifications.
+ *
+ * Shared lab kiosks see the same students log in over and over; a cache hit
+ * skips the PBKDF2 cost. Entries hold a keyed digest of (password, stored
+ * hash) under a per-process random secret, never the password itself, and
+ * stop matching as soon as the stored hash changes. Entries expire after
+ * EntryTtlMs.
+ */
+class CredentialVerifier {
+public:
+    static constexpr int DefaultCapacity = 128;
+    static constexpr qint64 EntryTtlMs = 15 * 60 * 1000;
+
+    static CredentialVerifier& instance();
+
+    // realm names the account table ("students", "faculty", "users"). When stored is a
+    // legacy or under-cost value, upgradedHash receives the hash to write back.
+    bool verify(const QString& realm, const QString& username, const QString& password,
+                const QString& stored, QString* upgradedHash = nullptr);
+
+    // No such user: spend the same time as a wrong password would
+    void rejectUnknown(const QString& password);
+
+    void forget(const QString& realm, const QString& username);
+    void clear();
+    void setCapacity(int capacity);
+    CredentialCacheStats stats() const;
+
+private:
+    CredentialVerifier();
+    CredentialVerifier(const CredentialVerifier&) = delete;
+    CredentialVerifier& operator=(const CredentialVerifier&) = delete;
+
+    struct Entry {
+        QByteArray token;
+        QElapsedTimer age;
+        std::list<QString>::iterator order;
+    };
+
+    QByteArray token(const QString& key, const QString& password, const QString& stored) const;
+    bool lookup(const QString& key, const QByteArray& token);
+    void remember(const QString& key, const QByteArray& token);
+    void trim();
+
+    QByteArray m_secret;
+
+    mutable QMutex m_mutex;
+    int m_capacity = DefaultCapacity;
+    std::list<QString> m_order;   // Most recently used first
+    QHash<QString, Entry> m_entries;
+    CredentialCacheStats m_stats;
+};
+
+#endif // CREDENTIALVERIFIER_H
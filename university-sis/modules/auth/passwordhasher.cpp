@@ -0,0 +1,118 @@
+#include "passwordhasher.h"
+#include <QCryptographicHash>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <atomic>
+
+namespace {
+const QString Scheme = QStringLiteral("pbkdf2_sha256");
+std::atomic<int> s_iterations{PasswordHasher::DefaultIterations};
+}
+
+int PasswordHasher::iterations()
+{
+    return s_iterations.load();
+}
+
+void PasswordHasher::setIterations(int iterations)
+{
+    s_iterations.store(qMax(1000, iterations));
+}
+
+QByteArray PasswordHasher::pbkdf2(const QByteArray& password, const QByteArray& salt, int iterations, int keyLength)
+{
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, password);
+    QByteArray key;
+    key.reserve(keyLength + 32);
+
+    for (quint32 block = 1; key.size() < keyLength; ++block) {
+        const char index[4] = { char(block >> 24), char(block >> 16), char(block >> 8), char(block) };
+        mac.reset();
+        mac.addData(salt);
+        mac.addData(index, 4);
+        QByteArray u = mac.result();
+        QByteArray t = u;
+        for (int i = 1; i < iterations; ++i) {
+            mac.reset();
+            mac.addData(u);
+            u = mac.result();
+            for (int j = 0; j < t.size(); ++j) {
+                t[j] = char(t[j] ^ u[j]);
+            }
+        }
+        key += t;
+    }
+    key.truncate(keyLength);
+    return key;
+}
+
+QString PasswordHasher::hash(const QString& password)
+{
+    return hash(password, iterations());
+}
+
+QString PasswordHasher::hash(const QString& password, int iterations)
+{
+    QByteArray salt(SaltBytes, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(salt.data()), SaltBytes / int(sizeof(quint32)));
+
+    const QByteArray derived = pbkdf2(password.toUtf8(), salt, iterations, KeyBytes);
+    return QString("%1$%2$%3$%4").arg(Scheme).arg(iterations)
+        .arg(QString::fromLatin1(salt.toBase64()), QString::fromLatin1(derived.toBase64()));
+}
+
+bool PasswordHasher::isHashed(const QString& stored)
+{
+    return stored.startsWith(Scheme + '$');
+}
+
+bool PasswordHasher::constantTimeEquals(const QByteArray& a, const QByteArray& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    unsigned char diff = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+void PasswordHasher::burn(const QString& password)
+{
+    static const QByteArray salt(SaltBytes, '\0');
+    pbkdf2(password.toUtf8(), salt, iterations(), KeyBytes);
+}
+
+PasswordHasher::Verification PasswordHasher::verify(const QString& password, const QString& stored)
+{
+    Verification result;
+
+    if (!isHashed(stored)) {
+        // Legacy plaintext row. Pay the normal hashing cost anyway so legacy accounts
+        // cannot be told apart by timing, and compare fixed-length digests.
+        burn(password);
+        result.ok = !stored.isEmpty()
+            && constantTimeEquals(QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha256),
+                                  QCryptographicHash::hash(stored.toUtf8(), QCryptographicHash::Sha256));
+        result.needsRehash = result.ok;
+        return result;
+    }
+
+    const QStringList parts = stored.split('$');
+    bool validCost = false;
+    const int cost = parts.size() == 4 ? parts[1].toInt(&validCost) : 0;
+    if (!validCost || cost < 1) {
+        burn(password);
+        return result;
+    }
+
+    const QByteArray salt = QByteArray::fromBase64(parts[2].toLatin1());
+    const QByteArray expected = QByteArray::fromBase64(parts[3].toLatin1());
+    const QByteArray derived = pbkdf2(password.toUtf8(), salt, cost, int(expected.size() > 0 ? expected.size() : KeyBytes));
+
+    result.ok = constantTimeEquals(derived, expected);
+    result.needsRehash = result.ok && cost < iterations();
+    return result;
+}
@@ -0,0 +1,43 @@
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Salted PBKDF2-HMAC-SHA256 password hashing.
+ *
+ * Hashes are stored as "pbkdf2_sha256$<iterations>$<salt>$<hash>" (base64
+ * salt and hash). Anything without that prefix is treated as a legacy
+ * plaintext value: it still verifies, but reports needsRehash so the caller
+ * can write the upgraded hash back on a successful login.
+ */
+class PasswordHasher {
+public:
+    struct Verification {
+        bool ok = false;
+        bool needsRehash = false; // Legacy plaintext or fewer iterations than the current cost
+    };
+
+    static constexpr int DefaultIterations = 100000;
+    static constexpr int SaltBytes = 16;
+    static constexpr int KeyBytes = 32;
+
+    static QString hash(const QString& password);
+    static QString hash(const QString& password, int iterations);
+    static Verification verify(const QString& password, const QString& stored);
+
+    // Spends one full verification so unknown usernames take as long as wrong passwords
+    static void burn(const QString& password);
+
+    static bool isHashed(const QString& stored);
+    static bool constantTimeEquals(const QByteArray& a, const QByteArray& b);
+
+    // Work factor for new hashes; existing hashes below it are upgraded on login
+    static int iterations();
+    static void setIterations(int iterations);
+
+    static QByteArray pbkdf2(const QByteArray& password, const QByteArray& salt, int iterations, int keyLength);
+};
+
+#endif // PASSWORDHASHER_H
@@ -0,0 +1,17 @@
+#ifndef USER_H
+#define USER_H
+
+#include <QString>
+
+// Row of the users table. Every login account lives here; student and faculty
+// accounts link to their profile row.
+struct User {
+    int id = 0;
+    QString username;
+    QString role;         // Role code: ADMIN, STUDENT, FACULTY, FINANCE, REGISTRAR
+    QString displayName;
+    int studentId = 0;    // students.student_id for STUDENT accounts
+    int facultyId = 0;    // faculty.faculty_id for FACULTY accounts
+};
+
+#endif // USER_H
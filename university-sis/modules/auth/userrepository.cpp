@@ -0,0 +1,175 @@
+#include "userrepository.h"
+#include "../../utils/tracer.h"
+#include "passwordhasher.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "../../utils/stringpool.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+
+UserRepository::UserRepository() {}
+
+std::optional<UserLogin> UserRepository::findForLogin(const QString& username) {
+    SIS_TRACE_SCOPE("db", "UserRepository::findForLogin");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT u.user_id, u.role, u.password_hash, u.student_id, u.faculty_id, "
+                  "COALESCE(s.name, f.name, u.display_name), COALESCE(s.department, f.department), "
+                  "s.year, s.section_id "
+                  "FROM users u "
+                  "LEFT JOIN students s ON s.student_id = u.student_id "
+                  "LEFT JOIN faculty f ON f.faculty_id = u.faculty_id "
+                  "WHERE u.username = :u");
+    query.bindValue(":u", username);
+
+    if (!query.exec()) {
+        qDebug() << "Find User Error:" << query.lastError().text();
+        return std::nullopt;
+    }
+    if (!query.next()) {
+        return std::nullopt;
+    }
+
+    UserLogin login;
+    login.user.id = query.value(0).toInt();
+    login.user.username = username;
+    login.user.role = query.value(1).toString();
+    login.passwordHash = query.value(2).toString();
+    login.user.studentId = query.value(3).toInt();
+    login.user.facultyId = query.value(4).toInt();
+    login.user.displayName = query.value(5).toString();
+    login.department = StringPool::instance().shared(query.value(6).toString());
+    login.year = query.value(7).toInt();
+    login.sectionId = query.value(8).toInt();
+    return login;
+}
+
+bool UserRepository::addAccount(const User& user, const QString& password, const QSqlDatabase& db) {
+    SIS_TRACE_SCOPE("db", "UserRepository::addAccount");
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO users (username, password_hash, role, display_name, student_id, faculty_id) "
+                  "VALUES (:u, :h, :role, :name, :sid, :fid)");
+    query.bindValue(":u", user.username);
+    query.bindValue(":h", PasswordHasher::hash(password));
+    query.bindValue(":role", user.role);
+    query.bindValue(":name", user.displayName);
+    query.bindValue(":sid", user.studentId > 0 ? QVariant(user.studentId) : QVariant());
+    query.bindValue(":fid", user.facultyId > 0 ? QVariant(user.facultyId) : QVariant());
+
+    if (!query.exec()) {
+        qDebug() << "Add User Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool UserRepository::updatePasswordHash(int userId, const QString& hash) {
+    SIS_TRACE_SCOPE("db", "UserRepository::updatePasswordHash");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("UPDATE users SET password_hash = :h WHERE user_id = :id");
+    query.bindValue(":h", hash);
+    query.bindValue(":id", userId);
+
+    if (!query.exec()) {
+        qDebug() << "Update User Password Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool UserRepository::setStudentPassword(int studentId, const QString& password) {
+    SIS_TRACE_SCOPE("db", "UserRepository::setStudentPassword");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("UPDATE users SET password_hash = :h WHERE student_id = :id");
+    query.bindValue(":h", PasswordHasher::hash(password));
+    query.bindValue(":id", studentId);
+
+    if (!query.exec()) {
+        qDebug() << "Set Student Password Error:" << query.lastError().text();
+        return false;
+    }
+    if (query.numRowsAffected() == 0) {
+        qDebug() << "Set Student Password Error: no account for student" << studentId;
+        return false;
+    }
+    return true;
+}
+
+bool UserRepository::saveStudentAccount(int studentId, const QString& username, const QString& displayName,
+                                        const QString& password, const QSqlDatabase& db) {
+    SIS_TRACE_SCOPE("db", "UserRepository::saveStudentAccount");
+    // Looked up rather than inferred from affected rows: MySQL reports 0 for unchanged rows
+    ProfiledQuery find(db, SIS_QUERY_SITE);
+    find.prepare("SELECT user_id FROM users WHERE student_id = :id");
+    find.bindValue(":id", studentId);
+    if (!find.exec()) {
+        qDebug() << "Save Student Account Error:" << find.lastError().text();
+        return false;
+    }
+    if (!find.next()) {
+        if (username.isEmpty() || password.isEmpty()) {
+            return true; // No account, and not enough to create one
+        }
+        User account;
+        account.username = username;
+        account.role = "STUDENT";
+        account.displayName = displayName;
+        account.studentId = studentId;
+        return addAccount(account, password, db);
+    }
+    const int userId = find.value(0).toInt();
+
+    QString sql = "UPDATE users SET display_name = :name";
+    if (!username.isEmpty()) {
+        sql += ", username = :u";
+    }
+    if (!password.isEmpty()) {
+        sql += ", password_hash = :h";
+    }
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare(sql + " WHERE user_id = :id");
+    query.bindValue(":name", displayName);
+    if (!username.isEmpty()) {
+        query.bindValue(":u", username);
+    }
+    if (!password.isEmpty()) {
+        query.bindValue(":h", PasswordHasher::hash(password));
+    }
+    query.bindValue(":id", userId);
+
+    if (!query.exec()) {
+        qDebug() << "Save Student Account Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool UserRepository::deleteStudentAccount(int studentId, const QSqlDatabase& db) {
+    SIS_TRACE_SCOPE("db", "UserRepository::deleteStudentAccount");
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("DELETE FROM users WHERE student_id = :id");
+    query.bindValue(":id", studentId);
+
+    if (!query.exec()) {
+        qDebug() << "Delete Student Account Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool UserRepository::deleteFacultyAccount(int facultyId, const QSqlDatabase& db) {
+    SIS_TRACE_SCOPE("db", "UserRepository::deleteFacultyAccount");
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("DELETE FROM users WHERE faculty_id = :id");
+    query.bindValue(":id", facultyId);
+
+    if (!query.exec()) {
+        qDebug() << "Delete Faculty Account Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef USERREPOSITORY_H
+#define USERREPOSITORY_H
+
+#include "user.h"
+#include <QSqlDatabase>
+#include <optional>
+
+// Account row together with the profile fields the session needs
+struct UserLogin {
+    User user;
+    QString passwordHash;
+    QString department;   // From the linked student or faculty row
+    int year = 0;         // Students only
+    int sectionId = 0;    // Students only
+};
+
+class UserRepository {
+public:
+    UserRepository();
+
+    // Single indexed lookup joined with the linked student/faculty profile
+    std::optional<UserLogin> findForLogin(const QString& username);
+
+    // Inserts an account; password is hashed here. Uses db so callers can share a transaction.
+    bool addAccount(const User& user, const QString& password, const QSqlDatabase& db);
+    bool updatePasswordHash(int userId, const QString& hash);
+    // Fails when the student has no account
+    bool setStudentPassword(int studentId, const QString& password);
+    // Keeps a student's account in step with a profile edit: renames it and, when password
+    // is set, replaces the hash. Creates the account when there is none yet and both a
+    // username and a password are given.
+    bool saveStudentAccount(int studentId, const QString& username, const QString& displayName,
+                            const QString& password, const QSqlDatabase& db);
+    // MySQL ignores the inline REFERENCES ... ON DELETE CASCADE on users, so profile
+    // deletes remove the account themselves, in the same transaction
+    bool deleteStudentAccount(int studentId, const QSqlDatabase& db);
+    bool deleteFacultyAccount(int facultyId, const QSqlDatabase& db);
+};
+
+#endif // USERREPOSITORY_H
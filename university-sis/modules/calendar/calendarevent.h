@@ -0,0 +1,18 @@
+#ifndef CALENDAREVENT_H
+#define CALENDAREVENT_H
+
+#include <QString>
+#include <QDate>
+#include <QTime>
+
+struct CalendarEvent {
+    int id = 0;
+    QDate date = QDate::currentDate();
+    QTime time;
+    QString title;
+    QString type; // Class, Exam, Assignment Due, Meeting, Holiday, Other
+    QString description;
+    int seriesId = 0; // calendar_series row this occurrence was expanded from (id is 0 then)
+};
+
+#endif // CALENDAREVENT_H
@@ -0,0 +1,95 @@
+#include "calendareventcache.h"
+#include <algorithm>
+
+bool CalendarEventCache::covers(const QDate& from, const QDate& to) const
+{
+    const qint64 start = from.toJulianDay();
+    const qint64 end = to.toJulianDay();
+    // Last interval starting at or before `start`
+    auto it = m_loaded.upperBound(start);
+    if (it == m_loaded.constBegin()) {
+        return false;
+    }
+    --it;
+    return it.value() >= end;
+}
+
+void CalendarEventCache::insertRange(const QDate& from, const QDate& to, const std::vector<CalendarEvent>& events)
+{
+    qint64 start = from.toJulianDay();
+    qint64 end = to.toJulianDay();
+
+    // Replace cached days in the range with the fresh result
+    auto day = m_byDate.lowerBound(from);
+    while (day != m_byDate.end() && day.key() <= to) {
+        day = m_byDate.erase(day);
+    }
+    for (const auto& e : events) {
+        if (e.date >= from && e.date <= to) {
+            m_byDate[e.date].append(e);
+        }
+    }
+
+    // Merge with overlapping or adjacent intervals
+    auto it = m_loaded.upperBound(start);
+    if (it != m_loaded.begin()) {
+        auto prev = std::prev(it);
+        if (prev.value() + 1 >= start) {
+            start = prev.key();
+            end = std::max(end, prev.value());
+            it = m_loaded.erase(prev);
+        }
+    }
+    while (it != m_loaded.end() && it.key() <= end + 1) {
+        end = std::max(end, it.value());
+        it = m_loaded.erase(it);
+    }
+    m_loaded.insert(start, end);
+}
+
+void CalendarEventCache::addEvent(const CalendarEvent& event)
+{
+    if (!covers(event.date, event.date)) {
+        return; // Will be picked up when that range is loaded
+    }
+    QList<CalendarEvent>& list = m_byDate[event.date];
+    auto pos = std::upper_bound(list.begin(), list.end(), event,
+                                [](const CalendarEvent& a, const CalendarEvent& b) { return a.time < b.time; });
+    list.insert(pos, event);
+}
+
+void CalendarEventCache::removeEvent(int id)
+{
+    for (auto day = m_byDate.begin(); day != m_byDate.end(); ++day) {
+        QList<CalendarEvent>& list = day.value();
+        for (int i = 0; i < list.size(); ++i) {
+            if (list.at(i).id == id) {
+                list.removeAt(i);
+                if (list.isEmpty()) {
+                    m_byDate.erase(day);
+                }
+                return;
+            }
+        }
+    }
+}
+
+QList<CalendarEvent> CalendarEventCache::eventsOn(const QDate& date) const
+{
+    return m_byDate.value(date);
+}
+
+QList<QDate> CalendarEventCache::eventDates(const QDate& from, const QDate& to) const
+{
+    QList<QDate> dates;
+    for (auto it = m_byDate.lowerBound(from); it != m_byDate.constEnd() && it.key() <= to; ++it) {
+        dates.append(it.key());
+    }
+    return dates;
+}
+
+void CalendarEventCache::clear()
+{
+    m_loaded.clear();
+    m_byDate.clear();
+}
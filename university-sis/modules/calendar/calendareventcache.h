@@ -0,0 +1,39 @@
+#ifndef CALENDAREVENTCACHE_H
+#define CALENDAREVENTCACHE_H
+
+#include "calendarevent.h"
+#include <QMap>
+#include <QList>
+#include <QDate>
+#include <vector>
+
+/**
+ * @brief In-memory interval map of calendar events.
+ *
+ * Tracks which date ranges have been loaded (merged, non-overlapping
+ * intervals) and keeps the events of those ranges bucketed by day, so
+ * lookups inside a loaded range never touch the database.
+ */
+class CalendarEventCache {
+public:
+    // True when every day in [from, to] has been loaded
+    bool covers(const QDate& from, const QDate& to) const;
+
+    // Stores the complete event list for [from, to], replacing what was cached there
+    void insertRange(const QDate& from, const QDate& to, const std::vector<CalendarEvent>& events);
+
+    // Keep a loaded range in sync after a local write
+    void addEvent(const CalendarEvent& event);
+    void removeEvent(int id);
+
+    QList<CalendarEvent> eventsOn(const QDate& date) const;
+    QList<QDate> eventDates(const QDate& from, const QDate& to) const;
+
+    void clear();
+
+private:
+    QMap<qint64, qint64> m_loaded;               // Julian day start -> end (inclusive)
+    QMap<QDate, QList<CalendarEvent>> m_byDate;  // Only days with events
+};
+
+#endif // CALENDAREVENTCACHE_H
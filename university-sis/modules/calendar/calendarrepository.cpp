@@ -0,0 +1,221 @@
+#include "calendarrepository.h"
+#include "../../utils/tracer.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "../../utils/stringpool.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+std::atomic<quint64> writes{0};
+}
+
+CalendarRepository::CalendarRepository() {}
+
+quint64 CalendarRepository::changeCount() {
+    return writes.load();
+}
+
+bool CalendarRepository::failed(const char* what, const QSqlQuery& query) {
+    m_lastError = query.lastError().text();
+    qDebug() << what << m_lastError;
+    return false;
+}
+
+int CalendarRepository::addEvent(const CalendarEvent& event) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::addEvent");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO calendar_events (date, time, title, type, description) "
+                  "VALUES (:date, :time, :title, :type, :description)");
+    query.bindValue(":date", event.date.toString("yyyy-MM-dd"));
+    query.bindValue(":time", event.time.toString("HH:mm"));
+    query.bindValue(":title", event.title);
+    query.bindValue(":type", event.type);
+    query.bindValue(":description", event.description);
+
+    if (!query.exec()) {
+        return failed("Add Calendar Event Error:", query);
+    }
+    ++writes;
+    return query.lastInsertId().toInt();
+}
+
+bool CalendarRepository::deleteEvent(int id) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::deleteEvent");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("DELETE FROM calendar_events WHERE id = :id");
+    query.bindValue(":id", id);
+
+    if (!query.exec()) {
+        return failed("Delete Calendar Event Error:", query);
+    }
+    ++writes;
+    return true;
+}
+
+int CalendarRepository::addSeries(const RecurringEvent& series) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::addSeries");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO calendar_series (start_date, until_date, time, title, type, description, "
+                  "rrule, exdates, section_id) "
+                  "VALUES (:start, :until, :time, :title, :type, :description, :rrule, :exdates, :section)");
+    query.bindValue(":start", series.startDate.toString("yyyy-MM-dd"));
+    query.bindValue(":until", series.rule.until.isValid() ? QVariant(series.rule.until.toString("yyyy-MM-dd"))
+                                                          : QVariant());
+    query.bindValue(":time", series.time.toString("HH:mm"));
+    query.bindValue(":title", series.title);
+    query.bindValue(":type", series.type);
+    query.bindValue(":description", series.description);
+    query.bindValue(":rrule", series.rule.toRRule());
+    query.bindValue(":exdates", series.rule.exceptionsToString());
+    query.bindValue(":section", series.sectionId > 0 ? QVariant(series.sectionId) : QVariant());
+
+    if (!query.exec()) {
+        return failed("Add Calendar Series Error:", query);
+    }
+    ++writes;
+    return query.lastInsertId().toInt();
+}
+
+bool CalendarRepository::deleteSeries(int id) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::deleteSeries");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("DELETE FROM calendar_series WHERE id = :id");
+    query.bindValue(":id", id);
+
+    if (!query.exec()) {
+        return failed("Delete Calendar Series Error:", query);
+    }
+    ++writes;
+    return true;
+}
+
+bool CalendarRepository::addSeriesException(int seriesId, const QDate& date) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::addSeriesException");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT exdates FROM calendar_series WHERE id = :id");
+    query.bindValue(":id", seriesId);
+    if (!query.exec() || !query.next()) {
+        if (!query.lastError().isValid()) {
+            m_lastError = QString("recurring event %1 not found").arg(seriesId);
+            qDebug() << "Get Calendar Series Error:" << m_lastError;
+            return false;
+        }
+        return failed("Get Calendar Series Error:", query);
+    }
+
+    RecurrenceRule rule;
+    rule.setExceptionsFromString(query.value(0).toString());
+    rule.addException(date);
+
+    ProfiledQuery update(db, SIS_QUERY_SITE);
+    update.prepare("UPDATE calendar_series SET exdates = :exdates WHERE id = :id");
+    update.bindValue(":exdates", rule.exceptionsToString());
+    update.bindValue(":id", seriesId);
+    if (!update.exec()) {
+        return failed("Update Calendar Series Error:", update);
+    }
+    ++writes;
+    return true;
+}
+
+std::vector<RecurringEvent> CalendarRepository::getSeriesInRange(const QDate& from, const QDate& to) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::getSeriesInRange");
+    return getSeriesInRange(from, to, DatabaseManager::instance().getDatabase());
+}
+
+std::vector<RecurringEvent> CalendarRepository::getSeriesInRange(const QDate& from, const QDate& to, const QSqlDatabase& db) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::getSeriesInRange");
+    std::vector<RecurringEvent> series;
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    // until_date mirrors the rule's UNTIL so the window test stays in SQL (idx_calendar_series_range)
+    query.prepare("SELECT id, start_date, time, title, type, description, rrule, exdates, section_id "
+                  "FROM calendar_series "
+                  "WHERE start_date <= :to AND (until_date IS NULL OR until_date >= :from)");
+    query.bindValue(":to", to.toString("yyyy-MM-dd"));
+    query.bindValue(":from", from.toString("yyyy-MM-dd"));
+
+    if (!query.exec()) {
+        qDebug() << "Get Calendar Series Error:" << query.lastError().text();
+        return series;
+    }
+
+    while (query.next()) {
+        RecurringEvent s = seriesFromQuery(query);
+        if (s.rule.isValid()) {
+            series.push_back(s);
+        }
+    }
+    return series;
+}
+
+RecurringEvent CalendarRepository::seriesFromQuery(const QSqlQuery& query) {
+    RecurringEvent s;
+    s.id = query.value(0).toInt();
+    s.startDate = query.value(1).toDate();
+    s.time = QTime::fromString(query.value(2).toString().left(5), "HH:mm");
+    s.title = query.value(3).toString();
+    s.type = StringPool::instance().shared(query.value(4).toString());
+    s.description = query.value(5).toString();
+    if (auto rule = RecurrenceRule::fromRRule(query.value(6).toString())) {
+        s.rule = *rule;
+    }
+    s.rule.setExceptionsFromString(query.value(7).toString());
+    s.sectionId = query.value(8).toInt();
+    return s;
+}
+
+std::vector<CalendarEvent> CalendarRepository::getEventsInRange(const QDate& from, const QDate& to) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::getEventsInRange");
+    return getEventsInRange(from, to, DatabaseManager::instance().getDatabase());
+}
+
+std::vector<CalendarEvent> CalendarRepository::getEventsInRange(const QDate& from, const QDate& to, const QSqlDatabase& db) {
+    SIS_TRACE_SCOPE("db", "CalendarRepository::getEventsInRange");
+    std::vector<CalendarEvent> events;
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    // Range predicate on the indexed date column (idx_calendar_events_date)
+    query.prepare("SELECT id, date, time, title, type, description FROM calendar_events "
+                  "WHERE date >= :from AND date <= :to ORDER BY date, time");
+    query.bindValue(":from", from.toString("yyyy-MM-dd"));
+    query.bindValue(":to", to.toString("yyyy-MM-dd"));
+
+    if (!query.exec()) {
+        qDebug() << "Get Calendar Events Error:" << query.lastError().text();
+        return events;
+    }
+
+    while (query.next()) {
+        CalendarEvent e;
+        e.id = query.value(0).toInt();
+        e.date = query.value(1).toDate();
+        e.time = QTime::fromString(query.value(2).toString().left(5), "HH:mm");
+        e.title = query.value(3).toString();
+        e.type = StringPool::instance().shared(query.value(4).toString());
+        e.description = query.value(5).toString();
+        events.push_back(e);
+    }
+
+    // Occurrences exist only for the requested window
+    const size_t singles = events.size();
+    for (const auto& series : getSeriesInRange(from, to, db)) {
+        series.appendOccurrences(from, to, events);
+    }
+    if (events.size() > singles) {
+        std::stable_sort(events.begin(), events.end(), [](const CalendarEvent& a, const CalendarEvent& b) {
+            return a.date != b.date ? a.date < b.date : a.time < b.time;
+        });
+    }
+    return events;
+}
@@ -0,0 +1,47 @@
+#ifndef CALENDARREPOSITORY_H
+#define CALENDARREPOSITORY_H
+
+#include "calendarevent.h"
+#include "recurringevent.h"
+#include <QSqlDatabase>
+#include <QString>
+#include <vector>
+
+class QSqlQuery;
+
+class CalendarRepository {
+public:
+    CalendarRepository();
+
+    // Returns the new event id, or 0 on failure
+    int addEvent(const CalendarEvent& event);
+    bool deleteEvent(int id);
+
+    // Recurring series are stored once; occurrences are never written to the database
+    int addSeries(const RecurringEvent& series);
+    bool deleteSeries(int id);
+    // Skips a single occurrence (EXDATE) without touching the rest of the series
+    bool addSeriesException(int seriesId, const QDate& date);
+
+    // Series that can produce an occurrence in [from, to]
+    std::vector<RecurringEvent> getSeriesInRange(const QDate& from, const QDate& to);
+    std::vector<RecurringEvent> getSeriesInRange(const QDate& from, const QDate& to, const QSqlDatabase& db);
+
+    // Driver message of the last failed write on this repository
+    QString lastError() const { return m_lastError; }
+    // Bumped by every successful write in the process; callers holding cached events compare it
+    static quint64 changeCount();
+
+    // One-off events plus series occurrences expanded for [from, to], ordered by date and time
+    std::vector<CalendarEvent> getEventsInRange(const QDate& from, const QDate& to);
+    // Same query on an explicit connection (e.g. a ScopedConnection in a worker thread)
+    std::vector<CalendarEvent> getEventsInRange(const QDate& from, const QDate& to, const QSqlDatabase& db);
+
+private:
+    static RecurringEvent seriesFromQuery(const QSqlQuery& query);
+    bool failed(const char* what, const QSqlQuery& query);  // Logs, keeps the error text, returns false
+
+    QString m_lastError;
+};
+
+#endif // CALENDARREPOSITORY_H
@@ -0,0 +1,108 @@
+#include "recurrencerule.h"
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+const char* const kDayCodes[7] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+}
+
+bool RecurrenceRule::isException(const QDate& date) const
+{
+    return std::binary_search(exceptions.begin(), exceptions.end(), date.toJulianDay());
+}
+
+void RecurrenceRule::addException(const QDate& date)
+{
+    const qint64 jd = date.toJulianDay();
+    auto pos = std::lower_bound(exceptions.begin(), exceptions.end(), jd);
+    if (pos == exceptions.end() || *pos != jd) {
+        exceptions.insert(pos, jd);
+    }
+}
+
+QList<QDate> RecurrenceRule::occurrences(const QDate& start, const QDate& from, const QDate& to) const
+{
+    QList<QDate> dates;
+    forEachOccurrence(start, from, to, [&dates](const QDate& date) { dates.append(date); });
+    return dates;
+}
+
+QString RecurrenceRule::toRRule() const
+{
+    QStringList days;
+    for (int day = 0; day < 7; ++day) {
+        if (weekdays & (1 << day)) {
+            days << kDayCodes[day];
+        }
+    }
+    QString rule = "FREQ=WEEKLY";
+    if (intervalWeeks > 1) {
+        rule += QString(";INTERVAL=%1").arg(intervalWeeks);
+    }
+    rule += ";BYDAY=" + days.join(',');
+    if (until.isValid()) {
+        rule += ";UNTIL=" + until.toString("yyyyMMdd");
+    }
+    return rule;
+}
+
+std::optional<RecurrenceRule> RecurrenceRule::fromRRule(const QString& text)
+{
+    RecurrenceRule rule;
+    bool weekly = false;
+    const QStringList parts = text.trimmed().toUpper().split(';', Qt::SkipEmptyParts);
+    for (const QString& part : parts) {
+        const int eq = part.indexOf('=');
+        if (eq <= 0) {
+            return std::nullopt;
+        }
+        const QString key = part.left(eq);
+        const QString value = part.mid(eq + 1);
+        if (key == "FREQ") {
+            weekly = (value == "WEEKLY");
+        } else if (key == "INTERVAL") {
+            bool ok = false;
+            rule.intervalWeeks = value.toInt(&ok);
+            if (!ok || rule.intervalWeeks < 1) {
+                return std::nullopt;
+            }
+        } else if (key == "BYDAY") {
+            for (const QString& code : value.split(',', Qt::SkipEmptyParts)) {
+                for (int day = 0; day < 7; ++day) {
+                    if (code == kDayCodes[day]) {
+                        rule.weekdays |= quint8(1 << day);
+                    }
+                }
+            }
+        } else if (key == "UNTIL") {
+            rule.until = QDate::fromString(value.left(8), "yyyyMMdd");
+        }
+        // Other RRULE parts are not supported and ignored
+    }
+    if (!weekly || !rule.isValid()) {
+        return std::nullopt;
+    }
+    return rule;
+}
+
+QString RecurrenceRule::exceptionsToString() const
+{
+    QStringList dates;
+    for (qint64 jd : exceptions) {
+        dates << QDate::fromJulianDay(jd).toString(Qt::ISODate);
+    }
+    return dates.join(',');
+}
+
+void RecurrenceRule::setExceptionsFromString(const QString& text)
+{
+    exceptions.clear();
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+        const QDate date = QDate::fromString(part.trimmed(), Qt::ISODate);
+        if (date.isValid()) {
+            exceptions.push_back(date.toJulianDay());
+        }
+    }
+    std::sort(exceptions.begin(), exceptions.end());
+    exceptions.erase(std::unique(exceptions.begin(), exceptions.end()), exceptions.end());
+}
@@ -0,0 +1,98 @@
+#ifndef RECURRENCERULE_H
+#define RECURRENCERULE_H
+
+#include <QDate>
+#include <QString>
+#include <QList>
+#include <QtGlobal>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Weekly recurrence in a small RRULE subset:
+ * FREQ=WEEKLY;INTERVAL=n;BYDAY=MO,WE;UNTIL=yyyyMMdd plus EXDATE-style exceptions.
+ *
+ * Occurrences are never stored; they are expanded on demand for a window.
+ */
+class RecurrenceRule {
+public:
+    enum Weekday : quint8 {
+        Monday = 1 << 0,
+        Tuesday = 1 << 1,
+        Wednesday = 1 << 2,
+        Thursday = 1 << 3,
+        Friday = 1 << 4,
+        Saturday = 1 << 5,
+        Sunday = 1 << 6
+    };
+
+    quint8 weekdays = 0;        // Weekday bit mask
+    int intervalWeeks = 1;      // Every n-th week, counted from the start week
+    QDate until;                // Inclusive; invalid = open ended
+    std::vector<qint64> exceptions;  // Sorted Julian days that are skipped
+
+    static quint8 weekdayBit(const QDate& date) { return quint8(1 << (date.dayOfWeek() - 1)); }
+
+    bool isValid() const { return weekdays != 0 && intervalWeeks > 0; }
+    bool isException(const QDate& date) const;
+    void addException(const QDate& date);
+
+    // Occurrence dates of a series starting on `start`, restricted to [from, to]
+    QList<QDate> occurrences(const QDate& start, const QDate& from, const QDate& to) const;
+
+    // Calls fn(date) for every occurrence in [from, to] without building a list
+    template <typename Fn>
+    void forEachOccurrence(const QDate& start, const QDate& from, const QDate& to, Fn fn) const;
+
+    QString toRRule() const;
+    static std::optional<RecurrenceRule> fromRRule(const QString& text);
+
+    QString exceptionsToString() const;                 // Comma separated ISO dates
+    void setExceptionsFromString(const QString& text);
+};
+
+template <typename Fn>
+void RecurrenceRule::forEachOccurrence(const QDate& start, const QDate& from, const QDate& to, Fn fn) const
+{
+    if (!isValid() || !start.isValid() || !from.isValid() || !to.isValid()) {
+        return;
+    }
+
+    const qint64 first = qMax(start.toJulianDay(), from.toJulianDay());
+    qint64 last = to.toJulianDay();
+    if (until.isValid()) {
+        last = qMin(last, until.toJulianDay());
+    }
+    if (first > last) {
+        return;
+    }
+
+    // Monday of the week containing the series start anchors the interval
+    const qint64 anchorMonday = start.toJulianDay() - (start.dayOfWeek() - 1);
+    const qint64 firstMonday = first - (QDate::fromJulianDay(first).dayOfWeek() - 1);
+    qint64 weekIndex = (firstMonday - anchorMonday) / 7;
+    const qint64 skip = (intervalWeeks - weekIndex % intervalWeeks) % intervalWeeks;
+    weekIndex += skip;
+
+    auto exception = exceptions.begin();
+    for (qint64 monday = anchorMonday + weekIndex * 7; monday <= last; monday += 7 * intervalWeeks) {
+        for (int day = 0; day < 7; ++day) {
+            if (!(weekdays & (1 << day))) {
+                continue;
+            }
+            const qint64 jd = monday + day;
+            if (jd < first || jd > last) {
+                continue;
+            }
+            while (exception != exceptions.end() && *exception < jd) {
+                ++exception;
+            }
+            if (exception != exceptions.end() && *exception == jd) {
+                continue;
+            }
+            fn(QDate::fromJulianDay(jd));
+        }
+    }
+}
+
+#endif // RECURRENCERULE_H
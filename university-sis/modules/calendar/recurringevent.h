@@ -0,0 +1,38 @@
+#ifndef RECURRINGEVENT_H
+#define RECURRINGEVENT_H
+
+#include "calendarevent.h"
+#include "recurrencerule.h"
+#include <vector>
+
+// A calendar_series row: one stored event plus the rule that repeats it
+struct RecurringEvent {
+    int id = 0;
+    QDate startDate = QDate::currentDate();
+    QTime time;
+    QString title;
+    QString type;
+    QString description;
+    int sectionId = 0; // 0 = not tied to a section
+    RecurrenceRule rule;
+
+    CalendarEvent occurrenceOn(const QDate& date) const {
+        CalendarEvent e;
+        e.date = date;
+        e.time = time;
+        e.title = title;
+        e.type = type;
+        e.description = description;
+        e.seriesId = id;
+        return e;
+    }
+
+    // Expands only the occurrences inside [from, to]
+    void appendOccurrences(const QDate& from, const QDate& to, std::vector<CalendarEvent>& out) const {
+        rule.forEachOccurrence(startDate, from, to, [this, &out](const QDate& date) {
+            out.push_back(occurrenceOn(date));
+        });
+    }
+};
+
+#endif // RECURRINGEVENT_H
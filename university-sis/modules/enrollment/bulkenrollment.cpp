@@ -0,0 +1,224 @@
+#include "bulkenrollment.h"
+#include "enrollmentrepository.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QIODevice>
+#include <QFile>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QStringList>
+#include <QDebug>
+
+QString BulkEnrollmentRow::message() const
+{
+    if (!error.isEmpty()) {
+        return error;
+    }
+    EnrollmentDecision decision;
+    decision.status = status;
+    decision.studentId = studentId;
+    decision.sectionId = sectionId;
+    return decision.message();
+}
+
+BulkEnrollmentPipeline::BulkEnrollmentPipeline() {}
+
+BulkEnrollmentPipeline::BulkEnrollmentPipeline(const Config& config) : m_config(config) {}
+
+std::vector<BulkEnrollmentRow> BulkEnrollmentPipeline::parseCsv(QIODevice& device)
+{
+    std::vector<BulkEnrollmentRow> rows;
+    QTextStream in(&device);
+    int line = 0;
+    while (!in.atEnd()) {
+        const QString text = in.readLine().trimmed();
+        ++line;
+        if (text.isEmpty()) {
+            continue;
+        }
+        const QStringList fields = text.split(',');
+        BulkEnrollmentRow row;
+        row.line = line;
+        bool studentOk = false;
+        bool sectionOk = false;
+        if (fields.size() >= 2) {
+            row.studentId = fields.at(0).trimmed().remove('"').toInt(&studentOk);
+            row.sectionId = fields.at(1).trimmed().remove('"').toInt(&sectionOk);
+        }
+        if (!studentOk || !sectionOk) {
+            if (line == 1) {
+                continue; // Header
+            }
+            row.status = EnrollmentCheck::InvalidInput;
+            row.error = QString("Line %1: expected student_id,section_id but got \"%2\"").arg(line).arg(text);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+std::vector<BulkEnrollmentRow> BulkEnrollmentPipeline::fromList(const std::vector<Enrollment>& requests)
+{
+    std::vector<BulkEnrollmentRow> rows;
+    rows.reserve(requests.size());
+    for (const auto& request : requests) {
+        BulkEnrollmentRow row;
+        row.line = int(rows.size()) + 1;
+        row.studentId = request.studentId;
+        row.sectionId = request.sectionId;
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+BulkEnrollmentPipeline::Summary BulkEnrollmentPipeline::run(std::vector<BulkEnrollmentRow> rows, const Progress& progress)
+{
+    Summary summary;
+    summary.total = int(rows.size());
+    QElapsedTimer timer;
+    timer.start();
+
+    // Student ids fit in memory even for a large campus; one scan instead of a query per row
+    QSet<int> students;
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (query.exec("SELECT student_id FROM students")) {
+        while (query.next()) {
+            students.insert(query.value(0).toInt());
+        }
+    } else {
+        qDebug() << "Bulk Enrollment Load Students Error:" << query.lastError().text();
+    }
+
+    QSet<quint64> seen;
+    std::vector<Enrollment> candidates;
+    std::vector<int> candidateRows;
+    candidates.reserve(rows.size());
+    candidateRows.reserve(rows.size());
+    for (int i = 0; i < int(rows.size()); ++i) {
+        BulkEnrollmentRow& row = rows[i];
+        if (row.status != EnrollmentCheck::Ok) {
+            continue;
+        }
+        if (!students.contains(row.studentId)) {
+            row.status = EnrollmentCheck::UnknownStudent;
+            continue;
+        }
+        const quint64 key = (quint64(quint32(row.studentId)) << 32) | quint32(row.sectionId);
+        if (seen.contains(key)) {
+            row.status = EnrollmentCheck::DuplicateRequest;
+            continue;
+        }
+        seen.insert(key);
+        Enrollment e;
+        e.studentId = row.studentId;
+        e.sectionId = row.sectionId;
+        candidates.push_back(e);
+        candidateRows.push_back(i);
+    }
+
+    // Section, capacity and clash checks run in parallel; seats stay reserved unless dry run
+    const std::vector<EnrollmentDecision> decisions =
+        EnrollmentValidator::instance().validateBulk(candidates, m_config.dryRun, m_config.threadCount);
+    std::vector<int> accepted;
+    accepted.reserve(decisions.size());
+    for (size_t i = 0; i < decisions.size(); ++i) {
+        BulkEnrollmentRow& row = rows[candidateRows[i]];
+        row.status = decisions[i].status;
+        if (decisions[i].ok()) {
+            accepted.push_back(candidateRows[i]);
+        }
+    }
+    summary.validateMs = timer.restart();
+
+    if (!m_config.dryRun) {
+        const int batchSize = qMax(1, m_config.batchSize);
+        for (size_t begin = 0; begin < accepted.size(); begin += size_t(batchSize)) {
+            const size_t end = qMin(accepted.size(), begin + size_t(batchSize));
+            const std::vector<int> batch(accepted.begin() + begin, accepted.begin() + end);
+            commitBatch(rows, batch);
+            if (progress) {
+                progress(int(end), int(accepted.size()));
+            }
+        }
+    }
+    summary.commitMs = timer.elapsed();
+
+    for (const auto& row : rows) {
+        if (row.status == EnrollmentCheck::Ok) {
+            ++summary.enrolled;
+        } else {
+            ++summary.rejected;
+            summary.failures.push_back(row);
+        }
+    }
+    return summary;
+}
+
+bool BulkEnrollmentPipeline::commitBatch(std::vector<BulkEnrollmentRow>& rows, const std::vector<int>& batch)
+{
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    DatabaseManager::beginTransaction(db);
+
+    // Row by row in one transaction: the insert re-checks the seat in SQL, and a
+    // failing row is rejected with its reason instead of failing the batch
+    ProfiledQuery insert(db, SIS_QUERY_SITE);
+    EnrollmentRepository::prepareInsert(insert);
+    bool countsStale = false;
+    for (int i : batch) {
+        BulkEnrollmentRow& row = rows[i];
+        row.status = EnrollmentRepository::execInsert(insert, row.studentId, row.sectionId);
+        if (row.status == EnrollmentCheck::Ok) {
+            continue;
+        }
+        if (row.status == EnrollmentCheck::DatabaseError) {
+            row.error = QString("Line %1: %2").arg(row.line).arg(insert.lastError().text());
+        } else {
+            countsStale = true; // Seat taken by another session
+        }
+        EnrollmentValidator::instance().release(row.studentId, row.sectionId);
+    }
+    if (!DatabaseManager::commitTransaction(db)) {
+        qDebug() << "Bulk Enrollment Commit Error:" << db.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        for (int i : batch) {
+            BulkEnrollmentRow& row = rows[i];
+            if (row.status == EnrollmentCheck::Ok) {
+                row.status = EnrollmentCheck::DatabaseError;
+                row.error = QString("Line %1: %2").arg(row.line).arg(db.lastError().text());
+                EnrollmentValidator::instance().release(row.studentId, row.sectionId);
+            }
+        }
+        return false;
+    }
+    if (countsStale) {
+        EnrollmentValidator::instance().invalidate();
+    }
+    return true;
+}
+
+bool BulkEnrollmentPipeline::writeErrorReport(const Summary& summary, const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    out.setEncoding(QStringConverter::Utf8);
+#else
+    out.setCodec("UTF-8");
+#endif
+    out << "line,student_id,section_id,reason\n";
+    for (const auto& row : summary.failures) {
+        QString reason = row.message();
+        out << row.line << "," << row.studentId << "," << row.sectionId << ",\""
+            << reason.replace("\"", "\"\"") << "\"\n";
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef BULKENROLLMENT_H
+#define BULKENROLLMENT_H
+
+#include "enrollment.h"
+#include "enrollmentvalidator.h"
+#include <QString>
+#include <functional>
+#include <vector>
+
+class QIODevice;
+
+struct BulkEnrollmentRow {
+    int line = 0; // 1-based source line (list input: position)
+    int studentId = 0;
+    int sectionId = 0;
+    EnrollmentCheck status = EnrollmentCheck::Ok;
+    QString error; // Detail for InvalidInput / DatabaseError
+
+    QString message() const;
+};
+
+/**
+ * @brief Registration-day enrollment of many (student, section) pairs.
+ *
+ * Rows are checked for unknown students and duplicates, decided in parallel
+ * by EnrollmentValidator (section, capacity, clashes), then inserted in
+ * batched transactions. Each insert re-checks the seat in SQL, and every
+ * rejected row is reported with its reason instead of failing the file.
+ */
+class BulkEnrollmentPipeline {
+public:
+    struct Config {
+        int batchSize = 1000; // Rows per transaction
+        int threadCount = 0;  // 0 = QThread::idealThreadCount()
+        bool dryRun = false;  // Validate only, insert nothing
+    };
+
+    struct Summary {
+        int total = 0;
+        int enrolled = 0; // Inserted, or accepted in a dry run
+        int rejected = 0;
+        qint64 validateMs = 0;
+        qint64 commitMs = 0;
+        std::vector<BulkEnrollmentRow> failures; // Input order
+    };
+
+    using Progress = std::function<void(int done, int total)>;
+
+    BulkEnrollmentPipeline();
+    explicit BulkEnrollmentPipeline(const Config& config);
+
+    // "student_id,section_id" per line; a header line and blank lines are skipped
+    static std::vector<BulkEnrollmentRow> parseCsv(QIODevice& device);
+    static std::vector<BulkEnrollmentRow> fromList(const std::vector<Enrollment>& requests);
+
+    Summary run(std::vector<BulkEnrollmentRow> rows, const Progress& progress = Progress());
+
+    static bool writeErrorReport(const Summary& summary, const QString& path);
+
+private:
+    bool commitBatch(std::vector<BulkEnrollmentRow>& rows, const std::vector<int>& batch);
+
+    Config m_config;
+};
+
+#endif // BULKENROLLMENT_H
@@ -1,43 +1,109 @@
 #include "enrollmentrepository.h"
+#include "../../utils/tracer.h"
 #include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "waitlistmanager.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 
 EnrollmentRepository::EnrollmentRepository() {}
 
-bool EnrollmentRepository::enrollStudent(const Enrollment& enrollment) {
+EnrollmentDecision EnrollmentRepository::enroll(const Enrollment& enrollment) {
+    SIS_TRACE_SCOPE("db", "EnrollmentRepository::enroll");
+    EnrollmentDecision decision = EnrollmentValidator::instance().reserve(enrollment.studentId, enrollment.sectionId);
+    if (!decision.ok()) {
+        return decision;
+    }
+
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
-    query.prepare("INSERT INTO student_section (student_id, section_id) VALUES (:sid, :secid)");
-    query.bindValue(":sid", enrollment.studentId);
-    query.bindValue(":secid", enrollment.sectionId);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    prepareInsert(query);
+    decision.status = execInsert(query, enrollment.studentId, enrollment.sectionId);
     
-    if (!query.exec()) {
+    if (decision.status == EnrollmentCheck::DatabaseError) {
         qDebug() << "Enroll Error:" << query.lastError().text();
-        return false;
+        EnrollmentValidator::instance().release(enrollment.studentId, enrollment.sectionId);
+    } else if (decision.status == EnrollmentCheck::SectionFull) {
+        // Another session took the last seat; the in-memory counts are behind
+        EnrollmentValidator::instance().release(enrollment.studentId, enrollment.sectionId);
+        EnrollmentValidator::instance().invalidate();
     }
-    return true;
+    return decision;
+}
+
+bool EnrollmentRepository::prepareInsert(ProfiledQuery& query) {
+    return query.prepare("INSERT INTO student_section (student_id, section_id) "
+                         "SELECT :sid, s.section_id FROM sections s "
+                         "WHERE s.section_id = :secid AND (s.max_students <= 0 OR "
+                         "(SELECT COUNT(*) FROM student_section e WHERE e.section_id = s.section_id) < s.max_students)");
+}
+
+EnrollmentCheck EnrollmentRepository::execInsert(ProfiledQuery& query, int studentId, int sectionId) {
+    query.bindValue(":sid", studentId);
+    query.bindValue(":secid", sectionId);
+    if (!query.exec()) {
+        return EnrollmentCheck::DatabaseError;
+    }
+    return query.numRowsAffected() > 0 ? EnrollmentCheck::Ok : EnrollmentCheck::SectionFull;
 }
 
-bool EnrollmentRepository::unenrollStudent(int studentId, int sectionId) {
+bool EnrollmentRepository::enrollStudent(const Enrollment& enrollment) {
+    SIS_TRACE_SCOPE("db", "EnrollmentRepository::enrollStudent");
+    return enroll(enrollment).ok();
+}
+
+bool EnrollmentRepository::unenrollStudent(int studentId, int sectionId, int* promotedStudentId) {
+    SIS_TRACE_SCOPE("db", "EnrollmentRepository::unenrollStudent");
+    if (promotedStudentId) {
+        *promotedStudentId = 0;
+    }
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    DatabaseManager::beginTransaction(db);
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("DELETE FROM student_section WHERE student_id = :sid AND section_id = :secid");
     query.bindValue(":sid", studentId);
     query.bindValue(":secid", sectionId);
     
     if (!query.exec()) {
         qDebug() << "Unenroll Error:" << query.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
         return false;
     }
+
+    int promoted = 0;
+    if (query.numRowsAffected() > 0) {
+        EnrollmentValidator::instance().release(studentId, sectionId);
+        if (!WaitlistManager::instance().promoteNext(sectionId, db, promoted)) {
+            DatabaseManager::rollbackTransaction(db);
+            EnrollmentValidator::instance().invalidate(); // Seat counts no longer match; rebuild
+            WaitlistManager::instance().invalidate();
+            return false;
+        }
+    }
+
+    if (!DatabaseManager::commitTransaction(db)) {
+        qDebug() << "Unenroll Commit Error:" << db.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        EnrollmentValidator::instance().invalidate();
+        WaitlistManager::instance().invalidate();
+        return false;
+    }
+    if (promoted > 0) {
+        WaitlistManager::instance().promotionCommitted(sectionId, promoted);
+        if (promotedStudentId) {
+            *promotedStudentId = promoted;
+        }
+    }
     return true;
 }
 
 std::vector<Enrollment> EnrollmentRepository::getAllEnrollments() {
+    SIS_TRACE_SCOPE("db", "EnrollmentRepository::getAllEnrollments");
     std::vector<Enrollment> list;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query("SELECT student_id, section_id FROM student_section", db);
+    ProfiledQuery query("SELECT student_id, section_id FROM student_section", db, SIS_QUERY_SITE);
     
     while (query.next()) {
         Enrollment e;
@@ -49,9 +115,10 @@ std::vector<Enrollment> EnrollmentRepository::getAllEnrollments() {
 }
 
 std::vector<Enrollment> EnrollmentRepository::getAllEnrollmentsWithNames() {
+    SIS_TRACE_SCOPE("db", "EnrollmentRepository::getAllEnrollmentsWithNames");
     std::vector<Enrollment> list;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     
     query.prepare("SELECT ss.student_id, s.name as student_name, ss.section_id "
                   "FROM student_section ss "
@@ -74,9 +141,10 @@ std::vector<Enrollment> EnrollmentRepository::getAllEnrollmentsWithNames() {
 }
 
 std::vector<int> EnrollmentRepository::getStudentIdsBySection(int sectionId) {
+    SIS_TRACE_SCOPE("db", "EnrollmentRepository::getStudentIdsBySection");
     std::vector<int> studentIds;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("SELECT student_id FROM student_section WHERE section_id = :secid");
     query.bindValue(":secid", sectionId);
     
@@ -2,14 +2,26 @@
 #define ENROLLMENTREPOSITORY_H
 
 #include "enrollment.h"
+#include "enrollmentvalidator.h"
 #include <vector>
 
+class ProfiledQuery;
+
 class EnrollmentRepository {
 public:
     EnrollmentRepository();
     
+    // Checks capacity and timetable clashes (EnrollmentValidator) before inserting
+    EnrollmentDecision enroll(const Enrollment& enrollment);
     bool enrollStudent(const Enrollment& enrollment);
-    bool unenrollStudent(int studentId, int sectionId);
+    // Promotes the next waitlisted student into the freed seat in the same transaction
+    bool unenrollStudent(int studentId, int sectionId, int* promotedStudentId = nullptr);
+
+    // The INSERT every enrollment path uses: the row is only added while the section
+    // still has a free seat, so capacity holds across processes and the validator's
+    // in-memory counts stay a fast pre-check. Returns SectionFull when no row went in.
+    static bool prepareInsert(ProfiledQuery& query);
+    static EnrollmentCheck execInsert(ProfiledQuery& query, int studentId, int sectionId);
     
     // Returns list of (Student ID, Section ID) pairs
     std::vector<Enrollment> getAllEnrollments();
@@ -0,0 +1,327 @@
+#include "enrollmentvalidator.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QTime>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QDebug>
+#include <algorithm>
+
+QString EnrollmentDecision::message() const
+{
+    switch (status) {
+    case EnrollmentCheck::Ok:
+        return "OK";
+    case EnrollmentCheck::UnknownSection:
+        return QString("Section %1 does not exist.").arg(sectionId);
+    case EnrollmentCheck::SectionFull:
+        return QString("Section %1 is full.").arg(sectionId);
+    case EnrollmentCheck::AlreadyEnrolled:
+        return QString("Student %1 is already enrolled in section %2.").arg(studentId).arg(sectionId);
+    case EnrollmentCheck::ScheduleClash:
+        return QString("Section %1 clashes with section %2 in student %3's timetable.")
+            .arg(sectionId).arg(clashingSectionId).arg(studentId);
+    case EnrollmentCheck::DatabaseError:
+        return "Database error.";
+    case EnrollmentCheck::UnknownStudent:
+        return QString("Student %1 does not exist.").arg(studentId);
+    case EnrollmentCheck::DuplicateRequest:
+        return QString("Duplicate request for student %1 in section %2.").arg(studentId).arg(sectionId);
+    case EnrollmentCheck::InvalidInput:
+        return "Invalid input line.";
+    }
+    return QString();
+}
+
+EnrollmentValidator& EnrollmentValidator::instance()
+{
+    static EnrollmentValidator validator;
+    return validator;
+}
+
+EnrollmentValidator::EnrollmentValidator() {}
+
+void EnrollmentValidator::ensureLoaded()
+{
+    {
+        QReadLocker locker(&m_lock);
+        if (m_loaded) {
+            return;
+        }
+    }
+    load(DatabaseManager::instance().getDatabase());
+}
+
+void EnrollmentValidator::invalidate()
+{
+    QWriteLocker locker(&m_lock);
+    m_loaded = false;
+}
+
+void EnrollmentValidator::load(const QSqlDatabase& db)
+{
+    QWriteLocker locker(&m_lock);
+
+    m_sections.clear();
+    m_sectionIndex.clear();
+    for (auto& stripe : m_stripes) {
+        stripe.students.clear();
+    }
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT s.section_id, s.max_students, ss.days, ss.start_time, ss.end_time "
+                    "FROM sections s LEFT JOIN section_schedule ss ON ss.section_id = s.section_id")) {
+        qDebug() << "Load Enrollment Index Error:" << query.lastError().text();
+    }
+    while (query.next()) {
+        SectionInfo info;
+        info.id = query.value(0).toInt();
+        info.capacity = query.value(1).toInt();
+        const int days = query.value(2).toInt();
+        const QTime start = QTime::fromString(query.value(3).toString().left(5), "HH:mm");
+        const QTime end = QTime::fromString(query.value(4).toString().left(5), "HH:mm");
+        if (days != 0 && start.isValid() && end.isValid()) {
+            const int startMin = start.hour() * 60 + start.minute();
+            const int endMin = end.hour() * 60 + end.minute();
+            for (int day = 0; day < 7; ++day) {
+                if (days & (1 << day)) {
+                    info.meetings.push_back({day * 1440 + startMin, day * 1440 + endMin});
+                }
+            }
+        }
+        m_sectionIndex.insert(info.id, int(m_sections.size()));
+        m_sections.push_back(info);
+    }
+
+    m_enrolled.reset(new std::atomic<int>[m_sections.size()]);
+    for (size_t i = 0; i < m_sections.size(); ++i) {
+        m_enrolled[i].store(0);
+    }
+
+    int legacyClashes = 0;
+    if (!query.exec("SELECT student_id, section_id FROM student_section")) {
+        qDebug() << "Load Enrollment Index Error:" << query.lastError().text();
+    }
+    while (query.next()) {
+        const int studentId = query.value(0).toInt();
+        auto it = m_sectionIndex.constFind(query.value(1).toInt());
+        if (it == m_sectionIndex.constEnd()) {
+            continue;
+        }
+        const int section = it.value();
+        StudentIndex& student = stripeFor(studentId).students[studentId];
+        if (!student.sections.insert(section).second) {
+            continue;
+        }
+        m_enrolled[section].fetch_add(1, std::memory_order_relaxed);
+        for (const Interval& meeting : m_sections[section].meetings) {
+            // Existing rows predate validation; keep them but index only the first of a clash
+            if (clashIn(student, meeting) >= 0) {
+                ++legacyClashes;
+                continue;
+            }
+            student.busy.emplace(meeting.start, std::make_pair(meeting.end, section));
+        }
+    }
+    if (legacyClashes > 0) {
+        qDebug() << "Enrollment index: existing enrollments with timetable clashes:" << legacyClashes;
+    }
+    m_loaded = true;
+}
+
+int EnrollmentValidator::clashIn(const StudentIndex& student, const Interval& meeting)
+{
+    // Intervals are disjoint, so only the neighbours around meeting.start can overlap it
+    auto next = student.busy.upper_bound(meeting.start);
+    if (next != student.busy.end() && next->first < meeting.end) {
+        return next->second.second;
+    }
+    if (next != student.busy.begin()) {
+        auto prev = std::prev(next);
+        if (prev->second.first > meeting.start) {
+            return prev->second.second;
+        }
+    }
+    return -1;
+}
+
+EnrollmentDecision EnrollmentValidator::decide(StudentIndex& student, int studentId, int section, bool commit)
+{
+    EnrollmentDecision decision;
+    decision.studentId = studentId;
+    decision.sectionId = m_sections[section].id;
+
+    if (student.sections.count(section) > 0) {
+        decision.status = EnrollmentCheck::AlreadyEnrolled;
+        return decision;
+    }
+    for (const Interval& meeting : m_sections[section].meetings) {
+        const int other = clashIn(student, meeting);
+        if (other >= 0) {
+            decision.status = EnrollmentCheck::ScheduleClash;
+            decision.clashingSectionId = m_sections[other].id;
+            return decision;
+        }
+    }
+
+    // Seats are shared by all stripes, so they are taken with a CAS instead of a lock
+    const int capacity = m_sections[section].capacity;
+    std::atomic<int>& seats = m_enrolled[section];
+    int taken = seats.load(std::memory_order_relaxed);
+    for (;;) {
+        if (capacity > 0 && taken >= capacity) {
+            decision.status = EnrollmentCheck::SectionFull;
+            return decision;
+        }
+        if (!commit || seats.compare_exchange_weak(taken, taken + 1, std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+
+    if (commit) {
+        student.sections.insert(section);
+        for (const Interval& meeting : m_sections[section].meetings) {
+            student.busy.emplace(meeting.start, std::make_pair(meeting.end, section));
+        }
+    }
+    return decision;
+}
+
+EnrollmentDecision EnrollmentValidator::reserve(int studentId, int sectionId)
+{
+    ensureLoaded();
+    return reserveLoaded(studentId, sectionId);
+}
+
+EnrollmentDecision EnrollmentValidator::reserveLoaded(int studentId, int sectionId)
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_sectionIndex.constFind(sectionId);
+    if (it == m_sectionIndex.constEnd()) {
+        EnrollmentDecision decision;
+        decision.status = EnrollmentCheck::UnknownSection;
+        decision.studentId = studentId;
+        decision.sectionId = sectionId;
+        return decision;
+    }
+    Stripe& stripe = stripeFor(studentId);
+    QMutexLocker studentLock(&stripe.mutex);
+    return decide(stripe.students[studentId], studentId, it.value(), true);
+}
+
+EnrollmentDecision EnrollmentValidator::check(int studentId, int sectionId)
+{
+    ensureLoaded();
+    QReadLocker locker(&m_lock);
+    auto it = m_sectionIndex.constFind(sectionId);
+    if (it == m_sectionIndex.constEnd()) {
+        EnrollmentDecision decision;
+        decision.status = EnrollmentCheck::UnknownSection;
+        decision.studentId = studentId;
+        decision.sectionId = sectionId;
+        return decision;
+    }
+    Stripe& stripe = stripeFor(studentId);
+    QMutexLocker studentLock(&stripe.mutex);
+    StudentIndex empty;
+    auto student = stripe.students.find(studentId);
+    return decide(student != stripe.students.end() ? student.value() : empty, studentId, it.value(), false);
+}
+
+void EnrollmentValidator::release(int studentId, int sectionId)
+{
+    QReadLocker locker(&m_lock);
+    if (!m_loaded) {
+        return; // Rebuilt from the database on next use
+    }
+    auto it = m_sectionIndex.constFind(sectionId);
+    if (it == m_sectionIndex.constEnd()) {
+        return;
+    }
+    const int section = it.value();
+    Stripe& stripe = stripeFor(studentId);
+    QMutexLocker studentLock(&stripe.mutex);
+    auto student = stripe.students.find(studentId);
+    if (student == stripe.students.end() || student.value().sections.erase(section) == 0) {
+        return;
+    }
+    for (const Interval& meeting : m_sections[section].meetings) {
+        auto busy = student.value().busy.find(meeting.start);
+        if (busy != student.value().busy.end() && busy->second.second == section) {
+            student.value().busy.erase(busy);
+        }
+    }
+    m_enrolled[section].fetch_sub(1, std::memory_order_acq_rel);
+}
+
+std::vector<EnrollmentDecision> EnrollmentValidator::validateBulk(const std::vector<Enrollment>& requests,
+                                                                  bool dryRun, int threadCount)
+{
+    ensureLoaded(); // On the calling thread, which owns the database connection
+
+    std::vector<EnrollmentDecision> decisions(requests.size());
+
+    // One group per student keeps that student's requests in order on one worker
+    QHash<int, std::vector<int>> byStudent;
+    for (int i = 0; i < int(requests.size()); ++i) {
+        byStudent[requests[i].studentId].push_back(i);
+    }
+    std::vector<std::vector<int>> groups;
+    groups.reserve(byStudent.size());
+    for (auto it = byStudent.begin(); it != byStudent.end(); ++it) {
+        groups.push_back(std::move(it.value()));
+    }
+
+    const int threads = std::max(1, std::min(threadCount > 0 ? threadCount : QThread::idealThreadCount(),
+                                             int(groups.size())));
+    auto decideChunk = [&](int chunk) {
+        for (size_t g = size_t(chunk); g < groups.size(); g += size_t(threads)) {
+            for (int i : groups[g]) {
+                decisions[i] = reserveLoaded(requests[i].studentId, requests[i].sectionId);
+            }
+        }
+    };
+
+    if (threads == 1) {
+        decideChunk(0);
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for (int chunk = 0; chunk < threads; ++chunk) {
+            pool.start([&decideChunk, chunk]() { decideChunk(chunk); });
+        }
+        pool.waitForDone();
+    }
+
+    if (dryRun) {
+        for (const auto& decision : decisions) {
+            if (decision.ok()) {
+                release(decision.studentId, decision.sectionId);
+            }
+        }
+    }
+    return decisions;
+}
+
+int EnrollmentValidator::seatsTaken(int sectionId)
+{
+    ensureLoaded();
+    QReadLocker locker(&m_lock);
+    auto it = m_sectionIndex.constFind(sectionId);
+    return it == m_sectionIndex.constEnd() ? 0 : m_enrolled[it.value()].load();
+}
+
+int EnrollmentValidator::capacity(int sectionId)
+{
+    ensureLoaded();
+    QReadLocker locker(&m_lock);
+    auto it = m_sectionIndex.constFind(sectionId);
+    return it == m_sectionIndex.constEnd() ? 0 : m_sections[it.value()].capacity;
+}
@@ -0,0 +1,119 @@
+#ifndef ENROLLMENTVALIDATOR_H
+#define ENROLLMENTVALIDATOR_H
+
+#include "enrollment.h"
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSqlDatabase>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+enum class EnrollmentCheck : quint8 {
+    Ok,
+    UnknownSection,
+    SectionFull,
+    AlreadyEnrolled,
+    ScheduleClash,
+    DatabaseError,
+    UnknownStudent,   // Checked by BulkEnrollmentPipeline
+    DuplicateRequest, // Same pair twice in one bulk input
+    InvalidInput      // Unparseable bulk input line
+};
+
+struct EnrollmentDecision {
+    EnrollmentCheck status = EnrollmentCheck::Ok;
+    int studentId = 0;
+    int sectionId = 0;
+    int clashingSectionId = 0; // Set for ScheduleClash
+
+    bool ok() const { return status == EnrollmentCheck::Ok; }
+    QString message() const;
+};
+
+/**
+ * @brief Capacity and timetable clash checks for enrollments.
+ *
+ * Keeps live seat counts per section and, per student, an ordered map of the
+ * week intervals (from section_schedule) they already sit in, so a request is
+ * decided with a couple of O(log n) lookups instead of queries. Seats are
+ * reserved atomically and students are guarded by striped locks, so parallel
+ * enrollments never oversubscribe a section or double-book a student.
+ * The counts are per process; the seat itself is claimed by
+ * EnrollmentRepository's capacity-checked INSERT.
+ *
+ * The index is loaded lazily from the database and rebuilt after invalidate()
+ * (sections or the timetable changed).
+ */
+class EnrollmentValidator {
+public:
+    static EnrollmentValidator& instance();
+
+    // Checks and, when allowed, reserves the seat and the student's time slots
+    EnrollmentDecision reserve(int studentId, int sectionId);
+    // Undoes reserve() (failed insert, unenrollment)
+    void release(int studentId, int sectionId);
+    // Check only; nothing is reserved
+    EnrollmentDecision check(int studentId, int sectionId);
+
+    // Registration day: decides every request in parallel, partitioned by student.
+    // Requests of one student are decided in list order; with dryRun the
+    // reservations are rolled back afterwards.
+    std::vector<EnrollmentDecision> validateBulk(const std::vector<Enrollment>& requests, bool dryRun = true,
+                                                 int threadCount = 0);
+
+    int seatsTaken(int sectionId);
+    int capacity(int sectionId);
+
+    void invalidate();
+    // Loads from db now instead of on first use (e.g. from a worker connection)
+    void load(const QSqlDatabase& db);
+
+private:
+    EnrollmentValidator();
+    EnrollmentValidator(const EnrollmentValidator&) = delete;
+    EnrollmentValidator& operator=(const EnrollmentValidator&) = delete;
+
+    struct Interval {
+        int start = 0; // Minutes since Monday 00:00
+        int end = 0;
+    };
+
+    struct SectionInfo {
+        int id = 0;
+        int capacity = 0; // <= 0 means unlimited
+        std::vector<Interval> meetings;
+    };
+
+    struct StudentIndex {
+        std::map<int, std::pair<int, int>> busy; // start -> (end, section index); non-overlapping
+        std::set<int> sections;                   // Section indexes
+    };
+
+    struct Stripe {
+        QMutex mutex;
+        QHash<int, StudentIndex> students;
+    };
+
+    static const int StripeCount = 64;
+
+    void ensureLoaded();
+    EnrollmentDecision reserveLoaded(int studentId, int sectionId);
+    EnrollmentDecision decide(StudentIndex& student, int studentId, int section, bool commit);
+    static int clashIn(const StudentIndex& student, const Interval& meeting);
+    Stripe& stripeFor(int studentId) { return m_stripes[size_t(studentId) % StripeCount]; }
+
+    QReadWriteLock m_lock; // Write-held only while (re)loading
+    bool m_loaded = false;
+    std::vector<SectionInfo> m_sections;
+    QHash<int, int> m_sectionIndex; // section_id -> index
+    std::unique_ptr<std::atomic<int>[]> m_enrolled;
+    std::array<Stripe, StripeCount> m_stripes;
+};
+
+#endif // ENROLLMENTVALIDATOR_H
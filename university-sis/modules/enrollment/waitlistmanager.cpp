@@ -0,0 +1,299 @@
+#include "waitlistmanager.h"
+#include "enrollmentvalidator.h"
+#include "enrollmentrepository.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+
+WaitlistManager& WaitlistManager::instance()
+{
+    static WaitlistManager manager;
+    return manager;
+}
+
+WaitlistManager::WaitlistManager() {}
+
+void WaitlistManager::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_loaded = false;
+}
+
+// Caller holds m_mutex
+void WaitlistManager::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_queues.clear();
+    m_sequences.clear();
+
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT section_id, student_id, position FROM section_waitlist ORDER BY section_id, position")) {
+        qDebug() << "Load Waitlist Error:" << query.lastError().text();
+        return;
+    }
+    while (query.next()) {
+        const int sectionId = query.value(0).toInt();
+        Slot slot;
+        slot.studentId = query.value(1).toInt();
+        slot.sequence = query.value(2).toInt();
+        Queue& queue = m_queues[sectionId];
+        queue.slots.push_back(slot);
+        queue.nextSequence = slot.sequence + 1;
+        m_sequences.insert(key(slot.studentId, sectionId), slot.sequence);
+    }
+    m_loaded = true;
+}
+
+int WaitlistManager::join(int studentId, int sectionId, QString* error)
+{
+    // Only students who could not simply enroll belong in the line
+    const EnrollmentDecision decision = EnrollmentValidator::instance().check(studentId, sectionId);
+    const int capacity = EnrollmentValidator::instance().capacity(sectionId);
+    QString reason;
+    if (decision.status == EnrollmentCheck::AlreadyEnrolled || decision.status == EnrollmentCheck::UnknownSection) {
+        reason = decision.message();
+    } else if (capacity <= 0 || EnrollmentValidator::instance().seatsTaken(sectionId) < capacity) {
+        reason = QString("Section %1 still has free seats.").arg(sectionId);
+    }
+    if (!reason.isEmpty()) {
+        if (error) {
+            *error = reason;
+        }
+        return 0;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+    if (m_sequences.contains(key(studentId, sectionId))) {
+        locker.unlock();
+        return position(studentId, sectionId);
+    }
+
+    Queue& queue = m_queues[sectionId];
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO section_waitlist (section_id, student_id, position) VALUES (:secid, :sid, :pos)");
+    query.bindValue(":secid", sectionId);
+    query.bindValue(":sid", studentId);
+    query.bindValue(":pos", queue.nextSequence);
+    if (!query.exec()) {
+        qDebug() << "Join Waitlist Error:" << query.lastError().text();
+        if (error) {
+            *error = query.lastError().text();
+        }
+        m_loaded = false; // Another session may have taken the position; reload it next time
+        return 0;
+    }
+
+    Slot slot;
+    slot.studentId = studentId;
+    slot.sequence = queue.nextSequence++;
+    queue.slots.push_back(slot);
+    m_sequences.insert(key(studentId, sectionId), slot.sequence);
+    return int(queue.slots.size());
+}
+
+bool WaitlistManager::leave(int studentId, int sectionId)
+{
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("DELETE FROM section_waitlist WHERE section_id = :secid AND student_id = :sid");
+    query.bindValue(":secid", sectionId);
+    query.bindValue(":sid", studentId);
+    if (!query.exec()) {
+        qDebug() << "Leave Waitlist Error:" << query.lastError().text();
+        return false;
+    }
+    removeFromQueue(studentId, sectionId);
+    return true;
+}
+
+// Caller holds m_mutex
+void WaitlistManager::removeFromQueue(int studentId, int sectionId)
+{
+    auto seq = m_sequences.find(key(studentId, sectionId));
+    if (seq == m_sequences.end()) {
+        return;
+    }
+    const int sequence = seq.value();
+    m_sequences.erase(seq);
+
+    auto queue = m_queues.find(sectionId);
+    if (queue == m_queues.end()) {
+        return;
+    }
+    std::deque<Slot>& slots = queue.value().slots;
+    if (!slots.empty() && slots.front().sequence == sequence) {
+        slots.pop_front(); // Promotions always take the head
+        return;
+    }
+    auto it = std::lower_bound(slots.begin(), slots.end(), sequence,
+                               [](const Slot& s, int value) { return s.sequence < value; });
+    if (it != slots.end() && it->sequence == sequence) {
+        slots.erase(it);
+    }
+}
+
+int WaitlistManager::position(int studentId, int sectionId)
+{
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+    auto seq = m_sequences.constFind(key(studentId, sectionId));
+    auto queue = m_queues.constFind(sectionId);
+    if (seq == m_sequences.constEnd() || queue == m_queues.constEnd()) {
+        return 0;
+    }
+    const std::deque<Slot>& slots = queue.value().slots;
+    auto it = std::lower_bound(slots.begin(), slots.end(), seq.value(),
+                               [](const Slot& s, int value) { return s.sequence < value; });
+    return int(it - slots.begin()) + 1;
+}
+
+std::optional<int> WaitlistManager::head(int sectionId)
+{
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+    auto queue = m_queues.constFind(sectionId);
+    if (queue == m_queues.constEnd() || queue.value().slots.empty()) {
+        return std::nullopt;
+    }
+    return queue.value().slots.front().studentId;
+}
+
+int WaitlistManager::length(int sectionId)
+{
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+    auto queue = m_queues.constFind(sectionId);
+    return queue == m_queues.constEnd() ? 0 : int(queue.value().slots.size());
+}
+
+std::vector<WaitlistEntry> WaitlistManager::getEntriesWithNames()
+{
+    std::vector<WaitlistEntry> entries;
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT w.section_id, w.student_id, s.name, w.created_at "
+                    "FROM section_waitlist w LEFT JOIN students s ON s.student_id = w.student_id "
+                    "ORDER BY w.section_id, w.position")) {
+        qDebug() << "Get Waitlist Error:" << query.lastError().text();
+        return entries;
+    }
+    int lastSection = -1;
+    int rank = 0;
+    while (query.next()) {
+        WaitlistEntry e;
+        e.sectionId = query.value(0).toInt();
+        e.studentId = query.value(1).toInt();
+        e.studentName = query.value(2).toString();
+        e.joinedAt = query.value(3).toDateTime();
+        rank = (e.sectionId == lastSection) ? rank + 1 : 1;
+        lastSection = e.sectionId;
+        e.position = rank;
+        entries.push_back(e);
+    }
+    return entries;
+}
+
+bool WaitlistManager::promoteNext(int sectionId, const QSqlDatabase& db, int& promoted)
+{
+    promoted = 0;
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+    auto queue = m_queues.find(sectionId);
+    if (queue == m_queues.end()) {
+        return true;
+    }
+
+    std::deque<Slot>& slots = queue.value().slots;
+    for (size_t i = 0; i < slots.size();) {
+        const Slot slot = slots[i];
+        const EnrollmentDecision decision = EnrollmentValidator::instance().reserve(slot.studentId, sectionId);
+        if (decision.status == EnrollmentCheck::SectionFull) {
+            return true; // Seat already gone
+        }
+        if (decision.status == EnrollmentCheck::AlreadyEnrolled) {
+            // Enrolled some other way: the entry is dead, drop it instead of skipping it forever
+            if (!dropEntry(slot.studentId, sectionId, db)) {
+                return false;
+            }
+            continue;
+        }
+        if (!decision.ok()) {
+            ++i;
+            continue; // Clash: stays in line, next student gets the seat
+        }
+
+        ProfiledQuery insert(db, SIS_QUERY_SITE);
+        EnrollmentRepository::prepareInsert(insert);
+        const EnrollmentCheck inserted = EnrollmentRepository::execInsert(insert, slot.studentId, sectionId);
+        if (inserted == EnrollmentCheck::SectionFull) {
+            // Another session took the seat; the in-memory counts are behind
+            EnrollmentValidator::instance().release(slot.studentId, sectionId);
+            EnrollmentValidator::instance().invalidate();
+            return true;
+        }
+        if (inserted == EnrollmentCheck::DatabaseError && !studentExists(slot.studentId, db)) {
+            // Deleted since joining (the foreign key rejected the insert): skip to the next in line
+            qDebug() << "Promote Waitlist: dropping deleted student" << slot.studentId << "from section" << sectionId;
+            EnrollmentValidator::instance().release(slot.studentId, sectionId);
+            if (!dropEntry(slot.studentId, sectionId, db)) {
+                return false;
+            }
+            continue;
+        }
+        ProfiledQuery remove(db, SIS_QUERY_SITE);
+        remove.prepare("DELETE FROM section_waitlist WHERE section_id = :secid AND student_id = :sid");
+        remove.bindValue(":secid", sectionId);
+        remove.bindValue(":sid", slot.studentId);
+        if (inserted != EnrollmentCheck::Ok || !remove.exec()) {
+            qDebug() << "Promote Waitlist Error:" << insert.lastError().text() << remove.lastError().text();
+            EnrollmentValidator::instance().release(slot.studentId, sectionId);
+            return false;
+        }
+        promoted = slot.studentId;
+        return true;
+    }
+    return true;
+}
+
+// Caller holds m_mutex
+bool WaitlistManager::dropEntry(int studentId, int sectionId, const QSqlDatabase& db)
+{
+    ProfiledQuery remove(db, SIS_QUERY_SITE);
+    remove.prepare("DELETE FROM section_waitlist WHERE section_id = :secid AND student_id = :sid");
+    remove.bindValue(":secid", sectionId);
+    remove.bindValue(":sid", studentId);
+    if (!remove.exec()) {
+        qDebug() << "Promote Waitlist Error:" << remove.lastError().text();
+        return false;
+    }
+    removeFromQueue(studentId, sectionId); // Reloaded by invalidate() if the caller rolls back
+    return true;
+}
+
+bool WaitlistManager::studentExists(int studentId, const QSqlDatabase& db)
+{
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT 1 FROM students WHERE student_id = :sid");
+    query.bindValue(":sid", studentId);
+    return !query.exec() || query.next(); // Unknown counts as existing: the error is reported as before
+}
+
+void WaitlistManager::promotionCommitted(int sectionId, int studentId)
+{
+    QMutexLocker locker(&m_mutex);
+    removeFromQueue(studentId, sectionId);
+}
@@ -0,0 +1,85 @@
+#ifndef WAITLISTMANAGER_H
+#define WAITLISTMANAGER_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QString>
+#include <deque>
+#include <optional>
+#include <vector>
+
+struct WaitlistEntry {
+    int sectionId = 0;
+    int studentId = 0;
+    QString studentName; // Display only
+    int position = 0;    // 1-based place in the queue
+    QDateTime joinedAt;
+};
+
+/**
+ * @brief Ordered waitlists for full sections (section_waitlist).
+ *
+ * Each section's queue is mirrored in memory as a deque ordered by the
+ * persisted sequence number, giving O(1) head access and O(log n) position
+ * lookups. EnrollmentRepository::unenrollStudent calls promoteNext() inside
+ * its own transaction, so a freed seat goes straight to the first eligible
+ * waitlisted student.
+ */
+class WaitlistManager {
+public:
+    static WaitlistManager& instance();
+
+    // Returns the 1-based position, or 0 on failure. Students already in the section
+    // and sections with free seats are refused; error then says why.
+    int join(int studentId, int sectionId, QString* error = nullptr);
+    bool leave(int studentId, int sectionId);
+
+    int position(int studentId, int sectionId);   // 0 = not waitlisted
+    std::optional<int> head(int sectionId);       // Next student in line
+    int length(int sectionId);
+
+    std::vector<WaitlistEntry> getEntriesWithNames();
+
+    // Runs on the caller's open transaction: enrolls the first waitlisted student the
+    // validator accepts and deletes their waitlist row. promoted is 0 when nobody moved up.
+    // Entries of students who are already enrolled are deleted on the way; call
+    // invalidate() if the transaction is rolled back.
+    bool promoteNext(int sectionId, const QSqlDatabase& db, int& promoted);
+    // Applies a promotion to the in-memory queue once the transaction committed
+    void promotionCommitted(int sectionId, int studentId);
+
+    void invalidate();
+
+private:
+    WaitlistManager();
+    WaitlistManager(const WaitlistManager&) = delete;
+    WaitlistManager& operator=(const WaitlistManager&) = delete;
+
+    struct Slot {
+        int studentId = 0;
+        int sequence = 0; // section_waitlist.position, strictly increasing per section
+    };
+
+    struct Queue {
+        std::deque<Slot> slots;
+        int nextSequence = 1;
+    };
+
+    static quint64 key(int studentId, int sectionId) {
+        return (quint64(quint32(sectionId)) << 32) | quint32(studentId);
+    }
+
+    void ensureLoaded();
+    void removeFromQueue(int studentId, int sectionId);
+    bool dropEntry(int studentId, int sectionId, const QSqlDatabase& db);
+    static bool studentExists(int studentId, const QSqlDatabase& db);
+
+    QMutex m_mutex;
+    bool m_loaded = false;
+    QHash<int, Queue> m_queues;       // section_id -> queue
+    QHash<quint64, int> m_sequences;  // (section, student) -> sequence
+};
+
+#endif // WAITLISTMANAGER_H
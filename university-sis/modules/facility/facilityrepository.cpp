@@ -1,13 +1,30 @@
 #include "facilityrepository.h"
+#include "../../utils/tracer.h"
+#include "../../database/queryprofiler.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 #include <QVariant>
 
+namespace {
+EntityCache<Building, QList<Building>>& buildingCache()
+{
+    static EntityCache<Building, QList<Building>> cache("buildings");
+    return cache;
+}
+
+EntityCache<Room, QList<Room>>& roomCache()
+{
+    static EntityCache<Room, QList<Room>> cache("rooms");
+    return cache;
+}
+}
+
 // Buildings
 bool FacilityRepository::addBuilding(const Building& building)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "FacilityRepository::addBuilding");
+    ProfiledQuery query(SIS_QUERY_SITE);
     query.prepare("INSERT INTO buildings (name, code, location) VALUES (:name, :code, :loc)");
     query.bindValue(":name", building.name);
     query.bindValue(":code", building.code);
@@ -16,32 +33,61 @@ bool FacilityRepository::addBuilding(const Building& building)
         qDebug() << "addBuilding error:" << query.lastError().text();
         return false;
     }
+    buildingCache().invalidate();
     return true;
 }
 
 bool FacilityRepository::updateBuilding(const Building& building)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "FacilityRepository::updateBuilding");
+    ProfiledQuery query(SIS_QUERY_SITE);
     query.prepare("UPDATE buildings SET name=:name, code=:code, location=:loc WHERE building_id=:id");
     query.bindValue(":name", building.name);
     query.bindValue(":code", building.code);
     query.bindValue(":loc", building.location);
     query.bindValue(":id", building.id);
-    return query.exec();
+    if(!query.exec()){
+        return false;
+    }
+    buildingCache().invalidate();
+    return true;
 }
 
 bool FacilityRepository::deleteBuilding(int id)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "FacilityRepository::deleteBuilding");
+    ProfiledQuery query(SIS_QUERY_SITE);
     query.prepare("DELETE FROM buildings WHERE building_id=:id");
     query.bindValue(":id", id);
-    return query.exec();
+    if(!query.exec()){
+        return false;
+    }
+    buildingCache().invalidate();
+    roomCache().invalidate(); // Rooms are deleted by ON DELETE CASCADE
+    return true;
 }
 
 QList<Building> FacilityRepository::getAllBuildings()
 {
+    SIS_TRACE_SCOPE("db", "FacilityRepository::getAllBuildings");
+    return buildingCache().getAll(&FacilityRepository::loadAllBuildings);
+}
+
+Building FacilityRepository::getBuildingById(int id)
+{
+    SIS_TRACE_SCOPE("db", "FacilityRepository::getBuildingById");
+    return buildingCache().get(id, [id]() { return loadBuildingById(id); }).value_or(Building());
+}
+
+std::optional<QList<Building>> FacilityRepository::loadAllBuildings()
+{
+    SIS_TRACE_SCOPE("db", "FacilityRepository::loadAllBuildings");
     QList<Building> list;
-    QSqlQuery query("SELECT building_id, name, code, location FROM buildings");
+    ProfiledQuery query("SELECT building_id, name, code, location FROM buildings", SIS_QUERY_SITE);
+    if (!query.isActive()) {
+        qDebug() << "Load Buildings Error:" << query.lastError().text();
+        return std::nullopt;
+    }
     while(query.next()){
         Building b;
         b.id = query.value(0).toInt();
@@ -53,25 +99,28 @@ QList<Building> FacilityRepository::getAllBuildings()
     return list;
 }
 
-Building FacilityRepository::getBuildingById(int id)
+std::optional<Building> FacilityRepository::loadBuildingById(int id)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "FacilityRepository::loadBuildingById");
+    ProfiledQuery query(SIS_QUERY_SITE);
     query.prepare("SELECT building_id, name, code, location FROM buildings WHERE building_id=:id");
     query.bindValue(":id", id);
-    Building b;
     if(query.exec() && query.next()){
+        Building b;
         b.id = query.value(0).toInt();
         b.name = query.value(1).toString();
         b.code = query.value(2).toString();
         b.location = query.value(3).toString();
+        return b;
     }
-    return b;
+    return std::nullopt;
 }
 
 // Rooms
 bool FacilityRepository::addRoom(const Room& room)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "FacilityRepository::addRoom");
+    ProfiledQuery query(SIS_QUERY_SITE);
     query.prepare("INSERT INTO rooms (building_id, room_number, type, capacity) VALUES (:bid, :num, :type, :cap)");
     query.bindValue(":bid", room.buildingId);
     query.bindValue(":num", room.roomNumber);
@@ -81,43 +130,48 @@ bool FacilityRepository::addRoom(const Room& room)
         qDebug() << "addRoom error:" << query.lastError().text();
         return false;
     }
+    roomCache().invalidate();
     return true;
 }
 
 bool FacilityRepository::updateRoom(const Room& room)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "FacilityRepository::updateRoom");
+    ProfiledQuery query(SIS_QUERY_SITE);
     query.prepare("UPDATE rooms SET building_id=:bid, room_number=:num, type=:type, capacity=:cap WHERE room_id=:id");
     query.bindValue(":bid", room.buildingId);
     query.bindValue(":num", room.roomNumber);
     query.bindValue(":type", room.type);
     query.bindValue(":cap", room.capacity);
     query.bindValue(":id", room.id);
-    return query.exec();
+    if(!query.exec()){
+        return false;
+    }
+    roomCache().invalidate();
+    return true;
 }
 
 bool FacilityRepository::deleteRoom(int id)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "FacilityRepository::deleteRoom");
+    ProfiledQuery query(SIS_QUERY_SITE);
     query.prepare("DELETE FROM rooms WHERE room_id=:id");
     query.bindValue(":id", id);
-    return query.exec();
+    if(!query.exec()){
+        return false;
+    }
+    roomCache().invalidate();
+    return true;
 }
 
 QList<Room> FacilityRepository::getRoomsByBuildingId(int buildingId)
 {
+    SIS_TRACE_SCOPE("db", "FacilityRepository::getRoomsByBuildingId");
+    // Served from the cached room table instead of a per-building query
     QList<Room> list;
-    QSqlQuery query;
-    query.prepare("SELECT room_id, building_id, room_number, type, capacity FROM rooms WHERE building_id=:bid");
-    query.bindValue(":bid", buildingId);
-    if(query.exec()){
-        while(query.next()){
-            Room r;
-            r.id = query.value(0).toInt();
-            r.buildingId = query.value(1).toInt();
-            r.roomNumber = query.value(2).toString();
-            r.type = query.value(3).toString();
-            r.capacity = query.value(4).toInt();
+    const QList<Room> rooms = getAllRooms();
+    for (const Room& r : rooms) {
+        if (r.buildingId == buildingId) {
             list.append(r);
         }
     }
@@ -126,16 +180,165 @@ QList<Room> FacilityRepository::getRoomsByBuildingId(int buildingId)
 
 QList<Room> FacilityRepository::getAllRooms()
 {
+    SIS_TRACE_SCOPE("db", "FacilityRepository::getAllRooms");
+    return roomCache().getAll(&FacilityRepository::loadAllRooms);
+}
+
+QList<EntityCacheStats> FacilityRepository::cacheStats()
+{
+    return {buildingCache().stats(), roomCache().stats()};
+}
+
+void FacilityRepository::invalidateCache()
+{
+    buildingCache().invalidate();
+    roomCache().invalidate();
+}
+
+std::optional<QList<Room>> FacilityRepository::loadAllRooms()
+{
+    SIS_TRACE_SCOPE("db", "FacilityRepository::loadAllRooms");
     QList<Room> list;
-    QSqlQuery query("SELECT room_id, building_id, room_number, type, capacity FROM rooms");
+    ProfiledQuery query("SELECT room_id, building_id, room_number, type, capacity FROM rooms", SIS_QUERY_SITE);
+    if (!query.isActive()) {
+        qDebug() << "Load Rooms Error:" << query.lastError().text();
+        return std::nullopt;
+    }
     while(query.next()){
         Room r;
         r.id = query.value(0).toInt();
         r.buildingId = query.value(1).toInt();
         r.roomNumber = query.value(2).toString();
-        r.type = query.value(3).toString();
+        r.type = StringPool::instance().shared(query.value(3).toString());
         r.capacity = query.value(4).toInt();
         list.append(r);
     }
     return list;
 }
+
+QList<CompactRoom> FacilityRepository::getAllRoomsCompact()
+{
+    SIS_TRACE_SCOPE("db", "FacilityRepository::getAllRoomsCompact");
+    QList<CompactRoom> list;
+    ProfiledQuery query(SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT room_id, building_id, room_number, type, capacity FROM rooms")) {
+        return list;
+    }
+    StringPool& pool = StringPool::instance();
+    while(query.next()){
+        CompactRoom r;
+        r.id = query.value(0).toInt();
+        r.buildingId = query.value(1).toInt();
+        r.roomNumber = query.value(2).toString();
+        r.type = pool.intern(query.value(3).toString());
+        r.capacity = query.value(4).toInt();
+        list.append(r);
+    }
+    return list;
+}
+
+RoomPage FacilityRepository::getRoomsWithBuildings(const RoomFilter& filter)
+{
+    SIS_TRACE_SCOPE("db", "FacilityRepository::getRoomsWithBuildings");
+    RoomPage page;
+    QString where = " FROM rooms r LEFT JOIN buildings b ON r.building_id = b.building_id WHERE 1=1";
+    if (filter.buildingId > 0) {
+        where += " AND r.building_id = :bid";
+    }
+    if (!filter.type.isEmpty()) {
+        where += " AND r.type = :type";
+    }
+    if (filter.minCapacity > 0) {
+        where += " AND r.capacity >= :cap";
+    }
+    if (!filter.search.isEmpty()) {
+        where += " AND (r.room_number LIKE :s1 OR b.name LIKE :s2 OR b.code LIKE :s3)";
+    }
+    auto bindFilter = [&filter](QSqlQuery& q) {
+        if (filter.buildingId > 0) {
+            q.bindValue(":bid", filter.buildingId);
+        }
+        if (!filter.type.isEmpty()) {
+            q.bindValue(":type", filter.type);
+        }
+        if (filter.minCapacity > 0) {
+            q.bindValue(":cap", filter.minCapacity);
+        }
+        if (!filter.search.isEmpty()) {
+            const QString pattern = "%" + filter.search + "%";
+            q.bindValue(":s1", pattern);
+            q.bindValue(":s2", pattern);
+            q.bindValue(":s3", pattern);
+        }
+    };
+
+    // 1. Aggregates over every matching room, grouped in SQL: one row per building and type
+    ProfiledQuery totals(SIS_QUERY_SITE);
+    totals.setForwardOnly(true);
+    totals.prepare("SELECT r.building_id, b.name, b.code, r.type, COUNT(*), COALESCE(SUM(r.capacity), 0)" + where +
+                   " GROUP BY r.building_id, b.name, b.code, r.type ORDER BY b.name, r.building_id");
+    bindFilter(totals);
+    if (!totals.exec()) {
+        qDebug() << "getRoomsWithBuildings totals error:" << totals.lastError().text();
+        return page;
+    }
+    FacilityOverview& overview = page.overview;
+    StringPool& pool = StringPool::instance();
+    while (totals.next()) {
+        const int buildingId = totals.value(0).toInt();
+        const QString type = pool.shared(totals.value(3).toString());
+        const int rooms = totals.value(4).toInt();
+        const int seats = totals.value(5).toInt();
+        if (overview.buildings.isEmpty() || overview.buildings.last().buildingId != buildingId) {
+            BuildingCapacity building;
+            building.buildingId = buildingId;
+            building.name = totals.value(1).toString();
+            building.code = totals.value(2).toString();
+            overview.buildings.append(building);
+        }
+        BuildingCapacity& building = overview.buildings.last();
+        building.rooms += rooms;
+        building.seats += seats;
+        overview.roomsPerType[type] += rooms;
+        overview.seatsPerType[type] += seats;
+        overview.totalRooms += rooms;
+        overview.totalSeats += seats;
+    }
+    totals.finish();
+    page.totalCount = overview.totalRooms;
+
+    // 2. Only the requested page; room_id makes the order total so pages don't overlap
+    const int offset = qMax(0, filter.offset);
+    if (offset >= page.totalCount) {
+        return page;
+    }
+    QString sql = "SELECT r.room_id, r.building_id, r.room_number, r.type, r.capacity, b.name, b.code" + where +
+                  " ORDER BY b.name, r.room_number, r.room_id";
+    if (filter.limit > 0) {
+        sql += QString(" LIMIT %1 OFFSET %2").arg(filter.limit).arg(offset);
+    }
+    ProfiledQuery query(SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    bindFilter(query);
+    if (!query.exec()) {
+        qDebug() << "getRoomsWithBuildings error:" << query.lastError().text();
+        return page;
+    }
+    // Without a limit there is no OFFSET clause, so skip to the offset here
+    for (int skipped = 0; filter.limit <= 0 && skipped < offset && query.next(); ++skipped) {
+    }
+    while (query.next()) {
+        RoomWithBuilding row;
+        row.room.id = query.value(0).toInt();
+        row.room.buildingId = query.value(1).toInt();
+        row.room.roomNumber = query.value(2).toString();
+        row.room.type = pool.shared(query.value(3).toString());
+        row.room.capacity = query.value(4).toInt();
+        row.buildingName = query.value(5).toString();
+        row.buildingCode = query.value(6).toString();
+        page.rooms.append(row);
+    }
+    return page;
+}
@@ -3,7 +3,10 @@
 
 #include "building.h"
 #include "room.h"
+#include "roomoverview.h"
+#include "../../utils/entitycache.h"
 #include <QList>
+#include <optional>
 
 class FacilityRepository {
 public:
@@ -20,6 +23,20 @@ public:
     bool deleteRoom(int id);
     QList<Room> getRoomsByBuildingId(int buildingId);
     QList<Room> getAllRooms();
+    QList<CompactRoom> getAllRoomsCompact();
+
+    // Rooms joined to their building, one page at a time (LIMIT/OFFSET), with
+    // the overview aggregated in SQL by a separate GROUP BY query
+    RoomPage getRoomsWithBuildings(const RoomFilter& filter = RoomFilter());
+
+    // Shared read-through caches (buildings, rooms), invalidated by every write above
+    static QList<EntityCacheStats> cacheStats();
+    static void invalidateCache();
+
+private:
+    static std::optional<QList<Building>> loadAllBuildings();
+    static std::optional<Building> loadBuildingById(int id);
+    static std::optional<QList<Room>> loadAllRooms();
 };
 
 #endif // FACILITYREPOSITORY_H
@@ -2,6 +2,7 @@
 #define ROOM_H
 
 #include <QString>
+#include "../../utils/stringpool.h"
 
 struct Room {
     int id = -1;
@@ -15,4 +16,15 @@ struct Room {
     }
 };
 
+// Compact read-only variant for bulk listings (interned room type)
+struct CompactRoom {
+    int id = -1;
+    int buildingId = -1;
+    int capacity = 0;
+    StringPool::Id type = 0;
+    QString roomNumber;
+
+    QString typeName() const { return StringPool::instance().string(type); }
+};
+
 #endif // ROOM_H
@@ -0,0 +1,47 @@
+#ifndef ROOMOVERVIEW_H
+#define ROOMOVERVIEW_H
+
+#include "room.h"
+#include <QString>
+#include <QList>
+#include <QMap>
+
+struct RoomFilter {
+    int buildingId = -1;   // -1 = all buildings
+    QString type;          // Exact room type, empty = any
+    int minCapacity = 0;
+    QString search;        // Matches room number, building name or code
+    int offset = 0;
+    int limit = 50;        // 0 = no paging
+};
+
+struct RoomWithBuilding {
+    Room room;
+    QString buildingName;
+    QString buildingCode;
+};
+
+struct BuildingCapacity {
+    int buildingId = -1;
+    QString name;
+    QString code;
+    int rooms = 0;
+    int seats = 0;
+};
+
+// Aggregations over every room matching the filter (not just the current page)
+struct FacilityOverview {
+    int totalRooms = 0;
+    int totalSeats = 0;
+    QList<BuildingCapacity> buildings;   // Ordered by building name
+    QMap<QString, int> roomsPerType;
+    QMap<QString, int> seatsPerType;
+};
+
+struct RoomPage {
+    QList<RoomWithBuilding> rooms;  // Rows in [offset, offset + limit)
+    int totalCount = 0;             // Rows matching the filter
+    FacilityOverview overview;
+};
+
+#endif // ROOMOVERVIEW_H
@@ -2,6 +2,7 @@
 #define FACULTY_H
 
 #include <QString>
+#include "../../utils/stringpool.h"
 
 struct Faculty {
     int id = 0;
@@ -13,4 +14,16 @@ struct Faculty {
     QString password;
 };
 
+// Compact read-only variant for bulk listings (interned department/position, no credentials)
+struct CompactFaculty {
+    int id = 0;
+    StringPool::Id department = 0;
+    StringPool::Id position = 0;
+    QString name;
+    QString email;
+
+    QString departmentName() const { return StringPool::instance().string(department); }
+    QString positionName() const { return StringPool::instance().string(position); }
+};
+
 #endif // FACULTY_H
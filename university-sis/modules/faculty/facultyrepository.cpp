@@ -1,5 +1,8 @@
 #include "facultyrepository.h"
+#include "../../utils/tracer.h"
 #include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "../auth/userrepository.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
@@ -8,26 +11,48 @@
 FacultyRepository::FacultyRepository() {}
 
 bool FacultyRepository::addFaculty(const Faculty& faculty) {
+    SIS_TRACE_SCOPE("db", "FacultyRepository::addFaculty");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
-    query.prepare("INSERT INTO faculty (name, email, department, position, username, password) VALUES (:name, :email, :dept, :pos, :user, :pass)");
+    const bool withAccount = !faculty.username.isEmpty() && !faculty.password.isEmpty();
+    if (withAccount) {
+        DatabaseManager::beginTransaction(db);
+    }
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO faculty (name, email, department, position, username) VALUES (:name, :email, :dept, :pos, :user)");
     query.bindValue(":name", faculty.name);
     query.bindValue(":email", faculty.email);
     query.bindValue(":dept", faculty.department);
     query.bindValue(":pos", faculty.position);
-    query.bindValue(":user", faculty.username);
-    query.bindValue(":pass", faculty.password);
+    query.bindValue(":user", faculty.username.isEmpty() ? QVariant() : QVariant(faculty.username));
     
     if (!query.exec()) {
         qDebug() << "Add Faculty Error:" << query.lastError().text();
+        if (withAccount) {
+            DatabaseManager::rollbackTransaction(db);
+        }
         return false;
     }
-    return true;
+    if (!withAccount) {
+        return true;
+    }
+
+    User account;
+    account.username = faculty.username;
+    account.role = "FACULTY";
+    account.displayName = faculty.name;
+    account.facultyId = query.lastInsertId().toInt();
+    if (!UserRepository().addAccount(account, faculty.password, db)) {
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    return DatabaseManager::commitTransaction(db);
 }
 
 bool FacultyRepository::updateFaculty(const Faculty& faculty) {
+    SIS_TRACE_SCOPE("db", "FacultyRepository::updateFaculty");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("UPDATE faculty SET name=:name, email=:email, department=:dept, position=:pos WHERE faculty_id=:id");
     query.bindValue(":name", faculty.name);
     query.bindValue(":email", faculty.email);
@@ -43,68 +68,82 @@ bool FacultyRepository::updateFaculty(const Faculty& faculty) {
 }
 
 bool FacultyRepository::deleteFaculty(int id) {
+    SIS_TRACE_SCOPE("db", "FacultyRepository::deleteFaculty");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    DatabaseManager::beginTransaction(db);
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("DELETE FROM faculty WHERE faculty_id = :id");
     query.bindValue(":id", id);
     
     if (!query.exec()) {
         qDebug() << "Delete Faculty Error:" << query.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
         return false;
     }
-    return true;
+    if (!UserRepository().deleteFacultyAccount(id, db)) {
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    return DatabaseManager::commitTransaction(db);
 }
 
 std::vector<Faculty> FacultyRepository::getAllFaculty() {
+    SIS_TRACE_SCOPE("db", "FacultyRepository::getAllFaculty");
     std::vector<Faculty> list;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query("SELECT faculty_id, name, email, department, position FROM faculty", db);
+    ProfiledQuery query("SELECT faculty_id, name, email, department, position FROM faculty", db, SIS_QUERY_SITE);
     
     while (query.next()) {
         Faculty f;
         f.id = query.value(0).toInt();
         f.name = query.value(1).toString();
         f.email = query.value(2).toString();
-        f.department = query.value(3).toString();
-        f.position = query.value(4).toString();
+        f.department = StringPool::instance().shared(query.value(3).toString());
+        f.position = StringPool::instance().shared(query.value(4).toString());
         list.push_back(f);
     }
     return list;
 }
 
-std::optional<Faculty> FacultyRepository::getFacultyById(int id) {
+std::vector<CompactFaculty> FacultyRepository::getAllFacultyCompact() {
+    SIS_TRACE_SCOPE("db", "FacultyRepository::getAllFacultyCompact");
+    std::vector<CompactFaculty> list;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
-    query.prepare("SELECT faculty_id, name, email, department, position FROM faculty WHERE faculty_id = :id");
-    query.bindValue(":id", id);
-    
-    if (query.exec() && query.next()) {
-        Faculty f;
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT faculty_id, name, email, department, position FROM faculty")) {
+        qDebug() << "Get Compact Faculty Error:" << query.lastError().text();
+        return list;
+    }
+
+    StringPool& pool = StringPool::instance();
+    while (query.next()) {
+        CompactFaculty f;
         f.id = query.value(0).toInt();
         f.name = query.value(1).toString();
         f.email = query.value(2).toString();
-        f.department = query.value(3).toString();
-        f.position = query.value(4).toString();
-        return f;
+        f.department = pool.intern(query.value(3).toString());
+        f.position = pool.intern(query.value(4).toString());
+        list.push_back(f);
     }
-    return std::nullopt;
+    return list;
 }
 
-std::optional<Faculty> FacultyRepository::authenticate(const QString& username, const QString& password) {
+std::optional<Faculty> FacultyRepository::getFacultyById(int id) {
+    SIS_TRACE_SCOPE("db", "FacultyRepository::getFacultyById");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
-    query.prepare("SELECT faculty_id, name, email, department, position, username FROM faculty WHERE username = :u AND password = :p");
-    query.bindValue(":u", username);
-    query.bindValue(":p", password);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT faculty_id, name, email, department, position FROM faculty WHERE faculty_id = :id");
+    query.bindValue(":id", id);
     
     if (query.exec() && query.next()) {
         Faculty f;
         f.id = query.value(0).toInt();
         f.name = query.value(1).toString();
         f.email = query.value(2).toString();
-        f.department = query.value(3).toString();
-        f.position = query.value(4).toString();
-        f.username = query.value(5).toString();
+        f.department = StringPool::instance().shared(query.value(3).toString());
+        f.position = StringPool::instance().shared(query.value(4).toString());
         return f;
     }
     return std::nullopt;
@@ -14,8 +14,8 @@ public:
     bool deleteFaculty(int id);
     
     std::vector<Faculty> getAllFaculty();
+    std::vector<CompactFaculty> getAllFacultyCompact();
     std::optional<Faculty> getFacultyById(int id);
-    std::optional<Faculty> authenticate(const QString& username, const QString& password);
 };
 
 #endif // FACULTYREPOSITORY_H
@@ -3,6 +3,14 @@
 
 #include <QString>
 #include <QDate>
+#include <QtGlobal>
+
+// Values match payment_statuses.status_id (stored as TINYINT)
+enum class PaymentStatus : quint8 {
+    Pending = 1,
+    Paid = 2,
+    Overdue = 3
+};
 
 struct Payment {
     int id = 0;
@@ -10,8 +18,25 @@ struct Payment {
     QString studentName;  // Student name for display
     double amount = 0.0;
     QString description;
-    QString status = "Pending"; // Pending, Paid, Overdue
+    PaymentStatus status = PaymentStatus::Pending;
     QDate date = QDate::currentDate();
+
+    static QString statusToString(PaymentStatus status) {
+        switch (status) {
+        case PaymentStatus::Paid: return "Paid";
+        case PaymentStatus::Overdue: return "Overdue";
+        case PaymentStatus::Pending: break;
+        }
+        return "Pending";
+    }
+    static PaymentStatus statusFromString(const QString& text) {
+        if (text == "Paid") return PaymentStatus::Paid;
+        if (text == "Overdue") return PaymentStatus::Overdue;
+        return PaymentStatus::Pending;
+    }
+    static PaymentStatus statusFromId(int id) {
+        return (id >= 1 && id <= 3) ? static_cast<PaymentStatus>(id) : PaymentStatus::Pending;
+    }
 };
 
 #endif // PAYMENT_H
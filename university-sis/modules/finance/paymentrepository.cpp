@@ -1,20 +1,24 @@
 #include "paymentrepository.h"
+#include "../../utils/tracer.h"
 #include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
 #include <QDebug>
+#include <algorithm>
 
 PaymentRepository::PaymentRepository() {}
 
 bool PaymentRepository::addPayment(const Payment& payment) {
+    SIS_TRACE_SCOPE("db", "PaymentRepository::addPayment");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
-    query.prepare("INSERT INTO payments (student_id, amount, description, status, date) VALUES (:sid, :amt, :desc, :stat, :date)");
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO payments (student_id, amount, description, status_id, date) VALUES (:sid, :amt, :desc, :stat, :date)");
     query.bindValue(":sid", payment.studentId);
     query.bindValue(":amt", payment.amount);
     query.bindValue(":desc", payment.description);
-    query.bindValue(":stat", payment.status);
+    query.bindValue(":stat", int(payment.status));
     query.bindValue(":date", payment.date);
     
     if (!query.exec()) {
@@ -25,13 +29,14 @@ bool PaymentRepository::addPayment(const Payment& payment) {
 }
 
 bool PaymentRepository::updatePayment(const Payment& payment) {
+    SIS_TRACE_SCOPE("db", "PaymentRepository::updatePayment");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
-    query.prepare("UPDATE payments SET student_id=:sid, amount=:amt, description=:desc, status=:stat, date=:date WHERE payment_id=:id");
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("UPDATE payments SET student_id=:sid, amount=:amt, description=:desc, status_id=:stat, date=:date WHERE payment_id=:id");
     query.bindValue(":sid", payment.studentId);
     query.bindValue(":amt", payment.amount);
     query.bindValue(":desc", payment.description);
-    query.bindValue(":stat", payment.status);
+    query.bindValue(":stat", int(payment.status));
     query.bindValue(":date", payment.date);
     query.bindValue(":id", payment.id);
     
@@ -43,8 +48,9 @@ bool PaymentRepository::updatePayment(const Payment& payment) {
 }
 
 bool PaymentRepository::deletePayment(int id) {
+    SIS_TRACE_SCOPE("db", "PaymentRepository::deletePayment");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     query.prepare("DELETE FROM payments WHERE payment_id = :id");
     query.bindValue(":id", id);
     
@@ -56,9 +62,10 @@ bool PaymentRepository::deletePayment(int id) {
 }
 
 std::vector<Payment> PaymentRepository::getAllPayments() {
+    SIS_TRACE_SCOPE("db", "PaymentRepository::getAllPayments");
     std::vector<Payment> payments;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query("SELECT payment_id, student_id, amount, description, status, date FROM payments", db);
+    ProfiledQuery query("SELECT payment_id, student_id, amount, description, status_id, date FROM payments", db, SIS_QUERY_SITE);
     
     while (query.next()) {
         Payment p;
@@ -66,7 +73,7 @@ std::vector<Payment> PaymentRepository::getAllPayments() {
         p.studentId = query.value(1).toInt();
         p.amount = query.value(2).toDouble();
         p.description = query.value(3).toString();
-        p.status = query.value(4).toString();
+        p.status = Payment::statusFromId(query.value(4).toInt());
         p.date = query.value(5).toDate();
         payments.push_back(p);
     }
@@ -74,12 +81,13 @@ std::vector<Payment> PaymentRepository::getAllPayments() {
 }
 
 std::vector<Payment> PaymentRepository::getAllPaymentsWithNames() {
+    SIS_TRACE_SCOPE("db", "PaymentRepository::getAllPaymentsWithNames");
     std::vector<Payment> payments;
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     
     query.prepare("SELECT p.payment_id, p.student_id, s.name as student_name, "
-                  "p.amount, p.description, p.status, p.date "
+                  "p.amount, p.description, p.status_id, p.date "
                   "FROM payments p "
                   "LEFT JOIN students s ON p.student_id = s.student_id "
                   "ORDER BY p.date DESC, s.name");
@@ -96,7 +104,7 @@ std::vector<Payment> PaymentRepository::getAllPaymentsWithNames() {
         p.studentName = query.value(2).toString();
         p.amount = query.value(3).toDouble();
         p.description = query.value(4).toString();
-        p.status = query.value(5).toString();
+        p.status = Payment::statusFromId(query.value(5).toInt());
         p.date = query.value(6).toDate();
         payments.push_back(p);
     }
@@ -104,9 +112,10 @@ std::vector<Payment> PaymentRepository::getAllPaymentsWithNames() {
 }
 
 std::optional<Payment> PaymentRepository::getPaymentById(int id) {
+    SIS_TRACE_SCOPE("db", "PaymentRepository::getPaymentById");
     QSqlDatabase db = DatabaseManager::instance().getDatabase();
-    QSqlQuery query(db);
-    query.prepare("SELECT payment_id, student_id, amount, description, status, date FROM payments WHERE payment_id = :id");
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT payment_id, student_id, amount, description, status_id, date FROM payments WHERE payment_id = :id");
     query.bindValue(":id", id);
     
     if (query.exec() && query.next()) {
@@ -115,9 +124,41 @@ std::optional<Payment> PaymentRepository::getPaymentById(int id) {
         p.studentId = query.value(1).toInt();
         p.amount = query.value(2).toDouble();
         p.description = query.value(3).toString();
-        p.status = query.value(4).toString();
+        p.status = Payment::statusFromId(query.value(4).toInt());
         p.date = query.value(5).toDate();
         return p;
     }
     return std::nullopt;
 }
+
+qint64 PaymentRepository::markOverduePayments(const QSqlDatabase& db, const QDate& asOf, int graceDays, int chunkSize,
+                                              const ProgressCallback& progress) {
+    SIS_TRACE_SCOPE("db", "PaymentRepository::markOverduePayments");
+    const std::optional<IdRange> range = IdRange::of(db, "payments", "payment_id");
+    if (!range) {
+        return -1;
+    }
+
+    const QString cutoff = asOf.addDays(-graceDays).toString("yyyy-MM-dd");
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("UPDATE payments SET status_id = :overdue "
+                  "WHERE payment_id >= :lo AND payment_id < :hi AND status_id = :pending AND date < :cutoff");
+    qint64 changed = 0;
+    for (qint64 lo = range->first; lo <= range->last; lo += chunkSize) {
+        const qint64 hi = std::min(lo + chunkSize, range->last + 1);
+        query.bindValue(":overdue", int(PaymentStatus::Overdue));
+        query.bindValue(":lo", lo);
+        query.bindValue(":hi", hi);
+        query.bindValue(":pending", int(PaymentStatus::Pending));
+        query.bindValue(":cutoff", cutoff);
+        if (!query.exec()) {
+            qDebug() << "Mark Overdue Payments Error:" << query.lastError().text();
+            return -1;
+        }
+        changed += std::max(0, query.numRowsAffected());
+        if (progress) {
+            progress(hi - range->first, range->size());
+        }
+    }
+    return changed;
+}
@@ -2,6 +2,7 @@
 #define PAYMENTREPOSITORY_H
 
 #include "payment.h"
+#include "../../database/idrange.h"
 #include <vector>
 #include <optional>
 
@@ -16,6 +17,11 @@ public:
     std::vector<Payment> getAllPayments();
     std::vector<Payment> getAllPaymentsWithNames();  // Gets payments with student names
     std::optional<Payment> getPaymentById(int id);
+
+    // Batch: pending payments dated more than graceDays before asOf become
+    // overdue, walking payment_id in windows. Returns rows changed, -1 on error.
+    static qint64 markOverduePayments(const QSqlDatabase& db, const QDate& asOf, int graceDays, int chunkSize,
+                                      const ProgressCallback& progress = ProgressCallback());
 };
 
 #endif // PAYMENTREPOSITORY_H
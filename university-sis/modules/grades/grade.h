@@ -0,0 +1,28 @@
+#ifndef GRADE_H
+#define GRADE_H
+
+#include <QString>
+
+// Order matches the assignment type combo in GradesSystem
+enum class GradeComponent {
+    Assignment1,
+    Assignment2,
+    FinalExam
+};
+
+/**
+ * @brief One row of the grades table: letter grades per component and the
+ * weighted total, keyed by (student, course).
+ */
+struct GradeRecord {
+    int studentId = 0;
+    int courseId = 0;
+    QString studentName;  // For display
+    QString courseName;   // For display
+    QString a1;
+    QString a2;
+    QString finalExam;
+    QString total;
+};
+
+#endif // GRADE_H
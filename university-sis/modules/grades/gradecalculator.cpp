@@ -0,0 +1,89 @@
+#include "gradecalculator.h"
+
+QString GradeCalculator::letterForPercentage(double percentage)
+{
+    if (percentage >= 97) return "A+";
+    if (percentage >= 93) return "A";
+    if (percentage >= 90) return "A-";
+    if (percentage >= 87) return "B+";
+    if (percentage >= 83) return "B";
+    if (percentage >= 80) return "B-";
+    if (percentage >= 77) return "C+";
+    if (percentage >= 73) return "C";
+    if (percentage >= 70) return "C-";
+    if (percentage >= 67) return "D+";
+    if (percentage >= 63) return "D";
+    if (percentage >= 60) return "D-";
+    return "F";
+}
+
+double GradeCalculator::gradePoints(const QString& letter)
+{
+    if (letter == "A+" || letter == "A") return 4.0;
+    if (letter == "A-") return 3.7;
+    if (letter == "B+") return 3.3;
+    if (letter == "B") return 3.0;
+    if (letter == "B-") return 2.7;
+    if (letter == "C+") return 2.3;
+    if (letter == "C") return 2.0;
+    if (letter == "C-") return 1.7;
+    if (letter == "D+") return 1.3;
+    if (letter == "D") return 1.0;
+    if (letter == "D-") return 0.7;
+    if (letter == "F") return 0.0;
+    return -1; // Invalid
+}
+
+QString GradeCalculator::totalGrade(const QString& a1, const QString& a2, const QString& finalExam)
+{
+    int count = 0;
+    double sum = 0;
+
+    if (!a1.isEmpty()) {
+        double val = gradePoints(a1);
+        if (val >= 0) { sum += val * 0.3; count++; }
+    }
+    if (!a2.isEmpty()) {
+        double val = gradePoints(a2);
+        if (val >= 0) { sum += val * 0.3; count++; }
+    }
+    if (!finalExam.isEmpty()) {
+        double val = gradePoints(finalExam);
+        if (val >= 0) { sum += val * 0.4; count++; }
+    }
+
+    if (count == 0) return "";
+
+    double avg = sum; // Already weighted
+
+    // Convert back to letter grade
+    if (avg >= 3.85) return "A";
+    if (avg >= 3.5) return "A-";
+    if (avg >= 3.15) return "B+";
+    if (avg >= 2.85) return "B";
+    if (avg >= 2.5) return "B-";
+    if (avg >= 2.15) return "C+";
+    if (avg >= 1.85) return "C";
+    if (avg >= 1.5) return "C-";
+    if (avg >= 1.15) return "D+";
+    if (avg >= 0.85) return "D";
+    if (avg >= 0.5) return "D-";
+    return "F";
+}
+
+std::optional<double> GradeCalculator::gpa(const QStringList& totals)
+{
+    double sum = 0;
+    int count = 0;
+    for (const QString& total : totals) {
+        double points = gradePoints(total);
+        if (points >= 0) {
+            sum += points;
+            count++;
+        }
+    }
+    if (count == 0) {
+        return std::nullopt;
+    }
+    return sum / count;
+}
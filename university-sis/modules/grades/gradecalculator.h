@@ -0,0 +1,23 @@
+#ifndef GRADECALCULATOR_H
+#define GRADECALCULATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+/**
+ * @brief Letter grade arithmetic on the 4.0 scale.
+ *
+ * The total weights assignments 30% each and the final exam 40%; missing
+ * components simply contribute nothing. The GPA is the plain mean of the
+ * course totals.
+ */
+class GradeCalculator {
+public:
+    static QString letterForPercentage(double percentage);
+    static double gradePoints(const QString& letter);  // -1 for anything that is not a letter grade
+    static QString totalGrade(const QString& a1, const QString& a2, const QString& finalExam);
+    static std::optional<double> gpa(const QStringList& totals);
+};
+
+#endif // GRADECALCULATOR_H
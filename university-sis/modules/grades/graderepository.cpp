@@ -0,0 +1,292 @@
+#include "graderepository.h"
+#include "gradecalculator.h"
+#include "../../utils/tracer.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+const char* columnFor(GradeComponent component)
+{
+    switch (component) {
+    case GradeComponent::Assignment2: return "a2";
+    case GradeComponent::FinalExam: return "final_exam";
+    case GradeComponent::Assignment1: break;
+    }
+    return "a1";
+}
+}
+
+void GradeRecomputeSummary::merge(const GradeRecomputeSummary& other)
+{
+    rows += other.rows;
+    updated += other.updated;
+    students += other.students;
+    gpaSum += other.gpaSum;
+    belowTwo += other.belowTwo;
+    ok = ok && other.ok;
+}
+
+GradeRepository::GradeRepository() {}
+
+std::vector<GradeRecord> GradeRepository::getGrades(int courseId, int studentId) {
+    SIS_TRACE_SCOPE("db", "GradeRepository::getGrades");
+    std::vector<GradeRecord> list;
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+
+    QString sql = "SELECT g.student_id, s.name as student_name, g.course_id, c.name as course_name, "
+                  "g.a1, g.a2, g.final_exam, g.total "
+                  "FROM grades g "
+                  "LEFT JOIN students s ON g.student_id = s.student_id "
+                  "LEFT JOIN courses c ON g.course_id = c.course_id "
+                  "WHERE 1=1";
+    if (studentId != -1) {
+        sql += " AND g.student_id = :student_id";
+    }
+    if (courseId != -1) {
+        sql += " AND g.course_id = :course_id";
+    }
+    sql += " ORDER BY c.name, s.name";
+
+    query.prepare(sql);
+    if (studentId != -1) {
+        query.bindValue(":student_id", studentId);
+    }
+    if (courseId != -1) {
+        query.bindValue(":course_id", courseId);
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Get Grades Error:" << query.lastError().text();
+        return list;
+    }
+    while (query.next()) {
+        GradeRecord g;
+        g.studentId = query.value("student_id").toInt();
+        g.courseId = query.value("course_id").toInt();
+        g.studentName = query.value("student_name").toString();
+        g.courseName = query.value("course_name").toString();
+        g.a1 = query.value("a1").toString();
+        g.a2 = query.value("a2").toString();
+        g.finalExam = query.value("final_exam").toString();
+        g.total = query.value("total").toString();
+        list.push_back(g);
+    }
+    return list;
+}
+
+std::optional<GradeRecord> GradeRepository::getGrade(int studentId, int courseId) {
+    SIS_TRACE_SCOPE("db", "GradeRepository::getGrade");
+    std::vector<GradeRecord> list = getGrades(courseId, studentId);
+    if (list.empty()) {
+        return std::nullopt;
+    }
+    return list.front();
+}
+
+bool GradeRepository::isEnrolled(int studentId, int courseId) {
+    SIS_TRACE_SCOPE("db", "GradeRepository::isEnrolled");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT COUNT(*) FROM student_section ss "
+                  "JOIN sections s ON ss.section_id = s.section_id "
+                  "WHERE ss.student_id = :student_id AND s.course_id = :course_id");
+    query.bindValue(":student_id", studentId);
+    query.bindValue(":course_id", courseId);
+
+    if (!query.exec()) {
+        qDebug() << "Check Enrollment Error:" << query.lastError().text();
+        return false;
+    }
+    return query.next() && query.value(0).toInt() > 0;
+}
+
+bool GradeRepository::saveComponent(int studentId, int courseId, GradeComponent component,
+                                    const QString& letter, bool* created) {
+    SIS_TRACE_SCOPE("db", "GradeRepository::saveComponent");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    DatabaseManager::beginTransaction(db);
+
+    ProfiledQuery select(db, SIS_QUERY_SITE);
+    select.prepare("SELECT a1, a2, final_exam FROM grades WHERE student_id = :student_id AND course_id = :course_id");
+    select.bindValue(":student_id", studentId);
+    select.bindValue(":course_id", courseId);
+    if (!select.exec()) {
+        qDebug() << "Save Grade Error:" << select.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+
+    const bool exists = select.next();
+    QString a1 = exists ? select.value("a1").toString() : QString();
+    QString a2 = exists ? select.value("a2").toString() : QString();
+    QString finalExam = exists ? select.value("final_exam").toString() : QString();
+    select.finish();
+
+    switch (component) {
+    case GradeComponent::Assignment1: a1 = letter; break;
+    case GradeComponent::Assignment2: a2 = letter; break;
+    case GradeComponent::FinalExam: finalExam = letter; break;
+    }
+    const QString total = GradeCalculator::totalGrade(a1, a2, finalExam);
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    if (exists) {
+        query.prepare(QString("UPDATE grades SET %1 = :grade, total = :total "
+                              "WHERE student_id = :student_id AND course_id = :course_id").arg(columnFor(component)));
+        query.bindValue(":grade", letter);
+    } else {
+        query.prepare("INSERT INTO grades (student_id, course_id, a1, a2, final_exam, total) "
+                      "VALUES (:student_id, :course_id, :a1, :a2, :final_exam, :total)");
+        query.bindValue(":a1", a1);
+        query.bindValue(":a2", a2);
+        query.bindValue(":final_exam", finalExam);
+    }
+    query.bindValue(":total", total);
+    query.bindValue(":student_id", studentId);
+    query.bindValue(":course_id", courseId);
+
+    if (!query.exec()) {
+        qDebug() << "Save Grade Error:" << query.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    if (!DatabaseManager::commitTransaction(db)) {
+        qDebug() << "Save Grade Commit Error:" << db.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    if (created) {
+        *created = !exists;
+    }
+    return true;
+}
+
+bool GradeRepository::deleteGrades(int studentId, int courseId) {
+    SIS_TRACE_SCOPE("db", "GradeRepository::deleteGrades");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("DELETE FROM grades WHERE student_id = :student_id AND course_id = :course_id");
+    query.bindValue(":student_id", studentId);
+    query.bindValue(":course_id", courseId);
+
+    if (!query.exec()) {
+        qDebug() << "Delete Grades Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+std::optional<double> GradeRepository::computeGpa(int studentId) {
+    SIS_TRACE_SCOPE("db", "GradeRepository::computeGpa");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT total FROM grades WHERE student_id = :student_id AND total != '' AND total IS NOT NULL");
+    query.bindValue(":student_id", studentId);
+
+    if (!query.exec()) {
+        qDebug() << "Compute GPA Error:" << query.lastError().text();
+        return std::nullopt;
+    }
+    QStringList totals;
+    while (query.next()) {
+        totals << query.value("total").toString();
+    }
+    return GradeCalculator::gpa(totals);
+}
+
+GradeRecomputeSummary GradeRepository::recomputeTotals(const QSqlDatabase& db, const IdRange& students, int chunkSize,
+                                                       const ProgressCallback& progress) {
+    SIS_TRACE_SCOPE("db", "GradeRepository::recomputeTotals");
+    GradeRecomputeSummary summary;
+    QSqlDatabase conn = db;
+
+    ProfiledQuery select(conn, SIS_QUERY_SITE);
+    select.setForwardOnly(true);
+    select.prepare("SELECT student_id, course_id, a1, a2, final_exam, total FROM grades "
+                   "WHERE student_id >= :lo AND student_id < :hi ORDER BY student_id");
+    ProfiledQuery update(conn, SIS_QUERY_SITE);
+    update.prepare("UPDATE grades SET total = :total WHERE student_id = :student_id AND course_id = :course_id");
+
+    struct Change { int studentId; int courseId; QString total; };
+    std::vector<Change> changes;
+    QStringList studentTotals;
+    int currentStudent = 0;
+    auto closeStudent = [&]() {
+        if (std::optional<double> gpa = GradeCalculator::gpa(studentTotals)) {
+            ++summary.students;
+            summary.gpaSum += *gpa;
+            if (*gpa < 2.0) {
+                ++summary.belowTwo;
+            }
+        }
+        studentTotals.clear();
+    };
+
+    for (qint64 lo = students.first; lo <= students.last; lo += chunkSize) {
+        const qint64 hi = std::min(lo + chunkSize, students.last + 1);
+        select.bindValue(":lo", lo);
+        select.bindValue(":hi", hi);
+        if (!select.exec()) {
+            qDebug() << "Recompute Totals Error:" << select.lastError().text();
+            summary.ok = false;
+            return summary;
+        }
+
+        // Window rows are ordered by student, so each GPA closes when the id changes
+        changes.clear();
+        currentStudent = 0;
+        while (select.next()) {
+            const int studentId = select.value(0).toInt();
+            if (studentId != currentStudent) {
+                if (currentStudent != 0) {
+                    closeStudent();
+                }
+                currentStudent = studentId;
+            }
+            const QString total = GradeCalculator::totalGrade(select.value(2).toString(),
+                                                              select.value(3).toString(),
+                                                              select.value(4).toString());
+            if (total != select.value(5).toString()) {
+                changes.push_back({studentId, select.value(1).toInt(), total});
+            }
+            studentTotals << total;
+            ++summary.rows;
+        }
+        if (currentStudent != 0) {
+            closeStudent();
+        }
+        select.finish();
+
+        if (!changes.empty()) {
+            DatabaseManager::beginTransaction(conn);
+            for (const Change& change : changes) {
+                update.bindValue(":total", change.total);
+                update.bindValue(":student_id", change.studentId);
+                update.bindValue(":course_id", change.courseId);
+                if (!update.exec()) {
+                    qDebug() << "Recompute Totals Error:" << update.lastError().text();
+                    DatabaseManager::rollbackTransaction(conn);
+                    summary.ok = false;
+                    return summary;
+                }
+            }
+            if (!DatabaseManager::commitTransaction(conn)) {
+                qDebug() << "Recompute Totals Commit Error:" << conn.lastError().text();
+                DatabaseManager::rollbackTransaction(conn);
+                summary.ok = false;
+                return summary;
+            }
+            summary.updated += qint64(changes.size());
+        }
+        if (progress) {
+            progress(hi - students.first, students.size());
+        }
+    }
+    return summary;
+}
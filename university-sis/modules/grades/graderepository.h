@@ -0,0 +1,48 @@
+#ifndef GRADEREPOSITORY_H
+#define GRADEREPOSITORY_H
+
+#include "grade.h"
+#include "../../database/idrange.h"
+#include <vector>
+#include <optional>
+
+// Outcome of a GPA recomputation pass; partial results from parallel runs merge
+struct GradeRecomputeSummary {
+    qint64 rows = 0;      // Grade rows read
+    qint64 updated = 0;   // Stored totals that were stale
+    int students = 0;     // Students with a GPA
+    double gpaSum = 0.0;
+    int belowTwo = 0;     // Students with a GPA under 2.0
+    bool ok = true;
+
+    void merge(const GradeRecomputeSummary& other);
+    double meanGpa() const { return students > 0 ? gpaSum / students : 0.0; }
+};
+
+/**
+ * @brief Database operations for the grades table. Saving a component also
+ * recomputes the stored total for that (student, course).
+ */
+class GradeRepository {
+public:
+    GradeRepository();
+
+    // -1 means no filter; ordered by course name, then student name
+    std::vector<GradeRecord> getGrades(int courseId = -1, int studentId = -1);
+    std::optional<GradeRecord> getGrade(int studentId, int courseId);
+    bool isEnrolled(int studentId, int courseId);
+
+    // Sets one component; created reports whether a new row was inserted
+    bool saveComponent(int studentId, int courseId, GradeComponent component,
+                       const QString& letter, bool* created = nullptr);
+    bool deleteGrades(int studentId, int courseId);
+
+    std::optional<double> computeGpa(int studentId);
+
+    // Batch: recomputes every stored total for students in [students.first,
+    // students.last], chunkSize student ids per transaction, and gathers GPAs.
+    static GradeRecomputeSummary recomputeTotals(const QSqlDatabase& db, const IdRange& students, int chunkSize,
+                                                 const ProgressCallback& progress = ProgressCallback());
+};
+
+#endif // GRADEREPOSITORY_H
@@ -0,0 +1,41 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <QString>
+#include <QDate>
+#include "loanstatus.h"
+
+/**
+ * @brief A library title; copies are tracked as counters on the row.
+ */
+struct Book {
+    int id = 0;
+    QString isbn;
+    QString title;
+    QString author;
+    QString publisher;
+    int year = 0;
+    QString category;
+    int totalCopies = 1;
+    int availableCopies = 1;
+    QString location;
+};
+
+/**
+ * @brief One checkout of one copy, by a student or a faculty member.
+ */
+struct BookLoan {
+    int id = 0;
+    int bookId = 0;
+    int studentId = 0;   // 0 when borrowed by faculty
+    int facultyId = 0;   // 0 when borrowed by a student
+    QString borrowerName;
+    QDate checkoutDate;
+    QDate dueDate;
+    QDate returnDate;
+    LoanStatus status = LoanStatus::CheckedOut;
+
+    QString borrowerType() const { return studentId > 0 ? "Student" : "Faculty"; }
+};
+
+#endif // BOOK_H
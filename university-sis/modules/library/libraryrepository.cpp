@@ -0,0 +1,256 @@
+#include "libraryrepository.h"
+#include "../../utils/tracer.h"
+#include "../../utils/stringpool.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+#include <algorithm>
+
+LibraryRepository::LibraryRepository() {}
+
+std::vector<Book> LibraryRepository::getBooks(const QString& search, BookFilter filter) {
+    SIS_TRACE_SCOPE("db", "LibraryRepository::getBooks");
+    std::vector<Book> list;
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+
+    QString whereClause = "WHERE 1=1";
+    if (!search.isEmpty()) {
+        whereClause += " AND (title LIKE :search OR author LIKE :search OR isbn LIKE :search OR category LIKE :search)";
+    }
+    switch (filter) {
+    case BookFilter::Available:
+        whereClause += " AND available_copies > 0";
+        break;
+    case BookFilter::CheckedOut:
+        whereClause += " AND available_copies < total_copies";
+        break;
+    case BookFilter::Overdue:
+        whereClause += " AND book_id IN (SELECT book_id FROM book_loans "
+                       "WHERE status_id = :overdue OR (status_id = :out AND due_date < :today))";
+        break;
+    case BookFilter::All:
+        break;
+    }
+
+    query.prepare(QString("SELECT book_id, isbn, title, author, publisher, publication_year, category, "
+                          "available_copies, total_copies, location FROM books %1 ORDER BY title").arg(whereClause));
+    if (!search.isEmpty()) {
+        query.bindValue(":search", "%" + search + "%");
+    }
+    if (filter == BookFilter::Overdue) {
+        query.bindValue(":overdue", int(LoanStatus::Overdue));
+        query.bindValue(":out", int(LoanStatus::CheckedOut));
+        query.bindValue(":today", QDate::currentDate().toString("yyyy-MM-dd"));
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Get Books Error:" << query.lastError().text();
+        return list;
+    }
+    while (query.next()) {
+        Book b;
+        b.id = query.value("book_id").toInt();
+        b.isbn = query.value("isbn").toString();
+        b.title = query.value("title").toString();
+        b.author = query.value("author").toString();
+        b.publisher = query.value("publisher").toString();
+        b.year = query.value("publication_year").toInt();
+        b.category = StringPool::instance().shared(query.value("category").toString());
+        b.availableCopies = query.value("available_copies").toInt();
+        b.totalCopies = query.value("total_copies").toInt();
+        b.location = query.value("location").toString();
+        list.push_back(b);
+    }
+    return list;
+}
+
+bool LibraryRepository::addBook(const Book& book) {
+    SIS_TRACE_SCOPE("db", "LibraryRepository::addBook");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO books (isbn, title, author, publisher, publication_year, category, total_copies, available_copies, location) "
+                  "VALUES (:isbn, :title, :author, :publisher, :year, :category, :copies, :copies, :location)");
+    query.bindValue(":isbn", book.isbn);
+    query.bindValue(":title", book.title);
+    query.bindValue(":author", book.author);
+    query.bindValue(":publisher", book.publisher);
+    query.bindValue(":year", book.year);
+    query.bindValue(":category", book.category);
+    query.bindValue(":copies", book.totalCopies);
+    query.bindValue(":location", book.location);
+
+    if (!query.exec()) {
+        qDebug() << "Add Book Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool LibraryRepository::deleteBook(int id) {
+    SIS_TRACE_SCOPE("db", "LibraryRepository::deleteBook");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("DELETE FROM books WHERE book_id = :id");
+    query.bindValue(":id", id);
+
+    if (!query.exec()) {
+        qDebug() << "Delete Book Error:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+std::vector<BookLoan> LibraryRepository::getOpenLoans(int bookId) {
+    SIS_TRACE_SCOPE("db", "LibraryRepository::getOpenLoans");
+    std::vector<BookLoan> list;
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("SELECT bl.loan_id, bl.student_id, bl.faculty_id, bl.checkout_date, bl.due_date, bl.status_id, "
+                  "COALESCE(s.name, f.name) as borrower_name "
+                  "FROM book_loans bl "
+                  "LEFT JOIN students s ON bl.student_id = s.student_id "
+                  "LEFT JOIN faculty f ON bl.faculty_id = f.faculty_id "
+                  "WHERE bl.book_id = :book_id AND bl.status_id IN (:out, :overdue) "
+                  "ORDER BY bl.checkout_date DESC");
+    query.bindValue(":book_id", bookId);
+    query.bindValue(":out", int(LoanStatus::CheckedOut));
+    query.bindValue(":overdue", int(LoanStatus::Overdue));
+
+    if (!query.exec()) {
+        qDebug() << "Get Open Loans Error:" << query.lastError().text();
+        return list;
+    }
+    while (query.next()) {
+        BookLoan loan;
+        loan.id = query.value("loan_id").toInt();
+        loan.bookId = bookId;
+        loan.studentId = query.value("student_id").toInt();
+        loan.facultyId = query.value("faculty_id").toInt();
+        loan.borrowerName = query.value("borrower_name").toString();
+        loan.checkoutDate = query.value("checkout_date").toDate();
+        loan.dueDate = query.value("due_date").toDate();
+        loan.status = loanStatusFromId(query.value("status_id").toInt());
+        list.push_back(loan);
+    }
+    return list;
+}
+
+bool LibraryRepository::checkOut(BookLoan& loan) {
+    SIS_TRACE_SCOPE("db", "LibraryRepository::checkOut");
+    if (!loan.checkoutDate.isValid()) {
+        loan.checkoutDate = QDate::currentDate();
+    }
+    if (!loan.dueDate.isValid()) {
+        loan.dueDate = loan.checkoutDate.addDays(LoanDays);
+    }
+    loan.status = LoanStatus::CheckedOut;
+
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    DatabaseManager::beginTransaction(db);
+
+    // Claim a copy first so two checkouts cannot take the last one
+    ProfiledQuery claim(db, SIS_QUERY_SITE);
+    claim.prepare("UPDATE books SET available_copies = available_copies - 1 WHERE book_id = :id AND available_copies > 0");
+    claim.bindValue(":id", loan.bookId);
+    if (!claim.exec() || claim.numRowsAffected() <= 0) {
+        qDebug() << "Check Out Error: no copy available for book" << loan.bookId << claim.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO book_loans (book_id, student_id, faculty_id, checkout_date, due_date, status_id) "
+                  "VALUES (:book_id, :student_id, :faculty_id, :checkout_date, :due_date, :status)");
+    query.bindValue(":book_id", loan.bookId);
+    query.bindValue(":student_id", loan.studentId > 0 ? QVariant(loan.studentId) : QVariant());
+    query.bindValue(":faculty_id", loan.facultyId > 0 ? QVariant(loan.facultyId) : QVariant());
+    query.bindValue(":checkout_date", loan.checkoutDate.toString("yyyy-MM-dd"));
+    query.bindValue(":due_date", loan.dueDate.toString("yyyy-MM-dd"));
+    query.bindValue(":status", int(LoanStatus::CheckedOut));
+    if (!query.exec()) {
+        qDebug() << "Check Out Error:" << query.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    loan.id = query.lastInsertId().toInt();
+
+    if (!DatabaseManager::commitTransaction(db)) {
+        qDebug() << "Check Out Commit Error:" << db.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    return true;
+}
+
+bool LibraryRepository::returnLoan(const BookLoan& loan, const QDate& returnDate) {
+    SIS_TRACE_SCOPE("db", "LibraryRepository::returnLoan");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    DatabaseManager::beginTransaction(db);
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("UPDATE book_loans SET return_date = :return_date, status_id = :status "
+                  "WHERE loan_id = :loan_id AND status_id <> :status");
+    query.bindValue(":return_date", returnDate.toString("yyyy-MM-dd"));
+    query.bindValue(":status", int(LoanStatus::Returned));
+    query.bindValue(":loan_id", loan.id);
+    if (!query.exec()) {
+        qDebug() << "Return Loan Error:" << query.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    if (query.numRowsAffected() <= 0) {
+        DatabaseManager::rollbackTransaction(db);
+        return false;  // Already returned
+    }
+
+    ProfiledQuery update(db, SIS_QUERY_SITE);
+    update.prepare("UPDATE books SET available_copies = available_copies + 1 WHERE book_id = :id");
+    update.bindValue(":id", loan.bookId);
+    if (!update.exec()) {
+        qDebug() << "Return Loan Error:" << update.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+
+    if (!DatabaseManager::commitTransaction(db)) {
+        qDebug() << "Return Loan Commit Error:" << db.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    return true;
+}
+
+qint64 LibraryRepository::markOverdueLoans(const QSqlDatabase& db, const QDate& today, int chunkSize,
+                                           const ProgressCallback& progress) {
+    SIS_TRACE_SCOPE("db", "LibraryRepository::markOverdueLoans");
+    const std::optional<IdRange> range = IdRange::of(db, "book_loans", "loan_id");
+    if (!range) {
+        return -1;
+    }
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("UPDATE book_loans SET status_id = :overdue "
+                  "WHERE loan_id >= :lo AND loan_id < :hi AND status_id = :out AND due_date < :today");
+    qint64 changed = 0;
+    for (qint64 lo = range->first; lo <= range->last; lo += chunkSize) {
+        const qint64 hi = std::min(lo + chunkSize, range->last + 1);
+        query.bindValue(":overdue", int(LoanStatus::Overdue));
+        query.bindValue(":lo", lo);
+        query.bindValue(":hi", hi);
+        query.bindValue(":out", int(LoanStatus::CheckedOut));
+        query.bindValue(":today", today.toString("yyyy-MM-dd"));
+        if (!query.exec()) {
+            qDebug() << "Mark Overdue Loans Error:" << query.lastError().text();
+            return -1;
+        }
+        changed += std::max(0, query.numRowsAffected());
+        if (progress) {
+            progress(hi - range->first, range->size());
+        }
+    }
+    return changed;
+}
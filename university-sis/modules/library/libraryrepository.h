@@ -0,0 +1,41 @@
+#ifndef LIBRARYREPOSITORY_H
+#define LIBRARYREPOSITORY_H
+
+#include "book.h"
+#include "../../database/idrange.h"
+#include <vector>
+
+enum class BookFilter {
+    All,
+    Available,
+    CheckedOut,
+    Overdue
+};
+
+/**
+ * @brief Books and loans. Checkouts and returns keep books.available_copies
+ * in step with the loan rows inside one transaction.
+ */
+class LibraryRepository {
+public:
+    static constexpr int LoanDays = 14;
+
+    LibraryRepository();
+
+    // search matches title, author, ISBN or category
+    std::vector<Book> getBooks(const QString& search = QString(), BookFilter filter = BookFilter::All);
+    bool addBook(const Book& book);
+    bool deleteBook(int id);
+
+    // Loans that are checked out or overdue, newest first
+    std::vector<BookLoan> getOpenLoans(int bookId);
+    bool checkOut(BookLoan& loan);  // Fills in id; dueDate defaults to checkoutDate + LoanDays
+    bool returnLoan(const BookLoan& loan, const QDate& returnDate);
+
+    // Batch: flags checked-out loans due before today as overdue, walking
+    // loan_id in windows of chunkSize. Returns the loans changed, -1 on error.
+    static qint64 markOverdueLoans(const QSqlDatabase& db, const QDate& today, int chunkSize,
+                                   const ProgressCallback& progress = ProgressCallback());
+};
+
+#endif // LIBRARYREPOSITORY_H
@@ -0,0 +1,27 @@
+#ifndef LOANSTATUS_H
+#define LOANSTATUS_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Values match loan_statuses.status_id (book_loans.status_id, stored as TINYINT)
+enum class LoanStatus : quint8 {
+    CheckedOut = 1,
+    Returned = 2,
+    Overdue = 3
+};
+
+inline QString loanStatusToString(LoanStatus status) {
+    switch (status) {
+    case LoanStatus::Returned: return "Returned";
+    case LoanStatus::Overdue: return "Overdue";
+    case LoanStatus::CheckedOut: break;
+    }
+    return "Checked Out";
+}
+
+inline LoanStatus loanStatusFromId(int id) {
+    return (id >= 1 && id <= 3) ? static_cast<LoanStatus>(id) : LoanStatus::CheckedOut;
+}
+
+#endif // LOANSTATUS_H
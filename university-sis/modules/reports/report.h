@@ -0,0 +1,49 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <QDate>
+#include <vector>
+
+// Order matches the report type combo in ReportsSystem
+enum class ReportType {
+    StudentEnrollment,
+    CourseStatistics,
+    AttendanceSummary,
+    FinancialSummary
+};
+
+// How a row's highlighted cell should be shown; the view picks the colour
+enum class ReportTone {
+    Neutral,
+    Good,
+    Warning,
+    Bad
+};
+
+struct ReportRow {
+    QStringList cells;
+    ReportTone tone = ReportTone::Neutral;
+};
+
+/**
+ * @brief A generated report: already formatted cells plus the summary text.
+ * toneColumn is the cell the row tone applies to (-1 for none).
+ */
+struct Report {
+    ReportType type = ReportType::StudentEnrollment;
+    QString title;
+    QStringList headers;
+    std::vector<ReportRow> rows;
+    QString summary;
+    int toneColumn = -1;
+    int amountColumn = -1;  // Right-aligned money column (-1 for none)
+    QDate from;
+    QDate to;
+    QString error;          // Set when a query failed; rows and summary are then incomplete
+
+    bool ok() const { return error.isEmpty(); }
+};
+
+#endif // REPORT_H
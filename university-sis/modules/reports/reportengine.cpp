@@ -0,0 +1,435 @@
+#include "reportengine.h"
+#include "../../utils/tracer.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "../attendance/attendance.h"
+#include "../finance/payment.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <QIODevice>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTextStream>
+#include <QVariant>
+#include <QDebug>
+
+namespace {
+QString displayDate(const QDate& date)
+{
+    return date.toString("MMM dd, yyyy");
+}
+}
+
+ReportEngine::ReportEngine()
+    : m_db(DatabaseManager::instance().getDatabase(DbAccess::ReadOnly))
+{
+}
+
+ReportEngine::ReportEngine(const QSqlDatabase& db)
+    : m_db(db)
+{
+}
+
+QString ReportEngine::typeName(ReportType type)
+{
+    switch (type) {
+    case ReportType::CourseStatistics: return "Course Statistics";
+    case ReportType::AttendanceSummary: return "Attendance Summary";
+    case ReportType::FinancialSummary: return "Financial Summary";
+    case ReportType::StudentEnrollment: break;
+    }
+    return "Student Enrollment";
+}
+
+Report ReportEngine::generate(ReportType type, const QDate& from, const QDate& to)
+{
+    Report report;
+    const Report header = generate(type, from, to, [&report](const ReportRow& row) {
+        report.rows.push_back(row);
+    });
+    std::vector<ReportRow> rows = std::move(report.rows);
+    report = header;
+    report.rows = std::move(rows);
+    return report;
+}
+
+Report ReportEngine::generate(ReportType type, const QDate& from, const QDate& to, const RowSink& sink)
+{
+    Report report;
+    report.type = type;
+    report.title = typeName(type) + " Report";
+    report.from = from;
+    report.to = to;
+
+    switch (type) {
+    case ReportType::StudentEnrollment: studentEnrollment(report, sink); break;
+    case ReportType::CourseStatistics: courseStatistics(report, sink); break;
+    case ReportType::AttendanceSummary: attendanceSummary(report, sink); break;
+    case ReportType::FinancialSummary: financialSummary(report, sink); break;
+    }
+    return report;
+}
+
+void ReportEngine::studentEnrollment(Report& report, const RowSink& sink)
+{
+    SIS_TRACE_SCOPE("db", "ReportEngine::studentEnrollment");
+    report.headers << "Student ID" << "Name" << "Year" << "Department" << "Section ID" << "Courses Enrolled";
+
+    ProfiledQuery query(m_db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    query.prepare("SELECT s.student_id, s.name, s.year, s.department, s.section_id, "
+                  "COUNT(DISTINCT ss.section_id) as course_count "
+                  "FROM students s "
+                  "LEFT JOIN student_section ss ON s.student_id = ss.student_id "
+                  "GROUP BY s.student_id "
+                  "ORDER BY s.name");
+
+    int totalStudents = 0;
+    int totalEnrollments = 0;
+    if (!query.exec()) {
+        qDebug() << "Student Report Error:" << query.lastError().text();
+        report.error = query.lastError().text();
+    }
+    while (query.isActive() && query.next()) {
+        ReportRow row;
+        int courseCount = query.value("course_count").toInt();
+        row.cells << query.value("student_id").toString()
+                  << query.value("name").toString()
+                  << query.value("year").toString()
+                  << query.value("department").toString()
+                  << query.value("section_id").toString()
+                  << QString::number(courseCount);
+        sink(row);
+        totalStudents++;
+        totalEnrollments += courseCount;
+    }
+
+    double avgCourses = totalStudents > 0 ? (totalEnrollments * 1.0 / totalStudents) : 0;
+    report.summary = QString("Student Enrollment Report\n"
+                             "Total Students: %1\n"
+                             "Total Course Enrollments: %2\n"
+                             "Average Courses per Student: %3\n"
+                             "Generated: %4")
+                         .arg(totalStudents)
+                         .arg(totalEnrollments)
+                         .arg(QString::number(avgCourses, 'f', 1))
+                         .arg(displayDate(QDate::currentDate()));
+}
+
+void ReportEngine::courseStatistics(Report& report, const RowSink& sink)
+{
+    SIS_TRACE_SCOPE("db", "ReportEngine::courseStatistics");
+    report.headers << "Course ID" << "Course Name" << "Year" << "Hours" << "Sections" << "Students Enrolled" << "Avg Grade";
+    report.toneColumn = 6;
+
+    ProfiledQuery query(m_db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    query.prepare("SELECT c.course_id, c.name as course_name, c.year, c.hours, "
+                  "COUNT(DISTINCT sec.section_id) as section_count, "
+                  "COUNT(DISTINCT ss.student_id) as enrolled, "
+                  "AVG(CASE WHEN g.final_exam = 'A' THEN 95 "
+                  "          WHEN g.final_exam = 'A-' THEN 90 "
+                  "          WHEN g.final_exam = 'B+' THEN 87 "
+                  "          WHEN g.final_exam = 'B' THEN 83 "
+                  "          WHEN g.final_exam = 'B-' THEN 80 "
+                  "          WHEN g.final_exam = 'C+' THEN 77 "
+                  "          WHEN g.final_exam = 'C' THEN 73 "
+                  "          WHEN g.final_exam = 'C-' THEN 70 "
+                  "          WHEN g.final_exam = 'D+' THEN 67 "
+                  "          WHEN g.final_exam = 'D' THEN 63 "
+                  "          WHEN g.final_exam = 'D-' THEN 60 "
+                  "          WHEN g.final_exam = 'F' THEN 50 "
+                  "          ELSE NULL END) as avg_grade "
+                  "FROM courses c "
+                  "LEFT JOIN sections sec ON c.course_id = sec.course_id "
+                  "LEFT JOIN student_section ss ON sec.section_id = ss.section_id "
+                  "LEFT JOIN grades g ON (ss.student_id = g.student_id AND c.course_id = g.course_id) "
+                  "GROUP BY c.course_id "
+                  "ORDER BY c.year, c.name");
+
+    int totalCourses = 0;
+    int totalEnrollments = 0;
+    if (!query.exec()) {
+        qDebug() << "Course Report Error:" << query.lastError().text();
+        report.error = query.lastError().text();
+    }
+    while (query.isActive() && query.next()) {
+        ReportRow row;
+        int enrolled = query.value("enrolled").toInt();
+        double avgGrade = query.value("avg_grade").toDouble();
+        row.cells << query.value("course_id").toString()
+                  << query.value("course_name").toString()
+                  << query.value("year").toString()
+                  << query.value("hours").toString()
+                  << query.value("section_count").toString()
+                  << QString::number(enrolled)
+                  << (avgGrade > 0 ? QString::number(avgGrade, 'f', 1) : "N/A");
+        if (avgGrade >= 90) row.tone = ReportTone::Good;
+        else if (avgGrade >= 70) row.tone = ReportTone::Warning;
+        else if (avgGrade > 0) row.tone = ReportTone::Bad;
+        sink(row);
+        totalCourses++;
+        totalEnrollments += enrolled;
+    }
+
+    report.summary = QString("Course Statistics Report\n"
+                             "Total Courses: %1\n"
+                             "Total Enrollments: %2\n"
+                             "Average Enrollments per Course: %3\n"
+                             "Generated: %4")
+                         .arg(totalCourses)
+                         .arg(totalEnrollments)
+                         .arg(totalCourses > 0 ? QString::number(totalEnrollments * 1.0 / totalCourses, 'f', 1) : "0")
+                         .arg(displayDate(QDate::currentDate()));
+}
+
+void ReportEngine::attendanceSummary(Report& report, const RowSink& sink)
+{
+    SIS_TRACE_SCOPE("db", "ReportEngine::attendanceSummary");
+    report.headers << "Date" << "Student Name" << "Student ID" << "Course Name" << "Status";
+    report.toneColumn = 4;
+
+    ProfiledQuery query(m_db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    query.prepare("SELECT a.date, s.name as student_name, s.student_id, c.name as course_name, a.status_id "
+                  "FROM attendance a "
+                  "LEFT JOIN students s ON a.student_id = s.student_id "
+                  "LEFT JOIN courses c ON a.course_id = c.course_id "
+                  "WHERE a.date BETWEEN :start_date AND :end_date "
+                  "ORDER BY a.date DESC, s.name");
+    query.bindValue(":start_date", report.from.toString("yyyy-MM-dd"));
+    query.bindValue(":end_date", report.to.toString("yyyy-MM-dd"));
+
+    int totalRecords = 0;
+    int presentCount = 0;
+    int absentCount = 0;
+    int lateCount = 0;
+    if (!query.exec()) {
+        qDebug() << "Attendance Report Error:" << query.lastError().text();
+        report.error = query.lastError().text();
+    }
+    while (query.isActive() && query.next()) {
+        ReportRow row;
+        AttendanceStatus status = Attendance::statusFromId(query.value("status_id").toInt());
+        row.cells << displayDate(query.value("date").toDate())
+                  << query.value("student_name").toString()
+                  << query.value("student_id").toString()
+                  << query.value("course_name").toString()
+                  << Attendance::statusToString(status);
+        if (status == AttendanceStatus::Present) {
+            row.tone = ReportTone::Good;
+            presentCount++;
+        } else if (status == AttendanceStatus::Absent) {
+            row.tone = ReportTone::Bad;
+            absentCount++;
+        } else if (status == AttendanceStatus::Late) {
+            row.tone = ReportTone::Warning;
+            lateCount++;
+        }
+        sink(row);
+        totalRecords++;
+    }
+
+    double attendanceRate = totalRecords > 0 ? (presentCount * 100.0 / totalRecords) : 0;
+    report.summary = QString("Attendance Summary Report\n"
+                             "Period: %1 to %2\n"
+                             "Total Records: %3\n"
+                             "Present: %4\n"
+                             "Absent: %5\n"
+                             "Late: %6\n"
+                             "Attendance Rate: %7%\n"
+                             "Generated: %8")
+                         .arg(displayDate(report.from))
+                         .arg(displayDate(report.to))
+                         .arg(totalRecords)
+                         .arg(presentCount)
+                         .arg(absentCount)
+                         .arg(lateCount)
+                         .arg(QString::number(attendanceRate, 'f', 1))
+                         .arg(displayDate(QDate::currentDate()));
+}
+
+void ReportEngine::financialSummary(Report& report, const RowSink& sink)
+{
+    SIS_TRACE_SCOPE("db", "ReportEngine::financialSummary");
+    report.headers << "Payment ID" << "Student Name" << "Student ID" << "Date" << "Amount" << "Status" << "Description";
+    report.toneColumn = 5;
+    report.amountColumn = 4;
+
+    ProfiledQuery query(m_db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    query.prepare("SELECT p.payment_id, s.name as student_name, s.student_id, p.date, p.amount, p.status_id, p.description "
+                  "FROM payments p "
+                  "LEFT JOIN students s ON p.student_id = s.student_id "
+                  "WHERE p.date BETWEEN :start_date AND :end_date "
+                  "ORDER BY p.date DESC");
+    query.bindValue(":start_date", report.from.toString("yyyy-MM-dd"));
+    query.bindValue(":end_date", report.to.toString("yyyy-MM-dd"));
+
+    int totalPayments = 0;
+    double totalAmount = 0;
+    double paidAmount = 0;
+    double pendingAmount = 0;
+    double overdueAmount = 0;
+    int paidCount = 0;
+    int pendingCount = 0;
+    int overdueCount = 0;
+
+    if (!query.exec()) {
+        qDebug() << "Financial Report Error:" << query.lastError().text();
+        report.error = query.lastError().text();
+    }
+    while (query.isActive() && query.next()) {
+        ReportRow row;
+        double amount = query.value("amount").toDouble();
+        PaymentStatus status = Payment::statusFromId(query.value("status_id").toInt());
+        row.cells << query.value("payment_id").toString()
+                  << query.value("student_name").toString()
+                  << query.value("student_id").toString()
+                  << displayDate(query.value("date").toDate())
+                  << QString("$%1").arg(amount, 0, 'f', 2)
+                  << Payment::statusToString(status)
+                  << query.value("description").toString();
+        if (status == PaymentStatus::Paid) {
+            row.tone = ReportTone::Good;
+            paidAmount += amount;
+            paidCount++;
+        } else if (status == PaymentStatus::Pending) {
+            row.tone = ReportTone::Warning;
+            pendingAmount += amount;
+            pendingCount++;
+        } else if (status == PaymentStatus::Overdue) {
+            row.tone = ReportTone::Bad;
+            overdueAmount += amount;
+            overdueCount++;
+        }
+        sink(row);
+        totalPayments++;
+        totalAmount += amount;
+    }
+
+    report.summary = QString("Financial Summary Report\n"
+                             "Period: %1 to %2\n"
+                             "Total Payments: %3\n"
+                             "Total Amount: $%4\n"
+                             "Paid: %5 ($%6)\n"
+                             "Pending: %7 ($%8)\n"
+                             "Overdue: %9 ($%10)\n"
+                             "Collection Rate: %11%\n"
+                             "Generated: %12")
+                         .arg(displayDate(report.from))
+                         .arg(displayDate(report.to))
+                         .arg(totalPayments)
+                         .arg(QString::number(totalAmount, 'f', 2))
+                         .arg(paidCount)
+                         .arg(QString::number(paidAmount, 'f', 2))
+                         .arg(pendingCount)
+                         .arg(QString::number(pendingAmount, 'f', 2))
+                         .arg(overdueCount)
+                         .arg(QString::number(overdueAmount, 'f', 2))
+                         .arg(totalAmount > 0 ? QString::number((paidAmount / totalAmount) * 100, 'f', 1) : "0")
+                         .arg(displayDate(QDate::currentDate()));
+}
+
+QString ReportEngine::csvLine(const QStringList& cells)
+{
+    QStringList quoted;
+    quoted.reserve(cells.size());
+    for (const QString& cell : cells) {
+        quoted << "\"" + QString(cell).replace("\"", "\"\"") + "\"";
+    }
+    return quoted.join(",");
+}
+
+bool ReportEngine::writeCsv(const Report& report, QIODevice* device)
+{
+    QTextStream out(device);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    out.setEncoding(QStringConverter::Utf8);
+#else
+    out.setCodec("UTF-8");
+#endif
+
+    out << report.summary << "\n\n";
+    out << csvLine(report.headers) << "\n";
+    for (const ReportRow& row : report.rows) {
+        out << csvLine(row.cells) << "\n";
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+bool ReportEngine::exportCsv(const Report& report, const QString& path)
+{
+    if (!report.ok()) {
+        qDebug() << "Export Report Error: report incomplete:" << report.error;
+        return false;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "Export Report Error:" << file.errorString();
+        return false;
+    }
+    return writeCsv(report, &file);
+}
+
+bool ReportEngine::exportCsv(ReportType type, const QDate& from, const QDate& to, const QString& path,
+                             qint64* rowCount)
+{
+    SIS_TRACE_SCOPE("db", "ReportEngine::exportCsv");
+    // Rows go to a scratch file next to the target; the summary that heads the
+    // CSV is only known once the query is exhausted
+    QTemporaryFile rowsFile(QFileInfo(path).absolutePath() + "/.report_rows_XXXXXX");
+    if (!rowsFile.open()) {
+        qDebug() << "Export Report Error:" << rowsFile.errorString();
+        return false;
+    }
+    qint64 rows = 0;
+    Report report;
+    {
+        QTextStream out(&rowsFile);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        out.setEncoding(QStringConverter::Utf8);
+#else
+        out.setCodec("UTF-8");
+#endif
+        report = generate(type, from, to, [&out, &rows](const ReportRow& row) {
+            out << csvLine(row.cells) << "\n";
+            ++rows;
+        });
+        out.flush();
+        if (out.status() != QTextStream::Ok) {
+            qDebug() << "Export Report Error: writing rows failed";
+            return false;
+        }
+    }
+    if (!report.ok()) {
+        // A header-only file would pass for an empty report; leave no file at all
+        qDebug() << "Export Report Error: report incomplete:" << report.error;
+        QFile::remove(path);
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Export Report Error:" << file.errorString();
+        return false;
+    }
+    const QByteArray head = (report.summary + "\n\n" + csvLine(report.headers) + "\n").toUtf8();
+    bool ok = file.write(head) == head.size();
+    rowsFile.seek(0);
+    QByteArray block;
+    while (ok && !(block = rowsFile.read(1 << 16)).isEmpty()) {
+        ok = file.write(block) == block.size();
+    }
+    if (!ok) {
+        qDebug() << "Export Report Error:" << file.errorString();
+        file.remove();
+        return false;
+    }
+    if (rowCount) {
+        *rowCount = rows;
+    }
+    return true;
+}
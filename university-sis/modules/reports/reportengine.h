@@ -0,0 +1,49 @@
+#ifndef REPORTENGINE_H
+#define REPORTENGINE_H
+
+#include "report.h"
+#include <QSqlDatabase>
+#include <functional>
+
+class QIODevice;
+
+/**
+ * @brief Builds the reports shown on the Reports page, without any widgets.
+ *
+ * Rows can either be collected into the Report or handed to a sink one at a
+ * time, which keeps memory flat for exports of the whole database. The
+ * summary is only known once every row has been read.
+ */
+class ReportEngine {
+public:
+    using RowSink = std::function<void(const ReportRow&)>;
+
+    ReportEngine();                                // Read connection (replica when configured)
+    explicit ReportEngine(const QSqlDatabase& db); // e.g. a ScopedConnection on a worker thread
+
+    static QString typeName(ReportType type);
+
+    // from/to only apply to the attendance and financial reports
+    Report generate(ReportType type, const QDate& from, const QDate& to);
+    // Streams rows to sink; the returned report has headers and summary but no rows
+    Report generate(ReportType type, const QDate& from, const QDate& to, const RowSink& sink);
+
+    // Summary, a blank line, then quoted header and rows (UTF-8)
+    static bool writeCsv(const Report& report, QIODevice* device);
+    static bool exportCsv(const Report& report, const QString& path);
+    static QString csvLine(const QStringList& cells);
+    // Same file layout, but rows are streamed through a temporary file
+    // instead of being held, so memory does not grow with the report
+    bool exportCsv(ReportType type, const QDate& from, const QDate& to, const QString& path,
+                   qint64* rowCount = nullptr);
+
+private:
+    void studentEnrollment(Report& report, const RowSink& sink);
+    void courseStatistics(Report& report, const RowSink& sink);
+    void attendanceSummary(Report& report, const RowSink& sink);
+    void financialSummary(Report& report, const RowSink& sink);
+
+    QSqlDatabase m_db;
+};
+
+#endif // REPORTENGINE_H
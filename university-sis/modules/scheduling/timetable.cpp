@@ -0,0 +1,73 @@
+#include "timetable.h"
+#include "../calendar/recurrencerule.h"
+#include <QHash>
+#include <QStringList>
+
+QString TimeSlot::label() const
+{
+    static const char* const names[7] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+    QStringList dayNames;
+    // Week shown starting on Sunday, as in the university calendar
+    for (int day : {6, 0, 1, 2, 3, 4, 5}) {
+        if (days & (1 << day)) {
+            dayNames << names[day];
+        }
+    }
+    return QString("%1 %2-%3").arg(dayNames.join('/'), start.toString("HH:mm"), end.toString("HH:mm"));
+}
+
+std::vector<TimeSlot> TimeSlot::defaultWeek()
+{
+    const quint8 patterns[] = {
+        quint8(RecurrenceRule::Sunday | RecurrenceRule::Tuesday),
+        quint8(RecurrenceRule::Monday | RecurrenceRule::Wednesday),
+        quint8(RecurrenceRule::Tuesday | RecurrenceRule::Thursday),
+        quint8(RecurrenceRule::Sunday | RecurrenceRule::Wednesday),
+        quint8(RecurrenceRule::Monday | RecurrenceRule::Thursday)
+    };
+    std::vector<TimeSlot> slots;
+    for (quint8 days : patterns) {
+        for (int i = 0; i < 6; ++i) {
+            TimeSlot slot;
+            slot.id = int(slots.size()) + 1;
+            slot.days = days;
+            slot.start = QTime(8, 0).addSecs(i * 90 * 60);
+            slot.end = slot.start.addSecs(80 * 60);
+            slots.push_back(slot);
+        }
+    }
+    return slots;
+}
+
+void TimetableProblem::buildConflicts(const std::vector<std::pair<int, int>>& studentSections)
+{
+    conflicts.assign(sections.size(), {});
+    QHash<quint64, int> shared; // (low index << 32 | high index) -> students
+
+    size_t begin = 0;
+    while (begin < studentSections.size()) {
+        size_t end = begin;
+        while (end < studentSections.size() && studentSections[end].first == studentSections[begin].first) {
+            ++end;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t j = i + 1; j < end; ++j) {
+                const int a = studentSections[i].second;
+                const int b = studentSections[j].second;
+                if (a == b) {
+                    continue;
+                }
+                const quint64 key = (quint64(qMin(a, b)) << 32) | quint32(qMax(a, b));
+                shared[key] += 1;
+            }
+        }
+        begin = end;
+    }
+
+    for (auto it = shared.constBegin(); it != shared.constEnd(); ++it) {
+        const int a = int(it.key() >> 32);
+        const int b = int(it.key() & 0xffffffffu);
+        conflicts[a].push_back({b, it.value()});
+        conflicts[b].push_back({a, it.value()});
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef TIMETABLE_H
+#define TIMETABLE_H
+
+#include <QTime>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+// A weekly meeting pattern, e.g. Sunday + Tuesday 08:00-09:20
+struct TimeSlot {
+    int id = 0;
+    quint8 days = 0; // RecurrenceRule::Weekday bit mask
+    QTime start;
+    QTime end;
+
+    bool overlaps(const TimeSlot& other) const {
+        return (days & other.days) != 0 && start < other.end && other.start < end;
+    }
+
+    QString label() const;
+
+    // Two-day patterns over the Sunday-Thursday week, 6 start times each
+    static std::vector<TimeSlot> defaultWeek();
+};
+
+struct TimetableSection {
+    int id = 0;
+    int courseId = 0;
+    int demand = 0;                  // Seats needed (sections.max_students)
+};
+
+struct TimetableRoom {
+    int id = 0;
+    int capacity = 0;
+};
+
+// Sections sharing students, with the number of shared students as weight
+struct SectionConflict {
+    int other = 0; // Index into TimetableProblem::sections
+    int students = 0;
+};
+
+struct TimetableProblem {
+    std::vector<TimetableSection> sections;
+    std::vector<TimetableRoom> rooms;
+    std::vector<TimeSlot> slots;
+    std::vector<std::vector<SectionConflict>> conflicts; // Per section index, symmetric
+
+    // Builds `conflicts` from (student, section index) pairs sorted by student
+    void buildConflicts(const std::vector<std::pair<int, int>>& studentSections);
+};
+
+struct TimetableAssignment {
+    int sectionId = 0;
+    int roomId = 0;   // 0 = unassigned
+    int slotId = 0;
+};
+
+struct TimetableResult {
+    std::vector<TimetableAssignment> assignments; // Same order as TimetableProblem::sections
+    int unassigned = 0;
+    int studentConflicts = 0;  // Shared students whose sections overlap
+    int roomConflicts = 0;     // Always 0 unless the solver is broken
+    int capacityViolations = 0;
+    qint64 greedyMs = 0;
+    qint64 elapsedMs = 0;
+    quint64 moves = 0;         // Local search moves evaluated across all threads
+    int threads = 0;
+
+    bool isFeasible() const { return unassigned == 0 && studentConflicts == 0 && roomConflicts == 0 && capacityViolations == 0; }
+};
+
+#endif // TIMETABLE_H
@@ -0,0 +1,68 @@
+#include "timetablegenerator.h"
+#include <QRandomGenerator>
+
+TimetableProblem TimetableGenerator::generate(const Params& params)
+{
+    QRandomGenerator rng(params.seed);
+    TimetableProblem problem;
+    problem.slots = TimeSlot::defaultWeek();
+
+    // Rooms: mostly mid-size classrooms, some small rooms, a few large halls
+    const int roomCount = params.rooms > 0 ? params.rooms : qMax(1, params.sections / 10);
+    for (int i = 0; i < roomCount; ++i) {
+        TimetableRoom room;
+        room.id = i + 1;
+        const int kind = int(rng.bounded(100));
+        if (kind < 20) {
+            room.capacity = 25 + int(rng.bounded(4)) * 5;
+        } else if (kind < 30) {
+            room.capacity = 100 + int(rng.bounded(5)) * 25;
+        } else {
+            room.capacity = 30 + int(rng.bounded(5)) * 10;
+        }
+        problem.rooms.push_back(room);
+    }
+
+    const int perCourse = qMax(1, params.sectionsPerCourse);
+    for (int i = 0; i < params.sections; ++i) {
+        TimetableSection section;
+        section.id = i + 1;
+        section.courseId = i / perCourse + 1;
+        if (rng.bounded(20) == 0) {
+            section.demand = 80 + int(rng.bounded(60));
+        } else {
+            section.demand = 20 + int(rng.bounded(40));
+        }
+        problem.sections.push_back(section);
+    }
+
+    // Each cohort shares a block of core courses; a student takes one section of each
+    const int courses = (params.sections + perCourse - 1) / perCourse;
+    const int perStudent = qMax(1, params.sectionsPerStudent);
+    const int core = qMax(1, perStudent - 1);
+    const int cohorts = qMax(1, courses / core);
+    const int students = qMax(1, params.sections * params.studentsPerSection / perStudent);
+    auto sectionOf = [&](int course) {
+        const int first = course * perCourse;
+        return first + int(rng.bounded(qMin(perCourse, params.sections - first)));
+    };
+
+    std::vector<std::pair<int, int>> studentSections;
+    studentSections.reserve(size_t(students) * perStudent);
+    for (int student = 1; student <= students && params.sections > 0; ++student) {
+        const int cohort = int(rng.bounded(cohorts));
+        const int firstCourse = cohort * core;
+        for (int c = firstCourse; c < qMin(firstCourse + core, courses); ++c) {
+            studentSections.emplace_back(student, sectionOf(c));
+        }
+        if (perStudent > 1 && courses > core) {
+            int elective = int(rng.bounded(courses));
+            while (elective >= firstCourse && elective < firstCourse + core) {
+                elective = int(rng.bounded(courses));
+            }
+            studentSections.emplace_back(student, sectionOf(elective));
+        }
+    }
+    problem.buildConflicts(studentSections);
+    return problem;
+}
@@ -0,0 +1,27 @@
+#ifndef TIMETABLEGENERATOR_H
+#define TIMETABLEGENERATOR_H
+
+#include "timetable.h"
+
+/**
+ * @brief Synthetic, reproducible timetable problems for benchmarking the solver.
+ *
+ * Students belong to cohorts that share their core courses (one section of
+ * each) plus one random elective, which gives the clustered overlap graph a
+ * real term has.
+ */
+class TimetableGenerator {
+public:
+    struct Params {
+        int sections = 2000;
+        int rooms = 0;              // 0 = sections / 10
+        int sectionsPerCourse = 2;
+        int sectionsPerStudent = 5;  // Core courses of the cohort plus one elective
+        int studentsPerSection = 25; // Average enrolled students, drives the student count
+        quint32 seed = 42;
+    };
+
+    static TimetableProblem generate(const Params& params);
+};
+
+#endif // TIMETABLEGENERATOR_H
@@ -0,0 +1,127 @@
+#include "timetablerepository.h"
+#include "../../utils/tracer.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "../academic/sectionrepository.h"
+#include "../facility/facilityrepository.h"
+#include "../enrollment/enrollmentvalidator.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+
+TimetableRepository::TimetableRepository() {}
+
+TimetableProblem TimetableRepository::loadProblem(const std::vector<TimeSlot>& slots) {
+    SIS_TRACE_SCOPE("db", "TimetableRepository::loadProblem");
+    TimetableProblem problem;
+    problem.slots = slots;
+
+    QHash<int, int> sectionIndex;
+    for (const auto& s : SectionRepository().getAllSections()) {
+        TimetableSection section;
+        section.id = s.id;
+        section.courseId = s.courseId;
+        section.demand = s.maxStudents;
+        sectionIndex.insert(s.id, int(problem.sections.size()));
+        problem.sections.push_back(section);
+    }
+
+    for (const auto& r : FacilityRepository().getAllRoomsCompact()) {
+        TimetableRoom room;
+        room.id = r.id;
+        room.capacity = r.capacity;
+        problem.rooms.push_back(room);
+    }
+
+    std::vector<std::pair<int, int>> studentSections;
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (query.exec("SELECT student_id, section_id FROM student_section ORDER BY student_id")) {
+        while (query.next()) {
+            auto it = sectionIndex.constFind(query.value(1).toInt());
+            if (it != sectionIndex.constEnd()) {
+                studentSections.emplace_back(query.value(0).toInt(), it.value());
+            }
+        }
+    } else {
+        qDebug() << "Load Student Sections Error:" << query.lastError().text();
+    }
+    problem.buildConflicts(studentSections);
+    return problem;
+}
+
+bool TimetableRepository::saveSchedule(const TimetableProblem& problem, const TimetableResult& result) {
+    SIS_TRACE_SCOPE("db", "TimetableRepository::saveSchedule");
+    QHash<int, const TimeSlot*> slotById;
+    for (const auto& slot : problem.slots) {
+        slotById.insert(slot.id, &slot);
+    }
+
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    DatabaseManager::beginTransaction(db);
+
+    ProfiledQuery clear(db, SIS_QUERY_SITE);
+    if (!clear.exec("DELETE FROM section_schedule")) {
+        qDebug() << "Clear Section Schedule Error:" << clear.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+
+    QVariantList sectionIds, roomIds, days, starts, ends;
+    for (const auto& a : result.assignments) {
+        const TimeSlot* slot = slotById.value(a.slotId, nullptr);
+        if (a.roomId == 0 || !slot) {
+            continue;
+        }
+        sectionIds << a.sectionId;
+        roomIds << a.roomId;
+        days << int(slot->days);
+        starts << slot->start.toString("HH:mm");
+        ends << slot->end.toString("HH:mm");
+    }
+
+    if (!sectionIds.isEmpty()) {
+        ProfiledQuery insert(db, SIS_QUERY_SITE);
+        insert.prepare("INSERT INTO section_schedule (section_id, room_id, days, start_time, end_time) "
+                       "VALUES (?, ?, ?, ?, ?)");
+        insert.addBindValue(sectionIds);
+        insert.addBindValue(roomIds);
+        insert.addBindValue(days);
+        insert.addBindValue(starts);
+        insert.addBindValue(ends);
+        if (!insert.execBatch()) {
+            qDebug() << "Save Section Schedule Error:" << insert.lastError().text();
+            DatabaseManager::rollbackTransaction(db);
+            return false;
+        }
+    }
+
+    if (!DatabaseManager::commitTransaction(db)) {
+        return false;
+    }
+    EnrollmentValidator::instance().invalidate(); // Clash checks use the new slots
+    return true;
+}
+
+QHash<int, QString> TimetableRepository::getScheduleLabels() {
+    SIS_TRACE_SCOPE("db", "TimetableRepository::getScheduleLabels");
+    QHash<int, QString> labels;
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT ss.section_id, ss.days, ss.start_time, ss.end_time, r.room_number "
+                    "FROM section_schedule ss LEFT JOIN rooms r ON r.room_id = ss.room_id")) {
+        qDebug() << "Get Section Schedule Error:" << query.lastError().text();
+        return labels;
+    }
+    while (query.next()) {
+        TimeSlot slot;
+        slot.days = quint8(query.value(1).toInt());
+        slot.start = QTime::fromString(query.value(2).toString().left(5), "HH:mm");
+        slot.end = QTime::fromString(query.value(3).toString().left(5), "HH:mm");
+        labels.insert(query.value(0).toInt(), QString("%1, Room %2").arg(slot.label(), query.value(4).toString()));
+    }
+    return labels;
+}
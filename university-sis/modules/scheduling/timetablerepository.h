@@ -0,0 +1,21 @@
+#ifndef TIMETABLEREPOSITORY_H
+#define TIMETABLEREPOSITORY_H
+
+#include "timetable.h"
+#include <QHash>
+
+class TimetableRepository {
+public:
+    TimetableRepository();
+
+    // Sections, rooms and the student overlap graph (from student_section) for the given slots
+    TimetableProblem loadProblem(const std::vector<TimeSlot>& slots = TimeSlot::defaultWeek());
+
+    // Replaces section_schedule with the assigned sections of result
+    bool saveSchedule(const TimetableProblem& problem, const TimetableResult& result);
+
+    // section_id -> "Sun/Tue 08:00-09:20, Room 101"
+    QHash<int, QString> getScheduleLabels();
+};
+
+#endif // TIMETABLEREPOSITORY_H
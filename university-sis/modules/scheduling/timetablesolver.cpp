@@ -0,0 +1,421 @@
+#include "timetablesolver.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const long long UnassignedPenalty = 1000; // Outweighs any realistic student overlap
+
+// Read-only precomputation shared by all workers
+struct Model {
+    explicit Model(const TimetableProblem& problem)
+        : p(problem), S(int(problem.sections.size())), R(int(problem.rooms.size())), T(int(problem.slots.size()))
+    {
+        overlap.assign(size_t(T) * T, 0);
+        overlapping.resize(T);
+        for (int a = 0; a < T; ++a) {
+            for (int b = 0; b < T; ++b) {
+                if (problem.slots[a].overlaps(problem.slots[b])) {
+                    overlap[size_t(a) * T + b] = 1;
+                    overlapping[a].push_back(b);
+                }
+            }
+        }
+
+        // Rooms that fit each section, smallest first so the first free one is the best fit
+        std::vector<int> byCapacity(R);
+        for (int r = 0; r < R; ++r) {
+            byCapacity[r] = r;
+        }
+        std::sort(byCapacity.begin(), byCapacity.end(), [&problem](int a, int b) {
+            return problem.rooms[a].capacity < problem.rooms[b].capacity;
+        });
+        eligibleRooms.resize(S);
+        for (int s = 0; s < S; ++s) {
+            const TimetableSection& section = problem.sections[s];
+            for (int r : byCapacity) {
+                const TimetableRoom& room = problem.rooms[r];
+                if (room.capacity >= section.demand) {
+                    eligibleRooms[s].push_back(r);
+                }
+            }
+        }
+    }
+
+    bool overlaps(int a, int b) const { return overlap[size_t(a) * T + b] != 0; }
+
+    const TimetableProblem& p;
+    int S;
+    int R;
+    int T;
+    std::vector<char> overlap;                // T x T
+    std::vector<std::vector<int>> overlapping; // Slot -> overlapping slots (including itself)
+    std::vector<std::vector<int>> eligibleRooms;
+};
+
+// Mutable assignment with incrementally maintained cost
+struct State {
+    explicit State(const Model& model)
+        : m(&model), slotOf(model.S, -1), roomOf(model.S, -1),
+          occupant(size_t(model.R) * model.T, -1), blocked(size_t(model.R) * model.T, 0),
+          unassigned(model.S) {}
+
+    // Student overlap s would have in slot t given everyone else's placement
+    int conflictAt(int s, int t) const {
+        int c = 0;
+        for (const auto& e : m->p.conflicts[s]) {
+            const int u = slotOf[e.other];
+            if (u >= 0 && m->overlaps(t, u)) {
+                c += e.students;
+            }
+        }
+        return c;
+    }
+
+    // A placement counts as blocking for every slot it overlaps in its room
+    bool roomFree(int r, int t, int ignore) const {
+        int blocks = blocked[size_t(r) * m->T + t];
+        if (ignore >= 0 && roomOf[ignore] == r && m->overlaps(t, slotOf[ignore])) {
+            --blocks;
+        }
+        return blocks == 0;
+    }
+
+    int freeRoom(int s, int t, int ignore) const {
+        for (int r : m->eligibleRooms[s]) {
+            if (roomFree(r, t, ignore)) {
+                return r;
+            }
+        }
+        return -1;
+    }
+
+    void place(int s, int r, int t) {
+        conflictWeight += conflictAt(s, t);
+        slotOf[s] = t;
+        roomOf[s] = r;
+        occupant[size_t(r) * m->T + t] = s;
+        for (int u : m->overlapping[t]) {
+            ++blocked[size_t(r) * m->T + u];
+        }
+        --unassigned;
+    }
+
+    void remove(int s) {
+        const int t = slotOf[s];
+        const int r = roomOf[s];
+        occupant[size_t(r) * m->T + t] = -1;
+        for (int u : m->overlapping[t]) {
+            --blocked[size_t(r) * m->T + u];
+        }
+        slotOf[s] = -1;
+        roomOf[s] = -1;
+        conflictWeight -= conflictAt(s, t);
+        ++unassigned;
+    }
+
+    long long cost() const { return unassigned * UnassignedPenalty + conflictWeight; }
+
+    // Cheapest slot with a free room; ties go to the smaller room. Returns false when none fits.
+    bool bestPlacement(int s, int ignore, int skipSlot, int startSlot, int& bestSlot, int& bestRoom, int& bestConflict) const {
+        bestSlot = -1;
+        bestRoom = -1;
+        bestConflict = std::numeric_limits<int>::max();
+        for (int k = 0; k < m->T; ++k) {
+            const int t = (startSlot + k) % m->T;
+            if (t == skipSlot) {
+                continue;
+            }
+            const int c = conflictAt(s, t);
+            if (c > bestConflict) {
+                continue;
+            }
+            const int r = freeRoom(s, t, ignore);
+            if (r < 0) {
+                continue;
+            }
+            if (c < bestConflict || m->p.rooms[r].capacity < m->p.rooms[bestRoom].capacity) {
+                bestSlot = t;
+                bestRoom = r;
+                bestConflict = c;
+            }
+        }
+        return bestSlot >= 0;
+    }
+
+    const Model* m;
+    std::vector<int> slotOf;
+    std::vector<int> roomOf;
+    std::vector<int> occupant; // (room, slot) -> section starting exactly in that slot
+    std::vector<int> blocked;  // (room, slot) -> placements overlapping that slot
+    long long conflictWeight = 0;
+    int unassigned = 0;
+};
+
+void greedy(State& state)
+{
+    const Model& m = *state.m;
+    std::vector<long long> degree(m.S, 0);
+    for (int s = 0; s < m.S; ++s) {
+        for (const auto& e : m.p.conflicts[s]) {
+            degree[s] += e.students;
+        }
+    }
+    // Hardest first: fewest rooms, most shared students, largest demand
+    std::vector<int> order(m.S);
+    for (int s = 0; s < m.S; ++s) {
+        order[s] = s;
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        if (m.eligibleRooms[a].size() != m.eligibleRooms[b].size()) {
+            return m.eligibleRooms[a].size() < m.eligibleRooms[b].size();
+        }
+        if (degree[a] != degree[b]) {
+            return degree[a] > degree[b];
+        }
+        return m.p.sections[a].demand > m.p.sections[b].demand;
+    });
+
+    int start = 0;
+    for (int s : order) {
+        int t, r, c;
+        // Rotating the first slot spreads sections over the week instead of filling mornings first
+        if (state.bestPlacement(s, -1, -1, start, t, r, c)) {
+            state.place(s, r, t);
+        }
+        start = (start + 1) % qMax(1, m.T);
+    }
+}
+
+struct WorkerResult {
+    long long cost = std::numeric_limits<long long>::max();
+    std::vector<int> slotOf;
+    std::vector<int> roomOf;
+    quint64 moves = 0;
+};
+
+void localSearch(State state, const QElapsedTimer& clock, qint64 deadlineMs, quint32 seed,
+                 std::atomic<bool>& solved, WorkerResult& out)
+{
+    const Model& m = *state.m;
+    QRandomGenerator rng(seed);
+    out.cost = state.cost();
+    out.slotOf = state.slotOf;
+    out.roomOf = state.roomOf;
+    if (m.S == 0 || m.T == 0 || out.cost == 0) {
+        solved = true;
+        return;
+    }
+
+    const double startTemp = 2.0;
+    const double endTemp = 0.05;
+    const qint64 startMs = clock.elapsed();
+    const double spanMs = qMax<qint64>(1, deadlineMs - startMs);
+    double temp = startTemp;
+    std::vector<int> hot; // Sections in conflict, refreshed every 256 moves
+
+    auto accept = [&](long long delta) {
+        if (delta < 0) return true;
+        if (delta == 0) return rng.bounded(2) == 0;
+        return rng.generateDouble() < std::exp(-double(delta) / temp);
+    };
+
+    for (quint64 iter = 0;; ++iter) {
+        if ((iter & 63) == 0) {
+            const qint64 now = clock.elapsed();
+            if (now >= deadlineMs || solved.load(std::memory_order_relaxed)) {
+                break;
+            }
+            temp = startTemp * std::pow(endTemp / startTemp, double(now - startMs) / spanMs);
+        }
+        ++out.moves;
+
+        // Mostly work on sections that are unassigned or in conflict
+        if ((iter & 255) == 0) {
+            hot.clear();
+            for (int i = 0; i < m.S; ++i) {
+                if (state.slotOf[i] < 0 || state.conflictAt(i, state.slotOf[i]) > 0) {
+                    hot.push_back(i);
+                }
+            }
+        }
+        const int s = (!hot.empty() && rng.bounded(10) < 8) ? hot[rng.bounded(int(hot.size()))]
+                                                            : int(rng.bounded(m.S));
+
+        const int oldSlot = state.slotOf[s];
+        const int oldRoom = state.roomOf[s];
+        const long long current = oldSlot < 0 ? UnassignedPenalty : state.conflictAt(s, oldSlot);
+
+        int t, r, c;
+        if (state.bestPlacement(s, s, oldSlot, int(rng.bounded(m.T)), t, r, c) && accept(c - current)) {
+            if (oldSlot >= 0) {
+                state.remove(s);
+            }
+            state.place(s, r, t);
+        } else if (!m.eligibleRooms[s].empty()) {
+            // Eject the occupant of a random fitting room/slot and try to re-place it elsewhere
+            const int ejectSlot = int(rng.bounded(m.T));
+            const int ejectRoom = m.eligibleRooms[s][rng.bounded(int(m.eligibleRooms[s].size()))];
+            const int other = state.occupant[size_t(ejectRoom) * m.T + ejectSlot];
+            if (other < 0 || other == s) {
+                continue;
+            }
+            const long long before = state.cost();
+            state.remove(other);
+            if (oldSlot >= 0) {
+                state.remove(s);
+            }
+            if (!state.roomFree(ejectRoom, ejectSlot, -1)) {
+                // Still blocked by a neighbouring slot: undo
+                if (oldSlot >= 0) state.place(s, oldRoom, oldSlot);
+                state.place(other, ejectRoom, ejectSlot);
+                continue;
+            }
+            state.place(s, ejectRoom, ejectSlot);
+            int ot, orr, oc;
+            if (state.bestPlacement(other, -1, -1, int(rng.bounded(m.T)), ot, orr, oc)) {
+                state.place(other, orr, ot);
+            }
+            if (!accept(state.cost() - before)) {
+                if (state.slotOf[other] >= 0) state.remove(other);
+                state.remove(s);
+                state.place(other, ejectRoom, ejectSlot);
+                if (oldSlot >= 0) state.place(s, oldRoom, oldSlot);
+            }
+        } else {
+            continue;
+        }
+
+        const long long cost = state.cost();
+        if (cost < out.cost) {
+            out.cost = cost;
+            out.slotOf = state.slotOf;
+            out.roomOf = state.roomOf;
+            if (cost == 0) {
+                solved = true;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TimetableSolver::TimetableSolver() {}
+
+TimetableSolver::TimetableSolver(const Config& config) : m_config(config) {}
+
+TimetableResult TimetableSolver::solve(const TimetableProblem& problem) const
+{
+    QElapsedTimer clock;
+    clock.start();
+
+    const Model model(problem);
+    State start(model);
+    greedy(start);
+
+    TimetableResult result;
+    result.greedyMs = clock.elapsed();
+    result.threads = m_config.threadCount > 0 ? m_config.threadCount : QThread::idealThreadCount();
+
+    // Independent workers from the same start point, different random streams
+    std::vector<WorkerResult> workers(result.threads);
+    std::atomic<bool> solved(false);
+    QThreadPool pool;
+    pool.setMaxThreadCount(result.threads);
+    for (int i = 0; i < result.threads; ++i) {
+        WorkerResult* out = &workers[i];
+        const quint32 seed = m_config.seed + quint32(i) * 7919u;
+        pool.start([&start, &clock, &solved, out, seed, this]() {
+            localSearch(start, clock, m_config.timeBudgetMs, seed, solved, *out);
+        });
+    }
+    pool.waitForDone();
+
+    const WorkerResult* best = &workers.front();
+    for (const auto& w : workers) {
+        result.moves += w.moves;
+        if (w.cost < best->cost) {
+            best = &w;
+        }
+    }
+
+    result.assignments.resize(problem.sections.size());
+    for (int s = 0; s < model.S; ++s) {
+        TimetableAssignment& a = result.assignments[s];
+        a.sectionId = problem.sections[s].id;
+        if (best->slotOf[s] >= 0) {
+            a.roomId = problem.rooms[best->roomOf[s]].id;
+            a.slotId = problem.slots[best->slotOf[s]].id;
+        }
+    }
+    evaluate(problem, result);
+    result.elapsedMs = clock.elapsed();
+    return result;
+}
+
+void TimetableSolver::evaluate(const TimetableProblem& problem, TimetableResult& result)
+{
+    QHash<int, int> roomIndex;
+    for (int r = 0; r < int(problem.rooms.size()); ++r) {
+        roomIndex.insert(problem.rooms[r].id, r);
+    }
+    QHash<int, int> slotIndex;
+    for (int t = 0; t < int(problem.slots.size()); ++t) {
+        slotIndex.insert(problem.slots[t].id, t);
+    }
+
+    const int count = int(qMin(problem.sections.size(), result.assignments.size()));
+    std::vector<int> slotOf(count, -1);
+    QHash<int, std::vector<int>> byRoom;
+    result.unassigned = 0;
+    result.capacityViolations = 0;
+    for (int s = 0; s < count; ++s) {
+        const TimetableAssignment& a = result.assignments[s];
+        if (a.roomId == 0 || !roomIndex.contains(a.roomId) || !slotIndex.contains(a.slotId)) {
+            ++result.unassigned;
+            continue;
+        }
+        slotOf[s] = slotIndex.value(a.slotId);
+        const TimetableRoom& room = problem.rooms[roomIndex.value(a.roomId)];
+        const TimetableSection& section = problem.sections[s];
+        if (room.capacity < section.demand) {
+            ++result.capacityViolations;
+        }
+        byRoom[a.roomId].push_back(s);
+    }
+
+    result.roomConflicts = 0;
+    for (auto it = byRoom.constBegin(); it != byRoom.constEnd(); ++it) {
+        const std::vector<int>& list = it.value();
+        for (size_t i = 0; i < list.size(); ++i) {
+            for (size_t j = i + 1; j < list.size(); ++j) {
+                if (problem.slots[slotOf[list[i]]].overlaps(problem.slots[slotOf[list[j]]])) {
+                    ++result.roomConflicts;
+                }
+            }
+        }
+    }
+
+    result.studentConflicts = 0;
+    for (int s = 0; s < count && s < int(problem.conflicts.size()); ++s) {
+        if (slotOf[s] < 0) {
+            continue;
+        }
+        for (const auto& e : problem.conflicts[s]) {
+            if (e.other > s && e.other < count && slotOf[e.other] >= 0
+                && problem.slots[slotOf[s]].overlaps(problem.slots[slotOf[e.other]])) {
+                result.studentConflicts += e.students;
+            }
+        }
+    }
+}
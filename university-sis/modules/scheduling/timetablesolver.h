@@ -0,0 +1,37 @@
+#ifndef TIMETABLESOLVER_H
+#define TIMETABLESOLVER_H
+
+#include "timetable.h"
+
+/**
+ * @brief Assigns every section a room and a weekly time slot.
+ *
+ * Hard constraints: a room holds one section at a time and must fit the
+ * section's demand. Student conflicts
+ * (sections sharing students in overlapping slots) are minimised.
+ *
+ * A best-fit greedy pass builds the start solution; independent local search
+ * workers (move / eject-and-reinsert with annealing) then improve copies of it
+ * in parallel until the time budget runs out or no conflicts remain.
+ */
+class TimetableSolver {
+public:
+    struct Config {
+        int timeBudgetMs = 30000; // Wall clock for the whole solve
+        int threadCount = 0;      // 0 = QThread::idealThreadCount()
+        quint32 seed = 1;
+    };
+
+    TimetableSolver();
+    explicit TimetableSolver(const Config& config);
+
+    TimetableResult solve(const TimetableProblem& problem) const;
+
+    // Recounts unassigned sections and constraint violations of result.assignments
+    static void evaluate(const TimetableProblem& problem, TimetableResult& result);
+
+private:
+    Config m_config;
+};
+
+#endif // TIMETABLESOLVER_H
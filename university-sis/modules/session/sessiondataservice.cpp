@@ -0,0 +1,195 @@
+#include "sessiondataservice.h"
+#include "../attendance/attendance.h"
+#include "../finance/payment.h"
+#include "../../database/scopedconnection.h"
+#include "../../database/queryprofiler.h"
+#include "../../utils/stringpool.h"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThreadPool>
+#include <QVariant>
+#include <QDebug>
+
+SessionDataService& SessionDataService::instance()
+{
+    static SessionDataService service;
+    return service;
+}
+
+SessionDataService::SessionDataService() {}
+
+void SessionDataService::start(const QString& role, int userId)
+{
+    clear();
+    if (role != "Student" || userId <= 0) {
+        return;
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_studentId = userId;
+    }
+    refresh();
+}
+
+void SessionDataService::refresh()
+{
+    int studentId = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        studentId = m_studentId;
+        m_pending = studentId > 0;
+    }
+    if (studentId <= 0) {
+        return;
+    }
+
+    const quint64 generation = ++m_generation;
+    QThreadPool::globalInstance()->start([studentId, generation]() {
+        std::shared_ptr<const SessionSnapshot> snapshot;
+        {
+            ScopedConnection connection; // Worker threads cannot share the GUI thread's connection
+            if (connection.isOpen()) {
+                if (auto data = load(studentId, connection.database())) {
+                    snapshot = std::make_shared<const SessionSnapshot>(std::move(*data));
+                }
+            }
+        }
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [generation, snapshot]() {
+            SessionDataService::instance().onLoaded(generation, snapshot);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SessionDataService::onLoaded(quint64 generation, std::shared_ptr<const SessionSnapshot> snapshot)
+{
+    if (generation != m_generation) {
+        return; // Logged out or refreshed again meanwhile
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending = false;
+        m_snapshot = snapshot;
+    }
+    if (!snapshot) {
+        qDebug() << "Session prefetch failed; modules will query directly";
+    }
+    emit loaded(snapshot != nullptr);
+}
+
+void SessionDataService::clear()
+{
+    ++m_generation;
+    QMutexLocker locker(&m_mutex);
+    m_studentId = 0;
+    m_pending = false;
+    m_snapshot.reset();
+}
+
+bool SessionDataService::isStudentSession() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_studentId > 0;
+}
+
+bool SessionDataService::isPending() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending;
+}
+
+std::shared_ptr<const SessionSnapshot> SessionDataService::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_snapshot;
+}
+
+std::optional<SessionSnapshot> SessionDataService::load(int studentId, const QSqlDatabase& db)
+{
+    SessionSnapshot s;
+    s.studentId = studentId;
+
+    // One read transaction so all five reads see the same state
+    QSqlDatabase conn = db;
+    DatabaseManager::beginTransaction(conn);
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+
+    auto run = [&](const QString& sql) {
+        query.prepare(sql);
+        query.bindValue(":id", studentId);
+        if (!query.exec()) {
+            qDebug() << "Session Prefetch Error:" << query.lastError().text();
+            return false;
+        }
+        return true;
+    };
+
+    bool ok = run("SELECT student_id, name, year, department, section_id, username FROM students WHERE student_id = :id");
+    if (ok && query.next()) {
+        Student p;
+        p.id = query.value(0).toInt();
+        p.name = query.value(1).toString();
+        p.year = query.value(2).toInt();
+        p.department = StringPool::instance().shared(query.value(3).toString());
+        p.sectionId = query.value(4).toInt();
+        p.username = query.value(5).toString();
+        s.profile = p;
+    }
+
+    ok = ok && run("SELECT ss.section_id, sec.course_id, c.name FROM student_section ss "
+                   "LEFT JOIN sections sec ON sec.section_id = ss.section_id "
+                   "LEFT JOIN courses c ON c.course_id = sec.course_id "
+                   "WHERE ss.student_id = :id ORDER BY c.name, ss.section_id");
+    while (ok && query.next()) {
+        SessionEnrollment e;
+        e.sectionId = query.value(0).toInt();
+        e.courseId = query.value(1).toInt();
+        e.courseName = query.value(2).toString();
+        s.enrollments.push_back(e);
+    }
+
+    ok = ok && run("SELECT g.course_id, c.name, g.a1, g.a2, g.final_exam, g.total FROM grades g "
+                   "LEFT JOIN courses c ON c.course_id = g.course_id "
+                   "WHERE g.student_id = :id ORDER BY c.name");
+    while (ok && query.next()) {
+        SessionGrade g;
+        g.courseId = query.value(0).toInt();
+        g.courseName = query.value(1).toString();
+        g.a1 = query.value(2).toString();
+        g.a2 = query.value(3).toString();
+        g.finalExam = query.value(4).toString();
+        g.total = query.value(5).toString();
+        s.grades.push_back(g);
+    }
+
+    ok = ok && run("SELECT status_id, COUNT(*) FROM attendance WHERE student_id = :id GROUP BY status_id");
+    while (ok && query.next()) {
+        const int count = query.value(1).toInt();
+        switch (static_cast<AttendanceStatus>(query.value(0).toInt())) {
+        case AttendanceStatus::Present: s.attendance.present = count; break;
+        case AttendanceStatus::Absent: s.attendance.absent = count; break;
+        case AttendanceStatus::Late: s.attendance.late = count; break;
+        case AttendanceStatus::Excused: s.attendance.excused = count; break;
+        }
+    }
+
+    ok = ok && run("SELECT status_id, COALESCE(SUM(amount), 0) FROM payments WHERE student_id = :id GROUP BY status_id");
+    while (ok && query.next()) {
+        const double amount = query.value(1).toDouble();
+        if (Payment::statusFromId(query.value(0).toInt()) == PaymentStatus::Paid) {
+            s.totalPaid += amount;
+        } else {
+            s.balanceDue += amount;
+        }
+    }
+
+    query.finish();
+    DatabaseManager::commitTransaction(conn);
+    if (!ok) {
+        return std::nullopt;
+    }
+    return s;
+}
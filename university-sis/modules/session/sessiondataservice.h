@@ -0,0 +1,94 @@
+#ifndef SESSIONDATASERVICE_H
+#define SESSIONDATASERVICE_H
+
+#include "../student/student.h"
+#include <QObject>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class QSqlDatabase;
+
+struct SessionEnrollment {
+    int sectionId = 0;
+    int courseId = 0;
+    QString courseName;
+};
+
+struct SessionGrade {
+    int courseId = 0;
+    QString courseName;
+    QString a1;
+    QString a2;
+    QString finalExam;
+    QString total;
+};
+
+struct SessionAttendanceSummary {
+    int present = 0;
+    int absent = 0;
+    int late = 0;
+    int excused = 0;
+
+    int total() const { return present + absent + late + excused; }
+    // Late counts as attended, matching the attendance reports
+    double rate() const { return total() > 0 ? 100.0 * (present + late) / total() : 0.0; }
+};
+
+// Everything prefetched for the signed-in student
+struct SessionSnapshot {
+    int studentId = 0;
+    std::optional<Student> profile;
+    std::vector<SessionEnrollment> enrollments;  // Ordered by course name
+    std::vector<SessionGrade> grades;            // Ordered by course name
+    SessionAttendanceSummary attendance;
+    double balanceDue = 0.0;  // Pending + overdue payments
+    double totalPaid = 0.0;
+};
+
+/**
+ * @brief Per-session cache of the logged-in student's own rows.
+ *
+ * start() runs one background job right after login that reads the profile,
+ * enrollments, grades, attendance summary and balance over a single worker
+ * connection. Modules read snapshot() instead of querying (and filtering)
+ * whole tables. Until loaded() fires snapshot() is null; if the load failed
+ * it stays null and modules fall back to their own queries.
+ */
+class SessionDataService : public QObject {
+    Q_OBJECT
+public:
+    static SessionDataService& instance();
+
+    // Starts the prefetch for a Student session; other roles just clear the previous session
+    void start(const QString& role, int userId);
+    void refresh();
+    void clear();
+
+    bool isStudentSession() const;
+    bool isPending() const;
+    std::shared_ptr<const SessionSnapshot> snapshot() const;
+
+    static std::optional<SessionSnapshot> load(int studentId, const QSqlDatabase& db);
+
+signals:
+    void loaded(bool ok);
+
+private:
+    SessionDataService();
+    SessionDataService(const SessionDataService&) = delete;
+    SessionDataService& operator=(const SessionDataService&) = delete;
+
+    void onLoaded(quint64 generation, std::shared_ptr<const SessionSnapshot> snapshot);
+
+    mutable QMutex m_mutex;
+    int m_studentId = 0;
+    bool m_pending = false;
+    std::shared_ptr<const SessionSnapshot> m_snapshot;
+    std::atomic<quint64> m_generation{0};  // Bumped per session so late results are dropped
+};
+
+#endif // SESSIONDATASERVICE_H
@@ -2,6 +2,7 @@
 #define STUDENT_H
 
 #include <QString>
+#include "../../utils/stringpool.h"
 
 /**
  * @brief The Student struct represents a student entity in the system.
@@ -20,4 +21,18 @@ struct Student {
     }
 };
 
+/**
+ * @brief Compact read-only variant used for bulk listings: the department is an
+ * interned id and credentials are not loaded.
+ */
+struct CompactStudent {
+    int id = -1;
+    int sectionId = 0;
+    quint8 year = 1;
+    StringPool::Id department = 0;
+    QString name;
+
+    QString departmentName() const { return StringPool::instance().string(department); }
+};
+
 #endif // STUDENT_H
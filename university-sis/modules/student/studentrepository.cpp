@@ -1,4 +1,10 @@
 #include "studentrepository.h"
+#include "../../utils/tracer.h"
+#include "../auth/userrepository.h"
+#include "../enrollment/enrollmentvalidator.h"
+#include "../enrollment/waitlistmanager.h"
+#include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
@@ -9,60 +15,110 @@ StudentRepository::StudentRepository() {
 
 bool StudentRepository::addStudent(const Student& student)
 {
-    QSqlQuery query;
-    query.prepare("INSERT INTO students (name, year, department, section_id, username, password) "
-                  "VALUES (:name, :year, :dept, :section, :username, :password)");
+    SIS_TRACE_SCOPE("db", "StudentRepository::addStudent");
+    // Credentials live in users; the profile and its account are written together
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    const bool withAccount = !student.username.isEmpty() && !student.password.isEmpty();
+    if (withAccount) {
+        DatabaseManager::beginTransaction(db);
+    }
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("INSERT INTO students (name, year, department, section_id, username) "
+                  "VALUES (:name, :year, :dept, :section, :username)");
     
     query.bindValue(":name", student.name);
     query.bindValue(":year", student.year);
     query.bindValue(":dept", student.department);
     query.bindValue(":section", student.sectionId);
-    query.bindValue(":username", student.username);
-    query.bindValue(":password", student.password);
+    query.bindValue(":username", student.username.isEmpty() ? QVariant() : QVariant(student.username));
 
     if (!query.exec()) {
         qDebug() << "StudentRepository::addStudent error:" << query.lastError().text();
+        if (withAccount) {
+            DatabaseManager::rollbackTransaction(db);
+        }
         return false;
     }
-    return true;
+    if (!withAccount) {
+        return true;
+    }
+
+    User account;
+    account.username = student.username;
+    account.role = "STUDENT";
+    account.displayName = student.name;
+    account.studentId = query.lastInsertId().toInt();
+    if (!UserRepository().addAccount(account, student.password, db)) {
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    return DatabaseManager::commitTransaction(db);
 }
 
 bool StudentRepository::updateStudent(const Student& student)
 {
-    QSqlQuery query;
-    query.prepare("UPDATE students SET name = :name, year = :year, "
-                  "department = :dept, section_id = :section WHERE student_id = :id");
+    SIS_TRACE_SCOPE("db", "StudentRepository::updateStudent");
+    // The profile and its account are written together so a rename reaches the login
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    DatabaseManager::beginTransaction(db);
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
+    query.prepare("UPDATE students SET name = :name, year = :year, department = :dept, "
+                  "section_id = :section, username = COALESCE(:username, username) WHERE student_id = :id");
     
     query.bindValue(":name", student.name);
     query.bindValue(":year", student.year);
     query.bindValue(":dept", student.department);
     query.bindValue(":section", student.sectionId);
+    query.bindValue(":username", student.username.isEmpty() ? QVariant() : QVariant(student.username));
     query.bindValue(":id", student.id);
 
     if (!query.exec()) {
         qDebug() << "StudentRepository::updateStudent error:" << query.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
         return false;
     }
-    return true;
+    if (!UserRepository().saveStudentAccount(student.id, student.username, student.name, student.password, db)) {
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    return DatabaseManager::commitTransaction(db);
 }
 
 bool StudentRepository::deleteStudent(int id)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "StudentRepository::deleteStudent");
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    DatabaseManager::beginTransaction(db);
+
+    ProfiledQuery query(db, SIS_QUERY_SITE);
     // Note: Depends on cascade delete settings or if other tables reference this student
     query.prepare("DELETE FROM students WHERE student_id = :id");
     query.bindValue(":id", id);
     
     if (!query.exec()) {
         qDebug() << "StudentRepository::deleteStudent error:" << query.lastError().text();
+        DatabaseManager::rollbackTransaction(db);
+        return false;
+    }
+    if (!UserRepository().deleteStudentAccount(id, db)) {
+        DatabaseManager::rollbackTransaction(db);
         return false;
     }
+    if (!DatabaseManager::commitTransaction(db)) {
+        return false;
+    }
+    // Waitlist rows went with the student; the in-memory queues and seat counts still hold them
+    WaitlistManager::instance().invalidate();
+    EnrollmentValidator::instance().invalidate();
     return true;
 }
 
 std::optional<Student> StudentRepository::getStudentById(int id)
 {
-    QSqlQuery query;
+    SIS_TRACE_SCOPE("db", "StudentRepository::getStudentById");
+    ProfiledQuery query(SIS_QUERY_SITE);
     query.prepare("SELECT student_id, name, year, department, section_id FROM students WHERE student_id = :id");
     query.bindValue(":id", id);
     
@@ -71,7 +127,7 @@ std::optional<Student> StudentRepository::getStudentById(int id)
         s.id = query.value(0).toInt();
         s.name = query.value(1).toString();
         s.year = query.value(2).toInt();
-        s.department = query.value(3).toString();
+        s.department = StringPool::instance().shared(query.value(3).toString());
         s.sectionId = query.value(4).toInt();
         return s;
     }
@@ -80,41 +136,45 @@ std::optional<Student> StudentRepository::getStudentById(int id)
 
 std::vector<Student> StudentRepository::getAllStudents()
 {
+    SIS_TRACE_SCOPE("db", "StudentRepository::getAllStudents");
     std::vector<Student> students;
-    QSqlQuery query("SELECT student_id, name, year, department, section_id, username, password FROM students");
+    ProfiledQuery query("SELECT student_id, name, year, department, section_id, username FROM students", SIS_QUERY_SITE);
     
     while (query.next()) {
         Student s;
         s.id = query.value(0).toInt();
         s.name = query.value(1).toString();
         s.year = query.value(2).toInt();
-        s.department = query.value(3).toString();
+        s.department = StringPool::instance().shared(query.value(3).toString());
         s.sectionId = query.value(4).toInt();
         s.username = query.value(5).toString();
-        s.password = query.value(6).toString();
         students.push_back(s);
     }
     return students;
 }
 
-std::optional<Student> StudentRepository::authenticate(const QString& username, const QString& password)
+std::vector<CompactStudent> StudentRepository::getAllStudentsCompact()
 {
-    QSqlQuery query;
-    query.prepare("SELECT student_id, name, year, department, section_id FROM students WHERE username = :user AND password = :pass");
-    query.bindValue(":user", username);
-    query.bindValue(":pass", password);
-    
-    if (query.exec() && query.next()) {
-        Student s;
+    SIS_TRACE_SCOPE("db", "StudentRepository::getAllStudentsCompact");
+    std::vector<CompactStudent> students;
+    ProfiledQuery query(SIS_QUERY_SITE);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT student_id, name, year, department, section_id FROM students")) {
+        qDebug() << "StudentRepository::getAllStudentsCompact error:" << query.lastError().text();
+        return students;
+    }
+
+    StringPool& pool = StringPool::instance();
+    while (query.next()) {
+        CompactStudent s;
         s.id = query.value(0).toInt();
         s.name = query.value(1).toString();
-        s.year = query.value(2).toInt();
-        s.department = query.value(3).toString();
+        s.year = quint8(query.value(2).toInt());
+        s.department = pool.intern(query.value(3).toString());
         s.sectionId = query.value(4).toInt();
-        s.username = username; 
-        return s;
+        students.push_back(s);
     }
-    return std::nullopt;
+    return students;
 }
 
 // Removed emailExists since email is no longer in schema
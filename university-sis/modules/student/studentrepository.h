@@ -18,7 +18,7 @@ public:
     bool deleteStudent(int id);
     std::optional<Student> getStudentById(int id);
     std::vector<Student> getAllStudents();
-    std::optional<Student> authenticate(const QString& username, const QString& password);
+    std::vector<CompactStudent> getAllStudentsCompact();
     bool emailExists(const QString& email, int excludeId = -1);
 };
 
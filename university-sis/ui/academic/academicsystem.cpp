@@ -1,9 +1,15 @@
 #include "academicsystem.h"
+#include "../../utils/tracer.h"
 #include "coursedialog.h"
 #include "sectiondialog.h"
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QStandardItem>
+#include <QThreadPool>
+#include <QPointer>
+#include <QCoreApplication>
+#include <memory>
+#include "../../modules/scheduling/timetablesolver.h"
 
 AcademicSystem::AcademicSystem(QWidget *parent) : QWidget(parent)
 {
@@ -70,18 +76,24 @@ void AcademicSystem::setupUi()
     btnAddSection->setCursor(Qt::PointingHandCursor);
     btnAddSection->setProperty("type", "success");
     sectionToolbar->addWidget(btnAddSection);
+    m_btnTimetable = new QPushButton("Generate Timetable");
+    m_btnTimetable->setCursor(Qt::PointingHandCursor);
+    m_btnTimetable->setProperty("type", "primary");
+    m_btnTimetable->setToolTip("Assign every section a room and weekly time slot, keeping student clashes to a minimum");
+    sectionToolbar->addWidget(m_btnTimetable);
     sectionToolbar->addStretch();
     sectionLayout->addLayout(sectionToolbar);
     
     m_sectionView = new QTableView();
     m_sectionModel = new QStandardItemModel(this);
-    m_sectionModel->setColumnCount(4);
-    m_sectionModel->setHorizontalHeaderLabels({"Section ID", "Course ID", "Capacity", "Actions"});
+    m_sectionModel->setColumnCount(5);
+    m_sectionModel->setHorizontalHeaderLabels({"Section ID", "Course ID", "Capacity", "Schedule", "Actions"});
     m_sectionView->setModel(m_sectionModel);
     styleTable(m_sectionView);
     sectionLayout->addWidget(m_sectionView);
     
     connect(btnAddSection, &QPushButton::clicked, this, &AcademicSystem::onAddSection);
+    connect(m_btnTimetable, &QPushButton::clicked, this, &AcademicSystem::onGenerateTimetable);
     
     m_tabs->addTab(courseTab, "Courses Catalog");
     m_tabs->addTab(sectionTab, "Class Sections");
@@ -106,6 +118,7 @@ void AcademicSystem::styleTable(QTableView* view)
 
 void AcademicSystem::loadCourses()
 {
+    SIS_TRACE_SCOPE("ui", "AcademicSystem::loadCourses");
     m_courseModel->removeRows(0, m_courseModel->rowCount());
     auto courses = m_courseRepo.getAllCourses();
     
@@ -147,14 +160,17 @@ void AcademicSystem::loadCourses()
 
 void AcademicSystem::loadSections()
 {
+    SIS_TRACE_SCOPE("ui", "AcademicSystem::loadSections");
     m_sectionModel->removeRows(0, m_sectionModel->rowCount());
     auto sections = m_sectionRepo.getAllSections();
+    const auto schedule = m_timetableRepo.getScheduleLabels();
     
     for (const auto &s : sections) {
         QList<QStandardItem*> row;
         row << new QStandardItem(QString::number(s.id));
         row << new QStandardItem(QString::number(s.courseId));
         row << new QStandardItem(QString::number(s.maxStudents));
+        row << new QStandardItem(schedule.value(s.id, "Not scheduled"));
         row << new QStandardItem(""); // Actions
         
         m_sectionModel->appendRow(row);
@@ -172,7 +188,7 @@ void AcademicSystem::loadSections()
         int sectionId = s.id;
         connect(deleteBtn, &QPushButton::clicked, this, [this, sectionId]() { deleteSection(sectionId); });
         
-        m_sectionView->setIndexWidget(m_sectionModel->index(m_sectionModel->rowCount() - 1, 3), actionWidget);
+        m_sectionView->setIndexWidget(m_sectionModel->index(m_sectionModel->rowCount() - 1, 4), actionWidget);
     }
 }
 
@@ -208,6 +224,67 @@ void AcademicSystem::onAddSection()
     }
 }
 
+void AcademicSystem::onGenerateTimetable()
+{
+    auto problem = std::make_shared<TimetableProblem>(m_timetableRepo.loadProblem());
+    if (problem->sections.empty() || problem->rooms.empty()) {
+        QMessageBox::warning(this, "Timetable", "At least one section and one room are needed to build a timetable.");
+        return;
+    }
+    
+    m_btnTimetable->setEnabled(false);
+    m_btnTimetable->setText("Generating...");
+    
+    // The solver is pure C++; only loading and saving touch the database on this thread
+    QPointer<AcademicSystem> self(this);
+    QThreadPool::globalInstance()->start([self, problem]() {
+        TimetableSolver::Config config;
+        config.timeBudgetMs = 20000;
+        const TimetableResult result = TimetableSolver(config).solve(*problem);
+        QMetaObject::invokeMethod(qApp, [self, problem, result]() {
+            if (self) {
+                self->onTimetableSolved(*problem, result);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AcademicSystem::onTimetableSolved(const TimetableProblem &problem, const TimetableResult &result)
+{
+    m_btnTimetable->setEnabled(true);
+    m_btnTimetable->setText("Generate Timetable");
+    
+    QString summary = QString("Scheduled %1 of %2 sections in %3 ms (%4 threads).\n\n"
+                              "Unassigned sections: %5\nStudent conflicts: %6")
+                          .arg(int(problem.sections.size()) - result.unassigned)
+                          .arg(int(problem.sections.size()))
+                          .arg(result.elapsedMs)
+                          .arg(result.threads)
+                          .arg(result.unassigned)
+                          .arg(result.studentConflicts);
+    
+    // Saving replaces the whole schedule, so an incomplete result needs an explicit OK
+    if (!result.isFeasible()
+        && QMessageBox::Yes != QMessageBox::question(this, "Timetable Incomplete",
+                                                     summary + "\n\nSaving replaces the current timetable, leaving unassigned "
+                                                               "sections unscheduled. Save it anyway?",
+                                                     QMessageBox::Yes | QMessageBox::No, QMessageBox::No)) {
+        return;
+    }
+    
+    if (!m_timetableRepo.saveSchedule(problem, result)) {
+        QMessageBox::critical(this, "Error", "Failed to save the timetable.");
+        return;
+    }
+    loadSections();
+    
+    if (result.isFeasible()) {
+        QMessageBox::information(this, "Timetable Generated", summary);
+    } else {
+        QMessageBox::warning(this, "Timetable Generated", summary + "\n\nAdd rooms or review large sections to resolve the rest.");
+    }
+}
+
 void AcademicSystem::editCourse(int id)
 {
     auto c = m_courseRepo.getCourseById(id);
@@ -12,6 +12,7 @@
 #include <QTabWidget>
 #include "../../modules/academic/courserepository.h"
 #include "../../modules/academic/sectionrepository.h"
+#include "../../modules/scheduling/timetablerepository.h"
 
 class AcademicSystem : public QWidget
 {
@@ -28,6 +29,7 @@ private slots:
     void editCourse(int id);
     void deleteCourse(int id);
     void deleteSection(int id); // New Slot
+    void onGenerateTimetable();
 
 private:
     void setupUi();
@@ -35,6 +37,7 @@ private:
     void loadSections(); // New Logic
     void styleTable(QTableView* view); // Helper
     void refreshData();
+    void onTimetableSolved(const TimetableProblem &problem, const TimetableResult &result);
 
     QTabWidget *m_tabs;
     QTableView *m_courseView;
@@ -44,9 +47,11 @@ private:
     QStandardItemModel *m_sectionModel;
     
     QLineEdit *m_searchBar;
+    QPushButton *m_btnTimetable;
     
     CourseRepository m_courseRepo;
     SectionRepository m_sectionRepo;
+    TimetableRepository m_timetableRepo;
 };
 
 #endif // ACADEMICSYSTEM_H
@@ -1,4 +1,5 @@
 #include "attendancedialog.h"
+#include "../../utils/tracer.h"
 #include "../../modules/academic/section.h"
 #include "../../modules/academic/course.h"
 #include "../../modules/student/student.h"
@@ -107,6 +108,7 @@ void AttendanceDialog::setupUi()
 
 void AttendanceDialog::loadSections()
 {
+    SIS_TRACE_SCOPE("ui", "AttendanceDialog::loadSections");
     m_sectionEdit->clear();
     auto sections = m_sectionRepo.getAllSections();
     auto courses = m_courseRepo.getAllCourses();
@@ -166,6 +168,7 @@ void AttendanceDialog::onLoadStudents()
 
 void AttendanceDialog::loadStudentsForSection(int sectionId)
 {
+    SIS_TRACE_SCOPE("ui", "AttendanceDialog::loadStudentsForSection");
     m_studentsModel->removeRows(0, m_studentsModel->rowCount());
     
     // Get all student IDs enrolled in this section
@@ -194,15 +197,18 @@ void AttendanceDialog::loadStudentsForSection(int sectionId)
         
         // Create combo box for status
         QStandardItem *statusItem = new QStandardItem("Present");
-        statusItem->setData("Present", Qt::UserRole); // Store status value
+        statusItem->setData(int(AttendanceStatus::Present), Qt::UserRole); // Store status id
         row << statusItem;
         
         m_studentsModel->appendRow(row);
         
         // Create combo box widget for status selection
         QComboBox *statusCombo = new QComboBox();
-        statusCombo->addItems({"Present", "Absent", "Late", "Excused"});
-        statusCombo->setCurrentText("Present");
+        for (AttendanceStatus status : {AttendanceStatus::Present, AttendanceStatus::Absent,
+                                        AttendanceStatus::Late, AttendanceStatus::Excused}) {
+            statusCombo->addItem(Attendance::statusToString(status), int(status));
+        }
+        statusCombo->setCurrentIndex(0);
         statusCombo->setStyleSheet("QComboBox { padding: 5px; border: 1px solid #bdc3c7; border-radius: 3px; }");
         
         // Store student ID in combo box property for retrieval
@@ -251,7 +257,7 @@ std::vector<Attendance> AttendanceDialog::getAttendanceRecords() const
             att.sectionId = m_currentSectionId;
             att.courseId = m_currentCourseId;
             att.date = selectedDate;
-            att.status = statusCombo->currentText();
+            att.status = Attendance::statusFromId(statusCombo->currentData().toInt());
             
             records.push_back(att);
         }
@@ -1,6 +1,10 @@
 #include "attendancesystem.h"
+#include "../../utils/tracer.h"
 #include "attendancedialog.h"
 #include "../../modules/academic/courserepository.h"
+#include "../../database/scopedconnection.h"
+#include <QDialog>
+#include <QDialogButtonBox>
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QStandardItem>
@@ -8,6 +12,9 @@
 #include <QColor>
 #include <QFormLayout>
 #include <QGroupBox>
+#include <QApplication>
+#include <QThreadPool>
+#include <QPointer>
 
 AttendanceSystem::AttendanceSystem(QWidget *parent) : QWidget(parent)
 {
@@ -36,6 +43,10 @@ void AttendanceSystem::setupUi()
     m_btnAdd->setCursor(Qt::PointingHandCursor);
     m_btnAdd->setStyleSheet("QPushButton { background-color: #34495e; color: white; padding: 8px 16px; border: none; border-radius: 4px; font-size: 14px; font-weight: 600; } QPushButton:hover { opacity: 0.9; }");
     toolbarLayout->addWidget(m_btnAdd);
+    m_btnAnalytics = new QPushButton("At-Risk Analysis");
+    m_btnAnalytics->setCursor(Qt::PointingHandCursor);
+    m_btnAnalytics->setStyleSheet("QPushButton { background-color: #c0392b; color: white; padding: 8px 16px; border: none; border-radius: 4px; font-size: 14px; font-weight: 600; } QPushButton:hover { opacity: 0.9; }");
+    toolbarLayout->addWidget(m_btnAnalytics);
     toolbarLayout->addStretch();
     mainLayout->addLayout(toolbarLayout);
 
@@ -61,10 +72,11 @@ void AttendanceSystem::setupUi()
     // Status Filter
     filterLayout->addWidget(new QLabel("Status:"));
     m_filterStatus = new QComboBox();
-    m_filterStatus->addItem("All Statuses", "");
-    m_filterStatus->addItem("Present", "Present");
-    m_filterStatus->addItem("Absent", "Absent");
-    m_filterStatus->addItem("Late", "Late");
+    m_filterStatus->addItem("All Statuses", -1);
+    for (AttendanceStatus s : {AttendanceStatus::Present, AttendanceStatus::Absent,
+                               AttendanceStatus::Late, AttendanceStatus::Excused}) {
+        m_filterStatus->addItem(Attendance::statusToString(s), int(s));
+    }
     m_filterStatus->setFixedWidth(120);
     filterLayout->addWidget(m_filterStatus);
     
@@ -111,6 +123,7 @@ void AttendanceSystem::setupUi()
     mainLayout->addWidget(m_view);
 
     connect(m_btnAdd, &QPushButton::clicked, this, &AttendanceSystem::onAddAttendance);
+    connect(m_btnAnalytics, &QPushButton::clicked, this, &AttendanceSystem::onRunAnalytics);
     connect(btnFilter, &QPushButton::clicked, this, &AttendanceSystem::applyFilters);
     connect(m_btnClearFilters, &QPushButton::clicked, this, &AttendanceSystem::applyFilters);
     connect(m_filterStudentName, &QLineEdit::returnPressed, this, &AttendanceSystem::applyFilters);
@@ -133,6 +146,7 @@ void AttendanceSystem::styleTable()
 
 void AttendanceSystem::loadCourses()
 {
+    SIS_TRACE_SCOPE("ui", "AttendanceSystem::loadCourses");
     CourseRepository courseRepo;
     auto courses = courseRepo.getAllCourses();
     
@@ -143,6 +157,7 @@ void AttendanceSystem::loadCourses()
 
 void AttendanceSystem::loadAttendance()
 {
+    SIS_TRACE_SCOPE("ui", "AttendanceSystem::loadAttendance");
     m_model->removeRows(0, m_model->rowCount());
     auto list = m_repo.getAttendanceWithNames();
     
@@ -153,9 +168,9 @@ void AttendanceSystem::loadAttendance()
         row << new QStandardItem(QString::number(a.studentId));
         row << new QStandardItem(a.courseName.isEmpty() ? "N/A" : a.courseName);
         
-        auto statusItem = new QStandardItem(a.status);
-        if (a.status == "Present") statusItem->setForeground(QBrush(QColor("#27ae60")));
-        else if (a.status == "Absent") statusItem->setForeground(QBrush(QColor("#c0392b")));
+        auto statusItem = new QStandardItem(Attendance::statusToString(a.status));
+        if (a.status == AttendanceStatus::Present) statusItem->setForeground(QBrush(QColor("#27ae60")));
+        else if (a.status == AttendanceStatus::Absent) statusItem->setForeground(QBrush(QColor("#c0392b")));
         else statusItem->setForeground(QBrush(QColor("#f39c12")));
         
         row << statusItem;
@@ -184,7 +199,7 @@ void AttendanceSystem::applyFilters()
     // Get filter values
     QString studentName = m_filterStudentName->text().trimmed();
     int courseId = m_filterCourse->currentData().toInt();
-    QString status = m_filterStatus->currentData().toString();
+    int status = m_filterStatus->currentData().toInt();
     QDate dateFrom = m_filterDateFrom->date();
     QDate dateTo = m_filterDateTo->date();
     
@@ -194,7 +209,7 @@ void AttendanceSystem::applyFilters()
     QDate dateToFilter = datesAreDefault ? QDate() : dateTo;
     
     // If all filters are empty/default, just load all attendance
-    if (studentName.isEmpty() && courseId == -1 && status.isEmpty() && datesAreDefault) {
+    if (studentName.isEmpty() && courseId == -1 && status == -1 && datesAreDefault) {
         loadAttendance();
         return;
     }
@@ -216,9 +231,9 @@ void AttendanceSystem::applyFilters()
         row << new QStandardItem(QString::number(a.studentId));
         row << new QStandardItem(a.courseName.isEmpty() ? "N/A" : a.courseName);
         
-        auto statusItem = new QStandardItem(a.status);
-        if (a.status == "Present") statusItem->setForeground(QBrush(QColor("#27ae60")));
-        else if (a.status == "Absent") statusItem->setForeground(QBrush(QColor("#c0392b")));
+        auto statusItem = new QStandardItem(Attendance::statusToString(a.status));
+        if (a.status == AttendanceStatus::Present) statusItem->setForeground(QBrush(QColor("#27ae60")));
+        else if (a.status == AttendanceStatus::Absent) statusItem->setForeground(QBrush(QColor("#c0392b")));
         else statusItem->setForeground(QBrush(QColor("#f39c12")));
         
         row << statusItem;
@@ -257,3 +272,83 @@ void AttendanceSystem::refreshData()
 {
     loadAttendance();
 }
+
+void AttendanceSystem::onRunAnalytics()
+{
+    m_btnAnalytics->setEnabled(false);
+    m_btnAnalytics->setText("Analyzing...");
+
+    // Loading the aggregates scans the attendance table; keep it off the GUI thread
+    QPointer<AttendanceSystem> self(this);
+    const QDate today = QDate::currentDate();
+    QThreadPool::globalInstance()->start([self, today]() {
+        AttendanceAnalytics::RunSummary summary;
+        std::vector<AttendanceAlert> alerts;
+        {
+            ScopedConnection connection; // Worker threads cannot share the GUI thread's connection
+            if (connection.isOpen()) {
+                summary = AttendanceAnalytics().run(today, connection.database());
+                if (summary.saved) {
+                    alerts = AttendanceRepository().getAlerts(today, connection.database());
+                }
+            }
+        }
+        QMetaObject::invokeMethod(qApp, [self, summary, alerts]() {
+            if (self) {
+                self->onAnalyticsFinished(summary, alerts);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AttendanceSystem::onAnalyticsFinished(const AttendanceAnalytics::RunSummary &summary,
+                                           const std::vector<AttendanceAlert> &alerts)
+{
+    m_btnAnalytics->setEnabled(true);
+    m_btnAnalytics->setText("At-Risk Analysis");
+
+    if (!summary.saved) {
+        QMessageBox::critical(this, "Error", "Failed to save attendance alerts.");
+        return;
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("At-Risk Students");
+    dialog.resize(800, 500);
+    auto layout = new QVBoxLayout(&dialog);
+
+    auto info = new QLabel(QString("Evaluated %1 student/section pairs, %2 alert(s) raised in %3 ms.")
+        .arg(summary.studentSectionsEvaluated)
+        .arg(summary.alertsRaised)
+        .arg(summary.loadMs + summary.evaluateMs + summary.saveMs));
+    layout->addWidget(info);
+
+    auto view = new QTableView(&dialog);
+    auto model = new QStandardItemModel(&dialog);
+    model->setHorizontalHeaderLabels({"Student Name", "Student ID", "Section ID", "Rule", "Absence Rate", "Consecutive", "Sessions"});
+    for (const auto &a : alerts) {
+        QList<QStandardItem*> row;
+        row << new QStandardItem(a.studentName.isEmpty() ? "N/A" : a.studentName);
+        row << new QStandardItem(QString::number(a.studentId));
+        row << new QStandardItem(QString::number(a.sectionId));
+        row << new QStandardItem(a.rule == AttendanceAlertRule::AbsenceRate ? "Absence Rate" : "Consecutive Absences");
+        auto rateItem = new QStandardItem(QString::number(a.absenceRate * 100.0, 'f', 1) + "%");
+        rateItem->setForeground(QBrush(QColor("#c0392b")));
+        row << rateItem;
+        row << new QStandardItem(QString::number(a.consecutiveAbsences));
+        row << new QStandardItem(QString::number(a.totalSessions));
+        model->appendRow(row);
+    }
+    view->setModel(model);
+    view->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    view->setAlternatingRowColors(true);
+    view->verticalHeader()->setVisible(false);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(view);
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close, &dialog);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addWidget(buttons);
+
+    dialog.exec();
+}
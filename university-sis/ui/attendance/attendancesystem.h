@@ -12,6 +12,7 @@
 #include <QComboBox>
 #include <QDateEdit>
 #include "../../modules/attendance/attendancerepository.h"
+#include "../../modules/attendance/attendanceanalytics.h"
 
 class AttendanceSystem : public QWidget
 {
@@ -25,8 +26,10 @@ private slots:
     void deleteAttendance(int id);
     void refreshData();
     void applyFilters();
+    void onRunAnalytics();
 
 private:
+    void onAnalyticsFinished(const AttendanceAnalytics::RunSummary &summary, const std::vector<AttendanceAlert> &alerts);
     void setupUi();
     void loadAttendance();
     void styleTable();
@@ -35,6 +38,7 @@ private:
     QTableView *m_view;
     QStandardItemModel *m_model;
     QPushButton *m_btnAdd;
+    QPushButton *m_btnAnalytics;
     
     // Filter controls
     QLineEdit *m_filterStudentName;
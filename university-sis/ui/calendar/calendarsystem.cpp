@@ -1,18 +1,22 @@
 #include "calendarsystem.h"
+#include "../../utils/tracer.h"
 #include <QHeaderView>
 #include <QMessageBox>
-#include <QSqlQuery>
-#include <QSqlError>
 #include <QTime>
 #include <QStringList>
-#include "../../database/databasemanager.h"
+#include "../../database/scopedconnection.h"
 #include <QDate>
+#include <QTextCharFormat>
+#include <QThreadPool>
+#include <QPointer>
+#include <QCoreApplication>
+#include <QDebug>
 
 CalendarSystem::CalendarSystem(QWidget *parent)
     : BaseSystemWidget("Calendar & Schedule", parent)
 {
     setupUi();
-    refreshEvents();
+    onMonthPageChanged(m_calendar->yearShown(), m_calendar->monthShown());
 }
 
 void CalendarSystem::setupUi()
@@ -98,6 +102,40 @@ void CalendarSystem::setupUi()
     typeLayout->addWidget(m_typeCombo);
     formLayout->addLayout(typeLayout);
     
+    // Weekly repetition: stored as a single series, expanded when a month is shown
+    auto repeatLayout = new QHBoxLayout();
+    m_repeatCheck = new QCheckBox("Repeat weekly on", this);
+    repeatLayout->addWidget(m_repeatCheck);
+    for (const QString &day : {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"}) {
+        auto dayCheck = new QCheckBox(day, this);
+        dayCheck->setEnabled(false);
+        m_dayChecks.append(dayCheck);
+        repeatLayout->addWidget(dayCheck);
+    }
+    repeatLayout->addStretch();
+    formLayout->addLayout(repeatLayout);
+    
+    auto untilLayout = new QHBoxLayout();
+    untilLayout->addWidget(new QLabel("Until:"));
+    m_untilEdit = new QDateEdit(this);
+    m_untilEdit->setDate(QDate::currentDate().addMonths(4));
+    m_untilEdit->setCalendarPopup(true);
+    m_untilEdit->setDisplayFormat("MMM dd, yyyy");
+    m_untilEdit->setEnabled(false);
+    untilLayout->addWidget(m_untilEdit);
+    untilLayout->addStretch();
+    formLayout->addLayout(untilLayout);
+    
+    connect(m_repeatCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        for (auto dayCheck : m_dayChecks) {
+            dayCheck->setEnabled(checked);
+        }
+        m_untilEdit->setEnabled(checked);
+        if (checked) {
+            m_dayChecks.at(m_dateEdit->date().dayOfWeek() - 1)->setChecked(true);
+        }
+    });
+    
     auto descLayout = new QVBoxLayout();
     descLayout->addWidget(new QLabel("Description:"));
     m_descriptionEdit = new QTextEdit(this);
@@ -124,6 +162,7 @@ void CalendarSystem::setupUi()
     
     // Connections
     connect(m_calendar, &QCalendarWidget::selectionChanged, this, &CalendarSystem::onCalendarSelectionChanged);
+    connect(m_calendar, &QCalendarWidget::currentPageChanged, this, &CalendarSystem::onMonthPageChanged);
     connect(m_dateEdit, &QDateEdit::dateChanged, this, &CalendarSystem::onDateEditChanged);
     connect(m_addBtn, &QPushButton::clicked, this, &CalendarSystem::onAddEvent);
     connect(m_deleteBtn, &QPushButton::clicked, this, &CalendarSystem::onDeleteEvent);
@@ -152,24 +191,113 @@ void CalendarSystem::onDateEditChanged(const QDate &date)
 
 void CalendarSystem::loadEventsForDate(const QDate &date)
 {
+    SIS_TRACE_SCOPE("ui", "CalendarSystem::loadEventsForDate");
     m_eventsModel->removeRows(0, m_eventsModel->rowCount());
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    query.prepare("SELECT id, time, title, type FROM calendar_events WHERE date = :date ORDER BY time");
-    query.bindValue(":date", date.toString("yyyy-MM-dd"));
-    
-    if (query.exec()) {
-        while (query.next()) {
-            int row = m_eventsModel->rowCount();
-            m_eventsModel->insertRow(row);
-            m_eventsModel->setItem(row, 0, new QStandardItem(query.value("time").toString()));
-            m_eventsModel->setItem(row, 1, new QStandardItem(query.value("title").toString()));
-            m_eventsModel->setItem(row, 2, new QStandardItem(query.value("type").toString()));
-            m_eventsModel->item(row, 2)->setData(query.value("id").toInt(), Qt::UserRole);
+    // Served from the month cache; only a month that was never loaded hits the database
+    if (syncWithRepository()) {
+        onMonthPageChanged(m_calendar->yearShown(), m_calendar->monthShown());
+    }
+    ensureMonthLoaded(date.year(), date.month());
+    
+    for (const auto &e : m_cache.eventsOn(date)) {
+        int row = m_eventsModel->rowCount();
+        m_eventsModel->insertRow(row);
+        m_eventsModel->setItem(row, 0, new QStandardItem(e.time.toString("HH:mm")));
+        m_eventsModel->setItem(row, 1, new QStandardItem(e.title));
+        m_eventsModel->setItem(row, 2, new QStandardItem(e.type));
+        m_eventsModel->item(row, 2)->setData(e.id, Qt::UserRole);
+        m_eventsModel->item(row, 2)->setData(e.seriesId, Qt::UserRole + 1);
+    }
+}
+
+bool CalendarSystem::syncWithRepository()
+{
+    // Events written anywhere else in the process invalidate every cached range
+    const quint64 changes = CalendarRepository::changeCount();
+    if (changes == m_syncedChanges) {
+        return false;
+    }
+    m_syncedChanges = changes;
+    m_cache.clear();
+    return true;
+}
+
+bool CalendarSystem::acceptOwnWrite()
+{
+    // Patch the cache in place only if nobody else wrote since the last sync
+    if (CalendarRepository::changeCount() != m_syncedChanges + 1) {
+        return false;
+    }
+    ++m_syncedChanges;
+    return true;
+}
+
+void CalendarSystem::ensureMonthLoaded(int year, int month)
+{
+    const QDate from(year, month, 1);
+    const QDate to = from.addMonths(1).addDays(-1);
+    if (m_cache.covers(from, to)) {
+        return;
+    }
+    m_cache.insertRange(from, to, m_repo.getEventsInRange(from, to));
+}
+
+void CalendarSystem::prefetchMonth(int year, int month)
+{
+    const QDate from(year, month, 1);
+    const QDate to = from.addMonths(1).addDays(-1);
+    if (m_cache.covers(from, to) || m_pendingMonths.contains(from)) {
+        return;
+    }
+    m_pendingMonths.insert(from);
+    
+    QPointer<CalendarSystem> self(this);
+    const quint64 generation = CalendarRepository::changeCount();
+    QThreadPool::globalInstance()->start([self, from, to, generation]() {
+        std::vector<CalendarEvent> events;
+        bool ok = false;
+        {
+            ScopedConnection connection; // Worker threads cannot share the GUI thread's connection
+            if (connection.isOpen()) {
+                events = CalendarRepository().getEventsInRange(from, to, connection.database());
+                ok = true;
+            }
         }
+        QMetaObject::invokeMethod(qApp, [self, from, to, events, ok, generation]() {
+            if (self) {
+                self->onMonthPrefetched(from, to, events, ok, generation);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void CalendarSystem::onMonthPrefetched(const QDate &from, const QDate &to, const std::vector<CalendarEvent> &events,
+                                       bool ok, quint64 generation)
+{
+    m_pendingMonths.remove(from);
+    if (!ok || generation != m_syncedChanges || generation != CalendarRepository::changeCount()) {
+        return; // Failed or raced with a write; the month is loaded on demand instead
+    }
+    if (!m_cache.covers(from, to)) {
+        m_cache.insertRange(from, to, events);
+        refreshEvents();
     }
 }
 
+void CalendarSystem::onMonthPageChanged(int year, int month)
+{
+    syncWithRepository();
+    ensureMonthLoaded(year, month);
+    refreshEvents();
+    
+    const QDate shown(year, month, 1);
+    const QDate previous = shown.addMonths(-1);
+    const QDate next = shown.addMonths(1);
+    prefetchMonth(previous.year(), previous.month());
+    prefetchMonth(next.year(), next.month());
+}
+
 void CalendarSystem::onAddEvent()
 {
     if (m_titleEdit->text().trimmed().isEmpty()) {
@@ -179,16 +307,23 @@ void CalendarSystem::onAddEvent()
         return;
     }
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    query.prepare("INSERT INTO calendar_events (date, time, title, type, description) "
-                  "VALUES (:date, :time, :title, :type, :description)");
-    query.bindValue(":date", m_dateEdit->date().toString("yyyy-MM-dd"));
-    query.bindValue(":time", QTime::currentTime().toString("HH:mm"));
-    query.bindValue(":title", m_titleEdit->text().trimmed());
-    query.bindValue(":type", m_typeCombo->currentText());
-    query.bindValue(":description", m_descriptionEdit->toPlainText());
+    if (m_repeatCheck->isChecked()) {
+        onAddSeries();
+        return;
+    }
     
-    if (query.exec()) {
+    CalendarEvent event;
+    event.date = m_dateEdit->date();
+    event.time = QTime::fromString(QTime::currentTime().toString("HH:mm"), "HH:mm");
+    event.title = m_titleEdit->text().trimmed();
+    event.type = m_typeCombo->currentText();
+    event.description = m_descriptionEdit->toPlainText();
+    
+    event.id = m_repo.addEvent(event);
+    if (event.id > 0) {
+        if (acceptOwnWrite()) {
+            m_cache.addEvent(event);
+        }
         QMessageBox::information(this, "Success", 
             QString("Event '%1' has been added successfully.\n\nIt will appear in the News & Info section.").arg(m_titleEdit->text()));
         m_titleEdit->clear();
@@ -198,10 +333,62 @@ void CalendarSystem::onAddEvent()
         refreshEvents();
     } else {
         QMessageBox::critical(this, "Database Error", 
-            QString("Failed to add event.\n\nError: %1").arg(query.lastError().text()));
+            QString("Failed to add event.\n\nError: %1").arg(m_repo.lastError()));
     }
 }
 
+void CalendarSystem::onAddSeries()
+{
+    RecurringEvent series;
+    series.startDate = m_dateEdit->date();
+    series.time = QTime::fromString(QTime::currentTime().toString("HH:mm"), "HH:mm");
+    series.title = m_titleEdit->text().trimmed();
+    series.type = m_typeCombo->currentText();
+    series.description = m_descriptionEdit->toPlainText();
+    for (int day = 0; day < m_dayChecks.size(); ++day) {
+        if (m_dayChecks.at(day)->isChecked()) {
+            series.rule.weekdays |= quint8(1 << day);
+        }
+    }
+    series.rule.until = m_untilEdit->date();
+    
+    if (!series.rule.isValid()) {
+        QMessageBox::warning(this, "Validation Error", "Please select at least one day of the week.");
+        return;
+    }
+    if (series.rule.until < series.startDate) {
+        QMessageBox::warning(this, "Validation Error", "The end date must not be before the start date.");
+        m_untilEdit->setFocus();
+        return;
+    }
+    
+    if (m_repo.addSeries(series) > 0) {
+        const int count = series.rule.occurrences(series.startDate, series.startDate, series.rule.until).size();
+        QMessageBox::information(this, "Success", 
+            QString("Recurring event '%1' has been added (%2 occurrences).").arg(series.title).arg(count));
+        m_titleEdit->clear();
+        m_descriptionEdit->clear();
+        m_typeCombo->setCurrentIndex(0);
+        m_repeatCheck->setChecked(false);
+        for (auto dayCheck : m_dayChecks) {
+            dayCheck->setChecked(false);
+        }
+        reloadAfterSeriesChange();
+    } else {
+        QMessageBox::critical(this, "Database Error", 
+            QString("Failed to add recurring event.\n\nError: %1").arg(m_repo.lastError()));
+    }
+}
+
+void CalendarSystem::reloadAfterSeriesChange()
+{
+    // A series spans many months, so every cached range may be affected
+    m_syncedChanges = CalendarRepository::changeCount();
+    m_cache.clear();
+    onMonthPageChanged(m_calendar->yearShown(), m_calendar->monthShown());
+    loadEventsForDate(m_dateEdit->date());
+}
+
 void CalendarSystem::onDeleteEvent()
 {
     auto selection = m_eventsTable->selectionModel()->selectedRows();
@@ -214,6 +401,32 @@ void CalendarSystem::onDeleteEvent()
     int row = selection.first().row();
     QString eventTitle = m_eventsModel->item(row, 1)->text();
     int eventId = m_eventsModel->item(row, 2)->data(Qt::UserRole).toInt();
+    int seriesId = m_eventsModel->item(row, 2)->data(Qt::UserRole + 1).toInt();
+    
+    if (seriesId > 0) {
+        QMessageBox box(QMessageBox::Question, "Delete Recurring Event",
+            QString("'%1' is part of a recurring event.").arg(eventTitle), QMessageBox::Cancel, this);
+        auto occurrenceBtn = box.addButton("This Occurrence", QMessageBox::AcceptRole);
+        auto seriesBtn = box.addButton("Entire Series", QMessageBox::DestructiveRole);
+        box.exec();
+        
+        bool ok = false;
+        if (box.clickedButton() == occurrenceBtn) {
+            ok = m_repo.addSeriesException(seriesId, m_dateEdit->date());
+        } else if (box.clickedButton() == seriesBtn) {
+            ok = m_repo.deleteSeries(seriesId);
+        } else {
+            return;
+        }
+        
+        if (ok) {
+            reloadAfterSeriesChange();
+        } else {
+            QMessageBox::critical(this, "Database Error", 
+                QString("Failed to delete event.\n\nError: %1").arg(m_repo.lastError()));
+        }
+        return;
+    }
     
     int ret = QMessageBox::question(this, "Confirm Delete", 
         QString("Are you sure you want to delete the event '%1'?\n\nThis action cannot be undone.").arg(eventTitle),
@@ -223,18 +436,17 @@ void CalendarSystem::onDeleteEvent()
         return;
     }
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    query.prepare("DELETE FROM calendar_events WHERE id = :id");
-    query.bindValue(":id", eventId);
-    
-    if (query.exec()) {
+    if (m_repo.deleteEvent(eventId)) {
+        if (acceptOwnWrite()) {
+            m_cache.removeEvent(eventId);
+        }
         QMessageBox::information(this, "Success", 
             QString("Event '%1' has been deleted successfully.").arg(eventTitle));
         loadEventsForDate(m_dateEdit->date());
         refreshEvents();
     } else {
         QMessageBox::critical(this, "Database Error", 
-            QString("Failed to delete event.\n\nError: %1").arg(query.lastError().text()));
+            QString("Failed to delete event.\n\nError: %1").arg(m_repo.lastError()));
     }
 }
 
@@ -246,7 +458,19 @@ void CalendarSystem::onEventTypeChanged(int index)
 
 void CalendarSystem::refreshEvents()
 {
-    // Refresh calendar highlighting - calendar updates automatically
-    // No need to call protected updateCells() method
+    // Re-highlight days with events on the visible page (clears old formats first)
+    m_calendar->setDateTextFormat(QDate(), QTextCharFormat());
+    
+    QTextCharFormat eventDay;
+    eventDay.setFontWeight(QFont::Bold);
+    eventDay.setBackground(QColor(52, 152, 219, 60));
+    
+    // The month grid also shows parts of the neighbouring months
+    const QDate first(m_calendar->yearShown(), m_calendar->monthShown(), 1);
+    const QDate from = first.addDays(-7);
+    const QDate to = first.addMonths(1).addDays(13);
+    for (const QDate &date : m_cache.eventDates(from, to)) {
+        m_calendar->setDateTextFormat(date, eventDay);
+    }
 }
 
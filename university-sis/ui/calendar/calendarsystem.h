@@ -14,7 +14,12 @@
 #include <QTextEdit>
 #include <QComboBox>
 #include <QGroupBox>
+#include <QSet>
+#include <QCheckBox>
+#include <QList>
 #include "../basesystemwidget.h"
+#include "../../modules/calendar/calendarrepository.h"
+#include "../../modules/calendar/calendareventcache.h"
 
 class CalendarSystem : public BaseSystemWidget
 {
@@ -31,10 +36,24 @@ private slots:
     void onDeleteEvent();
     void onEventTypeChanged(int index);
     void refreshEvents();
+    void onMonthPageChanged(int year, int month);
 
 private:
     void setupUi();
     void loadEventsForDate(const QDate &date);
+    void ensureMonthLoaded(int year, int month);
+    void prefetchMonth(int year, int month);
+    void onMonthPrefetched(const QDate &from, const QDate &to, const std::vector<CalendarEvent> &events,
+                           bool ok, quint64 generation);
+    void reloadAfterSeriesChange();
+    void onAddSeries();
+    bool syncWithRepository();
+    bool acceptOwnWrite();
+    
+    CalendarRepository m_repo;
+    CalendarEventCache m_cache;
+    QSet<QDate> m_pendingMonths;   // Months being prefetched in the background
+    quint64 m_syncedChanges = 0;   // CalendarRepository::changeCount() the cache reflects
     
     QCalendarWidget *m_calendar;
     QTableView *m_eventsTable;
@@ -43,6 +62,9 @@ private:
     QLineEdit *m_titleEdit;
     QTextEdit *m_descriptionEdit;
     QComboBox *m_typeCombo;
+    QCheckBox *m_repeatCheck;
+    QList<QCheckBox*> m_dayChecks; // Monday..Sunday
+    QDateEdit *m_untilEdit;
     QPushButton *m_addBtn;
     QPushButton *m_deleteBtn;
     QLabel *m_selectedDateLabel;
@@ -0,0 +1,257 @@
+#include "diagnosticssystem.h"
+#include "../../utils/tracer.h"
+#include "../../database/databasemanager.h"
+#include "../../database/connectionguard.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDateTime>
+#include <QStringList>
+#include <QVariant>
+
+namespace {
+QStandardItem* numberItem(double value, int decimals = 0)
+{
+    auto item = new QStandardItem(QString::number(value, 'f', decimals));
+    item->setData(value, Qt::UserRole + 1);  // Sort numerically
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QString formatValues(const QVariantList& values)
+{
+    QStringList parts;
+    for (const QVariant& v : values) {
+        parts << (v.isNull() ? QString("NULL") : v.toString());
+    }
+    return parts.join(", ");
+}
+}
+
+DiagnosticsSystem::DiagnosticsSystem(QWidget *parent)
+    : BaseSystemWidget("Diagnostics", parent)
+{
+    setupUi();
+}
+
+void DiagnosticsSystem::setupUi()
+{
+    auto mainLayout = qobject_cast<QVBoxLayout*>(layout());
+    if (!mainLayout) return;
+
+    // Controls
+    auto controlsGroup = new QGroupBox("Query Profiler");
+    auto controlsLayout = new QHBoxLayout(controlsGroup);
+
+    m_enabledCheck = new QCheckBox("Profiling enabled", this);
+    m_enabledCheck->setChecked(QueryProfiler::enabled());
+    controlsLayout->addWidget(m_enabledCheck);
+
+    controlsLayout->addWidget(new QLabel("Slow threshold:"));
+    m_thresholdSpin = new QSpinBox(this);
+    m_thresholdSpin->setRange(0, 60000);
+    m_thresholdSpin->setSuffix(" ms");
+    m_thresholdSpin->setValue(int(QueryProfiler::instance().slowThresholdUs() / 1000));
+    controlsLayout->addWidget(m_thresholdSpin);
+
+    m_refreshBtn = new QPushButton("Refresh", this);
+    m_refreshBtn->setProperty("type", "primary");
+    m_resetBtn = new QPushButton("Reset", this);
+    controlsLayout->addWidget(m_refreshBtn);
+    controlsLayout->addWidget(m_resetBtn);
+    controlsLayout->addStretch();
+
+    m_summaryLabel = new QLabel(this);
+    controlsLayout->addWidget(m_summaryLabel);
+
+    mainLayout->addWidget(controlsGroup);
+
+    // Per-statement totals
+    auto statementGroup = new QGroupBox("Statements (by total time)");
+    auto statementLayout = new QVBoxLayout(statementGroup);
+    m_statementTable = new QTableView(this);
+    m_statementModel = new QStandardItemModel(0, 11, this);
+    m_statementModel->setHorizontalHeaderLabels({"Calls", "Total ms", "Mean ms", "Max ms", "Prepare ms",
+                                                 "Exec ms", "Fetch ms", "Rows", "Errors", "Site", "SQL"});
+    m_statementModel->setSortRole(Qt::UserRole + 1);
+    m_statementTable->setModel(m_statementModel);
+    statementLayout->addWidget(m_statementTable);
+    mainLayout->addWidget(statementGroup, 2);
+
+    // Slow query log
+    auto slowGroup = new QGroupBox("Slow Queries");
+    auto slowLayout = new QVBoxLayout(slowGroup);
+    m_slowTable = new QTableView(this);
+    m_slowModel = new QStandardItemModel(0, 6, this);
+    m_slowModel->setHorizontalHeaderLabels({"Time", "Total ms", "Rows", "Site", "SQL", "Bind Values"});
+    m_slowModel->setSortRole(Qt::UserRole + 1);
+    m_slowTable->setModel(m_slowModel);
+    slowLayout->addWidget(m_slowTable, 2);
+
+    auto explainLayout = new QHBoxLayout();
+    m_explainBtn = new QPushButton("Explain Selected", this);
+    explainLayout->addWidget(m_explainBtn);
+    explainLayout->addStretch();
+    slowLayout->addLayout(explainLayout);
+
+    m_planText = new QTextEdit(this);
+    m_planText->setReadOnly(true);
+    m_planText->setMaximumHeight(150);
+    m_planText->setPlaceholderText("Select a slow query and press Explain to see its query plan.");
+    slowLayout->addWidget(m_planText, 1);
+    mainLayout->addWidget(slowGroup, 2);
+
+    for (QTableView* table : {m_statementTable, m_slowTable}) {
+        table->horizontalHeader()->setStretchLastSection(true);
+        table->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+        table->verticalHeader()->setVisible(false);
+        table->setAlternatingRowColors(true);
+        table->setSortingEnabled(true);
+        table->setSelectionBehavior(QAbstractItemView::SelectRows);
+        table->setSelectionMode(QAbstractItemView::SingleSelection);
+        table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    }
+
+    // Connections
+    connect(m_enabledCheck, &QCheckBox::toggled, this, [](bool checked) {
+        QueryProfiler::instance().setEnabled(checked);
+    });
+    connect(m_thresholdSpin, qOverload<int>(&QSpinBox::valueChanged), this, [](int ms) {
+        QueryProfiler::instance().setSlowThresholdMs(ms);
+    });
+    connect(m_refreshBtn, &QPushButton::clicked, this, &DiagnosticsSystem::refresh);
+    connect(m_resetBtn, &QPushButton::clicked, this, &DiagnosticsSystem::onReset);
+    connect(m_explainBtn, &QPushButton::clicked, this, &DiagnosticsSystem::onExplain);
+    connect(m_slowTable, &QTableView::doubleClicked, this, &DiagnosticsSystem::onExplain);
+}
+
+void DiagnosticsSystem::showEvent(QShowEvent *event)
+{
+    BaseSystemWidget::showEvent(event);
+    refresh();
+}
+
+void DiagnosticsSystem::refresh()
+{
+    SIS_TRACE_SCOPE("ui", "DiagnosticsSystem::refresh");
+    loadStatements();
+    loadSlowQueries();
+}
+
+void DiagnosticsSystem::loadStatements()
+{
+    const std::vector<QueryStats> stats = QueryProfiler::instance().stats();
+
+    m_statementTable->setSortingEnabled(false);
+    m_statementModel->removeRows(0, m_statementModel->rowCount());
+    quint64 calls = 0;
+    qint64 totalUs = 0;
+    for (const QueryStats& s : stats) {
+        calls += s.calls;
+        totalUs += s.totalUs();
+
+        auto sqlItem = new QStandardItem(s.sql.simplified());
+        sqlItem->setToolTip(QString("%1\n\nHash: %2").arg(s.sql).arg(s.sqlHash, 16, 16, QChar('0')));
+        auto siteItem = new QStandardItem(QString::fromUtf8(s.site ? s.site : ""));
+        siteItem->setData(siteItem->text(), Qt::UserRole + 1);
+        sqlItem->setData(sqlItem->text(), Qt::UserRole + 1);
+
+        m_statementModel->appendRow({
+            numberItem(double(s.calls)),
+            numberItem(s.totalUs() / 1000.0, 2),
+            numberItem(s.meanUs() / 1000.0, 3),
+            numberItem(s.maxUs / 1000.0, 2),
+            numberItem(s.prepareUs / 1000.0, 2),
+            numberItem(s.execUs / 1000.0, 2),
+            numberItem(s.fetchUs / 1000.0, 2),
+            numberItem(double(s.rows)),
+            numberItem(double(s.errors)),
+            siteItem,
+            sqlItem
+        });
+    }
+    m_statementTable->setSortingEnabled(true);
+    m_statementTable->sortByColumn(1, Qt::DescendingOrder);
+
+    const ConnectionGuard::Metrics guard = ConnectionGuard::instance().metrics();
+    m_summaryLabel->setText(QString("%1 statements, %2 executions, %3 ms total; read-only queries on %4; "
+                                    "%5 retries (%6 succeeded), %7 reconnects, %8 circuit opens, %9 rejected")
+                                .arg(stats.size())
+                                .arg(calls)
+                                .arg(totalUs / 1000.0, 0, 'f', 1)
+                                .arg(DatabaseManager::instance().routesReads() ? "the read connection" : "the main connection")
+                                .arg(guard.retries)
+                                .arg(guard.retriesSucceeded)
+                                .arg(guard.reconnects)
+                                .arg(guard.circuitOpens)
+                                .arg(guard.rejected));
+}
+
+void DiagnosticsSystem::loadSlowQueries()
+{
+    m_slowQueries = QueryProfiler::instance().slowQueries();
+
+    m_slowTable->setSortingEnabled(false);
+    m_slowModel->removeRows(0, m_slowModel->rowCount());
+    for (int i = 0; i < int(m_slowQueries.size()); ++i) {
+        const SlowQuery& q = m_slowQueries[i];
+
+        auto timeItem = new QStandardItem(
+            QDateTime::fromMSecsSinceEpoch(q.timestampMs).toString("hh:mm:ss.zzz"));
+        timeItem->setData(q.timestampMs, Qt::UserRole + 1);
+        timeItem->setData(i, Qt::UserRole + 2);  // Index into m_slowQueries
+        auto siteItem = new QStandardItem(q.site);
+        siteItem->setData(q.site, Qt::UserRole + 1);
+        auto sqlItem = new QStandardItem(q.sql.simplified());
+        sqlItem->setData(sqlItem->text(), Qt::UserRole + 1);
+        sqlItem->setToolTip(QString("%1\n\nprepare %2 ms, exec %3 ms, fetch %4 ms (%5)")
+                                .arg(q.sql)
+                                .arg(q.prepareUs / 1000.0, 0, 'f', 2)
+                                .arg(q.execUs / 1000.0, 0, 'f', 2)
+                                .arg(q.fetchUs / 1000.0, 0, 'f', 2)
+                                .arg(q.connectionName));
+        auto valuesItem = new QStandardItem(formatValues(q.boundValues));
+        valuesItem->setData(valuesItem->text(), Qt::UserRole + 1);
+
+        m_slowModel->appendRow({
+            timeItem,
+            numberItem(q.totalUs() / 1000.0, 2),
+            numberItem(double(q.rows)),
+            siteItem,
+            sqlItem,
+            valuesItem
+        });
+    }
+    m_slowTable->setSortingEnabled(true);
+}
+
+void DiagnosticsSystem::onReset()
+{
+    QueryProfiler::instance().reset();
+    m_planText->clear();
+    refresh();
+}
+
+void DiagnosticsSystem::onExplain()
+{
+    const QModelIndexList rows = m_slowTable->selectionModel()->selectedRows(0);
+    if (rows.isEmpty()) {
+        QMessageBox::information(this, "Explain", "Please select a slow query first.");
+        return;
+    }
+    const int index = rows.first().data(Qt::UserRole + 2).toInt();
+    if (index < 0 || index >= int(m_slowQueries.size())) {
+        return;
+    }
+    const SlowQuery& q = m_slowQueries[index];
+    QStringList lines;
+    lines << q.sql.simplified();
+    if (!q.boundValues.isEmpty()) {
+        lines << "Bind values: " + formatValues(q.boundValues);
+    }
+    lines << QString();
+    lines << QueryProfiler::instance().explain(q);
+    m_planText->setPlainText(lines.join("\n"));
+}
@@ -0,0 +1,51 @@
+#ifndef DIAGNOSTICSSYSTEM_H
+#define DIAGNOSTICSSYSTEM_H
+
+#include <QWidget>
+#include <QTableView>
+#include <QStandardItemModel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <QTextEdit>
+#include <vector>
+#include "../basesystemwidget.h"
+#include "../../database/queryprofiler.h"
+
+// Admin page: per-statement query timings, the slow query log and EXPLAIN plans
+class DiagnosticsSystem : public BaseSystemWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsSystem(QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void refresh();
+    void onReset();
+    void onExplain();
+
+private:
+    void setupUi();
+    void loadStatements();
+    void loadSlowQueries();
+
+    QCheckBox *m_enabledCheck;
+    QSpinBox *m_thresholdSpin;
+    QPushButton *m_refreshBtn;
+    QPushButton *m_resetBtn;
+    QPushButton *m_explainBtn;
+    QLabel *m_summaryLabel;
+    QTableView *m_statementTable;
+    QStandardItemModel *m_statementModel;
+    QTableView *m_slowTable;
+    QStandardItemModel *m_slowModel;
+    QTextEdit *m_planText;
+    std::vector<SlowQuery> m_slowQueries;  // Rows of m_slowModel, newest first
+};
+
+#endif // DIAGNOSTICSSYSTEM_H
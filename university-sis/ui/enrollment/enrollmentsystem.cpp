@@ -1,13 +1,27 @@
 #include "enrollmentsystem.h"
+#include "../../utils/tracer.h"
 #include "enrollmentdialog.h"
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QStandardItem>
+#include <QFileDialog>
+#include <QFile>
+#include <QFileInfo>
+#include <QProgressDialog>
+#include <QApplication>
+#include "../../modules/enrollment/bulkenrollment.h"
+#include "../../modules/enrollment/waitlistmanager.h"
+#include "../../modules/session/sessiondataservice.h"
 
 EnrollmentSystem::EnrollmentSystem(QWidget *parent) : QWidget(parent)
 {
     setupUi();
     loadEnrollments();
+    connect(&SessionDataService::instance(), &SessionDataService::loaded, this, [this](bool) {
+        if (m_currentUserRole == "Student") {
+            loadEnrollments();
+        }
+    });
 }
 
 void EnrollmentSystem::setUserContext(const QString& role, int userId)
@@ -20,6 +34,7 @@ void EnrollmentSystem::setUserContext(const QString& role, int userId)
         // Assuming students cannot enroll themselves directly in this admin tool, 
         // or if they can, we might enable it. Based on "can't update any thing", disable.
         m_btnAdd->setVisible(canEdit);
+        m_btnBulk->setVisible(canEdit);
     }
     
     loadEnrollments();
@@ -45,6 +60,10 @@ void EnrollmentSystem::setupUi()
     m_btnAdd->setCursor(Qt::PointingHandCursor);
     m_btnAdd->setStyleSheet("QPushButton { background-color: #e67e22; color: white; padding: 8px 16px; border: none; border-radius: 4px; font-size: 14px; font-weight: 600; } QPushButton:hover { opacity: 0.9; }");
     toolbarLayout->addWidget(m_btnAdd);
+    m_btnBulk = new QPushButton("Bulk Enroll (CSV)");
+    m_btnBulk->setCursor(Qt::PointingHandCursor);
+    m_btnBulk->setToolTip("Import student_id,section_id rows for registration day");
+    toolbarLayout->addWidget(m_btnBulk);
     toolbarLayout->addStretch();
     mainLayout->addLayout(toolbarLayout);
 
@@ -55,9 +74,30 @@ void EnrollmentSystem::setupUi()
     m_model->setHorizontalHeaderLabels({"Student ID", "Student Name", "Section ID", "Actions"});
     m_view->setModel(m_model);
     styleTable();
-    mainLayout->addWidget(m_view);
+    mainLayout->addWidget(m_view, 3);
+
+    // Waitlists
+    auto waitlistTitle = new QLabel("Waitlists");
+    waitlistTitle->setStyleSheet("font-size: 16px; font-weight: bold;");
+    mainLayout->addWidget(waitlistTitle);
+    
+    m_waitlistView = new QTableView(this);
+    m_waitlistModel = new QStandardItemModel(this);
+    m_waitlistModel->setColumnCount(5);
+    m_waitlistModel->setHorizontalHeaderLabels({"Section ID", "Position", "Student ID", "Student Name", "Actions"});
+    m_waitlistView->setModel(m_waitlistModel);
+    m_waitlistView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_waitlistView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_waitlistView->setAlternatingRowColors(true);
+    m_waitlistView->verticalHeader()->setVisible(false);
+    m_waitlistView->verticalHeader()->setDefaultSectionSize(50);
+    m_waitlistView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_waitlistView->setShowGrid(false);
+    m_waitlistView->setStyleSheet("QTableView::item { padding: 5px; }");
+    mainLayout->addWidget(m_waitlistView, 1);
 
     connect(m_btnAdd, &QPushButton::clicked, this, &EnrollmentSystem::onEnroll);
+    connect(m_btnBulk, &QPushButton::clicked, this, &EnrollmentSystem::onBulkEnroll);
 }
 
 void EnrollmentSystem::styleTable()
@@ -74,8 +114,26 @@ void EnrollmentSystem::styleTable()
 
 void EnrollmentSystem::loadEnrollments()
 {
+    SIS_TRACE_SCOPE("ui", "EnrollmentSystem::loadEnrollments");
     m_model->removeRows(0, m_model->rowCount());
-    auto list = m_repo.getAllEnrollmentsWithNames();
+    
+    std::vector<Enrollment> list;
+    SessionDataService& session = SessionDataService::instance();
+    auto data = m_currentUserRole == "Student" ? session.snapshot() : nullptr;
+    if (data) {
+        // Own rows from the session prefetch instead of scanning every enrollment
+        for (const auto &se : data->enrollments) {
+            Enrollment e;
+            e.studentId = data->studentId;
+            e.studentName = data->profile ? data->profile->name : QString();
+            e.sectionId = se.sectionId;
+            list.push_back(e);
+        }
+    } else if (m_currentUserRole == "Student" && session.isPending()) {
+        // Filled in when SessionDataService::loaded fires
+    } else {
+        list = m_repo.getAllEnrollmentsWithNames();
+    }
     
     for (const auto &e : list) {
         // Filter: If Student, matching ID only. 
@@ -112,6 +170,46 @@ void EnrollmentSystem::loadEnrollments()
         
         m_view->setIndexWidget(m_model->index(m_model->rowCount() - 1, 3), actionWidget);
     }
+    
+    loadWaitlists();
+}
+
+void EnrollmentSystem::loadWaitlists()
+{
+    SIS_TRACE_SCOPE("ui", "EnrollmentSystem::loadWaitlists");
+    m_waitlistModel->removeRows(0, m_waitlistModel->rowCount());
+    auto entries = WaitlistManager::instance().getEntriesWithNames();
+    
+    for (const auto &e : entries) {
+        if (m_currentUserRole == "Student" && e.studentId != m_currentUserId) {
+            continue;
+        }
+        
+        QList<QStandardItem*> row;
+        row << new QStandardItem(QString::number(e.sectionId));
+        row << new QStandardItem(QString("#%1").arg(e.position));
+        row << new QStandardItem(QString::number(e.studentId));
+        row << new QStandardItem(e.studentName.isEmpty() ? "N/A" : e.studentName);
+        row << new QStandardItem("");
+        m_waitlistModel->appendRow(row);
+        
+        QWidget* actionWidget = new QWidget();
+        QHBoxLayout* layout = new QHBoxLayout(actionWidget);
+        layout->setContentsMargins(4, 4, 4, 4);
+        
+        QPushButton* leaveBtn = new QPushButton("Remove");
+        leaveBtn->setCursor(Qt::PointingHandCursor);
+        leaveBtn->setFixedSize(90, 32);
+        leaveBtn->setStyleSheet("QPushButton { background-color: #FFEBEE; color: #C62828; border: none; border-radius: 6px; padding: 6px 12px; font-weight: 600; font-size: 12px; } QPushButton:hover { background-color: #FFCDD2; }");
+        layout->addWidget(leaveBtn);
+        layout->addStretch();
+        
+        int sid = e.studentId;
+        int secid = e.sectionId;
+        connect(leaveBtn, &QPushButton::clicked, this, [this, sid, secid]() { leaveWaitlist(sid, secid); });
+        
+        m_waitlistView->setIndexWidget(m_waitlistModel->index(m_waitlistModel->rowCount() - 1, 4), actionWidget);
+    }
 }
 
 void EnrollmentSystem::onEnroll()
@@ -119,11 +217,80 @@ void EnrollmentSystem::onEnroll()
     EnrollmentDialog dialog(this);
     if (dialog.exec() == QDialog::Accepted) {
         Enrollment e = dialog.getEnrollment();
-        if (m_repo.enrollStudent(e)) {
+        EnrollmentDecision decision = m_repo.enroll(e);
+        if (decision.ok()) {
             refreshData();
             QMessageBox::information(this, "Success", "Student enrolled successfully.");
-        } else {
+        } else if (decision.status == EnrollmentCheck::SectionFull) {
+            if (QMessageBox::Yes == QMessageBox::question(this, "Section Full",
+                    decision.message() + "\n\nAdd the student to the waitlist?")) {
+                QString error;
+                int position = WaitlistManager::instance().join(e.studentId, e.sectionId, &error);
+                if (position > 0) {
+                    refreshData();
+                    QMessageBox::information(this, "Waitlisted",
+                        QString("Student %1 is #%2 on the waitlist for section %3.").arg(e.studentId).arg(position).arg(e.sectionId));
+                } else {
+                    QMessageBox::critical(this, "Error", "Failed to join the waitlist.\n\n" + error);
+                }
+            }
+        } else if (decision.status == EnrollmentCheck::DatabaseError) {
             QMessageBox::critical(this, "Error", "Failed to enroll student. Check IDs.");
+        } else {
+            QMessageBox::warning(this, "Enrollment Rejected", decision.message());
+        }
+    }
+}
+
+void EnrollmentSystem::onBulkEnroll()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Bulk Enrollment", QString(),
+                                                    "CSV Files (*.csv);;Text Files (*.txt)");
+    if (fileName.isEmpty()) return;
+    
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, "Error", "Failed to open file for reading.");
+        return;
+    }
+    auto rows = BulkEnrollmentPipeline::parseCsv(file);
+    file.close();
+    
+    QProgressDialog progress("Enrolling students...", QString(), 0, 100, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    BulkEnrollmentPipeline pipeline;
+    auto summary = pipeline.run(std::move(rows), [&progress](int done, int total) {
+        progress.setMaximum(total);
+        progress.setValue(done);
+    });
+    QApplication::restoreOverrideCursor();
+    progress.close();
+    
+    refreshData();
+    
+    QString text = QString("Processed %1 rows in %2 ms (validation %3 ms, commit %4 ms).\n\n"
+                           "Enrolled: %5\nRejected: %6")
+                       .arg(summary.total)
+                       .arg(summary.validateMs + summary.commitMs)
+                       .arg(summary.validateMs)
+                       .arg(summary.commitMs)
+                       .arg(summary.enrolled)
+                       .arg(summary.rejected);
+    if (summary.failures.empty()) {
+        QMessageBox::information(this, "Bulk Enrollment", text);
+        return;
+    }
+    
+    if (QMessageBox::Yes == QMessageBox::question(this, "Bulk Enrollment",
+            text + "\n\nSave the rejected rows with their reasons?")) {
+        QString reportName = QFileDialog::getSaveFileName(this, "Save Rejected Rows",
+                                                          QFileInfo(fileName).completeBaseName() + "_rejected.csv",
+                                                          "CSV Files (*.csv)");
+        if (!reportName.isEmpty() && !BulkEnrollmentPipeline::writeErrorReport(summary, reportName)) {
+            QMessageBox::critical(this, "Error", "Failed to open file for writing.");
         }
     }
 }
@@ -131,14 +298,30 @@ void EnrollmentSystem::onEnroll()
 void EnrollmentSystem::deleteEnrollment(int studentId, int sectionId)
 {
     if (QMessageBox::Yes == QMessageBox::question(this, "Confirm", "Unenroll this student?")) {
-        if (m_repo.unenrollStudent(studentId, sectionId)) {
+        int promoted = 0;
+        if (m_repo.unenrollStudent(studentId, sectionId, &promoted)) {
             refreshData();
+            if (promoted > 0) {
+                QMessageBox::information(this, "Waitlist",
+                    QString("Student %1 was promoted from the waitlist into section %2.").arg(promoted).arg(sectionId));
+            }
         } else {
             QMessageBox::critical(this, "Error", "Failed to unenroll.");
         }
     }
 }
 
+void EnrollmentSystem::leaveWaitlist(int studentId, int sectionId)
+{
+    if (QMessageBox::Yes == QMessageBox::question(this, "Confirm", "Remove this student from the waitlist?")) {
+        if (WaitlistManager::instance().leave(studentId, sectionId)) {
+            loadWaitlists();
+        } else {
+            QMessageBox::critical(this, "Error", "Failed to update the waitlist.");
+        }
+    }
+}
+
 void EnrollmentSystem::refreshData()
 {
     loadEnrollments();
@@ -20,17 +20,23 @@ public:
 
 private slots:
     void onEnroll();
+    void onBulkEnroll();
     void deleteEnrollment(int studentId, int sectionId);
+    void leaveWaitlist(int studentId, int sectionId);
     void refreshData();
 
 private:
     void setupUi();
     void loadEnrollments();
+    void loadWaitlists();
     void styleTable();
 
     QTableView *m_view;
     QStandardItemModel *m_model;
+    QTableView *m_waitlistView;
+    QStandardItemModel *m_waitlistModel;
     QPushButton *m_btnAdd;
+    QPushButton *m_btnBulk;
     
     EnrollmentRepository m_repo;
     QString m_currentUserRole;
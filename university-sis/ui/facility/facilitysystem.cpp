@@ -1,9 +1,10 @@
 #include "facilitysystem.h"
+#include "../../utils/tracer.h"
 #include "buildingdialog.h"
 #include "roomdialog.h"
 #include <QHeaderView>
 #include <QMessageBox>
-#include <QHash>
+#include <QStringList>
 
 FacilitySystem::FacilitySystem(QWidget *parent) : QWidget(parent)
 {
@@ -72,10 +73,18 @@ void FacilitySystem::setupRoomsTab()
     toolbar->addWidget(m_btnEditRoom);
     toolbar->addWidget(m_btnDeleteRoom);
     toolbar->addStretch();
+    m_roomSearch = new QLineEdit(this);
+    m_roomSearch->setPlaceholderText("Search room, building or code...");
+    m_roomSearch->setFixedWidth(240);
+    toolbar->addWidget(m_roomSearch);
 
     connect(m_btnAddRoom, &QPushButton::clicked, this, &FacilitySystem::addRoom);
     connect(m_btnEditRoom, &QPushButton::clicked, this, &FacilitySystem::editRoom);
     connect(m_btnDeleteRoom, &QPushButton::clicked, this, &FacilitySystem::deleteRoom);
+    connect(m_roomSearch, &QLineEdit::returnPressed, this, [this]() {
+        m_roomOffset = 0;
+        loadRooms();
+    });
 
     // Table
     m_roomsTable = new QTableView(this);
@@ -86,12 +95,39 @@ void FacilitySystem::setupRoomsTab()
     m_roomsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_roomsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
 
+    // Paging
+    QHBoxLayout *pager = new QHBoxLayout();
+    m_btnPrevPage = new QPushButton("< Previous", this);
+    m_btnNextPage = new QPushButton("Next >", this);
+    m_pageLabel = new QLabel(this);
+    pager->addStretch();
+    pager->addWidget(m_btnPrevPage);
+    pager->addWidget(m_pageLabel);
+    pager->addWidget(m_btnNextPage);
+
+    connect(m_btnPrevPage, &QPushButton::clicked, this, [this]() {
+        m_roomOffset = qMax(0, m_roomOffset - RoomsPerPage);
+        loadRooms();
+    });
+    connect(m_btnNextPage, &QPushButton::clicked, this, [this]() {
+        m_roomOffset += RoomsPerPage;
+        loadRooms();
+    });
+
+    // Overview (seats per building, rooms per type)
+    m_overviewLabel = new QLabel(this);
+    m_overviewLabel->setWordWrap(true);
+    m_overviewLabel->setStyleSheet("padding: 8px; background-color: rgba(52, 152, 219, 0.08); border-radius: 4px;");
+
     layout->addLayout(toolbar);
+    layout->addWidget(m_overviewLabel);
     layout->addWidget(m_roomsTable);
+    layout->addLayout(pager);
 }
 
 void FacilitySystem::loadBuildings()
 {
+    SIS_TRACE_SCOPE("ui", "FacilitySystem::loadBuildings");
     m_buildingsModel->removeRows(0, m_buildingsModel->rowCount());
     QList<Building> buildings = m_repository.getAllBuildings();
     
@@ -107,22 +143,49 @@ void FacilitySystem::loadBuildings()
 
 void FacilitySystem::loadRooms()
 {
+    SIS_TRACE_SCOPE("ui", "FacilitySystem::loadRooms");
     m_roomsModel->removeRows(0, m_roomsModel->rowCount());
-    QList<Room> rooms = m_repository.getAllRooms();
-    
-    QList<Building> buildings = m_repository.getAllBuildings();
-    QHash<int, QString> buildingNames;
-    for(const auto& b : buildings) buildingNames[b.id] = b.name;
 
-    for(const auto& r : rooms) {
+    RoomFilter filter;
+    filter.search = m_roomSearch->text().trimmed();
+    filter.offset = m_roomOffset;
+    filter.limit = RoomsPerPage;
+    RoomPage page = m_repository.getRoomsWithBuildings(filter);
+
+    // Stepped past the end (e.g. after deleting the last room of a page)
+    if (page.rooms.isEmpty() && m_roomOffset > 0 && page.totalCount > 0) {
+        m_roomOffset = ((page.totalCount - 1) / RoomsPerPage) * RoomsPerPage;
+        loadRooms();
+        return;
+    }
+
+    for(const auto& r : page.rooms) {
         QList<QStandardItem*> row;
-        row << new QStandardItem(QString::number(r.id));
-        row << new QStandardItem(buildingNames.value(r.buildingId, "Unknown"));
-        row << new QStandardItem(r.roomNumber);
-        row << new QStandardItem(r.type);
-        row << new QStandardItem(QString::number(r.capacity));
+        row << new QStandardItem(QString::number(r.room.id));
+        row << new QStandardItem(r.buildingName.isEmpty() ? "Unknown" : r.buildingName);
+        row << new QStandardItem(r.room.roomNumber);
+        row << new QStandardItem(r.room.type);
+        row << new QStandardItem(QString::number(r.room.capacity));
         m_roomsModel->appendRow(row);
     }
+
+    const int pages = qMax(1, (page.totalCount + RoomsPerPage - 1) / RoomsPerPage);
+    m_pageLabel->setText(QString("Page %1 of %2 (%3 rooms)").arg(m_roomOffset / RoomsPerPage + 1).arg(pages).arg(page.totalCount));
+    m_btnPrevPage->setEnabled(m_roomOffset > 0);
+    m_btnNextPage->setEnabled(m_roomOffset + RoomsPerPage < page.totalCount);
+
+    const FacilityOverview& overview = page.overview;
+    QStringList perBuilding;
+    for (const auto& b : overview.buildings) {
+        perBuilding << QString("%1: %2 seats in %3 rooms").arg(b.name.isEmpty() ? "Unknown" : b.name).arg(b.seats).arg(b.rooms);
+    }
+    QStringList perType;
+    for (auto it = overview.roomsPerType.constBegin(); it != overview.roomsPerType.constEnd(); ++it) {
+        perType << QString("%1: %2").arg(it.key().isEmpty() ? "Other" : it.key()).arg(it.value());
+    }
+    m_overviewLabel->setText(QString("<b>%1 rooms, %2 seats</b><br>%3<br>Rooms per type: %4")
+        .arg(overview.totalRooms).arg(overview.totalSeats)
+        .arg(perBuilding.join(" | ")).arg(perType.join(", ")));
 }
 
 void FacilitySystem::addBuilding()
@@ -8,6 +8,8 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QTabWidget>
+#include <QLineEdit>
+#include <QLabel>
 #include "../../modules/facility/facilityrepository.h"
 
 class FacilitySystem : public QWidget {
@@ -44,6 +46,13 @@ private:
     QPushButton *m_btnAddRoom;
     QPushButton *m_btnEditRoom;
     QPushButton *m_btnDeleteRoom;
+    QLineEdit *m_roomSearch;
+    QPushButton *m_btnPrevPage;
+    QPushButton *m_btnNextPage;
+    QLabel *m_pageLabel;
+    QLabel *m_overviewLabel;
+    int m_roomOffset = 0;
+    static constexpr int RoomsPerPage = 50;
 
     void setupUi();
     void setupBuildingsTab();
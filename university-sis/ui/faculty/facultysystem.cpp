@@ -1,4 +1,5 @@
 #include "facultysystem.h"
+#include "../../utils/tracer.h"
 #include "facultydialog.h"
 #include <QHeaderView>
 #include <QMessageBox>
@@ -81,6 +82,7 @@ void FacultySystem::styleTable()
 
 void FacultySystem::loadFaculty()
 {
+    SIS_TRACE_SCOPE("ui", "FacultySystem::loadFaculty");
     m_model->removeRows(0, m_model->rowCount());
     auto list = m_repo.getAllFaculty();
     
@@ -1,4 +1,5 @@
 #include "financesystem.h"
+#include "../../utils/tracer.h"
 #include "paymentdialog.h"
 #include <QHeaderView>
 #include <QMessageBox>
@@ -81,6 +82,7 @@ void FinanceSystem::styleTable()
 
 void FinanceSystem::loadPayments()
 {
+    SIS_TRACE_SCOPE("ui", "FinanceSystem::loadPayments");
     m_model->removeRows(0, m_model->rowCount());
     auto payments = m_repo.getAllPaymentsWithNames();
     
@@ -92,9 +94,9 @@ void FinanceSystem::loadPayments()
         row << new QStandardItem(QString("$%1").arg(p.amount, 0, 'f', 2));
         row << new QStandardItem(p.description);
         
-        auto statusItem = new QStandardItem(p.status);
-        if (p.status == "Paid") statusItem->setForeground(QBrush(QColor("#27ae60")));
-        else if (p.status == "Overdue") statusItem->setForeground(QBrush(QColor("#c0392b")));
+        auto statusItem = new QStandardItem(Payment::statusToString(p.status));
+        if (p.status == PaymentStatus::Paid) statusItem->setForeground(QBrush(QColor("#27ae60")));
+        else if (p.status == PaymentStatus::Overdue) statusItem->setForeground(QBrush(QColor("#c0392b")));
         else statusItem->setForeground(QBrush(QColor("#f39c12")));
         
         row << statusItem;
@@ -46,7 +46,9 @@ void PaymentDialog::setupUi()
     m_descEdit->setStyleSheet("QLineEdit { padding: 8px; border: 1px solid #bdc3c7; border-radius: 4px; }");
     
     m_statusEdit = new QComboBox();
-    m_statusEdit->addItems({"Pending", "Paid", "Overdue"});
+    for (PaymentStatus status : {PaymentStatus::Pending, PaymentStatus::Paid, PaymentStatus::Overdue}) {
+        m_statusEdit->addItem(Payment::statusToString(status), int(status));
+    }
     m_statusEdit->setStyleSheet("QComboBox { padding: 8px; border: 1px solid #bdc3c7; border-radius: 4px; }");
     
     m_dateEdit = new QDateEdit();
@@ -59,7 +61,7 @@ void PaymentDialog::setupUi()
         m_studentIdEdit->setValue(m_payment.studentId);
         m_amountEdit->setValue(m_payment.amount);
         m_descEdit->setText(m_payment.description);
-        m_statusEdit->setCurrentText(m_payment.status);
+        m_statusEdit->setCurrentIndex(m_statusEdit->findData(int(m_payment.status)));
         m_dateEdit->setDate(m_payment.date);
     } else {
         m_dateEdit->setDate(QDate::currentDate());
@@ -106,7 +108,7 @@ void PaymentDialog::onSave()
     m_payment.studentId = m_studentIdEdit->value();
     m_payment.amount = m_amountEdit->value();
     m_payment.description = m_descEdit->text();
-    m_payment.status = m_statusEdit->currentText();
+    m_payment.status = Payment::statusFromId(m_statusEdit->currentData().toInt());
     m_payment.date = m_dateEdit->date();
 
     accept();
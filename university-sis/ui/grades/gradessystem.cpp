@@ -1,4 +1,5 @@
 #include "gradessystem.h"
+#include "../../utils/tracer.h"
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QSqlQuery>
@@ -6,12 +7,22 @@
 #include <QStringList>
 #include <QInputDialog>
 #include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "../../modules/session/sessiondataservice.h"
+#include "../../modules/grades/graderepository.h"
+#include "../../modules/grades/gradecalculator.h"
+#include <QSet>
 
 GradesSystem::GradesSystem(QWidget *parent)
     : BaseSystemWidget("Grades & Transcripts", parent)
     , m_userId(0)
 {
     setupUi();
+    connect(&SessionDataService::instance(), &SessionDataService::loaded, this, [this](bool) {
+        if (m_role == "Student") {
+            loadCourses();
+        }
+    });
 }
 
 void GradesSystem::setUserContext(const QString& role, int userId)
@@ -22,7 +33,7 @@ void GradesSystem::setUserContext(const QString& role, int userId)
     // Reload student combo if admin/faculty
     if (m_role != "Student" && m_studentCombo) {
         m_studentCombo->clear();
-        QSqlQuery studentQuery(DatabaseManager::instance().getDatabase());
+        ProfiledQuery studentQuery(DatabaseManager::instance().getDatabase(), SIS_QUERY_SITE);
         studentQuery.exec("SELECT student_id, name FROM students ORDER BY name");
         while (studentQuery.next()) {
             QString text = studentQuery.value("name").toString() + " (ID: " + studentQuery.value("student_id").toString() + ")";
@@ -100,7 +111,7 @@ void GradesSystem::setupUi()
     if (m_role != "Student") {
         formLayout->addWidget(new QLabel("Student:"));
         m_studentCombo = new QComboBox(this);
-        QSqlQuery studentQuery(DatabaseManager::instance().getDatabase());
+        ProfiledQuery studentQuery(DatabaseManager::instance().getDatabase(), SIS_QUERY_SITE);
         studentQuery.exec("SELECT student_id, name FROM students ORDER BY name");
         while (studentQuery.next()) {
             QString text = studentQuery.value("name").toString() + " (ID: " + studentQuery.value("student_id").toString() + ")";
@@ -115,7 +126,7 @@ void GradesSystem::setupUi()
     formLayout->addWidget(new QLabel("Course:"));
     QComboBox *courseFormCombo = new QComboBox(this);
     courseFormCombo->setObjectName("courseFormCombo");
-    QSqlQuery courseQuery(DatabaseManager::instance().getDatabase());
+    ProfiledQuery courseQuery(DatabaseManager::instance().getDatabase(), SIS_QUERY_SITE);
     courseQuery.exec("SELECT course_id, name FROM courses ORDER BY name");
     while (courseQuery.next()) {
         QString text = courseQuery.value("name").toString();
@@ -161,10 +172,27 @@ void GradesSystem::setupUi()
 
 void GradesSystem::loadCourses()
 {
+    SIS_TRACE_SCOPE("ui", "GradesSystem::loadCourses");
     m_courseCombo->clear();
     m_courseCombo->addItem("All Courses", -1);
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    // Students: course list from the session prefetch (already ordered by name)
+    auto data = m_role == "Student" ? SessionDataService::instance().snapshot() : nullptr;
+    if (data) {
+        QSet<int> seen;
+        for (const auto& e : data->enrollments) {
+            if (e.courseId > 0 && !seen.contains(e.courseId)) {
+                seen.insert(e.courseId);
+                m_courseCombo->addItem(e.courseName, e.courseId);
+            }
+        }
+        if (m_courseCombo->count() > 1) {
+            onCourseChanged(0);
+        }
+        return;
+    }
+    
+    ProfiledQuery query(DatabaseManager::instance().getDatabase(), SIS_QUERY_SITE);
     if (m_role == "Student") {
         query.prepare("SELECT DISTINCT c.course_id, c.name as course_name "
                      "FROM courses c "
@@ -204,112 +232,86 @@ void GradesSystem::onCourseChanged(int index)
 
 void GradesSystem::loadGrades(int courseId)
 {
+    SIS_TRACE_SCOPE("ui", "GradesSystem::loadGrades");
     m_gradesModel->removeRows(0, m_gradesModel->rowCount());
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    QString baseQuery = "SELECT g.student_id, s.name as student_name, c.course_id, c.name as course_name, "
-                        "g.a1, g.a2, g.final_exam, g.total "
-                        "FROM grades g "
-                        "LEFT JOIN students s ON g.student_id = s.student_id "
-                        "LEFT JOIN courses c ON g.course_id = c.course_id "
-                        "WHERE 1=1";
-    
-    if (m_role == "Student") {
-        baseQuery += " AND g.student_id = :student_id";
-    }
-    
-    if (courseId != -1) {
-        baseQuery += " AND g.course_id = :course_id";
-    }
-    
-    baseQuery += " ORDER BY c.name, s.name";
-    
-    query.prepare(baseQuery);
-    
-    if (m_role == "Student") {
-        query.bindValue(":student_id", m_userId);
-    }
-    if (courseId != -1) {
-        query.bindValue(":course_id", courseId);
-    }
-    
-    if (query.exec()) {
-        while (query.next()) {
-            int row = m_gradesModel->rowCount();
+    GradeRepository repo;
+    const std::vector<GradeRecord> grades = repo.getGrades(courseId, m_role == "Student" ? m_userId : -1);
+    for (const GradeRecord& grade : grades) {
+        int row = m_gradesModel->rowCount();
+        m_gradesModel->insertRow(row);
+        
+        const QString& courseName = grade.courseName;
+        QString studentName = m_role == "Student" ? "" : grade.studentName;
+        const QString& a1 = grade.a1;
+        const QString& a2 = grade.a2;
+        const QString& finalExam = grade.finalExam;
+        const QString& total = grade.total;
+        
+        // Adjust columns based on role
+        if (m_role == "Student") {
+            m_gradesModel->setItem(row, 0, new QStandardItem(courseName));
+            m_gradesModel->setItem(row, 1, new QStandardItem("Assignment 1"));
+            m_gradesModel->setItem(row, 2, new QStandardItem("Assignment"));
+            m_gradesModel->setItem(row, 3, new QStandardItem(a1.isEmpty() ? "N/A" : a1));
+            m_gradesModel->setItem(row, 4, new QStandardItem("--"));
+            m_gradesModel->setItem(row, 5, new QStandardItem("--"));
+            m_gradesModel->setItem(row, 6, new QStandardItem(""));
+            
+            // Store student_id and course_id for reference
+            m_gradesModel->item(row, 0)->setData(grade.studentId, Qt::UserRole);
+            m_gradesModel->item(row, 0)->setData(grade.courseId, Qt::UserRole + 1);
+            
+            // Add row for Assignment 2
+            row = m_gradesModel->rowCount();
             m_gradesModel->insertRow(row);
+            m_gradesModel->setItem(row, 0, new QStandardItem(courseName));
+            m_gradesModel->setItem(row, 1, new QStandardItem("Assignment 2"));
+            m_gradesModel->setItem(row, 2, new QStandardItem("Assignment"));
+            m_gradesModel->setItem(row, 3, new QStandardItem(a2.isEmpty() ? "N/A" : a2));
+            m_gradesModel->setItem(row, 4, new QStandardItem("--"));
+            m_gradesModel->setItem(row, 5, new QStandardItem("--"));
+            m_gradesModel->setItem(row, 6, new QStandardItem(""));
             
-            QString courseName = query.value("course_name").toString();
-            QString studentName = m_role == "Student" ? "" : query.value("student_name").toString();
-            QString a1 = query.value("a1").toString();
-            QString a2 = query.value("a2").toString();
-            QString finalExam = query.value("final_exam").toString();
-            QString total = query.value("total").toString();
+            // Add row for Final Exam
+            row = m_gradesModel->rowCount();
+            m_gradesModel->insertRow(row);
+            m_gradesModel->setItem(row, 0, new QStandardItem(courseName));
+            m_gradesModel->setItem(row, 1, new QStandardItem("Final Exam"));
+            m_gradesModel->setItem(row, 2, new QStandardItem("Exam"));
+            m_gradesModel->setItem(row, 3, new QStandardItem(finalExam.isEmpty() ? "N/A" : finalExam));
+            m_gradesModel->setItem(row, 4, new QStandardItem("--"));
+            m_gradesModel->setItem(row, 5, new QStandardItem("--"));
+            m_gradesModel->setItem(row, 6, new QStandardItem(""));
             
-            // Adjust columns based on role
-            if (m_role == "Student") {
-                m_gradesModel->setItem(row, 0, new QStandardItem(courseName));
-                m_gradesModel->setItem(row, 1, new QStandardItem("Assignment 1"));
-                m_gradesModel->setItem(row, 2, new QStandardItem("Assignment"));
-                m_gradesModel->setItem(row, 3, new QStandardItem(a1.isEmpty() ? "N/A" : a1));
-                m_gradesModel->setItem(row, 4, new QStandardItem("--"));
-                m_gradesModel->setItem(row, 5, new QStandardItem("--"));
-                m_gradesModel->setItem(row, 6, new QStandardItem(""));
-                
-                // Store student_id and course_id for reference
-                m_gradesModel->item(row, 0)->setData(query.value("student_id").toInt(), Qt::UserRole);
-                m_gradesModel->item(row, 0)->setData(query.value("course_id").toInt(), Qt::UserRole + 1);
-                
-                // Add row for Assignment 2
-                row = m_gradesModel->rowCount();
-                m_gradesModel->insertRow(row);
-                m_gradesModel->setItem(row, 0, new QStandardItem(courseName));
-                m_gradesModel->setItem(row, 1, new QStandardItem("Assignment 2"));
-                m_gradesModel->setItem(row, 2, new QStandardItem("Assignment"));
-                m_gradesModel->setItem(row, 3, new QStandardItem(a2.isEmpty() ? "N/A" : a2));
-                m_gradesModel->setItem(row, 4, new QStandardItem("--"));
-                m_gradesModel->setItem(row, 5, new QStandardItem("--"));
-                m_gradesModel->setItem(row, 6, new QStandardItem(""));
-                
-                // Add row for Final Exam
-                row = m_gradesModel->rowCount();
-                m_gradesModel->insertRow(row);
-                m_gradesModel->setItem(row, 0, new QStandardItem(courseName));
-                m_gradesModel->setItem(row, 1, new QStandardItem("Final Exam"));
-                m_gradesModel->setItem(row, 2, new QStandardItem("Exam"));
-                m_gradesModel->setItem(row, 3, new QStandardItem(finalExam.isEmpty() ? "N/A" : finalExam));
-                m_gradesModel->setItem(row, 4, new QStandardItem("--"));
-                m_gradesModel->setItem(row, 5, new QStandardItem("--"));
-                m_gradesModel->setItem(row, 6, new QStandardItem(""));
-                
-                // Add row for Total
-                row = m_gradesModel->rowCount();
-                m_gradesModel->insertRow(row);
-                auto totalItem = new QStandardItem(total.isEmpty() ? "N/A" : total);
-                totalItem->setForeground(QBrush(QColor("#007AFF")));
-                QFont font = totalItem->font();
-                font.setBold(true);
-                totalItem->setFont(font);
-                m_gradesModel->setItem(row, 0, new QStandardItem(courseName));
-                m_gradesModel->setItem(row, 1, new QStandardItem("Total Grade"));
-                m_gradesModel->setItem(row, 2, new QStandardItem("Total"));
-                m_gradesModel->setItem(row, 3, totalItem);
-                m_gradesModel->setItem(row, 4, new QStandardItem("--"));
-                m_gradesModel->setItem(row, 5, new QStandardItem("--"));
-                m_gradesModel->setItem(row, 6, new QStandardItem(""));
-            } else {
-                // Admin/Faculty view - show student name
-                m_gradesModel->setItem(row, 0, new QStandardItem(studentName));
-                m_gradesModel->setItem(row, 1, new QStandardItem(courseName));
-                m_gradesModel->setItem(row, 2, new QStandardItem("A1: " + (a1.isEmpty() ? "N/A" : a1)));
-                m_gradesModel->setItem(row, 3, new QStandardItem("A2: " + (a2.isEmpty() ? "N/A" : a2)));
-                m_gradesModel->setItem(row, 4, new QStandardItem("Final: " + (finalExam.isEmpty() ? "N/A" : finalExam)));
-                m_gradesModel->setItem(row, 5, new QStandardItem("Total: " + (total.isEmpty() ? "N/A" : total)));
-                m_gradesModel->setItem(row, 6, new QStandardItem(""));
-                
-                // Store student_id and course_id for reference
-                m_gradesModel->item(row, 0)->setData(query.value("student_id").toInt(), Qt::UserRole);
-                m_gradesModel->item(row, 0)->setData(query.value("course_id").toInt(), Qt::UserRole + 1);
-            }
+            // Add row for Total
+            row = m_gradesModel->rowCount();
+            m_gradesModel->insertRow(row);
+            auto totalItem = new QStandardItem(total.isEmpty() ? "N/A" : total);
+            totalItem->setForeground(QBrush(QColor("#007AFF")));
+            QFont font = totalItem->font();
+            font.setBold(true);
+            totalItem->setFont(font);
+            m_gradesModel->setItem(row, 0, new QStandardItem(courseName));
+            m_gradesModel->setItem(row, 1, new QStandardItem("Total Grade"));
+            m_gradesModel->setItem(row, 2, new QStandardItem("Total"));
+            m_gradesModel->setItem(row, 3, totalItem);
+            m_gradesModel->setItem(row, 4, new QStandardItem("--"));
+            m_gradesModel->setItem(row, 5, new QStandardItem("--"));
+            m_gradesModel->setItem(row, 6, new QStandardItem(""));
+        } else {
+            // Admin/Faculty view - show student name
+            m_gradesModel->setItem(row, 0, new QStandardItem(studentName));
+            m_gradesModel->setItem(row, 1, new QStandardItem(courseName));
+            m_gradesModel->setItem(row, 2, new QStandardItem("A1: " + (a1.isEmpty() ? "N/A" : a1)));
+            m_gradesModel->setItem(row, 3, new QStandardItem("A2: " + (a2.isEmpty() ? "N/A" : a2)));
+            m_gradesModel->setItem(row, 4, new QStandardItem("Final: " + (finalExam.isEmpty() ? "N/A" : finalExam)));
+            m_gradesModel->setItem(row, 5, new QStandardItem("Total: " + (total.isEmpty() ? "N/A" : total)));
+            m_gradesModel->setItem(row, 6, new QStandardItem(""));
+            
+            // Store student_id and course_id for reference
+            m_gradesModel->item(row, 0)->setData(grade.studentId, Qt::UserRole);
+            m_gradesModel->item(row, 0)->setData(grade.courseId, Qt::UserRole + 1);
         }
     }
 }
@@ -337,181 +339,41 @@ void GradesSystem::onAddGrade()
     }
     
     // Check if student is enrolled in course
-    QSqlQuery checkQuery(DatabaseManager::instance().getDatabase());
-    checkQuery.prepare("SELECT COUNT(*) FROM student_section ss "
-                      "JOIN sections s ON ss.section_id = s.section_id "
-                      "WHERE ss.student_id = :student_id AND s.course_id = :course_id");
-    checkQuery.bindValue(":student_id", studentId);
-    checkQuery.bindValue(":course_id", courseId);
-    
-    if (!checkQuery.exec() || !checkQuery.next() || checkQuery.value(0).toInt() == 0) {
+    GradeRepository repo;
+    if (!repo.isEnrolled(studentId, courseId)) {
         QMessageBox::warning(this, "Enrollment Error", 
             "The selected student is not enrolled in this course.");
         return;
     }
     
-    // Map assignment type to grade field
-    QString assignmentType = m_assignmentTypeCombo->currentText();
-    QString gradeField;
-    if (assignmentType == "Assignment 1" || assignmentType == "A1") {
-        gradeField = "a1";
-    } else if (assignmentType == "Assignment 2" || assignmentType == "A2") {
-        gradeField = "a2";
-    } else if (assignmentType == "Final Exam" || assignmentType == "Final") {
-        gradeField = "final_exam";
-    } else {
+    // Assignment type combo order matches GradeComponent
+    int typeIndex = m_assignmentTypeCombo->currentIndex();
+    if (typeIndex < 0) {
         QMessageBox::warning(this, "Validation", 
             "Please select Assignment 1, Assignment 2, or Final Exam.");
         return;
     }
+    GradeComponent component = static_cast<GradeComponent>(typeIndex);
     
     // Convert percentage to letter grade (score is already percentage)
     double percentage = m_scoreSpin->value();
+    QString letterGrade = GradeCalculator::letterForPercentage(percentage);
     
-    QString letterGrade;
-    if (percentage >= 97) letterGrade = "A+";
-    else if (percentage >= 93) letterGrade = "A";
-    else if (percentage >= 90) letterGrade = "A-";
-    else if (percentage >= 87) letterGrade = "B+";
-    else if (percentage >= 83) letterGrade = "B";
-    else if (percentage >= 80) letterGrade = "B-";
-    else if (percentage >= 77) letterGrade = "C+";
-    else if (percentage >= 73) letterGrade = "C";
-    else if (percentage >= 70) letterGrade = "C-";
-    else if (percentage >= 67) letterGrade = "D+";
-    else if (percentage >= 63) letterGrade = "D";
-    else if (percentage >= 60) letterGrade = "D-";
-    else letterGrade = "F";
-    
-    // Check if grade record exists
-    QSqlQuery checkGradeQuery(DatabaseManager::instance().getDatabase());
-    checkGradeQuery.prepare("SELECT student_id, course_id FROM grades WHERE student_id = :student_id AND course_id = :course_id");
-    checkGradeQuery.bindValue(":student_id", studentId);
-    checkGradeQuery.bindValue(":course_id", courseId);
-    
-    bool recordExists = (checkGradeQuery.exec() && checkGradeQuery.next());
-    
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    if (recordExists) {
-        // Update existing record
-        QString updateSql;
-        if (gradeField == "a1") {
-            updateSql = "UPDATE grades SET a1 = :grade WHERE student_id = :student_id AND course_id = :course_id";
-        } else if (gradeField == "a2") {
-            updateSql = "UPDATE grades SET a2 = :grade WHERE student_id = :student_id AND course_id = :course_id";
-        } else if (gradeField == "final_exam") {
-            updateSql = "UPDATE grades SET final_exam = :grade WHERE student_id = :student_id AND course_id = :course_id";
-        } else {
-            QMessageBox::warning(this, "Error", "Invalid grade field.");
-            return;
-        }
-        query.prepare(updateSql);
-        query.bindValue(":grade", letterGrade);
-        query.bindValue(":student_id", studentId);
-        query.bindValue(":course_id", courseId);
-    } else {
-        // Insert new record
-        query.prepare("INSERT INTO grades (student_id, course_id, a1, a2, final_exam, total) "
-                     "VALUES (:student_id, :course_id, :a1, :a2, :final_exam, :total)");
-        query.bindValue(":student_id", studentId);
-        query.bindValue(":course_id", courseId);
-        query.bindValue(":a1", gradeField == "a1" ? letterGrade : "");
-        query.bindValue(":a2", gradeField == "a2" ? letterGrade : "");
-        query.bindValue(":final_exam", gradeField == "final_exam" ? letterGrade : "");
-        query.bindValue(":total", ""); // Will be calculated
-    }
-    
-    if (query.exec()) {
-        // Calculate and update total grade
-        QSqlQuery calcQuery(DatabaseManager::instance().getDatabase());
-        calcQuery.prepare("SELECT a1, a2, final_exam FROM grades WHERE student_id = :student_id AND course_id = :course_id");
-        calcQuery.bindValue(":student_id", studentId);
-        calcQuery.bindValue(":course_id", courseId);
-        
-        if (calcQuery.exec() && calcQuery.next()) {
-            QString a1 = calcQuery.value("a1").toString();
-            QString a2 = calcQuery.value("a2").toString();
-            QString finalExam = calcQuery.value("final_exam").toString();
-            
-            // Calculate total (weighted average)
-            QString totalGrade = calculateTotalGrade(a1, a2, finalExam);
-            
-            QSqlQuery updateTotalQuery(DatabaseManager::instance().getDatabase());
-            updateTotalQuery.prepare("UPDATE grades SET total = :total WHERE student_id = :student_id AND course_id = :course_id");
-            updateTotalQuery.bindValue(":total", totalGrade);
-            updateTotalQuery.bindValue(":student_id", studentId);
-            updateTotalQuery.bindValue(":course_id", courseId);
-            updateTotalQuery.exec();
-        }
-        
+    // Insert or update the component; the weighted total is recalculated with it
+    bool created = false;
+    if (repo.saveComponent(studentId, courseId, component, letterGrade, &created)) {
         QMessageBox::information(this, "Success", 
             QString("Grade '%1' (%2%) has been %3 successfully.")
             .arg(letterGrade).arg(QString::number(percentage, 'f', 1))
-            .arg(recordExists ? "updated" : "added"));
+            .arg(created ? "added" : "updated"));
         m_scoreSpin->setValue(85);  // Reset to default
         refreshGrades();
         calculateGPA();
     } else {
-        QMessageBox::critical(this, "Database Error", 
-            QString("Failed to add grade.\n\nError: %1").arg(query.lastError().text()));
+        QMessageBox::critical(this, "Database Error", "Failed to save grade.");
     }
 }
 
-QString GradesSystem::calculateTotalGrade(const QString& a1, const QString& a2, const QString& finalExam)
-{
-    // Convert letter grades to numeric values for calculation
-    auto gradeToNum = [](const QString& grade) -> double {
-        if (grade == "A+") return 4.0;
-        if (grade == "A") return 4.0;
-        if (grade == "A-") return 3.7;
-        if (grade == "B+") return 3.3;
-        if (grade == "B") return 3.0;
-        if (grade == "B-") return 2.7;
-        if (grade == "C+") return 2.3;
-        if (grade == "C") return 2.0;
-        if (grade == "C-") return 1.7;
-        if (grade == "D+") return 1.3;
-        if (grade == "D") return 1.0;
-        if (grade == "D-") return 0.7;
-        if (grade == "F") return 0.0;
-        return -1; // Invalid
-    };
-    
-    int count = 0;
-    double sum = 0;
-    
-    if (!a1.isEmpty()) {
-        double val = gradeToNum(a1);
-        if (val >= 0) { sum += val * 0.3; count++; }
-    }
-    if (!a2.isEmpty()) {
-        double val = gradeToNum(a2);
-        if (val >= 0) { sum += val * 0.3; count++; }
-    }
-    if (!finalExam.isEmpty()) {
-        double val = gradeToNum(finalExam);
-        if (val >= 0) { sum += val * 0.4; count++; }
-    }
-    
-    if (count == 0) return "";
-    
-    double avg = sum; // Already weighted
-    
-    // Convert back to letter grade
-    if (avg >= 3.85) return "A";
-    if (avg >= 3.5) return "A-";
-    if (avg >= 3.15) return "B+";
-    if (avg >= 2.85) return "B";
-    if (avg >= 2.5) return "B-";
-    if (avg >= 2.15) return "C+";
-    if (avg >= 1.85) return "C";
-    if (avg >= 1.5) return "C-";
-    if (avg >= 1.15) return "D+";
-    if (avg >= 0.85) return "D";
-    if (avg >= 0.5) return "D-";
-    return "F";
-}
-
 void GradesSystem::onDeleteGrade()
 {
     auto selection = m_gradesTable->selectionModel()->selectedRows();
@@ -534,7 +396,7 @@ void GradesSystem::onDeleteGrade()
     }
     
     // Get course and student names for confirmation
-    QSqlQuery nameQuery(DatabaseManager::instance().getDatabase());
+    ProfiledQuery nameQuery(DatabaseManager::instance().getDatabase(), SIS_QUERY_SITE);
     nameQuery.prepare("SELECT c.name as course_name, s.name as student_name "
                      "FROM courses c, students s "
                      "WHERE c.course_id = :course_id AND s.student_id = :student_id");
@@ -557,12 +419,8 @@ void GradesSystem::onDeleteGrade()
         return;
     }
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    query.prepare("DELETE FROM grades WHERE student_id = :student_id AND course_id = :course_id");
-    query.bindValue(":student_id", studentId);
-    query.bindValue(":course_id", courseId);
-    
-    if (query.exec()) {
+    GradeRepository repo;
+    if (repo.deleteGrades(studentId, courseId)) {
         QMessageBox::information(this, "Success", 
             QString("Grades for %1 in %2 have been deleted successfully.")
             .arg(studentName).arg(courseName));
@@ -570,7 +428,7 @@ void GradesSystem::onDeleteGrade()
         calculateGPA();
     } else {
         QMessageBox::critical(this, "Database Error", 
-            QString("Failed to delete grade.\n\nError: %1").arg(query.lastError().text()));
+            "Failed to delete grade.");
     }
 }
 
@@ -590,46 +448,11 @@ void GradesSystem::calculateGPA()
         return;
     }
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    query.prepare("SELECT total FROM grades WHERE student_id = :student_id AND total != '' AND total IS NOT NULL");
-    query.bindValue(":student_id", m_userId);
-    
-    // Convert letter grades to GPA points
-    auto gradeToGPA = [](const QString& grade) -> double {
-        if (grade == "A+" || grade == "A") return 4.0;
-        if (grade == "A-") return 3.7;
-        if (grade == "B+") return 3.3;
-        if (grade == "B") return 3.0;
-        if (grade == "B-") return 2.7;
-        if (grade == "C+") return 2.3;
-        if (grade == "C") return 2.0;
-        if (grade == "C-") return 1.7;
-        if (grade == "D+") return 1.3;
-        if (grade == "D") return 1.0;
-        if (grade == "D-") return 0.7;
-        if (grade == "F") return 0.0;
-        return -1;
-    };
-    
-    double sumGPA = 0;
-    int count = 0;
-    
-    if (query.exec()) {
-        while (query.next()) {
-            QString total = query.value("total").toString();
-            double gpa = gradeToGPA(total);
-            if (gpa >= 0) {
-                sumGPA += gpa;
-                count++;
-            }
-        }
-    }
-    
-    if (count > 0) {
-        double avgGPA = sumGPA / count;
-        m_gpaLabel->setText(QString("GPA: %1").arg(avgGPA, 0, 'f', 2));
+    GradeRepository repo;
+    std::optional<double> gpa = repo.computeGpa(m_userId);
+    if (gpa) {
+        m_gpaLabel->setText(QString("GPA: %1").arg(*gpa, 0, 'f', 2));
     } else {
         m_gpaLabel->setText("GPA: --");
     }
 }
-
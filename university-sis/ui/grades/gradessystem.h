@@ -32,7 +32,6 @@ private:
     void setupUi();
     void loadCourses();
     void loadGrades(int courseId);
-    QString calculateTotalGrade(const QString& a1, const QString& a2, const QString& finalExam);
     
     QString m_role;
     int m_userId;
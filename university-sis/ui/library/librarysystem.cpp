@@ -1,13 +1,13 @@
 #include "librarysystem.h"
+#include "../../utils/tracer.h"
 #include "../../modules/student/studentrepository.h"
 #include "../../modules/faculty/facultyrepository.h"
+#include "../../modules/library/libraryrepository.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QHeaderView>
 #include <QMessageBox>
-#include <QSqlQuery>
-#include <QSqlError>
 #include <QInputDialog>
 #include <QDateEdit>
 #include <QSpinBox>
@@ -19,8 +19,6 @@
 #include <QStandardItem>
 #include <QBrush>
 #include <QColor>
-#include <QPair>
-#include "../../database/databasemanager.h"
 
 LibrarySystem::LibrarySystem(QWidget* parent) 
     : BaseSystemWidget("Library System", parent)
@@ -127,61 +125,36 @@ void LibrarySystem::onFilterChanged(int index) {
 }
 
 void LibrarySystem::loadBooks(const QString& filter) {
+    SIS_TRACE_SCOPE("ui", "LibrarySystem::loadBooks");
     m_model->removeRows(0, m_model->rowCount());
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    // Status filter; combo order matches BookFilter
+    BookFilter bookFilter = static_cast<BookFilter>(qMax(0, m_filterCombo->currentIndex()));
     
-    QString whereClause = "WHERE 1=1";
-    
-    // Apply search filter
-    if (!filter.isEmpty()) {
-        whereClause += QString(" AND (title LIKE '%%1%' OR author LIKE '%%1%' OR isbn LIKE '%%1%' OR category LIKE '%%1%')")
-                      .arg(filter);
-    }
-    
-    // Apply status filter
-    QString filterText = m_filterCombo->currentText();
-    if (filterText == "Available") {
-        whereClause += " AND available_copies > 0";
-    } else if (filterText == "Checked Out") {
-        whereClause += " AND available_copies < total_copies";
-    } else if (filterText == "Overdue") {
-        // This would require a join with book_loans, simplified for now
-        whereClause += " AND available_copies < total_copies";
-    }
-    
-    query.prepare(QString("SELECT book_id, isbn, title, author, category, available_copies, total_copies, location "
-                  "FROM books %1 ORDER BY title").arg(whereClause));
-    
-    if (query.exec()) {
-        while (query.next()) {
-            int row = m_model->rowCount();
-            m_model->insertRow(row);
-            
-            int bookId = query.value("book_id").toInt();
-            int available = query.value("available_copies").toInt();
-            int total = query.value("total_copies").toInt();
-            
-            m_model->setItem(row, 0, new QStandardItem(query.value("isbn").toString()));
-            m_model->setItem(row, 1, new QStandardItem(query.value("title").toString()));
-            m_model->setItem(row, 2, new QStandardItem(query.value("author").toString()));
-            m_model->setItem(row, 3, new QStandardItem(query.value("category").toString()));
-            
-            // Available copies with color coding
-            auto availableItem = new QStandardItem(QString::number(available));
-            if (available > 0) {
-                availableItem->setForeground(QColor("#34C759")); // Green
-            } else {
-                availableItem->setForeground(QColor("#FF3B30")); // Red
-            }
-            m_model->setItem(row, 4, availableItem);
-            
-            m_model->setItem(row, 5, new QStandardItem(QString::number(total)));
-            m_model->setItem(row, 6, new QStandardItem(query.value("location").toString()));
-            
-            // Store book_id in first column for reference
-            m_model->item(row, 0)->setData(bookId, Qt::UserRole);
+    LibraryRepository repo;
+    for (const Book& book : repo.getBooks(filter, bookFilter)) {
+        int row = m_model->rowCount();
+        m_model->insertRow(row);
+        
+        m_model->setItem(row, 0, new QStandardItem(book.isbn));
+        m_model->setItem(row, 1, new QStandardItem(book.title));
+        m_model->setItem(row, 2, new QStandardItem(book.author));
+        m_model->setItem(row, 3, new QStandardItem(book.category));
+        
+        // Available copies with color coding
+        auto availableItem = new QStandardItem(QString::number(book.availableCopies));
+        if (book.availableCopies > 0) {
+            availableItem->setForeground(QColor("#34C759")); // Green
+        } else {
+            availableItem->setForeground(QColor("#FF3B30")); // Red
         }
+        m_model->setItem(row, 4, availableItem);
+        
+        m_model->setItem(row, 5, new QStandardItem(QString::number(book.totalCopies)));
+        m_model->setItem(row, 6, new QStandardItem(book.location));
+        
+        // Store book_id in first column for reference
+        m_model->item(row, 0)->setData(book.id, Qt::UserRole);
     }
 }
 
@@ -286,25 +259,25 @@ void LibrarySystem::onAddBook() {
             return;
         }
         
-        QSqlQuery query(DatabaseManager::instance().getDatabase());
-        query.prepare("INSERT INTO books (isbn, title, author, publisher, publication_year, category, total_copies, available_copies, location) "
-                      "VALUES (:isbn, :title, :author, :publisher, :year, :category, :copies, :copies, :location)");
-        query.bindValue(":isbn", isbnEdit->text().trimmed());
-        query.bindValue(":title", titleEdit->text().trimmed());
-        query.bindValue(":author", authorEdit->text().trimmed());
-        query.bindValue(":publisher", publisherEdit->text().trimmed());
-        query.bindValue(":year", yearSpin->value());
-        query.bindValue(":category", categoryEdit->text().trimmed());
-        query.bindValue(":copies", copiesSpin->value());
-        query.bindValue(":location", locationEdit->text().trimmed());
+        Book book;
+        book.isbn = isbnEdit->text().trimmed();
+        book.title = titleEdit->text().trimmed();
+        book.author = authorEdit->text().trimmed();
+        book.publisher = publisherEdit->text().trimmed();
+        book.year = yearSpin->value();
+        book.category = categoryEdit->text().trimmed();
+        book.totalCopies = copiesSpin->value();
+        book.availableCopies = book.totalCopies;
+        book.location = locationEdit->text().trimmed();
         
-        if (query.exec()) {
+        LibraryRepository repo;
+        if (repo.addBook(book)) {
             QMessageBox::information(this, "Success", 
                 QString("Book '%1' has been added successfully.").arg(titleEdit->text()));
             refreshBooks();
         } else {
             QMessageBox::critical(this, "Database Error", 
-                QString("Failed to add book.\n\nError: %1").arg(query.lastError().text()));
+                "Failed to add book. Please check that the ISBN is unique.");
         }
     }
 }
@@ -485,39 +458,24 @@ void LibrarySystem::onCheckOutBook() {
         return; // User cancelled
     }
     
-    // Calculate due date (14 days from now)
-    QDate checkoutDate = QDate::currentDate();
-    QDate dueDate = checkoutDate.addDays(14);
-    
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
+    BookLoan loan;
+    loan.bookId = bookId;
     if (borrower.type == "Student") {
-        query.prepare("INSERT INTO book_loans (book_id, student_id, checkout_date, due_date, status) "
-                      "VALUES (:book_id, :student_id, :checkout_date, :due_date, 'Checked Out')");
-        query.bindValue(":book_id", bookId);
-        query.bindValue(":student_id", borrower.id);
+        loan.studentId = borrower.id;
     } else {
-        query.prepare("INSERT INTO book_loans (book_id, faculty_id, checkout_date, due_date, status) "
-                      "VALUES (:book_id, :faculty_id, :checkout_date, :due_date, 'Checked Out')");
-        query.bindValue(":book_id", bookId);
-        query.bindValue(":faculty_id", borrower.id);
+        loan.facultyId = borrower.id;
     }
-    query.bindValue(":checkout_date", checkoutDate.toString("yyyy-MM-dd"));
-    query.bindValue(":due_date", dueDate.toString("yyyy-MM-dd"));
-    
-    if (query.exec()) {
-        // Update available copies
-        QSqlQuery updateQuery(DatabaseManager::instance().getDatabase());
-        updateQuery.prepare("UPDATE books SET available_copies = available_copies - 1 WHERE book_id = :id");
-        updateQuery.bindValue(":id", bookId);
-        updateQuery.exec();
-        
+    
+    LibraryRepository repo;
+    if (repo.checkOut(loan)) {
         QMessageBox::information(this, "Success", 
             QString("'%1' has been checked out to %2 (%3).\n\nDue Date: %4")
-            .arg(bookTitle).arg(borrower.name).arg(borrower.type).arg(dueDate.toString("MMMM dd, yyyy")));
+            .arg(bookTitle).arg(borrower.name).arg(borrower.type).arg(loan.dueDate.toString("MMMM dd, yyyy")));
         refreshBooks();
     } else {
         QMessageBox::critical(this, "Database Error", 
-            QString("Failed to check out book.\n\nError: %1").arg(query.lastError().text()));
+            QString("Failed to check out '%1'. No copy may be available any more.").arg(bookTitle));
+        refreshBooks();
     }
 }
 
@@ -541,45 +499,17 @@ void LibrarySystem::onReturnBook() {
     }
     
     // Find active loans for this book with borrower names
-    QSqlQuery findQuery(DatabaseManager::instance().getDatabase());
-    findQuery.prepare("SELECT bl.loan_id, bl.student_id, bl.faculty_id, bl.due_date, "
-                      "COALESCE(s.name, f.name) as borrower_name, "
-                      "CASE WHEN bl.student_id IS NOT NULL THEN 'Student' ELSE 'Faculty' END as borrower_type "
-                      "FROM book_loans bl "
-                      "LEFT JOIN students s ON bl.student_id = s.student_id "
-                      "LEFT JOIN faculty f ON bl.faculty_id = f.faculty_id "
-                      "WHERE bl.book_id = :book_id AND bl.status = 'Checked Out' "
-                      "ORDER BY bl.checkout_date DESC");
-    findQuery.bindValue(":book_id", bookId);
-    
-    if (!findQuery.exec()) {
-        QMessageBox::warning(this, "No Active Loan", 
-            QString("No active loan found for '%1'.").arg(bookTitle));
-        return;
-    }
-    
-    // Collect all loans first
-    QList<QPair<int, QPair<QDate, QString>>> loans;
-    while (findQuery.next()) {
-        loans.append(qMakePair(
-            findQuery.value("loan_id").toInt(),
-            qMakePair(
-                findQuery.value("due_date").toDate(),
-                findQuery.value("borrower_name").toString()
-            )
-        ));
-    }
+    LibraryRepository repo;
+    std::vector<BookLoan> loans = repo.getOpenLoans(bookId);
     
-    if (loans.isEmpty()) {
+    if (loans.empty()) {
         QMessageBox::warning(this, "No Active Loan", 
             QString("No active loan found for '%1'.").arg(bookTitle));
         return;
     }
     
     // If multiple loans, let user select which one to return
-    int loanId = -1;
-    QDate dueDate;
-    QString borrowerName;
+    BookLoan loan = loans.front();
     
     if (loans.size() > 1) {
         // Multiple loans - show selection dialog
@@ -601,27 +531,13 @@ void LibrarySystem::onReturnBook() {
         table->horizontalHeader()->setStretchLastSection(true);
         table->verticalHeader()->setVisible(false);
         
-        // Re-query to get borrower type
-        QSqlQuery typeQuery(DatabaseManager::instance().getDatabase());
-        typeQuery.prepare("SELECT bl.loan_id, bl.student_id, bl.faculty_id, bl.due_date, "
-                          "COALESCE(s.name, f.name) as borrower_name, "
-                          "CASE WHEN bl.student_id IS NOT NULL THEN 'Student' ELSE 'Faculty' END as borrower_type "
-                          "FROM book_loans bl "
-                          "LEFT JOIN students s ON bl.student_id = s.student_id "
-                          "LEFT JOIN faculty f ON bl.faculty_id = f.faculty_id "
-                          "WHERE bl.book_id = :book_id AND bl.status = 'Checked Out' "
-                          "ORDER BY bl.checkout_date DESC");
-        typeQuery.bindValue(":book_id", bookId);
-        typeQuery.exec();
-        
-        while (typeQuery.next()) {
+        for (int i = 0; i < int(loans.size()); ++i) {
             int row = model->rowCount();
             model->insertRow(row);
-            model->setItem(row, 0, new QStandardItem(typeQuery.value("borrower_name").toString()));
-            model->setItem(row, 1, new QStandardItem(typeQuery.value("borrower_type").toString()));
-            model->setItem(row, 2, new QStandardItem(typeQuery.value("due_date").toDate().toString("yyyy-MM-dd")));
-            model->item(row, 0)->setData(typeQuery.value("loan_id").toInt(), Qt::UserRole);
-            model->item(row, 0)->setData(typeQuery.value("due_date").toDate(), Qt::UserRole + 1);
+            model->setItem(row, 0, new QStandardItem(loans[i].borrowerName));
+            model->setItem(row, 1, new QStandardItem(loans[i].borrowerType()));
+            model->setItem(row, 2, new QStandardItem(loans[i].dueDate.toString("yyyy-MM-dd")));
+            model->item(row, 0)->setData(i, Qt::UserRole);
         }
         layout->addWidget(table);
         
@@ -630,48 +546,22 @@ void LibrarySystem::onReturnBook() {
         connect(buttonBox, &QDialogButtonBox::rejected, &selectDialog, &QDialog::reject);
         layout->addWidget(buttonBox);
         
-        if (selectDialog.exec() == QDialog::Accepted) {
-            auto selected = table->selectionModel()->selectedRows();
-            if (!selected.isEmpty()) {
-                int selectedRow = selected.first().row();
-                loanId = model->item(selectedRow, 0)->data(Qt::UserRole).toInt();
-                dueDate = model->item(selectedRow, 0)->data(Qt::UserRole + 1).toDate();
-                borrowerName = model->item(selectedRow, 0)->text();
-            } else {
-                return; // No selection
-            }
-        } else {
+        if (selectDialog.exec() != QDialog::Accepted) {
             return; // User cancelled
         }
-    } else {
-        // Single loan
-        loanId = findQuery.value("loan_id").toInt();
-        dueDate = findQuery.value("due_date").toDate();
-        borrowerName = findQuery.value("borrower_name").toString();
-    }
-    
-    if (loanId == -1) {
-        return;
+        auto selected = table->selectionModel()->selectedRows();
+        if (selected.isEmpty()) {
+            return; // No selection
+        }
+        loan = loans[model->item(selected.first().row(), 0)->data(Qt::UserRole).toInt()];
     }
     
     QDate returnDate = QDate::currentDate();
     
-    // Update loan status
-    QSqlQuery updateLoanQuery(DatabaseManager::instance().getDatabase());
-    updateLoanQuery.prepare("UPDATE book_loans SET return_date = :return_date, status = 'Returned' WHERE loan_id = :loan_id");
-    updateLoanQuery.bindValue(":return_date", returnDate.toString("yyyy-MM-dd"));
-    updateLoanQuery.bindValue(":loan_id", loanId);
-    
-    if (updateLoanQuery.exec()) {
-        // Update available copies
-        QSqlQuery updateBookQuery(DatabaseManager::instance().getDatabase());
-        updateBookQuery.prepare("UPDATE books SET available_copies = available_copies + 1 WHERE book_id = :id");
-        updateBookQuery.bindValue(":id", bookId);
-        updateBookQuery.exec();
-        
-        QString message = QString("'%1' has been returned successfully.\nBorrower: %2").arg(bookTitle).arg(borrowerName);
-        if (returnDate > dueDate) {
-            int daysOverdue = dueDate.daysTo(returnDate);
+    if (repo.returnLoan(loan, returnDate)) {
+        QString message = QString("'%1' has been returned successfully.\nBorrower: %2").arg(bookTitle).arg(loan.borrowerName);
+        if (returnDate > loan.dueDate) {
+            int daysOverdue = loan.dueDate.daysTo(returnDate);
             message += QString("\n\nNote: This book was %1 day(s) overdue.").arg(daysOverdue);
         }
         
@@ -679,7 +569,7 @@ void LibrarySystem::onReturnBook() {
         refreshBooks();
     } else {
         QMessageBox::critical(this, "Database Error", 
-            QString("Failed to return book.\n\nError: %1").arg(updateLoanQuery.lastError().text()));
+            QString("Failed to return '%1'.").arg(bookTitle));
     }
 }
 
@@ -711,16 +601,13 @@ void LibrarySystem::onDeleteBook() {
         return;
     }
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    query.prepare("DELETE FROM books WHERE book_id = :id");
-    query.bindValue(":id", bookId);
-    
-    if (query.exec()) {
+    LibraryRepository repo;
+    if (repo.deleteBook(bookId)) {
         QMessageBox::information(this, "Success", 
             QString("'%1' has been deleted successfully.").arg(bookTitle));
         refreshBooks();
     } else {
         QMessageBox::critical(this, "Database Error", 
-            QString("Failed to delete book.\n\nError: %1").arg(query.lastError().text()));
+            QString("Failed to delete '%1'.").arg(bookTitle));
     }
 }
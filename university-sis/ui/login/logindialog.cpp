@@ -11,8 +11,7 @@
 #include <QPainter>
 #include <QPainterPath>
 #include "../../database/databasemanager.h"
-#include "../../modules/student/studentrepository.h"
-#include "../../modules/faculty/facultyrepository.h"
+#include "../../modules/auth/authservice.h"
 
 // Custom Widget for Background with Image
 class BackgroundWidget : public QWidget {
@@ -130,40 +129,6 @@ LoginDialog::LoginDialog(QWidget *parent) : QDialog(parent)
     m_passEdit = createInput("Password", true);
     cardLayout->addWidget(m_passEdit);
 
-    // Role Selection - macOS Style
-    m_roleCombo = new QComboBox();
-    m_roleCombo->addItems({"Administrator", "Student", "Faculty Member", "Finance Officer", "Registrar Officer"});
-    m_roleCombo->setStyleSheet(
-        "QComboBox {"
-        "   padding: 8px 12px;"
-        "   background-color: rgba(255, 255, 255, 240);"
-        "   border: 0.5px solid rgba(209, 209, 214, 0.8);"
-        "   border-radius: 6px;"
-        "   font-size: 13px;"
-        "   color: #1D1D1F;"
-        "   font-weight: 400;"
-        "}"
-        "QComboBox:hover {"
-        "   background-color: rgba(255, 255, 255, 250);"
-        "   border-color: rgba(199, 199, 204, 0.8);"
-        "}"
-        "QComboBox:focus {"
-        "   background-color: #ffffff;"
-        "   border: 0.5px solid #007AFF;"
-        "}"
-        "QComboBox::drop-down { border: none; width: 24px; }"
-        "QComboBox::down-arrow { width: 0; height: 0; border-left: 4px solid transparent; border-right: 4px solid transparent; border-top: 5px solid #8E8E93; }"
-        "QComboBox QAbstractItemView {"
-        "   background-color: #ffffff;"
-        "   border: 0.5px solid #D1D1D6;"
-        "   border-radius: 8px;"
-        "   selection-background-color: #007AFF;"
-        "   selection-color: white;"
-        "   padding: 4px;"
-        "}"
-    );
-    cardLayout->addWidget(m_roleCombo);
-
     cardLayout->addSpacing(10);
 
     // Action Button - macOS Style
@@ -204,74 +169,24 @@ void LoginDialog::onLogin()
 {
     QString user = m_userEdit->text().trimmed();
     QString pass = m_passEdit->text().trimmed();
-    QString role = m_roleCombo->currentText();
 
     if (user.isEmpty() || pass.isEmpty()) {
         QMessageBox::warning(this, "Login Failed", "Please enter both username and password.");
         return;
     }
 
-    // 1. Authenticate Student
-    if (role == "Student") {
-        StudentRepository repo;
-        auto student = repo.authenticate(user, pass);
-        if (student) {
-            m_session.username = student->username.isEmpty() ? student->name : student->username;
-            m_session.role = "Student";
-            m_session.userId = student->id;
-            accept();
-        } else {
-             QMessageBox::critical(this, "Login Failed", "Invalid username or password for Student.");
-        }
-        return; // Don't proceed to admin/default check
-    }
-
-    // 2. Default/Simulation for other roles (Admin, Faculty, etc.)
-    // In a real app, we would authenticate them against 'users' table or 'faculty' table.
-    // For now, we simulate success for Admin/Faculty as per previous setup, 
-    // unless you want to lock it down. Let's keep existing simulation for non-students for simplicity 
-    // BUT verify against admin hardcoded creds if role is Admin to be slightly safer.
-    
-    // 3. Authenticate Faculty
-    if (role == "Faculty Member") {
-        FacultyRepository repo;
-        auto faculty = repo.authenticate(user, pass);
-        if (faculty) {
-            m_session.username = faculty->username.isEmpty() ? faculty->name : faculty->username;
-            m_session.role = "Faculty Member";
-            m_session.userId = faculty->id;
-            accept();
-            return;
-        } else {
-            // Check fallback demo credentials
-            if (user == "faculty" && pass == "faculty123") {
-                m_session.username = "Dr. Simulation";
-                m_session.role = "Faculty Member";
-                m_session.userId = 999;
-                accept();
-                return;
-            }
-             QMessageBox::critical(this, "Login Failed", "Invalid credentials for Faculty.");
-             return;
-        }
+    // One lookup in users; the role and linked profile come from the account row
+    AuthService auth;
+    auto session = auth.login(user, pass);
+    if (!session) {
+        QMessageBox::critical(this, "Login Failed", "Invalid username or password.");
+        return;
     }
 
-    if (role == "Administrator") {
-        if (user == "admin" && pass == "1234") {
-            m_session.username = "Administrator";
-            m_session.role = "Administrator";
-            m_session.userId = 1;
-            accept();
-        } else {
-             QMessageBox::critical(this, "Login Failed", "Invalid Admin credentials (try admin/1234).");
-        }
-    } else {
-        // Fallback for Finance/Others simulation
-        m_session.username = user;
-        m_session.role = role;
-        m_session.userId = 999; 
-        accept();
-    }
+    m_session.username = session->user.role == "ADMIN" ? session->roleName : session->user.username;
+    m_session.role = session->roleName;
+    m_session.userId = session->profileId();
+    accept();
 }
 
 LoginDialog::UserSession LoginDialog::getSession() const {
@@ -3,7 +3,6 @@
 
 #include <QDialog>
 #include <QLineEdit>
-#include <QComboBox>
 
 class LoginDialog : public QDialog
 {
@@ -24,7 +23,6 @@ private slots:
 private:
     QLineEdit *m_userEdit;
     QLineEdit *m_passEdit;
-    QComboBox *m_roleCombo; // For simulation/demo purposes, or real auth
     UserSession m_session;
 };
 
@@ -1,4 +1,5 @@
 #include "newssystem.h"
+#include "../../utils/tracer.h"
 #include <QGraphicsDropShadowEffect>
 #include <QHBoxLayout>
 #include <QSqlQuery>
@@ -6,6 +7,9 @@
 #include <QDate>
 #include <QPushButton>
 #include "../../database/databasemanager.h"
+#include "../../database/queryprofiler.h"
+#include "../../modules/calendar/calendarrepository.h"
+#include <algorithm>
 
 NewsSystem::NewsSystem(QWidget* parent) : QWidget(parent) {
     auto layout = new QVBoxLayout(this);
@@ -97,46 +101,89 @@ NewsSystem::NewsSystem(QWidget* parent) : QWidget(parent) {
 
 void NewsSystem::loadEventsFromDatabase()
 {
+    SIS_TRACE_SCOPE("ui", "NewsSystem::loadEventsFromDatabase");
     clearNews();
     
-    QSqlQuery query(DatabaseManager::instance().getDatabase());
-    // Cross-database compatible date query - show events from last 7 days or future events
-    QString dateFilter;
-    if (DatabaseManager::instance().getDatabase().driverName() == "QSQLITE") {
-        dateFilter = "date >= DATE('now', '-7 days')";
-    } else {
-        dateFilter = "date >= DATE_SUB(CURDATE(), INTERVAL 7 DAY)";
+    // Items nearest to today: the next 20 upcoming one-off events plus the last week's,
+    // so far-future entries can't push out what is happening now
+    const QDate today = QDate::currentDate();
+    const QDate recentFrom = today.addDays(-7);
+    std::vector<CalendarEvent> events;
+    auto load = [&events](ProfiledQuery& query) {
+        if (!query.exec()) {
+            qDebug() << "Load News Events Error:" << query.lastError().text();
+            return;
+        }
+        while (query.next()) {
+            CalendarEvent e;
+            e.title = query.value("title").toString();
+            e.date = query.value("date").toDate();
+            e.time = QTime::fromString(query.value("time").toString().left(5), "HH:mm");
+            e.type = query.value("type").toString();
+            e.description = query.value("description").toString();
+            events.push_back(e);
+        }
+    };
+    QSqlDatabase db = DatabaseManager::instance().getDatabase();
+    ProfiledQuery upcoming(db, SIS_QUERY_SITE);
+    upcoming.prepare("SELECT title, date, time, type, description FROM calendar_events "
+                     "WHERE date >= :today ORDER BY date, time LIMIT 20");
+    upcoming.bindValue(":today", today.toString("yyyy-MM-dd"));
+    load(upcoming);
+    ProfiledQuery recent(db, SIS_QUERY_SITE);
+    recent.prepare("SELECT title, date, time, type, description FROM calendar_events "
+                   "WHERE date >= :from AND date < :today ORDER BY date DESC, time DESC LIMIT 20");
+    recent.bindValue(":from", recentFrom.toString("yyyy-MM-dd"));
+    recent.bindValue(":today", today.toString("yyyy-MM-dd"));
+    load(recent);
+    
+    // Recurring series are open ended, so only their occurrences in a short window are expanded
+    CalendarRepository repo;
+    for (const auto& series : repo.getSeriesInRange(recentFrom, today.addDays(RecurringWindowDays))) {
+        series.appendOccurrences(recentFrom, today.addDays(RecurringWindowDays), events);
     }
-    query.prepare(QString("SELECT title, date, time, type, description FROM calendar_events "
-                  "WHERE %1 "
-                  "ORDER BY date DESC, time DESC LIMIT 20").arg(dateFilter));
     
-    if (query.exec()) {
-        while (query.next()) {
-            QString title = query.value("title").toString();
-            QDate eventDate = query.value("date").toDate();
-            QString time = query.value("time").toString();
-            QString type = query.value("type").toString();
-            QString description = query.value("description").toString();
-            
-            QString dateStr = eventDate.toString("MMM dd, yyyy");
-            if (!time.isEmpty()) {
-                dateStr += " at " + time;
-            }
-            
-            // Map calendar event types to news types
-            QString newsType = "Event";
-            if (type == "Exam" || type == "Assignment Due") {
-                newsType = "Important";
-            } else if (type == "Holiday" || type == "Meeting") {
-                newsType = "Notice";
-            }
-            
-            QString content = description.isEmpty() ? 
-                QString("Event scheduled for %1").arg(dateStr) : description;
-            
-            addNewsItem(title, dateStr, content, newsType);
+    // Keep the 20 closest to today, then show upcoming soonest first followed by the past week, newest first
+    auto distance = [today](const CalendarEvent& e) { return qAbs(today.daysTo(e.date)); };
+    std::sort(events.begin(), events.end(), [&](const CalendarEvent& a, const CalendarEvent& b) {
+        if (distance(a) != distance(b)) {
+            return distance(a) < distance(b);
+        }
+        return a.date != b.date ? a.date > b.date : a.time < b.time;
+    });
+    if (events.size() > 20) {
+        events.resize(20);
+    }
+    std::sort(events.begin(), events.end(), [today](const CalendarEvent& a, const CalendarEvent& b) {
+        const bool aUpcoming = a.date >= today;
+        const bool bUpcoming = b.date >= today;
+        if (aUpcoming != bUpcoming) {
+            return aUpcoming;
+        }
+        if (a.date != b.date) {
+            return aUpcoming ? a.date < b.date : a.date > b.date;
+        }
+        return aUpcoming ? a.time < b.time : a.time > b.time;
+    });
+    
+    for (const auto& e : events) {
+        QString dateStr = e.date.toString("MMM dd, yyyy");
+        if (e.time.isValid()) {
+            dateStr += " at " + e.time.toString("HH:mm");
+        }
+        
+        // Map calendar event types to news types
+        QString newsType = "Event";
+        if (e.type == "Exam" || e.type == "Assignment Due") {
+            newsType = "Important";
+        } else if (e.type == "Holiday" || e.type == "Meeting") {
+            newsType = "Notice";
         }
+        
+        QString content = e.description.isEmpty() ? 
+            QString("Event scheduled for %1").arg(dateStr) : e.description;
+        
+        addNewsItem(e.title, dateStr, content, newsType);
     }
     
     // If no events, show welcome message
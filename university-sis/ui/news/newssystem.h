@@ -17,6 +17,8 @@ private:
     void addNewsItem(const QString& title, const QString& date, const QString& content, const QString& type);
     void loadEventsFromDatabase();
     void clearNews();
+    
+    static constexpr int RecurringWindowDays = 14; // Upcoming days of recurring events to show
     QWidget* m_contentContainer;
     QVBoxLayout* m_containerLayout;
 };
@@ -0,0 +1,91 @@
+#include "pageregistry.h"
+#include "../utils/tracer.h"
+#include <QStackedWidget>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDebug>
+
+PageRegistry::PageRegistry(QStackedWidget* stack)
+    : QObject(stack)
+    , m_stack(stack)
+{
+}
+
+int PageRegistry::add(const QString& name, Factory factory)
+{
+    Entry entry;
+    entry.name = name;
+    entry.factory = std::move(factory);
+    m_entries.push_back(std::move(entry));
+    return int(m_entries.size()) - 1;
+}
+
+QString PageRegistry::name(int id) const
+{
+    return (id >= 0 && id < count()) ? m_entries[id].name : QString();
+}
+
+QWidget* PageRegistry::createdPage(int id) const
+{
+    return (id >= 0 && id < count()) ? m_entries[id].widget.data() : nullptr;
+}
+
+QWidget* PageRegistry::page(int id)
+{
+    if (id < 0 || id >= count()) {
+        return nullptr;
+    }
+    if (!m_entries[id].widget) {
+        return create(id, "navigation");
+    }
+    return m_entries[id].widget;
+}
+
+bool PageRegistry::show(int id)
+{
+    QWidget* w = page(id);
+    if (!w) {
+        return false;
+    }
+    m_stack->setCurrentWidget(w);
+    return true;
+}
+
+QWidget* PageRegistry::create(int id, const char* reason)
+{
+    Entry& entry = m_entries[id];
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 traceStart = Tracer::enabled() ? Tracer::instance().nowNs() : 0;
+    QWidget* w = entry.factory();
+    m_stack->addWidget(w);
+    entry.widget = w;
+    if (Tracer::enabled()) {
+        Tracer::instance().complete("ui", "Create " + entry.name, traceStart, Tracer::instance().nowNs());
+    }
+    qDebug() << "Module" << entry.name << "created in" << timer.elapsed() << "ms" << "(" << reason << ")";
+    return w;
+}
+
+void PageRegistry::warmUp(const QList<int>& ids, int delayMs)
+{
+    const bool idle = m_warmUpQueue.isEmpty();
+    m_warmUpQueue.append(ids);
+    if (idle) {
+        QTimer::singleShot(delayMs, this, &PageRegistry::warmUpNext);
+    }
+}
+
+void PageRegistry::warmUpNext()
+{
+    while (!m_warmUpQueue.isEmpty()) {
+        const int id = m_warmUpQueue.takeFirst();
+        if (id >= 0 && id < count() && !m_entries[id].widget) {
+            create(id, "warm-up");
+            break;
+        }
+    }
+    if (!m_warmUpQueue.isEmpty()) {
+        QTimer::singleShot(WarmUpGapMs, this, &PageRegistry::warmUpNext);
+    }
+}
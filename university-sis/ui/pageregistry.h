@@ -0,0 +1,57 @@
+#ifndef PAGEREGISTRY_H
+#define PAGEREGISTRY_H
+
+#include <QObject>
+#include <QPointer>
+#include <QList>
+#include <QString>
+#include <functional>
+#include <vector>
+
+class QStackedWidget;
+class QWidget;
+
+/**
+ * @brief Lazily constructed pages of the main content stack.
+ *
+ * Each module registers a factory; the widget (and the queries its
+ * constructor runs) is only created the first time it is shown, or earlier by
+ * warmUp() while the UI is idle. Creation time is logged per module. The
+ * registry is a child of the stack, so it goes away with it on logout.
+ */
+class PageRegistry : public QObject {
+    Q_OBJECT
+public:
+    using Factory = std::function<QWidget*()>;
+
+    explicit PageRegistry(QStackedWidget* stack);
+
+    int add(const QString& name, Factory factory);
+    int count() const { return int(m_entries.size()); }
+    QString name(int id) const;
+
+    QWidget* page(int id);               // Creates the page on first use
+    QWidget* createdPage(int id) const;  // nullptr until created
+    bool show(int id);
+
+    // Pre-creates the given pages one per event-loop turn, starting after delayMs
+    void warmUp(const QList<int>& ids, int delayMs = 500);
+
+private:
+    struct Entry {
+        QString name;
+        Factory factory;
+        QPointer<QWidget> widget;
+    };
+
+    QWidget* create(int id, const char* reason);
+    void warmUpNext();
+
+    static constexpr int WarmUpGapMs = 50; // Lets input events through between pages
+
+    QStackedWidget* m_stack;
+    std::vector<Entry> m_entries;
+    QList<int> m_warmUpQueue;
+};
+
+#endif // PAGEREGISTRY_H
@@ -1,10 +1,38 @@
 #include "profilewidget.h"
+#include "../../modules/session/sessiondataservice.h"
 #include <QFrame>
+#include <QStringList>
 
 ProfileWidget::ProfileWidget(const QString& username, const QString& role, QWidget* parent)
     : QWidget(parent)
 {
     setupUi(username, role);
+    connect(&SessionDataService::instance(), &SessionDataService::loaded, this, &ProfileWidget::updateSummary);
+    updateSummary();
+}
+
+void ProfileWidget::updateSummary()
+{
+    SessionDataService& session = SessionDataService::instance();
+    if (!session.isStudentSession()) {
+        m_summaryLabel->hide();
+        return;
+    }
+    m_summaryLabel->show();
+
+    auto data = session.snapshot();
+    if (!data || !data->profile) {
+        m_summaryLabel->setText(session.isPending() ? "Loading your details..." : "");
+        return;
+    }
+    QStringList lines;
+    lines << QString("%1 - Year %2").arg(data->profile->department).arg(data->profile->year);
+    lines << QString("%1 enrolled section(s)").arg(data->enrollments.size());
+    if (data->attendance.total() > 0) {
+        lines << QString("Attendance: %1%").arg(data->attendance.rate(), 0, 'f', 0);
+    }
+    lines << QString("Balance due: $%1").arg(data->balanceDue, 0, 'f', 2);
+    m_summaryLabel->setText(lines.join("\n"));
 }
 
 void ProfileWidget::setupUi(const QString& username, const QString& role)
@@ -37,6 +65,11 @@ void ProfileWidget::setupUi(const QString& username, const QString& role)
     roleLabel->setStyleSheet("font-size: 16px; color: #7f8c8d; border: none;");
     cardLayout->addWidget(roleLabel);
     
+    m_summaryLabel = new QLabel();
+    m_summaryLabel->setAlignment(Qt::AlignCenter);
+    m_summaryLabel->setStyleSheet("font-size: 13px; color: #555; border: none;");
+    cardLayout->addWidget(m_summaryLabel);
+    
     // Divider
     QFrame* line = new QFrame();
     line->setFrameShape(QFrame::HLine);
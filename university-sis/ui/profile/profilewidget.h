@@ -16,6 +16,9 @@ signals:
 
 private:
     void setupUi(const QString& username, const QString& role);
+    void updateSummary();
+
+    QLabel* m_summaryLabel = nullptr; // Student details from SessionDataService
 };
 
 #endif // PROFILEWIDGET_H
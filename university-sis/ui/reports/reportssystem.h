@@ -13,6 +13,7 @@
 #include <QLabel>
 #include <QTextEdit>
 #include "../basesystemwidget.h"
+#include "../../modules/reports/reportengine.h"
 
 class ReportsSystem : public BaseSystemWidget
 {
@@ -28,11 +29,10 @@ private slots:
 
 private:
     void setupUi();
-    void generateStudentReport();
-    void generateCourseReport();
-    void generateAttendanceReport();
-    void generateFinancialReport();
+    void showReport();
+    void onReportGenerated(int reportType, const Report &report, bool connected);
     
+    Report m_report;
     QComboBox *m_reportTypeCombo;
     QDateEdit *m_startDateEdit;
     QDateEdit *m_endDateEdit;
@@ -1,5 +1,7 @@
 #include "studentportal.h"
+#include "../utils/tracer.h"
 #include "student/studentdialog.h"
+#include "../modules/session/sessiondataservice.h"
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QStandardItem>
@@ -8,6 +10,11 @@ StudentPortal::StudentPortal(QWidget *parent) : QWidget(parent)
 {
     setupUi();
     loadStudents();
+    connect(&SessionDataService::instance(), &SessionDataService::loaded, this, [this](bool) {
+        if (m_currentUserRole == "Student") {
+            loadStudents();
+        }
+    });
 }
 
 void StudentPortal::setUserContext(const QString& role, int userId)
@@ -103,15 +110,23 @@ void StudentPortal::styleTable()
 
 void StudentPortal::loadStudents()
 {
+    SIS_TRACE_SCOPE("ui", "StudentPortal::loadStudents");
     m_model->removeRows(0, m_model->rowCount());
     
     std::vector<Student> students;
     
     // If Student, only load self
     if (m_currentUserRole == "Student" && m_currentUserId != -1) {
-        auto s = m_repo.getStudentById(m_currentUserId);
-        if (s) {
-            students.push_back(*s);
+        SessionDataService& session = SessionDataService::instance();
+        if (auto data = session.snapshot()) {
+            if (data->profile) {
+                students.push_back(*data->profile);
+            }
+        } else if (!session.isPending()) {
+            auto s = m_repo.getStudentById(m_currentUserId);
+            if (s) {
+                students.push_back(*s);
+            }
         }
     } else {
         // Admin/Faculty see all
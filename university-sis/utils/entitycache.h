@@ -0,0 +1,123 @@
+#ifndef ENTITYCACHE_H
+#define ENTITYCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <functional>
+#include <optional>
+#include <vector>
+
+struct EntityCacheStats {
+    QString name;
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 invalidations = 0;
+    int size = 0;
+
+    double hitRate() const {
+        const quint64 total = hits + misses;
+        return total > 0 ? double(hits) / double(total) : 0.0;
+    }
+};
+
+/**
+ * @brief Read-through cache for small, hot lookup tables (courses, sections,
+ * buildings, rooms).
+ *
+ * The whole table is loaded on the first read and served from memory until a
+ * write invalidates it. T must expose an int `id`. Container is the list type
+ * the owning repository returns.
+ */
+template <typename T, typename Container = std::vector<T>>
+class EntityCache {
+public:
+    using Loader = std::function<std::optional<Container>()>;  // nullopt: the query failed
+    using ItemLoader = std::function<std::optional<T>()>;
+
+    explicit EntityCache(const QString& name) : m_name(name) {}
+
+    // Whole table, loading it through loader on a miss. A failed load returns
+    // an empty container and is not cached, so the next call tries again.
+    Container getAll(const Loader& loader) {
+        QMutexLocker locker(&m_mutex);
+        if (m_valid) {
+            ++m_stats.hits;
+            return m_all;
+        }
+        ++m_stats.misses;
+        std::optional<Container> rows = loader();
+        if (!rows) {
+            return Container();
+        }
+        fill(std::move(*rows));
+        return m_all;
+    }
+
+    // Single row by id. Served from the table snapshot when one is cached,
+    // otherwise from the per-id entries, falling back to loader.
+    std::optional<T> get(int id, const ItemLoader& loader) {
+        QMutexLocker locker(&m_mutex);
+        if (m_valid) {
+            ++m_stats.hits;
+            auto it = m_byId.constFind(id);
+            if (it == m_byId.constEnd()) {
+                return std::nullopt;  // Full table is cached, so the row does not exist
+            }
+            return m_all[it.value()];
+        }
+        auto it = m_items.constFind(id);
+        if (it != m_items.constEnd()) {
+            ++m_stats.hits;
+            return it.value();
+        }
+        ++m_stats.misses;
+        std::optional<T> item = loader();
+        if (item) {
+            m_items.insert(id, *item);
+        }
+        return item;
+    }
+
+    // Called by the repository after every successful write
+    void invalidate() {
+        QMutexLocker locker(&m_mutex);
+        m_valid = false;
+        m_all = Container();
+        m_byId.clear();
+        m_items.clear();
+        ++m_stats.invalidations;
+    }
+
+    EntityCacheStats stats() const {
+        QMutexLocker locker(&m_mutex);
+        EntityCacheStats s = m_stats;
+        s.name = m_name;
+        s.size = m_valid ? int(m_all.size()) : int(m_items.size());
+        return s;
+    }
+
+private:
+    void fill(Container rows) {
+        m_all = std::move(rows);
+        m_byId.clear();
+        m_byId.reserve(int(m_all.size()));
+        for (int i = 0; i < int(m_all.size()); ++i) {
+            m_byId.insert(m_all[i].id, i);
+        }
+        m_items.clear();
+        m_valid = true;
+    }
+
+    QString m_name;
+
+    mutable QMutex m_mutex;
+    bool m_valid = false;
+    Container m_all;
+    QHash<int, int> m_byId;     // id -> index into m_all
+    QHash<int, T> m_items;      // Single rows fetched before the table was loaded
+    EntityCacheStats m_stats;
+};
+
+#endif // ENTITYCACHE_H
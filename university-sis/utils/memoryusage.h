@@ -0,0 +1,9 @@
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <QtGlobal>
+
+// Resident set size of the current process in bytes, or -1 if unavailable
+qint64 currentRssBytes();
+
+#endif // MEMORYUSAGE_H
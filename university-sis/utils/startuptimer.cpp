@@ -0,0 +1,51 @@
+#include "startuptimer.h"
+#include "tracer.h"
+#include <QDebug>
+
+StartupTimer& StartupTimer::instance()
+{
+    static StartupTimer timer;
+    return timer;
+}
+
+void StartupTimer::start()
+{
+    m_clock.start();
+    m_lastMark = 0;
+    m_finished = false;
+    m_phases.clear();
+}
+
+void StartupTimer::mark(const QString& phase, bool userWait)
+{
+    if (!m_clock.isValid() || m_finished) {
+        return;
+    }
+    const qint64 now = m_clock.elapsed();
+    m_phases.push_back({phase, now - m_lastMark, userWait});
+    if (Tracer::enabled()) {
+        Tracer& tracer = Tracer::instance();
+        const qint64 end = tracer.nowNs();
+        tracer.complete("startup", "Startup: " + phase, end - (now - m_lastMark) * 1000000, end);
+    }
+    m_lastMark = now;
+}
+
+void StartupTimer::finish(const QString& phase)
+{
+    if (!m_clock.isValid() || m_finished) {
+        return;
+    }
+    mark(phase);
+    m_finished = true;
+
+    qint64 firstFrame = 0;
+    qint64 waited = 0;
+    for (const auto& p : m_phases) {
+        (p.userWait ? waited : firstFrame) += p.ms;
+        qInfo().noquote() << QString("Startup: %1 %2 ms%3")
+                             .arg(p.name, -28).arg(p.ms, 6).arg(p.userWait ? " (user input, excluded)" : "");
+    }
+    qInfo().noquote() << QString("Startup: time to first frame %1 ms (+%2 ms waiting for login)")
+                         .arg(firstFrame).arg(waited);
+}
@@ -0,0 +1,44 @@
+#ifndef STARTUPTIMER_H
+#define STARTUPTIMER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <vector>
+
+/**
+ * @brief Startup timing breakdown, logged once the first frame is up.
+ *
+ * main() calls start() first and mark() after each phase; the time since the
+ * previous mark is charged to that phase. Phases spent waiting on the user
+ * (the login dialog) are marked as such and left out of the
+ * time-to-first-frame figure.
+ */
+class StartupTimer {
+public:
+    static StartupTimer& instance();
+
+    void start();
+    void mark(const QString& phase, bool userWait = false);
+    void finish(const QString& phase); // Marks the last phase and logs the breakdown
+
+    qint64 elapsedMs() const { return m_clock.isValid() ? m_clock.elapsed() : 0; }
+    bool isFinished() const { return m_finished; }
+
+private:
+    StartupTimer() = default;
+    StartupTimer(const StartupTimer&) = delete;
+    StartupTimer& operator=(const StartupTimer&) = delete;
+
+    struct Phase {
+        QString name;
+        qint64 ms = 0;
+        bool userWait = false;
+    };
+
+    QElapsedTimer m_clock;
+    qint64 m_lastMark = 0;
+    bool m_finished = false;
+    std::vector<Phase> m_phases;
+};
+
+#endif // STARTUPTIMER_H
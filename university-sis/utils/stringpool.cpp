@@ -0,0 +1,63 @@
+#include "stringpool.h"
+#include <QDebug>
+#include <limits>
+
+StringPool::StringPool()
+{
+    m_strings.append(QString());
+    m_ids.insert(QString(), 0);
+}
+
+StringPool& StringPool::instance()
+{
+    static StringPool instance;
+    return instance;
+}
+
+StringPool::Id StringPool::intern(const QString& value)
+{
+    if (value.isEmpty()) {
+        return 0;
+    }
+
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_ids.constFind(value);
+        if (it != m_ids.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto it = m_ids.constFind(value); // Another thread may have added it meanwhile
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+    if (m_strings.size() > std::numeric_limits<Id>::max()) {
+        qWarning() << "StringPool: id space exhausted, not interning" << value;
+        return 0;
+    }
+
+    const Id id = Id(m_strings.size());
+    m_strings.append(value);
+    m_ids.insert(value, id);
+    return id;
+}
+
+QString StringPool::string(Id id) const
+{
+    QReadLocker locker(&m_lock);
+    return id < m_strings.size() ? m_strings.at(id) : QString();
+}
+
+QString StringPool::shared(const QString& value)
+{
+    const Id id = intern(value);
+    return id != 0 ? string(id) : value;
+}
+
+int StringPool::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_strings.size();
+}
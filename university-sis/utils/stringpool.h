@@ -0,0 +1,40 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+/**
+ * @brief Process-wide symbol table for low-cardinality strings
+ * (departments, positions, room types, book categories).
+ *
+ * intern() maps a string to a small integer id; shared() returns the pooled
+ * QString so every row holding the same value shares one buffer instead of
+ * allocating its own copy. Id 0 is always the empty string.
+ */
+class StringPool {
+public:
+    using Id = quint16;
+
+    static StringPool& instance();
+
+    Id intern(const QString& value);
+    QString string(Id id) const;
+    // The pooled copy of value; value itself once the id space is exhausted
+    QString shared(const QString& value);
+
+    int size() const;
+
+private:
+    StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, Id> m_ids;
+    QVector<QString> m_strings;
+};
+
+#endif // STRINGPOOL_H
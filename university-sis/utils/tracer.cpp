@@ -0,0 +1,194 @@
+#include "tracer.h"
+#include <QFile>
+#include <QHash>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer()
+{
+    m_clock.start();
+}
+
+void Tracer::start(const QString& outputPath)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_outputPath = outputPath;
+        m_events.clear();
+        m_events.reserve(64 * 1024);
+        m_dropped = 0;
+    }
+    s_enabled.store(true, std::memory_order_relaxed);
+    qInfo() << "Tracing enabled, writing" << outputPath << "on exit";
+}
+
+void Tracer::record(Event&& event)
+{
+    event.thread = quintptr(QThread::currentThreadId());
+    QMutexLocker locker(&m_mutex);
+    if (int(m_events.size()) >= MaxEvents) {
+        ++m_dropped;
+        return;
+    }
+    m_events.push_back(std::move(event));
+}
+
+void Tracer::complete(const char* category, const char* name, qint64 startNs, qint64 endNs)
+{
+    Event e;
+    e.category = category;
+    e.name = name;
+    e.startNs = startNs;
+    e.durationNs = endNs - startNs;
+    record(std::move(e));
+}
+
+void Tracer::complete(const char* category, const QString& name, qint64 startNs, qint64 endNs)
+{
+    if (!enabled()) {
+        return;
+    }
+    Event e;
+    e.category = category;
+    e.dynamicName = name.toUtf8();
+    e.startNs = startNs;
+    e.durationNs = endNs - startNs;
+    record(std::move(e));
+}
+
+void Tracer::counter(const char* category, const char* name, double value)
+{
+    Event e;
+    e.category = category;
+    e.name = name;
+    e.phase = 'C';
+    e.startNs = nowNs();
+    e.value = value;
+    record(std::move(e));
+}
+
+namespace {
+QByteArray jsonString(const QByteArray& text)
+{
+    QByteArray out;
+    out.reserve(text.size() + 2);
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+    return out;
+}
+
+QByteArray eventName(const char* name, const QByteArray& dynamicName)
+{
+    return name ? QByteArray(name) : dynamicName;
+}
+}
+
+bool Tracer::finish()
+{
+    if (!enabled()) {
+        return true;
+    }
+    s_enabled.store(false, std::memory_order_relaxed);
+
+    QMutexLocker locker(&m_mutex);
+    QFile file(m_outputPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Trace Error: cannot write" << m_outputPath;
+        return false;
+    }
+
+    // Chrome wants small integer thread ids
+    QHash<quintptr, int> threads;
+    file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const Event& e : m_events) {
+        int tid = threads.value(e.thread, 0);
+        if (tid == 0) {
+            tid = int(threads.size()) + 1;
+            threads.insert(e.thread, tid);
+        }
+        QByteArray line = first ? "" : ",\n";
+        first = false;
+        line += "{\"name\":" + jsonString(eventName(e.name, e.dynamicName))
+              + ",\"cat\":" + jsonString(e.category ? e.category : "app")
+              + ",\"ph\":\"" + e.phase + "\",\"pid\":1,\"tid\":" + QByteArray::number(tid)
+              + ",\"ts\":" + QByteArray::number(e.startNs / 1000.0, 'f', 3);
+        if (e.phase == 'C') {
+            line += ",\"args\":{\"value\":" + QByteArray::number(e.value, 'g', 12) + "}}";
+        } else {
+            line += ",\"dur\":" + QByteArray::number(e.durationNs / 1000.0, 'f', 3) + "}";
+        }
+        file.write(line);
+    }
+    file.write("\n]}\n");
+    file.close();
+
+    qInfo() << "Trace written to" << m_outputPath << "(" << m_events.size() << "events," << m_dropped << "dropped)";
+    logHistograms();
+    return true;
+}
+
+// Caller holds m_mutex. Per-scope duration histogram with power-of-two microsecond buckets.
+void Tracer::logHistograms() const
+{
+    struct Histogram {
+        quint64 count = 0;
+        double totalUs = 0.0;
+        double maxUs = 0.0;
+        std::vector<quint64> buckets; // [0] < 1 us, [i] < 2^i us
+    };
+    QHash<QByteArray, Histogram> histograms;
+    for (const Event& e : m_events) {
+        if (e.phase != 'X') {
+            continue;
+        }
+        Histogram& h = histograms[eventName(e.name, e.dynamicName)];
+        const double us = e.durationNs / 1000.0;
+        const int bucket = us < 1.0 ? 0 : int(std::floor(std::log2(us))) + 1;
+        if (int(h.buckets.size()) <= bucket) {
+            h.buckets.resize(bucket + 1, 0);
+        }
+        ++h.buckets[bucket];
+        ++h.count;
+        h.totalUs += us;
+        h.maxUs = std::max(h.maxUs, us);
+    }
+
+    QList<QByteArray> names = histograms.keys();
+    std::sort(names.begin(), names.end(), [&histograms](const QByteArray& a, const QByteArray& b) {
+        return histograms[a].totalUs > histograms[b].totalUs;
+    });
+    for (const QByteArray& name : names) {
+        const Histogram& h = histograms[name];
+        QStringList buckets;
+        for (int i = 0; i < int(h.buckets.size()); ++i) {
+            if (h.buckets[i] > 0) {
+                buckets << QString("<%1us:%2").arg(i == 0 ? qint64(1) : (qint64(1) << i)).arg(h.buckets[i]);
+            }
+        }
+        qInfo().noquote() << QString("Trace: %1 n=%2 total=%3ms mean=%4us max=%5us [%6]")
+                             .arg(QString::fromUtf8(name)).arg(h.count)
+                             .arg(h.totalUs / 1000.0, 0, 'f', 2).arg(h.totalUs / h.count, 0, 'f', 1)
+                             .arg(h.maxUs, 0, 'f', 1).arg(buckets.join(' '));
+    }
+}
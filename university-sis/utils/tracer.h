@@ -0,0 +1,98 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief Lightweight tracing: scoped timers, counters and duration
+ * histograms, written out as Chrome trace JSON (chrome://tracing, Perfetto).
+ *
+ * Off by default. When disabled a SIS_TRACE_SCOPE costs one relaxed atomic
+ * load and nothing is recorded. Enable with --trace <file> or the SIS_TRACE
+ * environment variable; the file is written by finish() at shutdown.
+ * Scope and counter names must be string literals (they are stored by
+ * pointer); use the QString overloads for dynamic names.
+ */
+class Tracer {
+public:
+    static Tracer& instance();
+
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    void start(const QString& outputPath);
+    bool finish();   // Writes the trace and a histogram summary; no-op when disabled
+
+    void complete(const char* category, const char* name, qint64 startNs, qint64 endNs);
+    void complete(const char* category, const QString& name, qint64 startNs, qint64 endNs);
+    void counter(const char* category, const char* name, double value);
+
+    qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+
+    static constexpr int MaxEvents = 1000000; // Later events are dropped and counted
+
+private:
+    Tracer();
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    struct Event {
+        const char* category = nullptr;
+        const char* name = nullptr;
+        QByteArray dynamicName;  // Used when name is null
+        char phase = 'X';        // X = complete, C = counter
+        qint64 startNs = 0;
+        qint64 durationNs = 0;
+        double value = 0.0;
+        quintptr thread = 0;
+    };
+
+    void record(Event&& event);
+    void logHistograms() const;
+
+    static inline std::atomic<bool> s_enabled{false};
+
+    QElapsedTimer m_clock;
+    QString m_outputPath;
+    mutable QMutex m_mutex;
+    std::vector<Event> m_events;
+    quint64 m_dropped = 0;
+};
+
+// RAII timer for the enclosing scope
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name) {
+        if (Q_UNLIKELY(Tracer::enabled())) {
+            m_category = category;
+            m_name = name;
+            m_start = Tracer::instance().nowNs();
+        }
+    }
+    ~TraceScope() {
+        if (Q_UNLIKELY(m_name != nullptr)) {
+            Tracer& tracer = Tracer::instance();
+            tracer.complete(m_category, m_name, m_start, tracer.nowNs());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_category = nullptr;
+    const char* m_name = nullptr;
+    qint64 m_start = 0;
+};
+
+#define SIS_TRACE_CONCAT_INNER(a, b) a##b
+#define SIS_TRACE_CONCAT(a, b) SIS_TRACE_CONCAT_INNER(a, b)
+#define SIS_TRACE_SCOPE(category, name) TraceScope SIS_TRACE_CONCAT(sisTraceScope_, __LINE__)(category, name)
+#define SIS_TRACE_COUNTER(category, name, value) \
+    do { if (Q_UNLIKELY(Tracer::enabled())) Tracer::instance().counter(category, name, double(value)); } while (0)
+
+#endif // TRACER_H